@@ -0,0 +1,24 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "aligned_read_core.hpp"
+
+namespace octopus {
+
+AlignedReadCore extract_core(const AlignedRead& read) noexcept
+{
+    AlignedReadCore result {};
+    result.flags = read.flags();
+    result.mapping_quality = read.mapping_quality();
+    result.sequence_size = sequence_size(read);
+    result.has_other_segment = read.has_other_segment();
+    if (result.has_other_segment) {
+        const auto& next_segment = read.next_segment();
+        result.next_segment_flags.unmapped = next_segment.is_marked_unmapped();
+        result.next_segment_flags.reverse_mapped = next_segment.is_marked_reverse_mapped();
+        result.next_segment_on_same_contig = next_segment.contig_name() == contig_name(read);
+    }
+    return result;
+}
+
+} // namespace octopus
@@ -0,0 +1,27 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef aligned_read_core_hpp
+#define aligned_read_core_hpp
+
+#include "aligned_read.hpp"
+
+namespace octopus {
+
+// The fields of an AlignedRead that are available from an alignment record before the read name,
+// sequence, base qualities, and cigar are decoded.
+struct AlignedReadCore
+{
+    AlignedRead::Flags flags;
+    AlignedRead::MappingQuality mapping_quality;
+    AlignedRead::NucleotideSequence::size_type sequence_size;
+    bool has_other_segment;
+    AlignedRead::Segment::Flags next_segment_flags;
+    bool next_segment_on_same_contig;
+};
+
+AlignedReadCore extract_core(const AlignedRead& read) noexcept;
+
+} // namespace octopus
+
+#endif
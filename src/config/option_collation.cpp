@@ -311,7 +311,13 @@ ReferenceGenome make_reference(const OptionMap& options)
         }
     }
     try {
-        return octopus::make_reference(std::move(resolved_path), ref_cache_size, is_threading_allowed(options));
+        boost::optional<fs::path> packed_store_path {};
+        if (is_set("packed-reference-path", options)) {
+            packed_store_path = resolve_path(options.at("packed-reference-path").as<fs::path>(), options);
+        }
+        const auto use_packed_store = options.at("packed-reference").as<bool>() || packed_store_path;
+        return octopus::make_reference(std::move(resolved_path), ref_cache_size, is_threading_allowed(options),
+                                       true, true, use_packed_store, std::move(packed_store_path));
     } catch (MissingFileError& e) {
         e.set_location_specified("the command line option --reference");
         throw;
@@ -683,7 +689,13 @@ ReadManager make_read_manager(const OptionMap& options)
 {
     auto read_paths = get_read_paths(options);
     const auto max_open_files = as_unsigned("max-open-read-files", options);
-    return ReadManager {std::move(read_paths), max_open_files};
+    auto num_threads = get_num_threads(options);
+    if (!num_threads) {
+        num_threads = std::thread::hardware_concurrency();
+    }
+    ReadManager result {std::move(read_paths), max_open_files};
+    result.set_max_fetch_threads(std::min(*num_threads, result.num_files()));
+    return result;
 }
 
 bool allow_assembler_generation(const OptionMap& options)
@@ -1648,6 +1660,7 @@ HaplotypeLikelihoodModel make_likelihood_model(const OptionMap& options, const b
     HaplotypeLikelihoodModel::Config config {};
     config.use_mapping_quality = options.at("model-mapping-quality").as<bool>();
     config.use_flank_state = allow_flank_scoring(options);
+    config.use_read_batching = options.at("batch-read-likelihoods").as<bool>();
     if (config.use_mapping_quality) {
         config.mapping_quality_cap = calculate_mapping_quality_cap(options, read_profile);
         config.mapping_quality_cap_trigger = calculate_mapping_quality_cap_trigger(options, read_profile);
@@ -87,6 +87,16 @@ OptionMap parse_options(const int argc, const char** argv)
      po::value<MemoryFootprint>()->default_value(*parse_footprint("500MB"), "500MB"),
      "Maximum memory footprint for cached reference sequence")
     
+    ("packed-reference",
+     po::bool_switch()->default_value(false),
+     "Read reference sequence from a memory-mapped 2-bit packed copy of the reference, which is made"
+     " next to the FASTA the first time it is used, or in the system temp directory if the FASTA directory"
+     " is not writable. Threads read the packed reference without locking and the reference cache is not used")
+    
+    ("packed-reference-path",
+     po::value<fs::path>(),
+     "Location of the packed reference copy, which is made if it does not exist (implies --packed-reference)")
+    
     ("target-read-buffer-footprint,B",
      po::value<MemoryFootprint>()->default_value(*parse_footprint("6GB"), "6GB"),
      "None binding request to limit the memory footprint of buffered read data")
@@ -522,6 +532,11 @@ OptionMap parse_options(const int argc, const char** argv)
      po::value<bool>()->default_value(true),
      "Include the read mapping quality in the haplotype likelihood calculation")
     
+    ("batch-read-likelihoods",
+     po::value<bool>()->default_value(false),
+     "Score reads of the same length together with the inter-read SIMD pair HMM when"
+     " calculating haplotype likelihoods")
+    
     ("sequence-error-model",
      po::value<std::string>()->default_value("PCR-free.HiSeq-2500"),
      "The sequencer error model to use")
@@ -303,6 +303,7 @@ Caller::call_variants(const GenomicRegion& call_region, const MappableFlatSet<Va
 {
     std::deque<CallWrapper> result {};
     auto haplotype_likelihoods = make_haplotype_likelihood_cache();
+    auto likelihood_reuse_cache = make_read_likelihood_reuse_cache();
     if (candidates.empty()) {
         if (refcalls_requested()) {
             utils::append(call_reference(call_region, reads), result);
@@ -343,7 +344,7 @@ Caller::call_variants(const GenomicRegion& call_region, const MappableFlatSet<Va
             continue;
         }
         if (debug_log_) stream(*debug_log_) << "There are " << count_reads(active_reads) << " active reads in " << active_region;
-        if (!populate(haplotype_likelihoods, active_region, haplotypes, candidates, active_reads)) {
+        if (!populate(haplotype_likelihoods, active_region, haplotypes, candidates, active_reads, likelihood_reuse_cache)) {
             haplotype_generator.clear_progress();
             haplotype_likelihoods.clear();
             continue;
@@ -393,6 +394,10 @@ Caller::call_variants(const GenomicRegion& call_region, const MappableFlatSet<Va
         haplotype_likelihoods.clear();
         progress_meter.log_completed(completed_region);
     }
+    if (debug_log_) {
+        stream(*debug_log_) << "Read likelihood reuse cache had " << likelihood_reuse_cache.num_hits() << " hits and "
+                            << likelihood_reuse_cache.num_misses() << " misses in " << call_region;
+    }
     return result;
 }
 
@@ -411,6 +416,11 @@ ExecutionPolicy Caller::exucution_policy() const noexcept
     return parameters_.execution_policy;
 }
 
+std::shared_ptr<Executor> Caller::executor() const noexcept
+{
+    return get_executor();
+}
+
 Caller::GeneratorStatus
 Caller::generate_active_haplotypes(const GenomicRegion& call_region,
                                    HaplotypeGenerator& haplotype_generator,
@@ -852,7 +862,18 @@ HaplotypeGenerator Caller::make_haplotype_generator(const MappableFlatSet<Varian
 
 HaplotypeLikelihoodArray Caller::make_haplotype_likelihood_cache() const
 {
-    return HaplotypeLikelihoodArray {likelihood_model_, parameters_.max_haplotypes, samples_};
+    return HaplotypeLikelihoodArray {likelihood_model_, parameters_.max_haplotypes, samples_, executor()};
+}
+
+ReadLikelihoodCache Caller::make_read_likelihood_reuse_cache() const
+{
+    // Most of the working memory is needed for the likelihoods and genotype models of each active region
+    static constexpr MemoryFootprint defaultMaxReuseCacheMemory {64 * 1024 * 1024};
+    if (parameters_.target_max_memory) {
+        return ReadLikelihoodCache {parameters_.target_max_memory->bytes() / 4};
+    } else {
+        return ReadLikelihoodCache {defaultMaxReuseCacheMemory};
+    }
 }
 
 VcfRecordFactory Caller::make_record_factory(const ReadMap& reads) const
@@ -903,7 +924,8 @@ bool Caller::populate(HaplotypeLikelihoodArray& haplotype_likelihoods,
                       const GenomicRegion& active_region,
                       const std::vector<Haplotype>& haplotypes,
                       const MappableFlatSet<Variant>& candidates,
-                      const ReadMap& active_reads) const
+                      const ReadMap& active_reads,
+                      ReadLikelihoodCache& reuse_cache) const
 {
     assert(haplotype_likelihoods.is_empty());
     boost::optional<HaplotypeLikelihoodArray::FlankState> flank_state {};
@@ -920,7 +942,7 @@ bool Caller::populate(HaplotypeLikelihoodArray& haplotype_likelihoods,
         }
     }
     try {
-        haplotype_likelihoods.populate(active_reads, haplotypes, std::move(flank_state));
+        haplotype_likelihoods.populate(active_reads, haplotypes, std::move(flank_state), reuse_cache);
     } catch(const HaplotypeLikelihoodModel::ShortHaplotypeError& e) {
         if (debug_log_) {
             stream(*debug_log_) << "Skipping " << active_region << " as a haplotype was too short by "
@@ -928,6 +950,9 @@ bool Caller::populate(HaplotypeLikelihoodArray& haplotype_likelihoods,
         }
         return false;
     }
+    if (debug_log_) {
+        stream(*debug_log_) << "Read likelihood compression ratio is " << haplotype_likelihoods.compression_ratio();
+    }
     if (trace_log_) {
         debug::print_read_haplotype_likelihoods(stream(*trace_log_), haplotypes, active_reads,
                                                haplotype_likelihoods, -1);
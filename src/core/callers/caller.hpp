@@ -22,6 +22,7 @@
 #include "core/types/haplotype.hpp"
 #include "core/tools/coretools.hpp"
 #include "core/models/haplotype_likelihood_array.hpp"
+#include "core/models/read_likelihood_cache.hpp"
 #include "containers/mappable_flat_set.hpp"
 #include "containers/probability_matrix.hpp"
 #include "logging/progress_meter.hpp"
@@ -146,6 +147,7 @@ protected:
     
     boost::optional<MemoryFootprint> target_max_memory() const noexcept;
     ExecutionPolicy exucution_policy() const noexcept;
+    std::shared_ptr<Executor> executor() const noexcept; // may be null
 
 private:
     virtual std::unique_ptr<Latents>
@@ -176,13 +178,14 @@ private:
     HaplotypeGenerator make_haplotype_generator(const MappableFlatSet<Variant>& candidates, const ReadMap& reads,
                                                 const ReadPipe::Report& read_report) const;
     HaplotypeLikelihoodArray make_haplotype_likelihood_cache() const;
+    ReadLikelihoodCache make_read_likelihood_reuse_cache() const;
     VcfRecordFactory make_record_factory(const ReadMap& reads) const;
     std::vector<Haplotype>
     filter(std::vector<Haplotype>& haplotypes, const HaplotypeLikelihoodArray& haplotype_likelihoods,
            const std::deque<Haplotype>& protected_haplotypes) const;
     bool populate(HaplotypeLikelihoodArray& haplotype_likelihoods, const GenomicRegion& active_region,
                   const std::vector<Haplotype>& haplotypes, const MappableFlatSet<Variant>& candidates,
-                  const ReadMap& active_reads) const;
+                  const ReadMap& active_reads, ReadLikelihoodCache& reuse_cache) const;
     std::vector<std::reference_wrapper<const Haplotype>>
     get_removable_haplotypes(const std::vector<Haplotype>& haplotypes, const HaplotypeLikelihoodArray& haplotype_likelihoods,
                              const Latents::HaplotypeProbabilityMap& haplotype_posteriors,
@@ -11,6 +11,8 @@
 #include <deque>
 #include <unordered_set>
 #include <stdexcept>
+#include <future>
+#include <memory>
 #include <iostream>
 
 #include <boost/iterator/zip_iterator.hpp>
@@ -31,6 +33,7 @@
 #include "utils/merge_transform.hpp"
 #include "utils/mappable_algorithms.hpp"
 #include "utils/maths.hpp"
+#include "utils/executor.hpp"
 #include "logging/logging.hpp"
 #include "core/types/calls/germline_variant_call.hpp"
 #include "core/types/calls/reference_call.hpp"
@@ -140,13 +143,22 @@ CancerCaller::infer_latents(const std::vector<Haplotype>& haplotypes,
     set_model_priors(*result);
     generate_germline_genotypes(*result, haplotypes);
     if (debug_log_) stream(*debug_log_) << "There are " << result->germline_genotypes_.size() << " candidate germline genotypes";
-    evaluate_germline_model(*result, haplotype_likelihoods);
-    evaluate_cnv_model(*result, haplotype_likelihoods);
-    if (haplotypes.size() > 1) {
-        fit_somatic_model(*result, haplotype_likelihoods);
-        evaluate_noise_model(*result, haplotype_likelihoods);
-        set_model_posteriors(*result);
+    result->germline_prior_model_ = make_germline_prior_model(haplotypes);
+    // The CNV model only depends on the germline prior, so it can be fitted alongside the other models
+    auto cnv_fit = fit_cnv_model(*result, haplotype_likelihoods);
+    try {
+        evaluate_germline_model(*result, haplotype_likelihoods);
+        if (haplotypes.size() > 1) {
+            fit_somatic_model(*result, haplotype_likelihoods, cnv_fit);
+            evaluate_noise_model(*result, haplotype_likelihoods);
+            join_cnv_model(*result, cnv_fit);
+            set_model_posteriors(*result);
+        }
+    } catch (...) {
+        if (cnv_fit.valid()) cnv_fit.wait();
+        throw;
     }
+    join_cnv_model(*result, cnv_fit);
     return result;
 }
 
@@ -165,7 +177,8 @@ void CancerCaller::set_cancer_genotype_prior_model(Latents& latents) const
     latents.cancer_genotype_prior_model_ = CancerGenotypePriorModel {*latents.germline_prior_model_, std::move(mutation_model)};
 }
 
-void CancerCaller::fit_somatic_model(Latents& latents, const HaplotypeLikelihoodArray& haplotype_likelihoods) const
+void CancerCaller::fit_somatic_model(Latents& latents, const HaplotypeLikelihoodArray& haplotype_likelihoods,
+                                     std::future<CNVModel::InferredLatents>& cnv_fit) const
 {
     set_cancer_genotype_prior_model(latents);
     SomaticModel::InferredLatents prev_latents;
@@ -182,6 +195,7 @@ void CancerCaller::fit_somatic_model(Latents& latents, const HaplotypeLikelihood
                 break;
             }
         } else {
+            join_cnv_model(latents, cnv_fit);
             set_model_posteriors(latents);
             if (latents.model_posteriors_.somatic < std::max(latents.model_posteriors_.germline, latents.model_posteriors_.cnv)) {
                 break;
@@ -374,22 +388,26 @@ auto copy_greatest_probability_genotypes(const std::vector<G>& genotypes,
     return std::make_pair(std::move(result_genotypes), std::move(result_indices));
 }
 
-auto calculate_posteriors_with_germline_likelihood_model(const std::vector<CancerGenotype<Haplotype>>& genotypes,
-                                                         const std::vector<CancerGenotypeIndex>& indices,
+auto calculate_posteriors_with_germline_likelihood_model(const std::vector<CancerGenotypeIndex>& indices,
                                                          const CancerGenotypePriorModel& prior_model,
                                                          const model::ConstantMixtureGenotypeLikelihoodModel likelihood_model,
                                                          const std::vector<SampleName>& samples)
 {
     auto result = evaluate(indices, prior_model);
-    GenotypeIndex flattened_index(genotypes.front().ploidy());
+    // Germline haplotypes come first so genotypes with the same germline part share its evaluation
+    std::vector<GenotypeIndex> flattened_indices {};
+    flattened_indices.reserve(indices.size());
+    for (const auto& genotype : indices) {
+        GenotypeIndex flattened_index {};
+        flattened_index.reserve(genotype.germline.size() + genotype.somatic.size());
+        flattened_index.insert(std::cend(flattened_index), std::cbegin(genotype.germline), std::cend(genotype.germline));
+        flattened_index.insert(std::cend(flattened_index), std::cbegin(genotype.somatic), std::cend(genotype.somatic));
+        flattened_indices.push_back(std::move(flattened_index));
+    }
     for (const auto& sample : samples) {
         likelihood_model.cache().prime(sample);
-        std::transform(std::cbegin(indices), std::cend(indices), std::cbegin(result), std::begin(result),
-                       [&] (const auto& genotype, auto curr) {
-                           auto itr = std::copy(std::cbegin(genotype.germline), std::cbegin(genotype.germline), std::begin(flattened_index));
-                           std::copy(std::cbegin(genotype.somatic), std::cbegin(genotype.somatic), itr);
-                           return curr + likelihood_model.evaluate(flattened_index);
-                       });
+        const auto likelihoods = likelihood_model.evaluate(flattened_indices);
+        std::transform(std::cbegin(likelihoods), std::cend(likelihoods), std::cbegin(result), std::begin(result), std::plus<> {});
     }
     maths::normalise_exp(result);
     return result;
@@ -402,7 +420,7 @@ void filter_with_germline_model(std::vector<CancerGenotype<Haplotype>>& genotype
                                 const std::vector<SampleName>& samples,
                                 const std::size_t n)
 {
-    const auto germline_model_posteriors = calculate_posteriors_with_germline_likelihood_model(genotypes, indices, prior_model, likelihood_model, samples);
+    const auto germline_model_posteriors = calculate_posteriors_with_germline_likelihood_model(indices, prior_model, likelihood_model, samples);
     auto result = copy_greatest_probability_genotypes(genotypes, indices, germline_model_posteriors, n);
     genotypes = std::move(result.first);
     indices = std::move(result.second);
@@ -642,7 +660,7 @@ bool CancerCaller::has_high_normal_contamination_risk(const Latents& latents) co
 void CancerCaller::evaluate_germline_model(Latents& latents, const HaplotypeLikelihoodArray& haplotype_likelihoods) const
 {
     assert(!(latents.haplotypes_.get().empty() || latents.germline_genotypes_.empty()));
-    latents.germline_prior_model_ = make_germline_prior_model(latents.haplotypes_);
+    assert(latents.germline_prior_model_);
     latents.germline_model_ = std::make_unique<GermlineModel>(*latents.germline_prior_model_);
     const auto pooled_likelihoods = pool_likelihood(samples_,  latents.haplotypes_, haplotype_likelihoods);
     if (latents.germline_genotype_indices_) {
@@ -656,23 +674,51 @@ void CancerCaller::evaluate_germline_model(Latents& latents, const HaplotypeLike
     }
 }
 
-void CancerCaller::evaluate_cnv_model(Latents& latents, const HaplotypeLikelihoodArray& haplotype_likelihoods) const
+CancerCaller::CNVModel::InferredLatents
+CancerCaller::evaluate_cnv_model(const Latents& latents, const GenotypePriorModel& germline_prior_model,
+                                 const HaplotypeLikelihoodArray& haplotype_likelihoods) const
 {
-    assert(!latents.germline_genotypes_.empty() && latents.germline_prior_model_);
-    auto cnv_model_priors = get_cnv_model_priors(*latents.germline_prior_model_);
+    assert(!latents.germline_genotypes_.empty());
+    auto cnv_model_priors = get_cnv_model_priors(germline_prior_model);
     CNVModel::AlgorithmParameters params {};
     if (parameters_.max_vb_seeds) params.max_seeds = *parameters_.max_vb_seeds;
     params.target_max_memory = this->target_max_memory();
     CNVModel cnv_model {samples_, cnv_model_priors, params};
     if (latents.germline_genotype_indices_) {
         cnv_model.prime(latents.haplotypes_);
-        latents.cnv_model_inferences_ = cnv_model.evaluate(latents.germline_genotypes_, *latents.germline_genotype_indices_,
-                                                           haplotype_likelihoods);
+        return cnv_model.evaluate(latents.germline_genotypes_, *latents.germline_genotype_indices_, haplotype_likelihoods);
+    } else {
+        return cnv_model.evaluate(latents.germline_genotypes_, haplotype_likelihoods);
+    }
+}
+
+std::future<CancerCaller::CNVModel::InferredLatents>
+CancerCaller::fit_cnv_model(const Latents& latents, const HaplotypeLikelihoodArray& haplotype_likelihoods) const
+{
+    assert(latents.germline_prior_model_);
+    const auto executor = this->executor();
+    if (executor && executor->num_available_helpers() > 0) {
+        // The prior model caches and the likelihood array is primed per sample, so the concurrent fit
+        // gets its own prior model and a shared view of the likelihoods; the result is the same as a sequential fit.
+        std::shared_ptr<GenotypePriorModel> germline_prior_model {make_germline_prior_model(latents.haplotypes_)};
+        if (latents.germline_genotype_indices_) germline_prior_model->prime(latents.haplotypes_);
+        auto likelihoods = std::make_shared<HaplotypeLikelihoodArray>(haplotype_likelihoods.share());
+        return executor->async("CancerCaller::fit_cnv_model", [this, &latents, germline_prior_model, likelihoods] () {
+            return evaluate_cnv_model(latents, *germline_prior_model, *likelihoods);
+        });
     } else {
-        latents.cnv_model_inferences_ = cnv_model.evaluate(latents.germline_genotypes_, haplotype_likelihoods);
+        // Evaluated when first needed, by which time the germline model has primed the prior model
+        return std::async(std::launch::deferred, [this, &latents, &haplotype_likelihoods] () {
+            return evaluate_cnv_model(latents, *latents.germline_prior_model_, haplotype_likelihoods);
+        });
     }
 }
 
+void CancerCaller::join_cnv_model(Latents& latents, std::future<CNVModel::InferredLatents>& cnv_fit) const
+{
+    if (cnv_fit.valid()) latents.cnv_model_inferences_ = cnv_fit.get();
+}
+
 void CancerCaller::evaluate_somatic_model(Latents& latents, const HaplotypeLikelihoodArray& haplotype_likelihoods) const
 {
     assert(latents.germline_prior_model_ && !latents.cancer_genotypes_.empty());
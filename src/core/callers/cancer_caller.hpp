@@ -7,6 +7,7 @@
 #include <vector>
 #include <unordered_map>
 #include <memory>
+#include <future>
 #include <functional>
 #include <typeindex>
 
@@ -151,7 +152,10 @@ private:
     bool has_high_normal_contamination_risk(const Latents& latents) const;
     
     void evaluate_germline_model(Latents& latents, const HaplotypeLikelihoodArray& haplotype_likelihoods) const;
-    void evaluate_cnv_model(Latents& latents, const HaplotypeLikelihoodArray& haplotype_likelihoods) const;
+    CNVModel::InferredLatents evaluate_cnv_model(const Latents& latents, const GenotypePriorModel& germline_prior_model,
+                                                 const HaplotypeLikelihoodArray& haplotype_likelihoods) const;
+    std::future<CNVModel::InferredLatents> fit_cnv_model(const Latents& latents, const HaplotypeLikelihoodArray& haplotype_likelihoods) const;
+    void join_cnv_model(Latents& latents, std::future<CNVModel::InferredLatents>& cnv_fit) const;
     void evaluate_somatic_model(Latents& latents, const HaplotypeLikelihoodArray& haplotype_likelihoods) const;
     void evaluate_noise_model(Latents& latents, const HaplotypeLikelihoodArray& haplotype_likelihoods) const;
     
@@ -159,7 +163,8 @@ private:
     void set_model_posteriors(Latents& latents) const;
 
     void set_cancer_genotype_prior_model(Latents& latents) const;
-    void fit_somatic_model(Latents& latents, const HaplotypeLikelihoodArray& haplotype_likelihoods) const;
+    void fit_somatic_model(Latents& latents, const HaplotypeLikelihoodArray& haplotype_likelihoods,
+                           std::future<CNVModel::InferredLatents>& cnv_fit) const;
     
     std::unique_ptr<GenotypePriorModel> make_germline_prior_model(const std::vector<Haplotype>& haplotypes) const;
     CNVModel::Priors get_cnv_model_priors(const GenotypePriorModel& prior_model) const;
@@ -9,9 +9,12 @@
 #include <algorithm>
 #include <functional>
 #include <exception>
+#include <thread>
 
 #include "config/config.hpp"
 #include "config/option_collation.hpp"
+#include "io/htslib_thread_pool.hpp"
+#include "utils/executor.hpp"
 #include "utils/map_utils.hpp"
 #include "logging/logging.hpp"
 #include "exceptions/user_error.hpp"
@@ -30,8 +33,11 @@ VcfWriter make_vcf_writer(boost::optional<fs::path> dst)
 } // namespace
 
 GenomeCallingComponents::GenomeCallingComponents(ReferenceGenome&& reference, ReadManager&& read_manager,
-                                                 VcfWriter&& output, const options::OptionMap& options)
-: components_ {std::move(reference), std::move(read_manager), std::move(output), options}
+                                                 VcfWriter&& output, const options::OptionMap& options,
+                                                 std::shared_ptr<io::HtslibThreadPool> htslib_thread_pool,
+                                                 std::shared_ptr<Executor> executor)
+: components_ {std::move(reference), std::move(read_manager), std::move(output), options,
+               std::move(htslib_thread_pool), std::move(executor)}
 {}
 
 GenomeCallingComponents::GenomeCallingComponents(GenomeCallingComponents&& other) noexcept
@@ -491,8 +497,12 @@ public:
 } // namespace
 
 GenomeCallingComponents::Components::Components(ReferenceGenome&& reference, ReadManager&& read_manager,
-                                                VcfWriter&& output, const options::OptionMap& options)
-: reference {std::move(reference)}
+                                                VcfWriter&& output, const options::OptionMap& options,
+                                                std::shared_ptr<io::HtslibThreadPool> htslib_thread_pool,
+                                                std::shared_ptr<Executor> executor)
+: htslib_thread_pool {std::move(htslib_thread_pool)}
+, executor {std::move(executor)}
+, reference {std::move(reference)}
 , read_manager {std::move(read_manager)}
 , samples {extract_samples(options, this->read_manager)}
 , regions {get_search_regions(options, this->reference, this->read_manager)}
@@ -652,8 +662,34 @@ VcfWriter make_output_vcf_writer(const options::OptionMap& options)
 
 } // namespace
 
+namespace {
+
+std::shared_ptr<io::HtslibThreadPool> make_htslib_thread_pool(const options::OptionMap& options)
+{
+    auto num_threads = options::get_num_threads(options);
+    if (!num_threads) num_threads = std::thread::hardware_concurrency();
+    if (*num_threads <= 1) return nullptr;
+    return std::make_shared<io::HtslibThreadPool>(*num_threads);
+}
+
+std::shared_ptr<Executor> make_executor(const options::OptionMap& options)
+{
+    auto num_threads = options::get_num_threads(options);
+    if (!num_threads) num_threads = std::thread::hardware_concurrency();
+    if (*num_threads <= 1) return nullptr;
+    return std::make_shared<Executor>(*num_threads);
+}
+
+} // namespace
+
 GenomeCallingComponents collate_genome_calling_components(const options::OptionMap& options)
 {
+    // Installed before any files are opened so that all htslib files share the pool
+    auto htslib_thread_pool = make_htslib_thread_pool(options);
+    io::install_htslib_thread_pool(htslib_thread_pool);
+    // Installed before any callers are made so that all parallel work within calling tasks shares it
+    auto executor = make_executor(options);
+    install_executor(executor);
     auto reference    = options::make_reference(options);
     auto read_manager = options::make_read_manager(options);
     // Check this here to avoid creating output file on error
@@ -665,7 +701,9 @@ GenomeCallingComponents collate_genome_calling_components(const options::OptionM
         std::move(reference),
         std::move(read_manager),
         std::move(output),
-        options
+        options,
+        std::move(htslib_thread_pool),
+        std::move(executor)
     };
 }
 
@@ -30,6 +30,9 @@
 
 namespace octopus {
 
+namespace io { class HtslibThreadPool; }
+class Executor;
+
 class GenomeCallingComponents
 {
 public:
@@ -38,7 +41,9 @@ public:
     GenomeCallingComponents() = delete;
     
     GenomeCallingComponents(ReferenceGenome&& reference, ReadManager&& read_manager,
-                            VcfWriter&& output, const options::OptionMap& options);
+                            VcfWriter&& output, const options::OptionMap& options,
+                            std::shared_ptr<io::HtslibThreadPool> htslib_thread_pool = nullptr,
+                            std::shared_ptr<Executor> executor = nullptr);
     
     GenomeCallingComponents(const GenomeCallingComponents&)            = delete;
     GenomeCallingComponents& operator=(const GenomeCallingComponents&) = delete;
@@ -84,7 +89,9 @@ private:
         Components() = delete;
         
         Components(ReferenceGenome&& reference, ReadManager&& read_manager,
-                   VcfWriter&& output, const options::OptionMap& options);
+                   VcfWriter&& output, const options::OptionMap& options,
+                   std::shared_ptr<io::HtslibThreadPool> htslib_thread_pool,
+                   std::shared_ptr<Executor> executor);
         
         Components(const Components&)            = delete;
         Components& operator=(const Components&) = delete;
@@ -93,6 +100,8 @@ private:
         
         ~Components() = default;
         
+        std::shared_ptr<io::HtslibThreadPool> htslib_thread_pool; // must outlive all htslib files
+        std::shared_ptr<Executor> executor;
         ReferenceGenome reference;
         ReadManager read_manager;
         std::vector<SampleName> samples;
@@ -0,0 +1,36 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "calling_task.hpp"
+
+#include <sstream>
+#include <iostream>
+
+namespace octopus {
+
+std::ostream& operator<<(std::ostream& os, const TaskCost& cost)
+{
+    os << cost.predicted << " (" << cost.num_reads << " reads, " << cost.repeat_fraction << " repetitive)";
+    return os;
+}
+
+std::ostream& operator<<(std::ostream& os, const Task& task)
+{
+    os << task.region;
+    return os;
+}
+
+std::string duration(const CompletedTask& task)
+{
+    std::ostringstream ss {};
+    ss << task.runtime;
+    return ss.str();
+}
+
+std::ostream& operator<<(std::ostream& os, const CompletedTask& task)
+{
+    os << task.region;
+    return os;
+}
+
+} // namespace octopus
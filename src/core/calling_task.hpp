@@ -0,0 +1,94 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef calling_task_hpp
+#define calling_task_hpp
+
+#include <deque>
+#include <unordered_map>
+#include <string>
+#include <utility>
+#include <cstddef>
+#include <iosfwd>
+
+#include "config/common.hpp"
+#include "basics/genomic_region.hpp"
+#include "concepts/mappable.hpp"
+#include "io/variant/vcf_record.hpp"
+#include "utils/timing.hpp"
+
+namespace octopus {
+
+// Features of a task region that are cheap to compute before calling, and the cost predicted from them
+struct TaskCost
+{
+    std::size_t num_reads = 0;
+    double repeat_fraction = 0.0;
+    double predicted = 0.0;
+};
+
+std::ostream& operator<<(std::ostream& os, const TaskCost& cost);
+
+struct Task : public Mappable<Task>
+{
+    GenomicRegion region;
+    ExecutionPolicy policy;
+    std::size_t index; // the position of the task in its contig
+    TaskCost cost;
+
+    Task() = delete;
+
+    Task(GenomicRegion region, ExecutionPolicy policy = ExecutionPolicy::seq, std::size_t index = 0)
+    : region {std::move(region)}
+    , policy {policy}
+    , index {index}
+    , cost {}
+    {};
+
+    const GenomicRegion& mapped_region() const noexcept { return region; }
+};
+
+std::ostream& operator<<(std::ostream& os, const Task& task);
+
+struct ContigOrder
+{
+    using ContigName = GenomicRegion::ContigName;
+
+    template <typename Container>
+    ContigOrder(const Container& contigs)
+    : ranks_ {}
+    {
+        ranks_.reserve(contigs.size());
+        for (const auto& contig : contigs) {
+            ranks_.emplace(contig, ranks_.size());
+        }
+    }
+
+    bool operator()(const ContigName& lhs, const ContigName& rhs) const
+    {
+        return rank(lhs) < rank(rhs);
+    }
+
+    std::size_t rank(const ContigName& contig) const
+    {
+        return ranks_.at(contig);
+    }
+
+private:
+    std::unordered_map<ContigName, std::size_t> ranks_;
+};
+
+struct CompletedTask : public Task
+{
+    CompletedTask(Task task) : Task {std::move(task)}, calls {}, runtime {} {}
+    std::deque<VcfRecord> calls;
+    utils::TimeInterval runtime;
+};
+
+std::string duration(const CompletedTask& task);
+
+std::ostream& operator<<(std::ostream& os, const CompletedTask& task);
+
+} // namespace octopus
+
+#endif
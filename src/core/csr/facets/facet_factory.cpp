@@ -237,6 +237,11 @@ FacetFactory::make(const std::vector<std::string>& names,
     return result;
 }
 
+void FacetFactory::hint(std::vector<GenomicRegion> regions) const
+{
+    if (read_pipe_) read_pipe_->hint(std::move(regions));
+}
+
 // private methods
 
 void FacetFactory::setup_facet_makers()
@@ -47,6 +47,9 @@ public:
     FacetWrapper make(const std::string& name, const CallBlock& block) const;
     FacetBlock make(const std::vector<std::string>& names, const CallBlock& block) const;
     std::vector<FacetBlock> make(const std::vector<std::string>& names, const std::vector<CallBlock>& blocks, ThreadPool& workers) const;
+    
+    // Passes read hints on to the read pipe, if there is one
+    void hint(std::vector<GenomicRegion> regions) const;
 
 private:
     struct BlockData
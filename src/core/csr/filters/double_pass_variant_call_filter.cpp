@@ -61,19 +61,21 @@ DoublePassVariantCallFilter::make_registration_pass(const VcfReader& source, con
     prepare_for_registration(samples);
     if (progress_) progress_->start();
     auto annotated_vcf = get_temp_measure_annotated_vcf(source, filtered_header);
+    // Calls are only measured in this pass, so unless they are annotated only the fields the measures need are unpacked
+    const auto unpack = annotated_vcf ? VcfReader::UnpackMask {} : measurement_unpack_mask();
     std::size_t record_idx {0};
     if (can_measure_multiple_blocks()) {
-        for (auto p = source.iterate(); p.first != p.second;) {
+        for (auto p = source.iterate(unpack); p.first != p.second;) {
             const auto blocks = read_next_blocks(p.first, p.second, samples);
             record(blocks, record_idx, filtered_header, samples, annotated_vcf);
             for (const auto& block : blocks) record_idx += block.size();
         }
     } else if (can_measure_single_call()) {
-        auto p = source.iterate();
+        auto p = source.iterate(unpack);
         std::for_each(std::move(p.first), std::move(p.second),
                       [&] (const VcfRecord& call) { record(call, record_idx++, filtered_header, samples, annotated_vcf); });
     } else {
-        for (auto p = source.iterate(); p.first != p.second;) {
+        for (auto p = source.iterate(unpack); p.first != p.second;) {
             const auto block = read_next_block(p.first, p.second, samples);
             record(block, record_idx, filtered_header, samples, annotated_vcf);
             record_idx += block.size();
@@ -7,14 +7,12 @@
 #include <vector>
 #include <cstddef>
 #include <memory>
-#include <fstream>
 
 #include <boost/optional.hpp>
 #include <boost/filesystem.hpp>
 
-#include "ranger/Forest.h"
-
 #include "double_pass_variant_call_filter.hpp"
+#include "ranger_forest.hpp"
 
 namespace octopus { namespace csr {
 
@@ -41,26 +39,17 @@ public:
     virtual ~RandomForestFilter() override = default;
 
 private:
-    struct File
-    {
-        std::ofstream handle;
-        Path path;
-        template <typename F, typename P>
-        File(F&& handle, P&& path) : handle {std::forward<F>(handle)}, path {std::forward<P>(path)} {};
-    };
-    
-    std::unique_ptr<ranger::Forest> forest_;
-    Path ranger_forest_, temp_dir_;
+    std::shared_ptr<const RangerForest> forest_;
     
-    mutable std::vector<File> data_;
+    mutable RangerForest::Batch batch_;
+    mutable std::vector<double> row_buffer_;
     mutable std::size_t num_records_;
-    mutable std::vector<std::vector<double>> data_buffer_;
+    mutable RangerForest::Batch::PredictionMatrix predictions_;
     
     const static std::string call_qual_name_;
     
     boost::optional<std::string> genotype_quality_name() const override;
     void annotate(VcfHeader::Builder& header) const override;
-    void prepare_for_registration(const SampleList& samples) const override;
     void record(std::size_t call_idx, std::size_t sample_idx, MeasureVector measures) const override;
     void prepare_for_classification(boost::optional<Log>& log) const override;
     Classification classify(std::size_t call_idx, std::size_t sample_idx) const override;
@@ -0,0 +1,232 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "ranger_forest.hpp"
+
+#include <string>
+#include <map>
+#include <mutex>
+#include <future>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <stdexcept>
+#include <cmath>
+#include <cassert>
+
+#include <boost/filesystem/operations.hpp>
+
+#include "ranger/ForestProbability.h"
+#include "ranger/DataDouble.h"
+
+#include "exceptions/missing_file_error.hpp"
+#include "exceptions/malformed_file_error.hpp"
+
+namespace octopus { namespace csr {
+
+namespace {
+
+class MissingForestFile : public MissingFileError
+{
+    std::string do_where() const override { return "RangerForest"; }
+public:
+    MissingForestFile(boost::filesystem::path p) : MissingFileError {std::move(p), ".forest"} {};
+};
+
+class MalformedForestFile : public MalformedFileError
+{
+    std::string do_where() const override { return "RangerForest"; }
+    std::string do_help() const override
+    {
+        return "make sure the forest was trained with the same measures and in the same order as the prediction measures";
+    }
+public:
+    MalformedForestFile(boost::filesystem::path file) : MalformedFileError {std::move(file)} {}
+};
+
+// Only used to get at ranger's forest file reader
+class ForestFileReader : public ranger::ForestProbability
+{
+public:
+    ForestFileReader(const RangerForest::Path& file, const std::size_t num_variables)
+    {
+        // ranger expects the prediction data to have the dependent variable column too
+        this->num_variables = num_variables + 1;
+        this->num_threads = 1;
+        this->data = std::make_unique<ranger::DataDouble>(std::vector<double> {}, std::vector<std::string>(this->num_variables),
+                                                          0, this->num_variables);
+        loadFromFile(file.string());
+    }
+};
+
+} // namespace
+
+RangerForest::RangerForest(const Path& ranger_forest, const std::size_t num_variables)
+: nodes_ {}
+, roots_ {}
+, num_variables_ {num_variables}
+{
+    if (!boost::filesystem::exists(ranger_forest)) {
+        throw MissingForestFile {ranger_forest};
+    }
+    std::unique_ptr<ForestFileReader> forest {};
+    try {
+        forest = std::make_unique<ForestFileReader>(ranger_forest, num_variables);
+    } catch (const std::runtime_error& e) {
+        throw MalformedForestFile {ranger_forest};
+    }
+    const auto& class_values = forest->getClassValues();
+    if (class_values.size() != 2) throw MalformedForestFile {ranger_forest};
+    const std::size_t false_class_idx = class_values.front() == 1 ? 1 : 0;
+    const auto child_ids = forest->getChildNodeIDs();
+    const auto split_variables = forest->getSplitVarIDs();
+    const auto split_values = forest->getSplitValues();
+    const auto terminal_class_counts = forest->getTerminalClassCounts();
+    const auto& is_ordered = forest->getIsOrderedVariable();
+    const auto num_trees = forest->getNumTrees();
+    roots_.reserve(num_trees);
+    for (std::size_t tree {0}; tree < num_trees; ++tree) {
+        const auto offset = static_cast<std::uint32_t>(nodes_.size());
+        const auto& left_children = child_ids[tree][0];
+        const auto& right_children = child_ids[tree][1];
+        roots_.push_back(offset);
+        nodes_.reserve(nodes_.size() + left_children.size());
+        for (std::size_t node_id {0}; node_id < left_children.size(); ++node_id) {
+            Node node {};
+            if (left_children[node_id] == 0 && right_children[node_id] == 0) {
+                const auto& class_counts = terminal_class_counts[tree][node_id];
+                if (class_counts.size() != class_values.size()) throw MalformedForestFile {ranger_forest};
+                node.value = class_counts[false_class_idx];
+            } else {
+                const auto variable = split_variables[tree][node_id];
+                if (variable >= num_variables) throw MalformedForestFile {ranger_forest};
+                node.value = split_values[tree][node_id];
+                node.variable = static_cast<std::uint32_t>(variable);
+                node.left = offset + static_cast<std::uint32_t>(left_children[node_id]);
+                node.right = offset + static_cast<std::uint32_t>(right_children[node_id]);
+                node.is_ordered = variable >= is_ordered.size() || is_ordered[variable];
+            }
+            nodes_.push_back(node);
+        }
+    }
+}
+
+std::size_t RangerForest::num_variables() const noexcept
+{
+    return num_variables_;
+}
+
+std::size_t RangerForest::num_trees() const noexcept
+{
+    return roots_.size();
+}
+
+namespace {
+
+template <typename Node>
+bool goes_left(const Node& node, const double value) noexcept
+{
+    if (node.is_ordered) {
+        return value <= node.value;
+    } else {
+        // Same encoding as ranger: bit (factor - 1) of the split value is set for factors that go right
+        const auto factor_id = static_cast<std::size_t>(std::floor(value)) - 1;
+        const auto split_id = static_cast<std::size_t>(std::floor(node.value));
+        return !(split_id & (std::size_t {1} << factor_id));
+    }
+}
+
+} // namespace
+
+double RangerForest::predict_false(const double* row) const noexcept
+{
+    double result {0};
+    for (const auto root : roots_) {
+        const Node* node {&nodes_[root]};
+        while (node->left != 0) {
+            node = &nodes_[goes_left(*node, row[node->variable]) ? node->left : node->right];
+        }
+        result += node->value;
+    }
+    return roots_.empty() ? result : result / roots_.size();
+}
+
+std::shared_ptr<const RangerForest> load_ranger_forest(const RangerForest::Path& ranger_forest, const std::size_t num_variables)
+{
+    using ForestKey = std::pair<std::string, std::size_t>;
+    static std::mutex mutex {};
+    static std::map<ForestKey, std::shared_ptr<const RangerForest>> forests {};
+    std::lock_guard<std::mutex> lock {mutex};
+    ForestKey key {ranger_forest.string(), num_variables};
+    auto itr = forests.find(key);
+    if (itr == std::cend(forests)) {
+        itr = forests.emplace(std::move(key), std::make_shared<const RangerForest>(ranger_forest, num_variables)).first;
+    }
+    return itr->second;
+}
+
+// RangerForest::Batch
+
+RangerForest::Batch::Batch(std::shared_ptr<const RangerForest> forest, const std::size_t capacity)
+: forest_ {std::move(forest)}
+, capacity_ {capacity}
+, rows_ {}
+, targets_ {}
+{
+    rows_.reserve(capacity_ * forest_->num_variables());
+    targets_.reserve(capacity_);
+}
+
+bool RangerForest::Batch::empty() const noexcept
+{
+    return targets_.empty();
+}
+
+bool RangerForest::Batch::full() const noexcept
+{
+    return targets_.size() >= capacity_;
+}
+
+void RangerForest::Batch::add(const std::size_t call_idx, const std::size_t sample_idx, const std::vector<double>& row)
+{
+    assert(row.size() == forest_->num_variables());
+    rows_.insert(std::cend(rows_), std::cbegin(row), std::cend(row));
+    targets_.push_back({call_idx, sample_idx});
+}
+
+void RangerForest::Batch::predict(PredictionMatrix& predictions, ThreadPool& workers)
+{
+    static constexpr std::size_t minRowsPerTask {1'000};
+    const auto num_rows = targets_.size();
+    const auto row_size = forest_->num_variables();
+    std::vector<double> probabilities(num_rows);
+    const auto predict_rows = [&] (std::size_t first, const std::size_t last) {
+        for (; first < last; ++first) {
+            probabilities[first] = forest_->predict_false(rows_.data() + first * row_size);
+        }
+    };
+    if (workers.empty() || num_rows < 2 * minRowsPerTask) {
+        predict_rows(0, num_rows);
+    } else {
+        const auto num_tasks = std::min(workers.size(), num_rows / minRowsPerTask);
+        const auto rows_per_task = (num_rows + num_tasks - 1) / num_tasks;
+        std::vector<std::future<void>> tasks {};
+        tasks.reserve(num_tasks);
+        for (std::size_t first {0}; first < num_rows; first += rows_per_task) {
+            tasks.push_back(workers.push(predict_rows, first, std::min(first + rows_per_task, num_rows)));
+        }
+        for (auto& task : tasks) task.get();
+    }
+    for (std::size_t row {0}; row < num_rows; ++row) {
+        const auto& target = targets_[row];
+        if (predictions.size() <= target.call_idx) predictions.resize(target.call_idx + 1);
+        auto& call_predictions = predictions[target.call_idx];
+        if (call_predictions.size() <= target.sample_idx) call_predictions.resize(target.sample_idx + 1);
+        call_predictions[target.sample_idx] = probabilities[row];
+    }
+    rows_.clear();
+    targets_.clear();
+}
+
+} // namespace csr
+} // namespace octopus
@@ -0,0 +1,109 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef ranger_forest_hpp
+#define ranger_forest_hpp
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include <boost/filesystem/path.hpp>
+
+#include "utils/thread_pool.hpp"
+
+namespace octopus { namespace csr {
+
+/**
+ RangerForest is a read-only, in-memory copy of a two class probability forest trained by ranger.
+ The trees are flattened into a single node array so prediction is const and can be done from
+ any number of threads.
+
+ Rows must contain the forest variables in the order used for training, excluding the dependent
+ (TP) variable, which must be the last training column.
+ */
+class RangerForest
+{
+public:
+    using Path = boost::filesystem::path;
+
+    class Batch;
+
+    RangerForest() = delete;
+
+    RangerForest(const Path& ranger_forest, std::size_t num_variables);
+
+    RangerForest(const RangerForest&)            = default;
+    RangerForest& operator=(const RangerForest&) = default;
+    RangerForest(RangerForest&&)                 = default;
+    RangerForest& operator=(RangerForest&&)      = default;
+
+    ~RangerForest() = default;
+
+    std::size_t num_variables() const noexcept;
+    std::size_t num_trees() const noexcept;
+
+    // Returns the probability the row belongs to the false (0) class
+    double predict_false(const double* row) const noexcept;
+
+private:
+    struct Node
+    {
+        double value; // split value, or the false class probability if terminal
+        std::uint32_t variable;
+        std::uint32_t left, right; // both 0 if terminal
+        bool is_ordered;
+    };
+
+    std::vector<Node> nodes_;
+    std::vector<std::uint32_t> roots_;
+    std::size_t num_variables_;
+};
+
+// Forests are cached, so each forest file is only loaded once per process
+std::shared_ptr<const RangerForest> load_ranger_forest(const RangerForest::Path& ranger_forest, std::size_t num_variables);
+
+/**
+ A Batch collects the rows of measured calls and predicts them together, split over a ThreadPool.
+ */
+class RangerForest::Batch
+{
+public:
+    using PredictionMatrix = std::vector<std::vector<double>>; // call x sample
+
+    Batch() = delete;
+
+    Batch(std::shared_ptr<const RangerForest> forest, std::size_t capacity = 10'000);
+
+    Batch(const Batch&)            = delete;
+    Batch& operator=(const Batch&) = delete;
+    Batch(Batch&&)                 = default;
+    Batch& operator=(Batch&&)      = default;
+
+    ~Batch() = default;
+
+    bool empty() const noexcept;
+    bool full() const noexcept;
+
+    void add(std::size_t call_idx, std::size_t sample_idx, const std::vector<double>& row);
+
+    // Writes the false probability of each row to predictions[call_idx][sample_idx] and clears the batch
+    void predict(PredictionMatrix& predictions, ThreadPool& workers);
+
+private:
+    struct Target
+    {
+        std::size_t call_idx, sample_idx;
+    };
+
+    std::shared_ptr<const RangerForest> forest_;
+    std::size_t capacity_;
+    std::vector<double> rows_;
+    std::vector<Target> targets_;
+};
+
+} // namespace csr
+} // namespace octopus
+
+#endif
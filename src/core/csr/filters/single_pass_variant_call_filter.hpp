@@ -32,6 +32,8 @@ public:
     
     virtual ~SinglePassVariantCallFilter() override = default;
     
+    bool can_stream() const noexcept override { return true; }
+    
 protected:
     std::vector<std::string> measure_names_;
     
@@ -44,7 +46,7 @@ private:
     void filter(const VcfReader& source, VcfWriter& dest, const VcfHeader& dest_header) const override;
     void filter(const VcfRecord& call, VcfWriter& dest, const VcfHeader& dest_header, const SampleList& samples) const;
     void filter(const CallBlock& block, VcfWriter& dest, const VcfHeader& dest_header, const SampleList& samples) const;
-    void filter(const std::vector<CallBlock>& blocks, VcfWriter& dest, const VcfHeader& dest_header, const SampleList& samples) const;
+    void filter(const std::vector<CallBlock>& blocks, VcfWriter& dest, const VcfHeader& dest_header, const SampleList& samples) const override;
     void filter(const CallBlock& block, const MeasureBlock & measures, VcfWriter& dest, const VcfHeader& dest_header, const SampleList& samples) const;
     void filter(const VcfRecord& call, const MeasureVector& measures, VcfWriter& dest, const VcfHeader& dest_header, const SampleList& samples) const;
     ClassificationList classify(const MeasureVector& call_measures, const SampleList& samples) const;
@@ -30,6 +30,7 @@
 #include "utils/parallel_transform.hpp"
 #include "io/variant/vcf_writer.hpp"
 #include "io/variant/vcf_spec.hpp"
+#include "exceptions/program_error.hpp"
 
 namespace octopus { namespace csr {
 
@@ -96,6 +97,73 @@ inline VcfHeader read_header(const VcfWriter& writer)
     return tmp.fetch_header();
 }
 
+class UnstreamableVariantCallFilter : public ProgramError
+{
+    std::string do_where() const override { return "VariantCallFilter::CallStream"; }
+    std::string do_why() const override { return "Tried to stream calls through a filter that requires multiple passes"; }
+    std::string do_help() const override { return "submit an error report"; }
+};
+
+VariantCallFilter::CallStream::CallStream(const VariantCallFilter& filter, const VcfHeader& source_header, VcfWriter& dest)
+: filter_ {filter}
+, dest_ {dest}
+, dest_header_ {}
+, samples_ {source_header.samples()}
+, pending_ {}
+{
+    if (!filter.can_stream()) throw UnstreamableVariantCallFilter {};
+    if (dest.is_header_written()) {
+        dest_header_ = read_header(dest);
+    } else {
+        dest_header_ = filter.make_header(source_header);
+        dest << dest_header_;
+    }
+}
+
+void VariantCallFilter::CallStream::filter(std::vector<VcfRecord> calls)
+{
+    utils::append(std::move(calls), pending_);
+    flush(false);
+}
+
+void VariantCallFilter::CallStream::close()
+{
+    flush(true);
+}
+
+void VariantCallFilter::CallStream::flush(const bool all)
+{
+    const auto& filter = filter_.get();
+    std::vector<CallBlock> blocks {};
+    auto block_begin = std::begin(pending_);
+    while (block_begin != std::end(pending_)) {
+        const auto block_end = filter.find_block_end(block_begin, std::end(pending_), samples_);
+        if (block_end == std::end(pending_) && !all) break;
+        blocks.emplace_back(std::make_move_iterator(block_begin), std::make_move_iterator(block_end));
+        block_begin = block_end;
+        if (blocks.size() == filter.max_concurrent_blocks()
+            || (block_begin != std::end(pending_) && !is_same_contig(*block_begin, blocks.back().front()))) {
+            this->filter(blocks);
+        }
+    }
+    pending_.erase(std::begin(pending_), block_begin);
+    this->filter(blocks);
+}
+
+void VariantCallFilter::CallStream::filter(std::vector<CallBlock>& blocks)
+{
+    if (blocks.empty()) return;
+    const auto& filter = filter_.get();
+    std::vector<GenomicRegion> block_regions {};
+    block_regions.reserve(blocks.size());
+    for (const auto& block : blocks) {
+        block_regions.push_back(encompassing_region(block));
+    }
+    filter.facet_factory_.hint(std::move(block_regions));
+    filter.filter(blocks, dest_, dest_header_, samples_);
+    blocks.clear();
+}
+
 void VariantCallFilter::filter(const VcfReader& source, VcfWriter& dest) const
 {
     if (dest.is_header_written()) {
@@ -225,6 +293,19 @@ VariantCallFilter::read_next_block(VcfIterator& first, const VcfIterator& last,
     return copy_each_first(block);
 }
 
+VariantCallFilter::CallIterator
+VariantCallFilter::find_block_end(CallIterator first, const CallIterator last, const SampleList& samples) const
+{
+    if (first == last) return last;
+    auto prev_phase_region = get_phase_region(*first, samples);
+    for (++first; first != last; ++first) {
+        auto call_phase_region = get_phase_region(*first, samples);
+        if (!overlaps(prev_phase_region, call_phase_region)) break;
+        prev_phase_region = std::move(call_phase_region);
+    }
+    return first;
+}
+
 std::vector<VariantCallFilter::CallBlock>
 VariantCallFilter::read_next_blocks(VcfIterator& first, const VcfIterator& last, const SampleList& samples) const
 {
@@ -242,6 +323,18 @@ VariantCallFilter::read_next_blocks(VcfIterator& first, const VcfIterator& last,
     return result;
 }
 
+VcfReader::UnpackMask VariantCallFilter::measurement_unpack_mask() const
+{
+    // GT and PS are needed to find call blocks and for the genotype based facets
+    auto result = VcfReader::UnpackMask::site_fields_only();
+    result.add_format(vcfspec::format::genotype).add_format(vcfspec::format::phaseSet);
+    for (const auto& measure : measures_) {
+        for (auto& key : measure.info_requirements()) result.add_info(std::move(key));
+        for (auto& key : measure.format_requirements()) result.add_format(std::move(key));
+    }
+    return result;
+}
+
 VariantCallFilter::MeasureVector VariantCallFilter::measure(const VcfRecord& call) const
 {
     MeasureVector result(measures_.size());
@@ -336,6 +429,12 @@ void VariantCallFilter::annotate(VcfRecord::Builder& call, const MeasureVector&
 
 // private methods
 
+void VariantCallFilter::filter(const std::vector<CallBlock>& blocks, VcfWriter& dest,
+                               const VcfHeader& dest_header, const SampleList& samples) const
+{
+    throw UnstreamableVariantCallFilter {};
+}
+
 bool VariantCallFilter::is_soft_filtered(const ClassificationList& sample_classifications, const MeasureVector& measures) const
 {
     return std::all_of(std::cbegin(sample_classifications), std::cend(sample_classifications),
@@ -366,7 +465,12 @@ Phred<double> VariantCallFilter::combine_sample_qualities(const std::vector<Phre
 
 VcfHeader VariantCallFilter::make_header(const VcfReader& source) const
 {
-    VcfHeader::Builder builder {source.fetch_header()};
+    return make_header(source.fetch_header());
+}
+
+VcfHeader VariantCallFilter::make_header(const VcfHeader& source) const
+{
+    VcfHeader::Builder builder {source};
     if (output_config_.clear_info) {
         builder.clear_info();
     }
@@ -554,6 +658,11 @@ void VariantCallFilter::fail(VcfRecord::Builder& call, std::vector<std::string>
     }
 }
 
+ThreadPool& VariantCallFilter::workers() const noexcept
+{
+    return workers_;
+}
+
 bool VariantCallFilter::is_multithreaded() const noexcept
 {
     return !workers_.empty();
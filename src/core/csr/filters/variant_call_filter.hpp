@@ -65,13 +65,19 @@ public:
     
     virtual ~VariantCallFilter() = default;
     
+    class CallStream;
+    
     void filter(const VcfReader& source, VcfWriter& dest) const;
     
+    // Filters that can classify calls in a single pass can filter calls with a CallStream
+    virtual bool can_stream() const noexcept { return false; }
+    
 protected:
     using SampleList    = std::vector<SampleName>;
     using MeasureVector = std::vector<Measure::ResultType>;
     using VcfIterator   = VcfReader::RecordIterator;
     using CallBlock     = std::vector<VcfRecord>;
+    using CallIterator  = CallBlock::iterator;
     using MeasureBlock  = std::vector<MeasureVector>;
     
     struct Classification
@@ -91,7 +97,10 @@ protected:
     bool can_measure_single_call() const noexcept;
     bool can_measure_multiple_blocks() const noexcept;
     CallBlock read_next_block(VcfIterator& first, const VcfIterator& last, const SampleList& samples) const;
+    CallIterator find_block_end(CallIterator first, CallIterator last, const SampleList& samples) const;
     std::vector<CallBlock> read_next_blocks(VcfIterator& first, const VcfIterator& last, const SampleList& samples) const;
+    VcfReader::UnpackMask measurement_unpack_mask() const;
+    ThreadPool& workers() const noexcept;
     MeasureVector measure(const VcfRecord& call) const;
     MeasureBlock measure(const CallBlock& block) const;
     std::vector<MeasureBlock> measure(const std::vector<CallBlock>& blocks) const;
@@ -114,12 +123,14 @@ private:
     
     virtual void annotate(VcfHeader::Builder& header) const = 0;
     virtual void filter(const VcfReader& source, VcfWriter& dest, const VcfHeader& dest_header) const = 0;
+    virtual void filter(const std::vector<CallBlock>& blocks, VcfWriter& dest, const VcfHeader& dest_header, const SampleList& samples) const;
     virtual boost::optional<std::string> call_quality_name() const { return boost::none; }
     virtual boost::optional<std::string> genotype_quality_name() const { return boost::none; }
     virtual bool is_soft_filtered(const ClassificationList& sample_classifications, const MeasureVector& measures) const;
     virtual Phred<double> combine_sample_qualities(const std::vector<Phred<double>>& qualities) const;
     
     VcfHeader make_header(const VcfReader& source) const;
+    VcfHeader make_header(const VcfHeader& source) const;
     Measure::FacetMap compute_facets(const CallBlock& block) const;
     std::vector<Measure::FacetMap> compute_facets(const std::vector<CallBlock>& blocks) const;
     MeasureBlock measure(const CallBlock& block, const Measure::FacetMap& facets) const;
@@ -138,6 +149,37 @@ private:
     unsigned max_concurrent_blocks() const noexcept;
 };
 
+// Filters calls that are already in memory, such as calls that have just been made by a caller, so they
+// do not need to be read back from a VCF. Calls must be given in order. The last block of calls given is
+// held back until more calls are given or the stream is closed, as the block may continue into the next calls.
+class VariantCallFilter::CallStream
+{
+public:
+    CallStream() = delete;
+    
+    CallStream(const VariantCallFilter& filter, const VcfHeader& source_header, VcfWriter& dest);
+    
+    CallStream(const CallStream&)            = delete;
+    CallStream& operator=(const CallStream&) = delete;
+    CallStream(CallStream&&)                 = default;
+    CallStream& operator=(CallStream&&)      = default;
+    
+    ~CallStream() = default;
+    
+    void filter(std::vector<VcfRecord> calls);
+    void close();
+    
+private:
+    std::reference_wrapper<const VariantCallFilter> filter_;
+    std::reference_wrapper<VcfWriter> dest_;
+    VcfHeader dest_header_;
+    SampleList samples_;
+    CallBlock pending_;
+    
+    void flush(bool all);
+    void filter(std::vector<CallBlock>& blocks);
+};
+
 } // namespace csr
 
 using csr::VariantCallFilter;
@@ -62,6 +62,16 @@ std::vector<std::string> BaseMismatchFraction::do_requirements() const
 {
     return concat(concat(depth_.requirements(), BaseMismatchCount{}.requirements()), VariantLength{}.requirements());
 }
+
+std::vector<std::string> BaseMismatchFraction::do_info_requirements() const
+{
+    return depth_.info_requirements();
+}
+
+std::vector<std::string> BaseMismatchFraction::do_format_requirements() const
+{
+    return depth_.format_requirements();
+}
     
 } // namespace csr
 } // namespace octopus
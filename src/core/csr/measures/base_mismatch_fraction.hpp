@@ -26,6 +26,8 @@ class BaseMismatchFraction : public Measure
     const std::string& do_name() const override;
     std::string do_describe() const override;
     std::vector<std::string> do_requirements() const override;
+    std::vector<std::string> do_info_requirements() const override;
+    std::vector<std::string> do_format_requirements() const override;
 public:
     BaseMismatchFraction();
 };
@@ -43,5 +43,10 @@ std::string ClassificationConfidence::do_describe() const
     return "PP divided by QUAL";
 }
 
+std::vector<std::string> ClassificationConfidence::do_info_requirements() const
+{
+    return PosteriorProbability().info_requirements();
+}
+
 } // namespace csr
 } // namespace octopus
@@ -22,6 +22,7 @@ class ClassificationConfidence : public Measure
     ResultCardinality do_cardinality() const noexcept override;
     const std::string& do_name() const override;
     std::string do_describe() const override;
+    std::vector<std::string> do_info_requirements() const override;
 };
 
 } // namespace csr
@@ -228,5 +228,10 @@ std::vector<std::string> DeNovoContamination::do_requirements() const
     return result;
 }
 
+std::vector<std::string> DeNovoContamination::do_info_requirements() const
+{
+    return IsDenovo(false).info_requirements();
+}
+
 } // namespace csr
 } // namespace octopus
@@ -80,6 +80,24 @@ std::vector<std::string> Depth::do_requirements() const
     return result;
 }
 
+std::vector<std::string> Depth::do_info_requirements() const
+{
+    if (aggregate_ && !recalculate_) {
+        return {vcfspec::info::combinedReadDepth};
+    } else {
+        return {};
+    }
+}
+
+std::vector<std::string> Depth::do_format_requirements() const
+{
+    if (!aggregate_ && !recalculate_) {
+        return {vcfspec::format::combinedReadDepth};
+    } else {
+        return {};
+    }
+}
+
 bool Depth::is_equal(const Measure& other) const noexcept
 {
     const auto& other_depth = static_cast<const Depth&>(other);
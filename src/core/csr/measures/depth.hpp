@@ -25,6 +25,8 @@ class Depth : public Measure
     const std::string& do_name() const override;
     std::string do_describe() const override;
     std::vector<std::string> do_requirements() const override;
+    std::vector<std::string> do_info_requirements() const override;
+    std::vector<std::string> do_format_requirements() const override;
     bool is_equal(const Measure& other) const noexcept override;
 public:
     Depth();
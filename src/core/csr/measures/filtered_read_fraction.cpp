@@ -8,6 +8,8 @@
 
 #include <boost/variant.hpp>
 
+#include "utils/concat.hpp"
+
 namespace octopus { namespace csr {
 
 const std::string FilteredReadFraction::name_ = "FRF";
@@ -63,6 +65,16 @@ std::vector<std::string> FilteredReadFraction::do_requirements() const
     return filtering_depth_.requirements();
 }
 
+std::vector<std::string> FilteredReadFraction::do_info_requirements() const
+{
+    return concat(calling_depth_.info_requirements(), filtering_depth_.info_requirements());
+}
+
+std::vector<std::string> FilteredReadFraction::do_format_requirements() const
+{
+    return concat(calling_depth_.format_requirements(), filtering_depth_.format_requirements());
+}
+
 bool FilteredReadFraction::is_equal(const Measure& other) const noexcept
 {
     return calling_depth_ == static_cast<const FilteredReadFraction&>(other).calling_depth_;
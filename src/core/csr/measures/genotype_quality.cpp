@@ -58,5 +58,10 @@ std::vector<std::string> GenotypeQuality::do_requirements() const
     return {"Samples"};
 }
 
+std::vector<std::string> GenotypeQuality::do_format_requirements() const
+{
+    return {vcfspec::format::conditionalQuality};
+}
+
 } // namespace csr
 } // namespace octopus
@@ -24,6 +24,7 @@ class GenotypeQuality : public Measure
     const std::string& do_name() const override;
     std::string do_describe() const override;
     std::vector<std::string> do_requirements() const override;
+    std::vector<std::string> do_format_requirements() const override;
     bool is_required_vcf_field() const noexcept override { return true; }
 };
 
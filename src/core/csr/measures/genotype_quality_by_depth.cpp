@@ -58,6 +58,16 @@ std::vector<std::string> GenotypeQualityByDepth::do_requirements() const
     return concat(depth_.requirements(), GenotypeQuality().requirements());
 }
 
+std::vector<std::string> GenotypeQualityByDepth::do_info_requirements() const
+{
+    return depth_.info_requirements();
+}
+
+std::vector<std::string> GenotypeQualityByDepth::do_format_requirements() const
+{
+    return concat(depth_.format_requirements(), GenotypeQuality().format_requirements());
+}
+
 bool GenotypeQualityByDepth::is_equal(const Measure& other) const noexcept
 {
     return depth_ == static_cast<const GenotypeQualityByDepth&>(other).depth_;
@@ -88,6 +88,11 @@ std::vector<std::string> IsDenovo::do_requirements() const
     }
 }
 
+std::vector<std::string> IsDenovo::do_info_requirements() const
+{
+    return {vcf::spec::info::denovo};
+}
+
 bool IsDenovo::is_equal(const Measure& other) const noexcept
 {
     return report_sample_status_ == static_cast<const IsDenovo&>(other).report_sample_status_;
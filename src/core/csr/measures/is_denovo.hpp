@@ -24,6 +24,7 @@ class IsDenovo : public Measure
     const std::string& do_name() const override;
     std::string do_describe() const override;
     std::vector<std::string> do_requirements() const override;
+    std::vector<std::string> do_info_requirements() const override;
     bool is_equal(const Measure& other) const noexcept override;
 public:
     IsDenovo(bool report_sample_status = true);
@@ -8,6 +8,7 @@
 #include <cassert>
 
 #include "io/variant/vcf_record.hpp"
+#include "io/variant/vcf_spec.hpp"
 #include "../facets/samples.hpp"
 #include "../facets/ploidies.hpp"
 
@@ -85,6 +86,11 @@ std::vector<std::string> IsSomatic::do_requirements() const
     }
 }
 
+std::vector<std::string> IsSomatic::do_info_requirements() const
+{
+    return {vcfspec::info::somatic};
+}
+
 bool IsSomatic::is_equal(const Measure& other) const noexcept
 {
     return report_sample_status_ == static_cast<const IsSomatic&>(other).report_sample_status_;
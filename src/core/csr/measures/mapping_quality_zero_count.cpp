@@ -54,6 +54,15 @@ std::vector<std::string> MappingQualityZeroCount::do_requirements() const
     }
 }
 
+std::vector<std::string> MappingQualityZeroCount::do_info_requirements() const
+{
+    if (recalculate_) {
+        return {};
+    } else {
+        return {"MQ0"};
+    }
+}
+
 bool MappingQualityZeroCount::is_equal(const Measure& other) const noexcept
 {
     return recalculate_ == static_cast<const MappingQualityZeroCount&>(other).recalculate_;
@@ -58,6 +58,15 @@ std::vector<std::string> MeanMappingQuality::do_requirements() const
     }
 }
 
+std::vector<std::string> MeanMappingQuality::do_info_requirements() const
+{
+    if (recalculate_) {
+        return {};
+    } else {
+        return {vcfspec::info::rmsMappingQuality};
+    }
+}
+
 bool MeanMappingQuality::is_equal(const Measure& other) const noexcept
 {
     return recalculate_ == static_cast<const MeanMappingQuality&>(other).recalculate_;
@@ -55,6 +55,9 @@ public:
     const std::string& name() const { return do_name(); }
     std::string describe() const { return do_describe(); }
     std::vector<std::string> requirements() const { return do_requirements(); }
+    // INFO and FORMAT keys read directly from calls; GT and PS are always available
+    std::vector<std::string> info_requirements() const { return do_info_requirements(); }
+    std::vector<std::string> format_requirements() const { return do_format_requirements(); }
     std::string serialise(const ResultType& value) const { return do_serialise(value); }
     void annotate(VcfHeader::Builder& header) const;
     void annotate(VcfRecord::Builder& record, const ResultType& value, const VcfHeader& header) const;
@@ -72,6 +75,8 @@ private:
     virtual const std::string& do_name() const = 0;
     virtual std::string do_describe() const = 0;
     virtual std::vector<std::string> do_requirements() const { return {}; }
+    virtual std::vector<std::string> do_info_requirements() const { return {}; }
+    virtual std::vector<std::string> do_format_requirements() const { return {}; }
     virtual std::string do_serialise(const ResultType& value) const;
     virtual bool is_required_vcf_field() const noexcept { return false; }
     virtual bool is_equal(const Measure& other) const noexcept { return true; }
@@ -105,6 +110,8 @@ public:
     const std::string& name() const { return measure_->name(); }
     std::string describe() const { return measure_->describe(); }
     std::vector<std::string> requirements() const { return measure_->requirements(); }
+    std::vector<std::string> info_requirements() const { return measure_->info_requirements(); }
+    std::vector<std::string> format_requirements() const { return measure_->format_requirements(); }
     std::string serialise(const Measure::ResultType& value) const { return measure_->serialise(value); }
     void annotate(VcfHeader::Builder& header) const { measure_->annotate(header); }
     void annotate(VcfRecord::Builder& record, const Measure::ResultType& value, const VcfHeader& header) const { measure_->annotate(record, value, header); }
@@ -162,6 +162,11 @@ std::vector<std::string> MedianSomaticMappingQuality::do_requirements() const
     sort_unique(result);
     return result;
 }
+
+std::vector<std::string> MedianSomaticMappingQuality::do_info_requirements() const
+{
+    return IsSomatic(true).info_requirements();
+}
     
 } // namespace csr
 } // namespace octopus
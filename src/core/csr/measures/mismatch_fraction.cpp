@@ -57,5 +57,15 @@ std::vector<std::string> MismatchFraction::do_requirements() const
     return concat(depth_.requirements(), mismatch_count_.requirements());
 }
 
+std::vector<std::string> MismatchFraction::do_info_requirements() const
+{
+    return depth_.info_requirements();
+}
+
+std::vector<std::string> MismatchFraction::do_format_requirements() const
+{
+    return depth_.format_requirements();
+}
+
 } // namespace csr
 } // namespace octopus
@@ -28,6 +28,8 @@ class MismatchFraction : public Measure
     const std::string& do_name() const override;
     std::string do_describe() const override;
     std::vector<std::string> do_requirements() const override;
+    std::vector<std::string> do_info_requirements() const override;
+    std::vector<std::string> do_format_requirements() const override;
 public:
     MismatchFraction();
 };
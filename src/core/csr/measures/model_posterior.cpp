@@ -40,5 +40,10 @@ std::string ModelPosterior::do_describe() const
     return "Model posterior for this haplotype block";
 }
 
+std::vector<std::string> ModelPosterior::do_info_requirements() const
+{
+    return {vcf::spec::info::modelPosterior};
+}
+
 } // namespace csr
 } // namespace octopus
@@ -206,5 +206,10 @@ std::vector<std::string> NormalContamination::do_requirements() const
     return result;
 }
 
+std::vector<std::string> NormalContamination::do_info_requirements() const
+{
+    return IsSomatic(true).info_requirements();
+}
+
 } // namespace csr
 } // namespace octopus
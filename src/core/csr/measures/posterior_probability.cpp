@@ -42,5 +42,10 @@ std::string PosteriorProbability::do_describe() const
     return "Call posterior probability";
 }
 
+std::vector<std::string> PosteriorProbability::do_info_requirements() const
+{
+    return {"PP"};
+}
+
 } // namespace csr
 } // namespace octopus
@@ -7,6 +7,7 @@
 #include <boost/optional.hpp>
 
 #include "io/variant/vcf_record.hpp"
+#include "utils/concat.hpp"
 #include "posterior_probability.hpp"
 
 namespace octopus { namespace csr {
@@ -53,6 +54,16 @@ std::vector<std::string> PosteriorProbabilityByDepth::do_requirements() const
     return depth_.requirements();
 }
 
+std::vector<std::string> PosteriorProbabilityByDepth::do_info_requirements() const
+{
+    return concat(PosteriorProbability().info_requirements(), depth_.info_requirements());
+}
+
+std::vector<std::string> PosteriorProbabilityByDepth::do_format_requirements() const
+{
+    return depth_.format_requirements();
+}
+
 bool PosteriorProbabilityByDepth::is_equal(const Measure& other) const noexcept
 {
     return depth_ == static_cast<const PosteriorProbabilityByDepth&>(other).depth_;
@@ -49,6 +49,16 @@ std::vector<std::string> QualityByDepth::do_requirements() const
     return depth_.requirements();
 }
 
+std::vector<std::string> QualityByDepth::do_info_requirements() const
+{
+    return depth_.info_requirements();
+}
+
+std::vector<std::string> QualityByDepth::do_format_requirements() const
+{
+    return depth_.format_requirements();
+}
+
 bool QualityByDepth::is_equal(const Measure& other) const noexcept
 {
     return depth_ == static_cast<const QualityByDepth&>(other).depth_;
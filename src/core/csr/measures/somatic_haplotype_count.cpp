@@ -4,6 +4,7 @@
 #include "somatic_haplotype_count.hpp"
 
 #include "io/variant/vcf_record.hpp"
+#include "io/variant/vcf_spec.hpp"
 #include "../facets/samples.hpp"
 #include "../facets/ploidies.hpp"
 #include "measure.hpp"
@@ -52,5 +53,10 @@ std::vector<std::string> SomaticHaplotypeCount::do_requirements() const
     return {"Samples", "Ploidies"};
 }
 
+std::vector<std::string> SomaticHaplotypeCount::do_info_requirements() const
+{
+    return {vcfspec::info::somatic};
+}
+
 } // namespace csr
 } // namespace octopus
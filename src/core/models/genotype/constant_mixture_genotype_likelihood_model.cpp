@@ -8,10 +8,12 @@
 #include <algorithm>
 #include <numeric>
 #include <array>
+#include <tuple>
 #include <limits>
 #include <cassert>
 
 #include "utils/maths.hpp"
+#include "utils/simd_log_sum_exp.hpp"
 
 namespace octopus { namespace model {
 
@@ -33,22 +35,20 @@ const HaplotypeLikelihoodArray& ConstantMixtureGenotypeLikelihoodModel::cache()
 
 void ConstantMixtureGenotypeLikelihoodModel::prime(const std::vector<Haplotype>& haplotypes)
 {
-    assert(likelihoods_.is_primed());
-    indexed_likelihoods_.reserve(haplotypes.size());
-    std::transform(std::cbegin(haplotypes), std::cend(haplotypes), std::back_inserter(indexed_likelihoods_),
-                   [this] (const auto& haplotype) -> const HaplotypeLikelihoodArray::LikelihoodVector& {
-                       return likelihoods_[haplotype]; });
+    indexed_haplotypes_.reserve(haplotypes.size());
+    std::transform(std::cbegin(haplotypes), std::cend(haplotypes), std::back_inserter(indexed_haplotypes_),
+                   [this] (const auto& haplotype) { return likelihoods_.index_of(haplotype); });
 }
 
 void ConstantMixtureGenotypeLikelihoodModel::unprime() noexcept
 {
-    indexed_likelihoods_.clear();
-    indexed_likelihoods_.shrink_to_fit();
+    indexed_haplotypes_.clear();
+    indexed_haplotypes_.shrink_to_fit();
 }
 
 bool ConstantMixtureGenotypeLikelihoodModel::is_primed() const noexcept
 {
-    return !indexed_likelihoods_.empty();
+    return !indexed_haplotypes_.empty();
 }
 
 // ln p(read | genotype)  = ln sum {haplotype in genotype} p(read | haplotype) - ln ploidy
@@ -67,9 +67,6 @@ ConstantMixtureGenotypeLikelihoodModel::evaluate(const Genotype<Haplotype>& geno
             return evaluate_diploid(genotype);
         case 3:
             return evaluate_triploid(genotype);
-        case 4:
-            return evaluate_polyploid(genotype);
-            //return log_likelihood_tetraploid(sample, genotype);
         default:
             return evaluate_polyploid(genotype);
     }
@@ -96,26 +93,148 @@ static constexpr auto ln(const unsigned n)
     return lnLookup[n];
 }
 
+template <typename T, std::size_t N>
+double sum_log_sum_exp(const std::array<const T*, N>& likelihoods,
+                       const std::array<double, N>& log_counts,
+                       const std::size_t num_likelihoods) noexcept
+{
+    return maths::simd::sum_log_sum_exp(likelihoods.data(), log_counts.data(), N, num_likelihoods);
+}
+
 } // namespace
 
 ConstantMixtureGenotypeLikelihoodModel::LogProbability
 ConstantMixtureGenotypeLikelihoodModel::evaluate(const GenotypeIndex& genotype) const
 {
     assert(is_primed());
-    const auto ploidy = static_cast<unsigned>(genotype.size());
-    buffer_.resize(ploidy);
-    LogProbability result {0};
-    const auto num_likelihoods = indexed_likelihoods_.front().get().size();
-    for (std::size_t read_idx {0}; read_idx < num_likelihoods; ++read_idx) {
-        std::transform(std::cbegin(genotype), std::cend(genotype), std::begin(buffer_),
-                       [=] (auto haplotype_idx) noexcept { return indexed_likelihoods_[haplotype_idx].get()[read_idx]; });
-        result += maths::log_sum_exp(buffer_) - ln<LogProbability>(ploidy);
+    return evaluate_mixture(to_haplotype_indices(genotype));
+}
+
+// Genotypes are evaluated in groups that share all but their last haplotype (the base); the
+// per-read log-sum-exp of a base with two or more distinct haplotypes is computed once per group,
+// leaving a two term log-sum-exp per read for each genotype in the group.
+std::vector<ConstantMixtureGenotypeLikelihoodModel::LogProbability>
+ConstantMixtureGenotypeLikelihoodModel::evaluate(const std::vector<Genotype<Haplotype>>& genotypes) const
+{
+    assert(likelihoods_.is_primed());
+    std::vector<HaplotypeIndexVector> haplotype_indices {};
+    haplotype_indices.reserve(genotypes.size());
+    for (const auto& genotype : genotypes) {
+        HaplotypeIndexVector indices(genotype.ploidy());
+        std::transform(std::cbegin(genotype), std::cend(genotype), std::begin(indices),
+                       [this] (const Haplotype& haplotype) { return likelihoods_.index_of(haplotype); });
+        haplotype_indices.push_back(std::move(indices));
     }
-    return result;
+    return evaluate_shared(haplotype_indices);
+}
+
+std::vector<ConstantMixtureGenotypeLikelihoodModel::LogProbability>
+ConstantMixtureGenotypeLikelihoodModel::evaluate(const std::vector<GenotypeIndex>& genotypes) const
+{
+    assert(is_primed());
+    std::vector<HaplotypeIndexVector> haplotype_indices {};
+    haplotype_indices.reserve(genotypes.size());
+    for (const auto& genotype : genotypes) {
+        haplotype_indices.push_back(to_haplotype_indices(genotype));
+    }
+    return evaluate_shared(haplotype_indices);
 }
 
 // private methods
 
+ConstantMixtureGenotypeLikelihoodModel::HaplotypeIndexVector
+ConstantMixtureGenotypeLikelihoodModel::to_haplotype_indices(const GenotypeIndex& genotype) const
+{
+    HaplotypeIndexVector result(genotype.size());
+    std::transform(std::cbegin(genotype), std::cend(genotype), std::begin(result),
+                   [this] (auto idx) { return indexed_haplotypes_[idx]; });
+    return result;
+}
+
+ConstantMixtureGenotypeLikelihoodModel::LogProbability
+ConstantMixtureGenotypeLikelihoodModel::evaluate_mixture(const HaplotypeIndexVector& genotype) const
+{
+    if (genotype.empty()) return 0.0;
+    likelihood_columns_.clear();
+    log_counts_.clear();
+    std::size_t num_likelihoods {0};
+    for (auto itr = std::cbegin(genotype); itr != std::cend(genotype); ++itr) {
+        if (std::find(std::cbegin(genotype), itr, *itr) == itr) {
+            const auto log_likelihoods = likelihoods_[*itr];
+            likelihood_columns_.push_back(log_likelihoods.data());
+            log_counts_.push_back(std::log(std::count(itr, std::cend(genotype), *itr)));
+            num_likelihoods = log_likelihoods.size();
+        }
+    }
+    return maths::simd::sum_log_sum_exp(likelihood_columns_.data(), log_counts_.data(), likelihood_columns_.size(), num_likelihoods)
+           - num_likelihoods * std::log(genotype.size());
+}
+
+std::vector<ConstantMixtureGenotypeLikelihoodModel::LogProbability>
+ConstantMixtureGenotypeLikelihoodModel::evaluate_shared(const std::vector<HaplotypeIndexVector>& genotypes) const
+{
+    std::vector<LogProbability> result(genotypes.size());
+    struct SharedBase
+    {
+        HaplotypeIndexVector base;
+        std::size_t genotype;
+    };
+    std::vector<SharedBase> shared {};
+    for (std::size_t genotype_idx {0}; genotype_idx < genotypes.size(); ++genotype_idx) {
+        const auto& genotype = genotypes[genotype_idx];
+        if (!genotype.empty()) {
+            SharedBase split {{}, genotype_idx};
+            std::copy_if(std::cbegin(genotype), std::cend(genotype), std::back_inserter(split.base),
+                         [&genotype] (auto idx) { return idx != genotype.back(); });
+            std::sort(std::begin(split.base), std::end(split.base));
+            if (!split.base.empty() && split.base.front() != split.base.back()) {
+                shared.push_back(std::move(split));
+                continue;
+            }
+        }
+        result[genotype_idx] = evaluate_mixture(genotype);
+    }
+    std::sort(std::begin(shared), std::end(shared),
+              [] (const auto& lhs, const auto& rhs) { return std::tie(lhs.base, lhs.genotype) < std::tie(rhs.base, rhs.genotype); });
+    for (auto group_itr = std::cbegin(shared); group_itr != std::cend(shared);) {
+        const auto group_end = std::find_if(std::next(group_itr), std::cend(shared),
+                                            [group_itr] (const auto& split) { return split.base != group_itr->base; });
+        if (std::next(group_itr) == group_end) {
+            result[group_itr->genotype] = evaluate_mixture(genotypes[group_itr->genotype]);
+            group_itr = group_end;
+            continue;
+        }
+        // Only the first copy of each base haplotype is used, weighted by its copy number
+        const auto& base = group_itr->base;
+        likelihood_columns_.clear();
+        log_counts_.clear();
+        std::size_t num_likelihoods {0};
+        for (auto itr = std::cbegin(base); itr != std::cend(base);) {
+            const auto next = std::upper_bound(itr, std::cend(base), *itr);
+            const auto log_likelihoods = likelihoods_[*itr];
+            likelihood_columns_.push_back(log_likelihoods.data());
+            log_counts_.push_back(std::log(std::distance(itr, next)));
+            num_likelihoods = log_likelihoods.size();
+            itr = next;
+        }
+        base_log_likelihoods_.resize(num_likelihoods);
+        maths::simd::log_sum_exp(likelihood_columns_.data(), log_counts_.data(), likelihood_columns_.size(),
+                                 num_likelihoods, base_log_likelihoods_.data());
+        for (; group_itr != group_end; ++group_itr) {
+            const auto& genotype = genotypes[group_itr->genotype];
+            const auto ploidy = genotype.size();
+            const auto last_count = ploidy - base.size();
+            const std::array<const HaplotypeLikelihoodArray::StoredLogProbability*, 2> columns {
+                base_log_likelihoods_.data(), likelihoods_[genotype.back()].data()
+            };
+            const std::array<double, 2> log_weights {0.0, std::log(last_count)};
+            result[group_itr->genotype] = maths::simd::sum_log_sum_exp(columns.data(), log_weights.data(), 2, num_likelihoods)
+                                          - num_likelihoods * std::log(ploidy);
+        }
+    }
+    return result;
+}
+
 ConstantMixtureGenotypeLikelihoodModel::LogProbability
 ConstantMixtureGenotypeLikelihoodModel::evaluate_haploid(const Genotype<Haplotype>& genotype) const
 {
@@ -126,118 +245,65 @@ ConstantMixtureGenotypeLikelihoodModel::evaluate_haploid(const Genotype<Haplotyp
 ConstantMixtureGenotypeLikelihoodModel::LogProbability
 ConstantMixtureGenotypeLikelihoodModel::evaluate_diploid(const Genotype<Haplotype>& genotype) const
 {
-    const auto& log_likelihoods1 = likelihoods_[genotype[0]];
+    const auto log_likelihoods1 = likelihoods_[genotype[0]];
     if (genotype.is_homozygous()) {
         return std::accumulate(std::cbegin(log_likelihoods1), std::cend(log_likelihoods1), LogProbability {0});
     }
-    const auto& log_likelihoods2 = likelihoods_[genotype[1]];
-    return std::inner_product(std::cbegin(log_likelihoods1), std::cend(log_likelihoods1),
-                              std::cbegin(log_likelihoods2), LogProbability {0}, std::plus<> {},
-                              [] (const auto a, const auto b) -> LogProbability {
-                                  return maths::log_sum_exp(a, b) - ln<decltype(a)>(2);
-                              });
+    const auto log_likelihoods2 = likelihoods_[genotype[1]];
+    const auto num_likelihoods = log_likelihoods1.size();
+    return sum_log_sum_exp<HaplotypeLikelihoodArray::StoredLogProbability, 2>({log_likelihoods1.data(), log_likelihoods2.data()},
+                                                                              {0.0, 0.0}, num_likelihoods)
+           - num_likelihoods * ln(2);
 }
 
 ConstantMixtureGenotypeLikelihoodModel::LogProbability
 ConstantMixtureGenotypeLikelihoodModel::evaluate_triploid(const Genotype<Haplotype>& genotype) const
 {
     using std::cbegin; using std::cend;
-    const auto& log_likelihoods1 = likelihoods_[genotype[0]];
+    const auto log_likelihoods1 = likelihoods_[genotype[0]];
     if (genotype.is_homozygous()) {
         return std::accumulate(cbegin(log_likelihoods1), cend(log_likelihoods1), LogProbability {0});
     }
+    const auto num_likelihoods = log_likelihoods1.size();
     if (genotype.zygosity() == 3) {
-        const auto& log_likelihoods2 = likelihoods_[genotype[1]];
-        const auto& log_likelihoods3 = likelihoods_[genotype[2]];
-        return maths::inner_product(cbegin(log_likelihoods1), cend(log_likelihoods1),
-                                    cbegin(log_likelihoods2), cbegin(log_likelihoods3),
-                                    LogProbability {0}, std::plus<> {},
-                                    [] (const auto a, const auto b, const auto c) -> LogProbability {
-                                        return maths::log_sum_exp(a, b, c) - ln<decltype(a)>(3);
-                                    });
+        const auto log_likelihoods2 = likelihoods_[genotype[1]];
+        const auto log_likelihoods3 = likelihoods_[genotype[2]];
+        return sum_log_sum_exp<HaplotypeLikelihoodArray::StoredLogProbability, 3>({log_likelihoods1.data(), log_likelihoods2.data(), log_likelihoods3.data()},
+                                                                                  {0.0, 0.0, 0.0}, num_likelihoods)
+               - num_likelihoods * ln(3);
     }
     if (genotype[0] != genotype[1]) {
-        const auto& log_likelihoods2 = likelihoods_[genotype[1]];
-        return std::inner_product(cbegin(log_likelihoods1), cend(log_likelihoods1),
-                                  cbegin(log_likelihoods2), LogProbability {0}, std::plus<> {},
-                                  [] (const auto a, const auto b) -> LogProbability {
-                                      return maths::log_sum_exp(a, ln<decltype(a)>(2) + b) - ln<decltype(a)>(3);
-                                  });
+        const auto log_likelihoods2 = likelihoods_[genotype[1]];
+        return sum_log_sum_exp<HaplotypeLikelihoodArray::StoredLogProbability, 2>({log_likelihoods1.data(), log_likelihoods2.data()},
+                                                                                  {0.0, ln(2)}, num_likelihoods)
+               - num_likelihoods * ln(3);
     }
-    const auto& log_likelihoods3 = likelihoods_[genotype[2]];
-    return std::inner_product(cbegin(log_likelihoods1), cend(log_likelihoods1),
-                              cbegin(log_likelihoods3), LogProbability {0}, std::plus<> {},
-                              [] (const auto a, const auto b) -> LogProbability {
-                                  return maths::log_sum_exp(ln<decltype(a)>(2) + a, b) - ln<decltype(a)>(3);
-                              });
-}
-
-ConstantMixtureGenotypeLikelihoodModel::LogProbability
-ConstantMixtureGenotypeLikelihoodModel::evaluate_tetraploid(const Genotype<Haplotype>& genotype) const
-{
-    const auto z = genotype.zygosity();
-    const auto& log_likelihoods1 = likelihoods_[genotype[0]];
-    if (z == 1) {
-        return std::accumulate(std::cbegin(log_likelihoods1), std::cend(log_likelihoods1), LogProbability {0});
-    }
-    if (z == 4) {
-        const auto& log_likelihoods2 = likelihoods_[genotype[1]];
-        const auto& log_likelihoods3 = likelihoods_[genotype[2]];
-        const auto& log_likelihoods4 = likelihoods_[genotype[3]];
-        return maths::inner_product(std::cbegin(log_likelihoods1), std::cend(log_likelihoods1),
-                                    std::cbegin(log_likelihoods2), std::cbegin(log_likelihoods3),
-                                    std::cbegin(log_likelihoods4), LogProbability {0}, std::plus<> {},
-                                    [] (const auto a, const auto b, const auto c, const auto d) -> LogProbability {
-                                        return maths::log_sum_exp({a, b, c, d}) - ln<decltype(a)>(4);
-                                    });
-    }
-    
-    // TODO
-    
-    return 0;
+    const auto log_likelihoods3 = likelihoods_[genotype[2]];
+    return sum_log_sum_exp<HaplotypeLikelihoodArray::StoredLogProbability, 2>({log_likelihoods1.data(), log_likelihoods3.data()},
+                                                                              {ln(2), 0.0}, num_likelihoods)
+           - num_likelihoods * ln(3);
 }
 
 ConstantMixtureGenotypeLikelihoodModel::LogProbability
 ConstantMixtureGenotypeLikelihoodModel::evaluate_polyploid(const Genotype<Haplotype>& genotype) const
 {
     const auto ploidy = genotype.ploidy();
-    const auto z = genotype.zygosity();
-    const auto& log_likelihoods1 = likelihoods_[genotype[0]];
-    if (z == 1) {
+    const auto log_likelihoods1 = likelihoods_[genotype[0]];
+    if (genotype.zygosity() == 1) {
         return std::accumulate(std::cbegin(log_likelihoods1), std::cend(log_likelihoods1), LogProbability {0});
     }
-    if (z == 2) {
-        const auto unique_haplotypes = genotype.copy_unique_ref();
-        const auto& log_likelihoods2 = likelihoods_[unique_haplotypes.back()];
-        const auto lnpm1 = static_cast<HaplotypeLikelihoodArray::LogProbability>(std::log(ploidy - 1));
-        if (genotype.count(unique_haplotypes.front()) == 1) {
-            return std::inner_product(std::cbegin(log_likelihoods1), std::cend(log_likelihoods1),
-                                      std::cbegin(log_likelihoods2), LogProbability {0}, std::plus<> {},
-                                      [ploidy, lnpm1] (const auto a, const auto b) -> LogProbability {
-                                          return maths::log_sum_exp(a, lnpm1 + b) - ln<decltype(a)>(ploidy);
-                                      });
-        }
-        return std::inner_product(std::cbegin(log_likelihoods1), std::cend(log_likelihoods1),
-                                  std::cbegin(log_likelihoods2), LogProbability {0}, std::plus<> {},
-                                  [ploidy, lnpm1] (const auto a, const auto b) -> LogProbability {
-                                      return maths::log_sum_exp(lnpm1 + a, b) - ln<decltype(a)>(ploidy);
-                                  });
+    // Genotype elements are sorted so copies of a haplotype are adjacent
+    likelihood_columns_.clear();
+    log_counts_.clear();
+    for (auto itr = std::cbegin(genotype); itr != std::cend(genotype);) {
+        const auto next = std::find_if(std::next(itr), std::cend(genotype), [itr] (const auto& haplotype) { return haplotype != *itr; });
+        likelihood_columns_.push_back(likelihoods_[*itr].data());
+        log_counts_.push_back(std::log(std::distance(itr, next)));
+        itr = next;
     }
-    likelihood_refs_.reserve(ploidy);
-    likelihood_refs_.push_back(log_likelihoods1);
-    std::transform(std::next(std::cbegin(genotype)), std::cend(genotype), std::back_inserter(likelihood_refs_),
-                   [this] (const auto& haplotype) -> const HaplotypeLikelihoodArray::LikelihoodVector& {
-                       return likelihoods_[haplotype]; });
-    LogProbability result {0};
-    const auto num_likelihoods = likelihood_refs_.front().get().size();
-    buffer_.resize(ploidy);
-    for (std::size_t read_idx {0}; read_idx < num_likelihoods; ++read_idx) {
-        std::transform(std::cbegin(likelihood_refs_), std::cend(likelihood_refs_), std::begin(buffer_),
-                       [read_idx] (const auto& likelihoods) noexcept { return likelihoods.get()[read_idx]; });
-        result += maths::log_sum_exp(buffer_) - ln<LogProbability>(ploidy);
-    }
-    likelihood_refs_.clear();
-    return result;
+    const auto num_likelihoods = log_likelihoods1.size();
+    return maths::simd::sum_log_sum_exp(likelihood_columns_.data(), log_counts_.data(), likelihood_columns_.size(), num_likelihoods)
+           - num_likelihoods * std::log(ploidy);
 }
 
 } // namespace model
@@ -39,17 +39,27 @@ public:
     LogProbability evaluate(const Genotype<Haplotype>& genotype) const;
     LogProbability evaluate(const GenotypeIndex& genotype) const;
     
+    // Evaluates all genotypes together, sharing work between genotypes with common haplotypes
+    std::vector<LogProbability> evaluate(const std::vector<Genotype<Haplotype>>& genotypes) const;
+    std::vector<LogProbability> evaluate(const std::vector<GenotypeIndex>& genotypes) const;
+    
 private:
+    using HaplotypeIndexVector = std::vector<HaplotypeLikelihoodArray::HaplotypeIndex>;
+    
     const HaplotypeLikelihoodArray& likelihoods_;
-    std::vector<HaplotypeLikelihoodArray::LikelihoodVectorRef> indexed_likelihoods_;
-    mutable std::vector<HaplotypeLikelihoodArray::LikelihoodVectorRef> likelihood_refs_;
-    mutable std::vector<HaplotypeLikelihoodArray::LogProbability> buffer_;
+    HaplotypeIndexVector indexed_haplotypes_;
+    mutable std::vector<const HaplotypeLikelihoodArray::StoredLogProbability*> likelihood_columns_;
+    mutable std::vector<double> log_counts_;
+    mutable std::vector<HaplotypeLikelihoodArray::StoredLogProbability> base_log_likelihoods_;
+    
+    HaplotypeIndexVector to_haplotype_indices(const GenotypeIndex& genotype) const;
+    LogProbability evaluate_mixture(const HaplotypeIndexVector& genotype) const;
+    std::vector<LogProbability> evaluate_shared(const std::vector<HaplotypeIndexVector>& genotypes) const;
     
     // These are just for optimisation
     LogProbability evaluate_haploid(const Genotype<Haplotype>& genotype) const;
     LogProbability evaluate_diploid(const Genotype<Haplotype>& genotype) const;
     LogProbability evaluate_triploid(const Genotype<Haplotype>& genotype) const;
-    LogProbability evaluate_tetraploid(const Genotype<Haplotype>& genotype) const;
     LogProbability evaluate_polyploid(const Genotype<Haplotype>& genotype) const;
 };
 
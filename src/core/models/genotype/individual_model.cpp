@@ -68,7 +68,7 @@ IndividualModel::evaluate(const std::vector<Genotype<Haplotype>>& genotypes,
 {
     assert(!genotypes.empty());
     const ConstantMixtureGenotypeLikelihoodModel likelihood_model {haplotype_likelihoods};
-    auto posteriors = octopus::model::evaluate(genotypes, likelihood_model);
+    auto posteriors = likelihood_model.evaluate(genotypes);
     debug::log_genotype_likelihoods(debug_log_, trace_log_, genotypes, posteriors);
     octopus::evaluate(genotypes, genotype_prior_model_, posteriors, false, true);
     const auto log_evidence = maths::normalise_exp(posteriors);
@@ -86,9 +86,9 @@ IndividualModel::evaluate(const std::vector<Genotype<Haplotype>>& genotypes,
     InferredLatents result {};
     if (is_primed()) {
         likelihood_model.prime(*haplotypes_);
-        result.posteriors.genotype_probabilities = octopus::model::evaluate(genotype_indices, likelihood_model);
+        result.posteriors.genotype_probabilities = likelihood_model.evaluate(genotype_indices);
     } else {
-        result.posteriors.genotype_probabilities = octopus::model::evaluate(genotypes, likelihood_model);
+        result.posteriors.genotype_probabilities = likelihood_model.evaluate(genotypes);
     }
     debug::log_genotype_likelihoods(debug_log_, trace_log_, genotypes, result.posteriors.genotype_probabilities);
     octopus::evaluate(genotype_indices, genotype_prior_model_, result.posteriors.genotype_probabilities, false, true);
@@ -52,8 +52,8 @@ public:
 private:
     const HaplotypeLikelihoodArray& likelihoods_;
     MixtureVector mixtures_, log_mixtures_;
-    std::vector<HaplotypeLikelihoodArray::LikelihoodVectorRef> indexed_likelihoods_;
-    mutable std::vector<HaplotypeLikelihoodArray::LikelihoodVectorRef> likelihood_refs_;
+    std::vector<HaplotypeLikelihoodArray::LikelihoodVector> indexed_likelihoods_;
+    mutable std::vector<HaplotypeLikelihoodArray::LikelihoodVector> likelihood_refs_;
     mutable std::vector<HaplotypeLikelihoodArray::LogProbability> buffer_;
 };
 
@@ -75,7 +75,7 @@ public:
     BaseType::value_type operator[](const std::size_t n) const noexcept;
 
 private:
-    const BaseType* likelihoods;
+    BaseType likelihoods;
 };
 
 template <std::size_t K>
@@ -531,7 +531,7 @@ run_variational_bayes(const VBAlphaVector<K>& prior_alphas,
         const auto func = [&] (auto&& seed) { return detail::run_variational_bayes(prior_alphas, genotype_log_priors, log_likelihoods,
                                                                                    inverted_log_likelihoods, std::move(seed), params); };
         if (params.parallel_execution) {
-            parallel_transform(std::make_move_iterator(std::begin(seeds)), std::make_move_iterator(std::end(seeds)),
+            parallel_transform("run_variational_bayes", std::make_move_iterator(std::begin(seeds)), std::make_move_iterator(std::end(seeds)),
                                std::back_inserter(result), func);
         } else {
             for (auto& seed : seeds) result.push_back(func(std::move(seed)));
@@ -540,7 +540,7 @@ run_variational_bayes(const VBAlphaVector<K>& prior_alphas,
         const auto func = [&] (auto&& seed) { return detail::run_variational_bayes(prior_alphas, genotype_log_priors, log_likelihoods,
                                                                                    std::move(seed), params); };
         if (params.parallel_execution) {
-            parallel_transform(std::make_move_iterator(std::begin(seeds)), std::make_move_iterator(std::end(seeds)),
+            parallel_transform("run_variational_bayes", std::make_move_iterator(std::begin(seeds)), std::make_move_iterator(std::end(seeds)),
                                std::back_inserter(result), func);
         } else {
             for (auto& seed : seeds) result.push_back(func(std::move(seed)));
@@ -607,36 +607,36 @@ run_variational_bayes(const VBAlphaVector<K>& prior_alphas,
 }
 
 inline VBReadLikelihoodArray::VBReadLikelihoodArray(const BaseType& underlying_likelihoods)
-: likelihoods{std::addressof(underlying_likelihoods)} {}
+: likelihoods{underlying_likelihoods} {}
 
 inline void VBReadLikelihoodArray::operator=(const BaseType& other)
 {
-    likelihoods = std::addressof(other);
+    likelihoods = other;
 }
 
 inline void VBReadLikelihoodArray::operator=(std::reference_wrapper<const BaseType> other)
 {
-    likelihoods = std::addressof(other.get());
+    likelihoods = other.get();
 }
 
 inline std::size_t VBReadLikelihoodArray::size() const noexcept
 {
-    return likelihoods->size();
+    return likelihoods.size();
 }
 
 inline VBReadLikelihoodArray::BaseType::const_iterator VBReadLikelihoodArray::begin() const noexcept
 {
-    return likelihoods->begin();
+    return likelihoods.begin();
 }
 
 inline VBReadLikelihoodArray::BaseType::const_iterator VBReadLikelihoodArray::end() const noexcept
 {
-    return likelihoods->end();
+    return likelihoods.end();
 }
 
 inline VBReadLikelihoodArray::BaseType::value_type VBReadLikelihoodArray::operator[](const std::size_t n) const noexcept
 {
-    return likelihoods->operator[](n);
+    return likelihoods[n];
 }
 
 template <std::size_t K>
@@ -4,8 +4,15 @@
 #include "haplotype_likelihood_array.hpp"
 
 #include <utility>
+#include <iterator>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
 #include <cassert>
 
+#include <boost/functional/hash.hpp>
+
 #include <iostream> // DEBUG
 #include <iomanip>  // DEBUG
 
@@ -15,21 +22,19 @@ namespace octopus {
 
 HaplotypeLikelihoodArray::HaplotypeLikelihoodArray(const unsigned max_haplotypes,
                                                    const std::vector<SampleName>& samples)
-: cache_ {max_haplotypes}
+: haplotype_indices_ {max_haplotypes}
 , sample_indices_ {samples.size()}
-{
-    mapping_positions_.resize(maxMappingPositions);
-}
+{}
 
 HaplotypeLikelihoodArray::HaplotypeLikelihoodArray(HaplotypeLikelihoodModel likelihood_model,
                                                    unsigned max_haplotypes,
-                                                   const std::vector<SampleName>& samples)
+                                                   const std::vector<SampleName>& samples,
+                                                   std::shared_ptr<Executor> executor)
 : likelihood_model_ {std::move(likelihood_model)}
-, cache_ {max_haplotypes}
+, executor_ {std::move(executor)}
+, haplotype_indices_ {max_haplotypes}
 , sample_indices_ {samples.size()}
-{
-    mapping_positions_.resize(maxMappingPositions);
-}
+{}
 
 HaplotypeLikelihoodArray::ReadPacket::ReadPacket(Iterator first, Iterator last)
 : first {first}
@@ -37,101 +42,410 @@ HaplotypeLikelihoodArray::ReadPacket::ReadPacket(Iterator first, Iterator last)
 , num_reads {static_cast<std::size_t>(std::distance(first, last))}
 {}
 
+namespace {
+
+using FlankState = HaplotypeLikelihoodArray::FlankState;
+using ReadIterator = HaplotypeLikelihoodModel::ReadIterator;
+using ReadHashIterator = std::vector<std::reference_wrapper<const KmerPerfectHashes>>::const_iterator;
+using LikelihoodIterator = HaplotypeLikelihoodArray::StoredLogProbability*;
+
+// The likelihoods of a contiguous block of unique reads given one haplotype
+struct LikelihoodBlock
+{
+    const Haplotype& haplotype;
+    ReadIterator first_read, last_read;
+    ReadHashIterator first_read_hash;
+    LikelihoodIterator first_likelihood;
+};
+
+// Evaluates blocks with its own kmer hash table, which is only rebuilt when the haplotype changes
+template <unsigned char K>
+class BlockEvaluator
+{
+public:
+    using MappingPositionItr = HaplotypeLikelihoodModel::MappingPositionItr;
+    
+    BlockEvaluator(HaplotypeLikelihoodModel& model, boost::optional<FlankState> flank_state,
+                   std::size_t max_mapping_positions)
+    : model_ {model}
+    , flank_state_ {std::move(flank_state)}
+    , haplotype_hashes_ {init_kmer_hash_table<K>()}
+    , mapping_positions_(max_mapping_positions)
+    {}
+    
+    void evaluate(const LikelihoodBlock& block)
+    {
+        if (haplotype_ != std::addressof(block.haplotype)) reset(block.haplotype);
+        if (model_.can_batch_reads()) {
+            read_mapping_positions_.resize(static_cast<std::size_t>(std::distance(block.first_read, block.last_read)));
+            auto read_hash_itr = block.first_read_hash;
+            for (auto& read_mapping_positions : read_mapping_positions_) {
+                read_mapping_positions.assign(std::cbegin(mapping_positions_), map(*read_hash_itr++));
+            }
+            model_.evaluate(block.first_read, block.last_read, read_mapping_positions_, likelihoods_);
+            std::copy(std::cbegin(likelihoods_), std::cend(likelihoods_), block.first_likelihood);
+        } else {
+            std::transform(block.first_read, block.last_read, block.first_read_hash, block.first_likelihood,
+                           [this] (const AlignedRead& read, const KmerPerfectHashes& read_hashes) {
+                               const auto last_mapping_position = map(read_hashes);
+                               return model_.evaluate(read, std::cbegin(mapping_positions_), last_mapping_position);
+                           });
+        }
+    }
+    
+    // The positions a read is mapped to in haplotype, valid until the next call. The model is left reset with haplotype.
+    std::pair<MappingPositionItr, MappingPositionItr> map(const Haplotype& haplotype, const KmerPerfectHashes& read_hashes)
+    {
+        if (haplotype_ != std::addressof(haplotype)) reset(haplotype);
+        const auto last_mapping_position = map(read_hashes);
+        return {std::cbegin(mapping_positions_), last_mapping_position};
+    }
+    
+private:
+    HaplotypeLikelihoodModel& model_;
+    boost::optional<FlankState> flank_state_;
+    KmerHashTable haplotype_hashes_;
+    MappedIndexCounts haplotype_mapping_counts_;
+    const Haplotype* haplotype_ = nullptr;
+    HaplotypeLikelihoodModel::MappingPositionVector mapping_positions_;
+    std::vector<HaplotypeLikelihoodModel::MappingPositionVector> read_mapping_positions_;
+    std::vector<HaplotypeLikelihoodModel::LogProbability> likelihoods_;
+    
+    void reset(const Haplotype& haplotype)
+    {
+        clear_kmer_hash_table(haplotype_hashes_);
+        populate_kmer_hash_table<K>(haplotype.sequence(), haplotype_hashes_);
+        haplotype_mapping_counts_ = init_mapping_counts(haplotype_hashes_);
+        model_.reset(haplotype, flank_state_);
+        haplotype_ = std::addressof(haplotype);
+    }
+    
+    MappingPositionItr map(const KmerPerfectHashes& read_hashes)
+    {
+        const auto result = map_query_to_target(read_hashes, haplotype_hashes_, haplotype_mapping_counts_,
+                                                std::begin(mapping_positions_), mapping_positions_.size());
+        reset_mapping_counts(haplotype_mapping_counts_);
+        return result;
+    }
+};
+
+// State shared by the populating thread and any helpers. Blocks reference data owned by the
+// populating thread, so helpers may only touch them between joining and leaving an open group.
+struct BlockGroup
+{
+    BlockGroup(std::vector<LikelihoodBlock> blocks, boost::optional<HaplotypeLikelihoodModel> model,
+               boost::optional<FlankState> flank_state)
+    : blocks {std::move(blocks)}
+    , prototype_model {std::move(model)}
+    , flank_state {std::move(flank_state)}
+    , next_block {0}
+    , failed_block {this->blocks.size()}
+    {}
+    
+    std::vector<LikelihoodBlock> blocks;
+    boost::optional<HaplotypeLikelihoodModel> prototype_model; // copied by each helper
+    boost::optional<FlankState> flank_state;
+    std::atomic<std::size_t> next_block, failed_block;
+    std::exception_ptr error = nullptr;
+    std::mutex mutex;
+    std::condition_variable helpers_done;
+    unsigned num_helpers = 0;
+    bool is_closed = false;
+};
+
+// Blocks are claimed in order, so every block before a failed block is evaluated and
+// the error reported is always that of the first failed block, whoever evaluated it
+template <unsigned char K>
+void evaluate(BlockGroup& group, HaplotypeLikelihoodModel& model, const std::size_t max_mapping_positions)
+{
+    BlockEvaluator<K> evaluator {model, group.flank_state, max_mapping_positions};
+    for (auto block = group.next_block++; block < group.blocks.size() && block < group.failed_block; block = group.next_block++) {
+        try {
+            evaluator.evaluate(group.blocks[block]);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock {group.mutex};
+            if (block < group.failed_block) {
+                group.failed_block = block;
+                group.error = std::current_exception();
+            }
+        }
+    }
+}
+
+template <unsigned char K>
+void help(std::shared_ptr<BlockGroup> group, const std::size_t max_mapping_positions)
+{
+    {
+        std::lock_guard<std::mutex> lock {group->mutex};
+        if (group->is_closed) return;
+        ++group->num_helpers;
+    }
+    try {
+        auto model = *group->prototype_model;
+        evaluate<K>(*group, model, max_mapping_positions);
+    } catch (...) {
+        // Any blocks left are evaluated by the populating thread
+    }
+    {
+        std::lock_guard<std::mutex> lock {group->mutex};
+        --group->num_helpers;
+    }
+    group->helpers_done.notify_all();
+}
+
+void close(BlockGroup& group)
+{
+    std::unique_lock<std::mutex> lock {group.mutex};
+    group.is_closed = true;
+    group.helpers_done.wait(lock, [&] () { return group.num_helpers == 0; });
+}
+
+} // namespace
+
 void HaplotypeLikelihoodArray::populate(const ReadMap& reads,
                                         const std::vector<Haplotype>& haplotypes,
                                         boost::optional<FlankState> flank_state)
+{
+    populate(reads, haplotypes, std::move(flank_state), nullptr);
+}
+
+void HaplotypeLikelihoodArray::populate(const ReadMap& reads,
+                                        const std::vector<Haplotype>& haplotypes,
+                                        boost::optional<FlankState> flank_state,
+                                        ReadLikelihoodCache& reuse_cache)
+{
+    populate(reads, haplotypes, std::move(flank_state), std::addressof(reuse_cache));
+}
+
+namespace {
+
+// The unique reads that must be evaluated against one haplotype as they are not in the reuse cache
+struct PendingReads
+{
+    std::vector<HaplotypeLikelihoodModel::ReadReference> reads;
+    std::vector<std::reference_wrapper<const KmerPerfectHashes>> read_hashes;
+    std::vector<std::size_t> indices;
+    std::vector<boost::optional<ReadLikelihoodCache::Key>> keys; // none if the likelihood can't be cached
+    std::vector<HaplotypeLikelihoodArray::StoredLogProbability> likelihoods;
+};
+
+} // namespace
+
+void HaplotypeLikelihoodArray::populate(const ReadMap& reads,
+                                        const std::vector<Haplotype>& haplotypes,
+                                        boost::optional<FlankState> flank_state,
+                                        ReadLikelihoodCache* reuse_cache)
 {
     // This code is not very pretty because it is a bottleneck for the entire application.
     // We want to try a minimise memory allocations for the mapping.
-    cache_.clear();
-    if (cache_.bucket_count() < haplotypes.size()) {
-        cache_.rehash(haplotypes.size());
+    haplotype_indices_.clear();
+    if (haplotype_indices_.bucket_count() < haplotypes.size()) {
+        haplotype_indices_.rehash(haplotypes.size());
+    }
+    std::vector<std::reference_wrapper<const Haplotype>> unique_haplotypes {};
+    unique_haplotypes.reserve(haplotypes.size());
+    for (const auto& haplotype : haplotypes) {
+        if (haplotype_indices_.emplace(haplotype, unique_haplotypes.size()).second) {
+            unique_haplotypes.emplace_back(haplotype);
+        }
     }
     set_read_iterators_and_sample_indices(reads);
     assert(reads.size() == read_iterators_.size());
-    const auto num_samples = reads.size();
+    // Reads that must have the same likelihood are only evaluated once, then copied to each duplicate
+    group_duplicate_reads();
+    num_unique_reads_ = unique_reads_.size();
     // Precompute all read hashes so we don't have to recompute for each haplotype
-    std::vector<std::vector<KmerPerfectHashes>> read_hashes {};
-    read_hashes.reserve(num_samples);
-    for (const auto& t : read_iterators_) {
-        std::vector<KmerPerfectHashes> sample_read_hashes {};
-        sample_read_hashes.reserve(t.num_reads);
-        std::transform(t.first, t.last, std::back_inserter(sample_read_hashes),
-                       [] (const AlignedRead& read) { return compute_kmer_hashes<mapperKmerSize>(read.sequence()); });
-        read_hashes.emplace_back(std::move(sample_read_hashes));
-    }
-    auto haplotype_hashes = init_kmer_hash_table<mapperKmerSize>();
-    const auto first_mapping_position = std::begin(mapping_positions_);
-    for (const auto& haplotype : haplotypes) {
-        populate_kmer_hash_table<mapperKmerSize>(haplotype.sequence(), haplotype_hashes);
-        auto haplotype_mapping_counts = init_mapping_counts(haplotype_hashes);
-        auto itr = std::begin(cache_.emplace(std::piecewise_construct,
-                                             std::forward_as_tuple(haplotype),
-                                             std::forward_as_tuple(num_samples)).first->second);
-        likelihood_model_.reset(haplotype, flank_state);
-        auto read_hash_itr = std::cbegin(read_hashes);
-        for (const auto& t : read_iterators_) { // for each sample
-            *itr = std::vector<LogProbability>(t.num_reads);
-            std::transform(t.first, t.last, std::cbegin(*read_hash_itr), std::begin(*itr),
-                           [&] (const AlignedRead& read, const auto& read_hashes) {
-                               const auto last_mapping_position = map_query_to_target(read_hashes, haplotype_hashes,
-                                                                                      haplotype_mapping_counts,
-                                                                                      first_mapping_position,
-                                                                                      maxMappingPositions);
-                               reset_mapping_counts(haplotype_mapping_counts);
-                               return likelihood_model_.evaluate(read, first_mapping_position, last_mapping_position);
-                           });
-            ++read_hash_itr;
-            ++itr;
+    std::vector<KmerPerfectHashes> read_hashes {};
+    read_hashes.reserve(num_unique_reads_);
+    std::transform(std::cbegin(unique_reads_), std::cend(unique_reads_), std::back_inserter(read_hashes),
+                   [] (const AlignedRead& read) { return compute_kmer_hashes<mapperKmerSize>(read.sequence()); });
+    const std::vector<std::reference_wrapper<const KmerPerfectHashes>> read_hash_refs {std::cbegin(read_hashes), std::cend(read_hashes)};
+    auto& buffer = unshared_likelihoods();
+    buffer.resize(unique_haplotypes.size() * num_reads());
+    const bool has_duplicates {num_unique_reads_ < num_reads()};
+    LikelihoodBuffer unique_likelihoods {};
+    if (has_duplicates) unique_likelihoods.resize(unique_haplotypes.size() * num_unique_reads_);
+    const auto unique_likelihoods_begin = has_duplicates ? unique_likelihoods.data() : buffer.data();
+    // Only reads not evaluated against the same local haplotype context in an earlier population are evaluated
+    std::vector<PendingReads> pending_reads {};
+    std::size_t num_pending_likelihoods {unique_haplotypes.size() * num_unique_reads_};
+    if (reuse_cache) {
+        std::vector<std::shared_ptr<const ReadLikelihoodCache::ReadIdentity>> read_identities(num_unique_reads_);
+        std::transform(std::cbegin(unique_reads_), std::cend(unique_reads_), std::begin(read_identities),
+                       [] (const AlignedRead& read) { return ReadLikelihoodCache::identify(read); });
+        pending_reads.resize(unique_haplotypes.size());
+        num_pending_likelihoods = 0;
+        // Keys need each read's mapping positions and the model parameters over the whole haplotype
+        BlockEvaluator<mapperKmerSize> mapper {likelihood_model_, flank_state, maxMappingPositions};
+        auto likelihood_itr = unique_likelihoods_begin;
+        for (std::size_t h {0}; h < unique_haplotypes.size(); ++h) {
+            auto& pending = pending_reads[h];
+            std::shared_ptr<const ReadLikelihoodCache::HaplotypeContext> haplotype_context {};
+            for (std::size_t i {0}; i < num_unique_reads_; ++i) {
+                const auto mapping_positions = mapper.map(unique_haplotypes[h], read_hash_refs[i]);
+                if (!haplotype_context) {
+                    haplotype_context = ReadLikelihoodCache::share_context(unique_haplotypes[h], likelihood_model_);
+                }
+                const auto key = ReadLikelihoodCache::make_key(read_identities[i], unique_reads_[i],
+                                                               haplotype_context, unique_haplotypes[h], flank_state,
+                                                               mapping_positions.first, mapping_positions.second,
+                                                               maxMappingPositions);
+                const auto likelihood = key ? reuse_cache->find(*key) : boost::none;
+                if (likelihood) {
+                    likelihood_itr[i] = *likelihood;
+                } else {
+                    pending.reads.push_back(unique_reads_[i]);
+                    pending.read_hashes.push_back(read_hash_refs[i]);
+                    pending.indices.push_back(i);
+                    pending.keys.push_back(key);
+                }
+            }
+            pending.likelihoods.resize(pending.reads.size());
+            num_pending_likelihoods += pending.reads.size();
+            likelihood_itr += num_unique_reads_;
         }
-        clear_kmer_hash_table(haplotype_hashes);
     }
+    unsigned num_helpers {0};
+    if (executor_) {
+        const auto max_helpers = num_pending_likelihoods / minLikelihoodsPerHelper;
+        num_helpers = static_cast<unsigned>(std::min(executor_->num_available_helpers(), max_helpers));
+    }
+    // Helpers share the grid in blocks of reads; otherwise each haplotype is one block
+    std::vector<LikelihoodBlock> blocks {};
+    const auto add_blocks = [&] (const Haplotype& haplotype, const auto& block_reads, const auto& block_read_hashes,
+                                 LikelihoodIterator likelihood_itr) {
+        const auto num_block_reads = block_reads.size();
+        std::size_t block_size {readBlockSize};
+        if (num_helpers == 0) block_size = std::max(num_block_reads, std::size_t {1});
+        for (std::size_t first {0}; first < num_block_reads; first += block_size) {
+            const auto last = std::min(first + block_size, num_block_reads);
+            blocks.push_back({haplotype, std::next(std::cbegin(block_reads), first), std::next(std::cbegin(block_reads), last),
+                              std::next(std::cbegin(block_read_hashes), first), likelihood_itr + first});
+        }
+    };
+    for (std::size_t h {0}; h < unique_haplotypes.size(); ++h) {
+        if (reuse_cache) {
+            auto& pending = pending_reads[h];
+            add_blocks(unique_haplotypes[h], pending.reads, pending.read_hashes, pending.likelihoods.data());
+        } else {
+            add_blocks(unique_haplotypes[h], unique_reads_, read_hash_refs, unique_likelihoods_begin + h * num_unique_reads_);
+        }
+    }
+    if (!blocks.empty()) {
+        num_helpers = std::min(num_helpers, static_cast<unsigned>(blocks.size() - 1));
+    }
+    boost::optional<HaplotypeLikelihoodModel> prototype_model {};
+    if (num_helpers > 0) prototype_model = likelihood_model_;
+    auto group = std::make_shared<BlockGroup>(std::move(blocks), std::move(prototype_model), flank_state);
+    if (num_helpers > 0) {
+        executor_->recruit("HaplotypeLikelihoodArray::populate", num_helpers,
+                           [group] () { help<mapperKmerSize>(group, maxMappingPositions); });
+    }
+    std::exception_ptr error {};
+    try {
+        evaluate<mapperKmerSize>(*group, likelihood_model_, maxMappingPositions);
+    } catch (...) {
+        error = std::current_exception();
+    }
+    close(*group);
     likelihood_model_.clear();
     read_iterators_.clear();
+    unique_reads_.clear();
+    if (group->error) std::rethrow_exception(group->error);
+    if (error) std::rethrow_exception(error);
+    if (reuse_cache) {
+        auto likelihood_itr = unique_likelihoods_begin;
+        for (const auto& pending : pending_reads) {
+            for (std::size_t i {0}; i < pending.indices.size(); ++i) {
+                likelihood_itr[pending.indices[i]] = pending.likelihoods[i];
+                if (pending.keys[i]) reuse_cache->insert(*pending.keys[i], pending.likelihoods[i]);
+            }
+            likelihood_itr += num_unique_reads_;
+        }
+    }
+    if (has_duplicates) {
+        auto unique_likelihood_itr = std::cbegin(unique_likelihoods);
+        for (auto haplotype_likelihood_itr = std::begin(buffer); haplotype_likelihood_itr != std::end(buffer);
+             haplotype_likelihood_itr += num_reads()) {
+            std::transform(std::cbegin(read_groups_), std::cend(read_groups_), haplotype_likelihood_itr,
+                           [=] (const auto read_group) { return unique_likelihood_itr[read_group]; });
+            unique_likelihood_itr += num_unique_reads_;
+        }
+    }
+}
+
+double HaplotypeLikelihoodArray::compression_ratio() const noexcept
+{
+    return num_unique_reads_ > 0 ? static_cast<double>(num_reads()) / num_unique_reads_ : 1.0;
 }
 
 std::size_t HaplotypeLikelihoodArray::num_likelihoods(const SampleName& sample) const
 {
-    return std::cbegin(cache_)->second.at(sample_indices_.at(sample)).size();
+    const auto sample_index = sample_indices_.at(sample);
+    return sample_read_offsets_[sample_index + 1] - sample_read_offsets_[sample_index];
 }
 
-const HaplotypeLikelihoodArray::LikelihoodVector&
+HaplotypeLikelihoodArray::HaplotypeIndex HaplotypeLikelihoodArray::index_of(const Haplotype& haplotype) const
+{
+    return haplotype_indices_.at(haplotype);
+}
+
+HaplotypeLikelihoodArray::LikelihoodVector
 HaplotypeLikelihoodArray::operator()(const SampleName& sample, const Haplotype& haplotype) const
 {
-    return cache_.at(haplotype)[sample_indices_.at(sample)];
+    return likelihoods(sample_indices_.at(sample), index_of(haplotype));
+}
+
+HaplotypeLikelihoodArray::LikelihoodVector
+HaplotypeLikelihoodArray::operator()(const SampleName& sample, const HaplotypeIndex haplotype) const
+{
+    return likelihoods(sample_indices_.at(sample), haplotype);
 }
 
-const HaplotypeLikelihoodArray::LikelihoodVector&
+HaplotypeLikelihoodArray::LikelihoodVector
 HaplotypeLikelihoodArray::operator[](const Haplotype& haplotype) const
 {
-    return cache_.at(haplotype)[*primed_sample_];
+    return likelihoods(*primed_sample_, index_of(haplotype));
+}
+
+HaplotypeLikelihoodArray::LikelihoodVector
+HaplotypeLikelihoodArray::operator[](const HaplotypeIndex haplotype) const
+{
+    return likelihoods(*primed_sample_, haplotype);
 }
 
 HaplotypeLikelihoodArray::SampleLikelihoodMap
 HaplotypeLikelihoodArray::extract_sample(const SampleName& sample) const
 {
     const auto sample_index = sample_indices_.at(sample);
-    SampleLikelihoodMap result {cache_.size()};
-    for (const auto& p : cache_) {
-        result.emplace(p.first, p.second[sample_index]);
+    SampleLikelihoodMap result {haplotype_indices_.size()};
+    for (const auto& p : haplotype_indices_) {
+        result.emplace(p.first, likelihoods(sample_index, p.second));
     }
     return result;
 }
 
 bool HaplotypeLikelihoodArray::contains(const Haplotype& haplotype) const noexcept
 {
-    return cache_.count(haplotype) == 1;
+    return haplotype_indices_.count(haplotype) == 1;
 }
 
 bool HaplotypeLikelihoodArray::is_empty() const noexcept
 {
-    return cache_.empty();
+    return haplotype_indices_.empty();
 }
 
 void HaplotypeLikelihoodArray::clear() noexcept
 {
-    cache_.clear();
+    if (likelihoods_.use_count() == 1) {
+        likelihoods_->clear();
+    } else {
+        likelihoods_.reset();
+    }
+    haplotype_indices_.clear();
     sample_indices_.clear();
+    sample_read_offsets_.clear();
+    num_unique_reads_ = 0;
     unprime();
 }
 
@@ -150,8 +464,41 @@ void HaplotypeLikelihoodArray::unprime() const noexcept
     primed_sample_ = boost::none;
 }
 
+HaplotypeLikelihoodArray HaplotypeLikelihoodArray::share() const
+{
+    HaplotypeLikelihoodArray result {};
+    result.likelihoods_ = likelihoods_;
+    result.haplotype_indices_ = haplotype_indices_;
+    result.sample_indices_ = sample_indices_;
+    result.sample_read_offsets_ = sample_read_offsets_;
+    result.num_unique_reads_ = num_unique_reads_;
+    return result;
+}
+
 // private methods
 
+std::size_t HaplotypeLikelihoodArray::DuplicateReadHash::operator()(const AlignedRead& read) const noexcept
+{
+    using boost::hash_combine;
+    std::size_t result {0};
+    hash_combine(result, mapped_begin(read));
+    hash_combine(result, read.mapping_quality());
+    hash_combine(result, read.is_marked_reverse_mapped());
+    hash_combine(result, read.sequence());
+    return result;
+}
+
+bool HaplotypeLikelihoodArray::IsDuplicateRead::operator()(const AlignedRead& lhs, const AlignedRead& rhs) const noexcept
+{
+    // The likelihood model only depends on these, given the haplotype
+    return mapped_begin(lhs) == mapped_begin(rhs)
+        && lhs.mapping_quality() == rhs.mapping_quality()
+        && lhs.is_marked_reverse_mapped() == rhs.is_marked_reverse_mapped()
+        && lhs.sequence() == rhs.sequence()
+        && lhs.base_qualities() == rhs.base_qualities()
+        && contig_name(lhs) == contig_name(rhs);
+}
+
 void HaplotypeLikelihoodArray::set_read_iterators_and_sample_indices(const ReadMap& reads)
 {
     read_iterators_.clear();
@@ -163,13 +510,57 @@ void HaplotypeLikelihoodArray::set_read_iterators_and_sample_indices(const ReadM
     if (sample_indices_.bucket_count() < num_samples) {
         sample_indices_.rehash(num_samples);
     }
+    sample_read_offsets_.assign(1, 0);
+    sample_read_offsets_.reserve(num_samples + 1);
     std::size_t i {0};
     for (const auto& p : reads) {
         read_iterators_.emplace_back(std::cbegin(p.second), std::cend(p.second));
         sample_indices_.emplace(p.first, i++);
+        sample_read_offsets_.push_back(sample_read_offsets_.back() + read_iterators_.back().num_reads);
     }
 }
 
+void HaplotypeLikelihoodArray::group_duplicate_reads()
+{
+    unique_reads_.clear();
+    read_groups_.clear();
+    read_group_indices_.clear();
+    unique_reads_.reserve(num_reads());
+    read_groups_.reserve(num_reads());
+    if (read_group_indices_.bucket_count() < num_reads()) {
+        read_group_indices_.rehash(num_reads());
+    }
+    for (const auto& t : read_iterators_) {
+        std::for_each(t.first, t.last, [this] (const AlignedRead& read) {
+            const auto p = read_group_indices_.emplace(read, unique_reads_.size());
+            if (p.second) unique_reads_.emplace_back(read);
+            read_groups_.push_back(p.first->second);
+        });
+    }
+    read_group_indices_.clear();
+}
+
+std::size_t HaplotypeLikelihoodArray::num_reads() const noexcept
+{
+    return sample_read_offsets_.empty() ? 0 : sample_read_offsets_.back();
+}
+
+HaplotypeLikelihoodArray::LikelihoodBuffer& HaplotypeLikelihoodArray::unshared_likelihoods()
+{
+    // Copies made by share may still be reading the old buffer
+    if (!likelihoods_ || likelihoods_.use_count() > 1) {
+        likelihoods_ = std::make_shared<LikelihoodBuffer>();
+    }
+    return *likelihoods_;
+}
+
+HaplotypeLikelihoodArray::LikelihoodVector
+HaplotypeLikelihoodArray::likelihoods(const std::size_t sample, const HaplotypeIndex haplotype) const noexcept
+{
+    const auto first = sample_read_offsets_[sample], last = sample_read_offsets_[sample + 1];
+    return {likelihoods_->data() + haplotype * num_reads() + first, last - first};
+}
+
 // non-member methods
 
 HaplotypeLikelihoodArray merge_samples(const std::vector<SampleName>& samples,
@@ -178,15 +569,24 @@ HaplotypeLikelihoodArray merge_samples(const std::vector<SampleName>& samples,
                                        const HaplotypeLikelihoodArray& haplotype_likelihoods)
 {
     HaplotypeLikelihoodArray result {static_cast<unsigned>(haplotypes.size()), {new_sample}};
+    std::size_t num_reads {0};
+    for (const auto& sample : samples) {
+        num_reads += haplotype_likelihoods.num_likelihoods(sample);
+    }
+    result.sample_indices_.emplace(new_sample, 0);
+    result.sample_read_offsets_ = {0, num_reads};
+    auto& buffer = result.unshared_likelihoods();
+    buffer.resize(haplotypes.size() * num_reads);
+    auto likelihood_itr = std::begin(buffer);
     for (const auto& haplotype : haplotypes) {
-        HaplotypeLikelihoodArray::LikelihoodVector likelihoods {};
-        for (const auto& sample : samples) {
-            const auto& m = haplotype_likelihoods(sample, haplotype);
-            likelihoods.insert(std::end(likelihoods), std::cbegin(m), std::cend(m));
+        if (result.haplotype_indices_.emplace(haplotype, result.haplotype_indices_.size()).second) {
+            for (const auto& sample : samples) {
+                const auto likelihoods = haplotype_likelihoods(sample, haplotype);
+                likelihood_itr = std::copy(std::cbegin(likelihoods), std::cend(likelihoods), likelihood_itr);
+            }
         }
-        likelihoods.shrink_to_fit();
-        result.insert(new_sample, haplotype, std::move(likelihoods));
     }
+    buffer.resize(result.haplotype_indices_.size() * num_reads);
     return result;
 }
 
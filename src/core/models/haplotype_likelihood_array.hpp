@@ -8,6 +8,7 @@
 #include <vector>
 #include <algorithm>
 #include <functional>
+#include <memory>
 
 #include <boost/optional.hpp>
 
@@ -15,7 +16,10 @@
 #include "core/types/haplotype.hpp"
 #include "basics/aligned_read.hpp"
 #include "utils/kmer_mapper.hpp"
+#include "utils/executor.hpp"
+#include "utils/aligned_allocator.hpp"
 #include "haplotype_likelihood_model.hpp"
+#include "read_likelihood_cache.hpp"
 
 namespace octopus {
 
@@ -24,18 +28,35 @@ namespace octopus {
     p(read | haplotype) for a given set of AlignedReads and Haplotypes.
  
     The matrix can be efficiently populated as the read mapping and alignment are
-    done internally which allows minimal memory allocation.
+    done internally which allows minimal memory allocation. Reads that must have the same
+    likelihood for any haplotype (same position, strand, sequence, base and mapping qualities),
+    such as retained duplicates, are only evaluated once. If given an Executor, available
+    helpers help populate large matrices; each has its own likelihood model and the result
+    does not depend on how many help.
+ 
+    Likelihoods are stored densely in a single aligned [haplotype][sample][read] buffer, so the
+    likelihoods of each sample's reads given a haplotype are contiguous. Haplotypes are
+    indexed in the order they are populated; looking up by Haplotype just finds the index.
+    Defining OCTOPUS_SINGLE_PRECISION_LIKELIHOODS stores likelihoods as floats. Copies share the
+    buffer until one of them is repopulated.
  */
 class HaplotypeLikelihoodArray
 {
 public:
     using FlankState = HaplotypeLikelihoodModel::FlankState;
     
-    using LogProbability       = HaplotypeLikelihoodModel::LogProbability;
-    using LikelihoodVector     = std::vector<LogProbability>;
-    using LikelihoodVectorRef  = std::reference_wrapper<const LikelihoodVector>;
+    using LogProbability = HaplotypeLikelihoodModel::LogProbability;
+    #ifdef OCTOPUS_SINGLE_PRECISION_LIKELIHOODS
+    using StoredLogProbability = float;
+    #else
+    using StoredLogProbability = double;
+    #endif
+    
+    class LikelihoodVector;
+    
+    using HaplotypeIndex       = std::size_t;
     using HaplotypeRef         = std::reference_wrapper<const Haplotype>;
-    using SampleLikelihoodMap  = std::unordered_map<HaplotypeRef, LikelihoodVectorRef>;
+    using SampleLikelihoodMap  = std::unordered_map<HaplotypeRef, LikelihoodVector>;
     
     HaplotypeLikelihoodArray() = default;
     
@@ -43,7 +64,8 @@ public:
     
     HaplotypeLikelihoodArray(HaplotypeLikelihoodModel likelihood_model,
                              unsigned max_haplotypes,
-                             const std::vector<SampleName>& samples);
+                             const std::vector<SampleName>& samples,
+                             std::shared_ptr<Executor> executor = nullptr);
     
     HaplotypeLikelihoodArray(const HaplotypeLikelihoodArray&)            = default;
     HaplotypeLikelihoodArray& operator=(const HaplotypeLikelihoodArray&) = default;
@@ -54,19 +76,26 @@ public:
     
     void populate(const ReadMap& reads, const std::vector<Haplotype>& haplotypes,
                   boost::optional<FlankState> flank_state = boost::none);
+    // Reuses likelihoods in reuse_cache, and adds those that are evaluated
+    void populate(const ReadMap& reads, const std::vector<Haplotype>& haplotypes,
+                  boost::optional<FlankState> flank_state, ReadLikelihoodCache& reuse_cache);
     
     std::size_t num_likelihoods(const SampleName& sample) const;
     
-    const LikelihoodVector& operator()(const SampleName& sample, const Haplotype& haplotype) const;
-    const LikelihoodVector& operator[](const Haplotype& haplotype) const; // when primed with a sample
+    // The number of reads per unique read evaluated in the last population
+    double compression_ratio() const noexcept;
+    
+    HaplotypeIndex index_of(const Haplotype& haplotype) const;
+    
+    LikelihoodVector operator()(const SampleName& sample, const Haplotype& haplotype) const;
+    LikelihoodVector operator()(const SampleName& sample, HaplotypeIndex haplotype) const;
+    LikelihoodVector operator[](const Haplotype& haplotype) const; // when primed with a sample
+    LikelihoodVector operator[](HaplotypeIndex haplotype) const; // when primed with a sample
     
     SampleLikelihoodMap extract_sample(const SampleName& sample) const;
     
     bool contains(const Haplotype& haplotype) const noexcept;
     
-    template <typename S, typename Container>
-    void insert(S&& sample, const Haplotype& haplotype, Container&& likelihoods);
-    
     template <typename Container> void erase(const Container& haplotypes);
     
     bool is_empty() const noexcept;
@@ -77,11 +106,22 @@ public:
     void prime(const SampleName& sample) const;
     void unprime() const noexcept;
     
+    // A copy that can only be read, sharing the likelihood buffer but primed independently
+    HaplotypeLikelihoodArray share() const;
+    
+    friend HaplotypeLikelihoodArray merge_samples(const std::vector<SampleName>& samples,
+                                                  const SampleName& new_sample,
+                                                  const std::vector<Haplotype>& haplotypes,
+                                                  const HaplotypeLikelihoodArray& haplotype_likelihoods);
+    
 private:
     static constexpr unsigned char mapperKmerSize {6};
     static constexpr std::size_t maxMappingPositions {10};
+    static constexpr std::size_t readBlockSize {256};
+    static constexpr std::size_t minLikelihoodsPerHelper {5000};
     
     HaplotypeLikelihoodModel likelihood_model_;
+    std::shared_ptr<Executor> executor_;
     
     struct ReadPacket
     {
@@ -91,31 +131,85 @@ private:
         std::size_t num_reads;
     };
     
-    std::unordered_map<Haplotype, std::vector<LikelihoodVector>, HaplotypeHash> cache_;
+    using LikelihoodBuffer = std::vector<StoredLogProbability, AlignedAllocator<StoredLogProbability>>;
+    using ReadReference = HaplotypeLikelihoodModel::ReadReference;
+    
+    struct DuplicateReadHash
+    {
+        std::size_t operator()(const AlignedRead& read) const noexcept;
+    };
+    struct IsDuplicateRead
+    {
+        bool operator()(const AlignedRead& lhs, const AlignedRead& rhs) const noexcept;
+    };
+    
+    std::shared_ptr<LikelihoodBuffer> likelihoods_;
+    std::unordered_map<Haplotype, HaplotypeIndex, HaplotypeHash> haplotype_indices_;
     std::unordered_map<SampleName, std::size_t> sample_indices_;
+    std::vector<std::size_t> sample_read_offsets_; // num samples + 1
+    std::size_t num_unique_reads_ = 0;
     
     mutable boost::optional<std::size_t> primed_sample_;
     
     // Just to optimise population
     std::vector<ReadPacket> read_iterators_;
-    std::vector<std::size_t> mapping_positions_;
+    std::vector<ReadReference> unique_reads_;
+    std::vector<std::size_t> read_groups_; // unique read index of each read
+    std::unordered_map<ReadReference, std::size_t, DuplicateReadHash, IsDuplicateRead> read_group_indices_;
     
+    void populate(const ReadMap& reads, const std::vector<Haplotype>& haplotypes,
+                  boost::optional<FlankState> flank_state, ReadLikelihoodCache* reuse_cache);
     void set_read_iterators_and_sample_indices(const ReadMap& reads);
+    void group_duplicate_reads();
+    std::size_t num_reads() const noexcept;
+    LikelihoodBuffer& unshared_likelihoods();
+    LikelihoodVector likelihoods(std::size_t sample, HaplotypeIndex haplotype) const noexcept;
 };
 
-template <typename S, typename Container>
-void HaplotypeLikelihoodArray::insert(S&& sample, const Haplotype& haplotype,
-                                      Container&& likelihoods)
+// A read-only view of the likelihoods of one sample's reads given one haplotype
+class HaplotypeLikelihoodArray::LikelihoodVector
 {
-    sample_indices_.emplace(std::forward<S>(sample), sample_indices_.size());
-    cache_[haplotype].emplace_back(std::forward<Container>(likelihoods));
-}
+public:
+    using value_type     = StoredLogProbability;
+    using size_type      = std::size_t;
+    using const_iterator = const value_type*;
+    using iterator       = const_iterator;
+    
+    LikelihoodVector() = default;
+    
+    LikelihoodVector(const value_type* first, size_type size) noexcept : first_ {first}, size_ {size} {}
+    
+    LikelihoodVector(const LikelihoodVector&)            = default;
+    LikelihoodVector& operator=(const LikelihoodVector&) = default;
+    LikelihoodVector(LikelihoodVector&&)                 = default;
+    LikelihoodVector& operator=(LikelihoodVector&&)      = default;
+    
+    ~LikelihoodVector() = default;
+    
+    const_iterator begin() const noexcept { return first_; }
+    const_iterator end() const noexcept { return first_ + size_; }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+    
+    const value_type* data() const noexcept { return first_; }
+    size_type size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+    
+    value_type operator[](size_type n) const noexcept { return first_[n]; }
+    value_type front() const noexcept { return first_[0]; }
+    value_type back() const noexcept { return first_[size_ - 1]; }
+    
+private:
+    const value_type* first_ = nullptr;
+    size_type size_ = 0;
+};
 
 template <typename Container>
 void HaplotypeLikelihoodArray::erase(const Container& haplotypes)
 {
+    // Erased likelihoods are left in place so the remaining haplotype indices are unchanged
     for (const auto& haplotype : haplotypes) {
-        cache_.erase(haplotype);
+        haplotype_indices_.erase(haplotype);
     }
 }
 
@@ -144,6 +144,11 @@ bool HaplotypeLikelihoodModel::can_use_flank_state() const noexcept
     return config_.use_flank_state;
 }
 
+bool HaplotypeLikelihoodModel::can_batch_reads() const noexcept
+{
+    return config_.use_read_batching;
+}
+
 HaplotypeLikelihoodModel::LogProbability
 HaplotypeLikelihoodModel::evaluate(const AlignedRead& read) const
 {
@@ -179,17 +184,15 @@ bool is_in_range(const std::size_t mapping_position, const AlignedRead& read, co
 
 } // namespace
 
-template <typename InputIt>
-HaplotypeLikelihoodModel::LogProbability
-max_score(const AlignedRead& read, const Haplotype& haplotype,
-          InputIt first_mapping_position, InputIt last_mapping_position,
-          const hmm::MutationModel& model)
+// Calls f with each mapping position of the read that should be evaluated
+template <typename InputIt, typename UnaryFunction>
+void for_each_mapping_position(const AlignedRead& read, const Haplotype& haplotype,
+                               InputIt first_mapping_position, InputIt last_mapping_position,
+                               UnaryFunction f)
 {
     assert(contains(haplotype, read));
-    using LogProbability = HaplotypeLikelihoodModel::LogProbability;
     using PositionType = typename std::iterator_traits<InputIt>::value_type;
     const auto original_mapping_position = static_cast<PositionType>(begin_distance(haplotype, read));
-    auto max_log_probability = std::numeric_limits<LogProbability>::lowest();
     bool is_original_position_mapped {false}, has_in_range_mapping_position {false};
     std::for_each(first_mapping_position, last_mapping_position, [&] (const auto position) {
         if (position == original_mapping_position) {
@@ -197,15 +200,12 @@ max_score(const AlignedRead& read, const Haplotype& haplotype,
         }
         if (is_in_range(position, read, haplotype)) {
             has_in_range_mapping_position = true;
-            auto p = hmm::evaluate(read.sequence(), haplotype.sequence(), read.base_qualities(), position, model);
-            max_log_probability = std::max(static_cast<LogProbability>(p), max_log_probability);
+            f(position);
         }
     });
     if (!is_original_position_mapped && is_in_range(original_mapping_position, read, haplotype)) {
         has_in_range_mapping_position = true;
-        auto p = hmm::evaluate(read.sequence(), haplotype.sequence(), read.base_qualities(),
-                               original_mapping_position, model);
-        max_log_probability = std::max(static_cast<LogProbability>(p), max_log_probability);
+        f(original_mapping_position);
     }
     if (!has_in_range_mapping_position) {
         const auto min_shift = num_out_of_range_bases(original_mapping_position, read, haplotype);
@@ -224,9 +224,22 @@ max_score(const AlignedRead& read, const Haplotype& haplotype,
                 throw HaplotypeLikelihoodModel::ShortHaplotypeError {haplotype, required_extension};
             }
         }
-        max_log_probability = hmm::evaluate(read.sequence(), haplotype.sequence(), read.base_qualities(),
-                                            final_mapping_position, model);
+        f(final_mapping_position);
     }
+}
+
+template <typename InputIt>
+HaplotypeLikelihoodModel::LogProbability
+max_score(const AlignedRead& read, const Haplotype& haplotype,
+          InputIt first_mapping_position, InputIt last_mapping_position,
+          const hmm::MutationModel& model)
+{
+    using LogProbability = HaplotypeLikelihoodModel::LogProbability;
+    auto max_log_probability = std::numeric_limits<LogProbability>::lowest();
+    for_each_mapping_position(read, haplotype, first_mapping_position, last_mapping_position, [&] (const auto position) {
+        auto p = hmm::evaluate(read.sequence(), haplotype.sequence(), read.base_qualities(), position, model);
+        max_log_probability = std::max(static_cast<LogProbability>(p), max_log_probability);
+    });
     assert(max_log_probability > std::numeric_limits<LogProbability>::lowest() && max_log_probability <= 0);
     return max_log_probability;
 }
@@ -239,40 +252,47 @@ HaplotypeLikelihoodModel::evaluate(const AlignedRead& read,
     if (haplotype_ == nullptr) {
         throw std::runtime_error {"HaplotypeLikelihoodModel: no buffered Haplotype"};
     }
-    const auto is_forward = !read.is_marked_reverse_mapped();
-    hmm::MutationModel model {
-        is_forward ? haplotype_snv_forward_mask_ : haplotype_snv_reverse_mask_,
-        is_forward ? haplotype_snv_forward_priors_ : haplotype_snv_reverse_priors_,
-        haplotype_gap_open_penalities_,
-        haplotype_gap_extend_penalities_
-    };
-    if (haplotype_flank_state_) {
-        model.lhs_flank_size = haplotype_flank_state_->lhs_flank;
-        model.rhs_flank_size = haplotype_flank_state_->rhs_flank;
-    } else {
-        model.lhs_flank_size = 0;
-        model.rhs_flank_size = 0;
-    }
+    const auto model = make_mutation_model(!read.is_marked_reverse_mapped());
     const auto ln_prob_given_mapped = max_score(read, *haplotype_, first_mapping_position, last_mapping_position, model);
-    if (config_.use_mapping_quality) {
-        // This calculation is approximately
-        // p(read | hap) = p(read missmapped) p(read | hap, missmapped)
-        //                  + p(read correctly mapped) p(read | hap, correctly mapped)
-        // = p(read correctly mapped) p(read | hap, correctly mapped)
-        //      + p(read missmapped)
-        // assuming p(read | hap, missmapped) = 1
-        auto mapping_quality = read.mapping_quality();
-        if (config_.mapping_quality_cap_trigger && mapping_quality >= *config_.mapping_quality_cap_trigger) {
-            mapping_quality = config_.mapping_quality_cap;
-        }
-        using octopus::maths::constants::ln10Div10;
-        const auto ln_prob_missmapped = -ln10Div10<> * mapping_quality;
-        const auto ln_prob_mapped = std::log(1.0 - std::exp(ln_prob_missmapped));
-        const auto result = maths::log_sum_exp(ln_prob_mapped + ln_prob_given_mapped, ln_prob_missmapped);
-        return result > -1e-15 ? 0.0 : result;
-    } else {
-        return ln_prob_given_mapped  > -1e-15 ? 0.0 : ln_prob_given_mapped;
+    return adjust_for_mapping_quality(read, ln_prob_given_mapped);
+}
+
+void HaplotypeLikelihoodModel::evaluate(ReadIterator first_read, ReadIterator last_read,
+                                        const std::vector<MappingPositionVector>& mapping_positions,
+                                        std::vector<LogProbability>& result) const
+{
+    if (haplotype_ == nullptr) {
+        throw std::runtime_error {"HaplotypeLikelihoodModel: no buffered Haplotype"};
     }
+    assert(static_cast<std::size_t>(std::distance(first_read, last_read)) == mapping_positions.size());
+    const auto forward_model = make_mutation_model(true), reverse_model = make_mutation_model(false);
+    thread_local std::vector<hmm::BatchTarget> targets {};
+    thread_local std::vector<std::size_t> target_reads {};
+    thread_local std::vector<double> target_likelihoods {};
+    targets.clear();
+    target_reads.clear();
+    auto mapping_positions_itr = std::cbegin(mapping_positions);
+    std::for_each(first_read, last_read, [&] (const AlignedRead& read) {
+        const auto& model = read.is_marked_reverse_mapped() ? reverse_model : forward_model;
+        const auto read_idx = static_cast<std::size_t>(std::distance(std::cbegin(mapping_positions), mapping_positions_itr));
+        for_each_mapping_position(read, *haplotype_, std::cbegin(*mapping_positions_itr), std::cend(*mapping_positions_itr),
+                                  [&] (const auto position) {
+            targets.push_back({read.sequence(), read.base_qualities(), position, model});
+            target_reads.push_back(read_idx);
+        });
+        ++mapping_positions_itr;
+    });
+    hmm::evaluate(targets, haplotype_->sequence(), target_likelihoods);
+    result.assign(mapping_positions.size(), std::numeric_limits<LogProbability>::lowest());
+    for (std::size_t i {0}; i < targets.size(); ++i) {
+        auto& max_log_probability = result[target_reads[i]];
+        max_log_probability = std::max(static_cast<LogProbability>(target_likelihoods[i]), max_log_probability);
+    }
+    std::transform(first_read, last_read, std::cbegin(result), std::begin(result),
+                   [this] (const AlignedRead& read, const auto ln_prob_given_mapped) {
+                       assert(ln_prob_given_mapped > std::numeric_limits<LogProbability>::lowest() && ln_prob_given_mapped <= 0);
+                       return adjust_for_mapping_quality(read, ln_prob_given_mapped);
+                   });
 }
 
 HaplotypeLikelihoodModel::Alignment
@@ -358,19 +378,62 @@ HaplotypeLikelihoodModel::align(const AlignedRead& read, MappingPositionItr firs
     if (haplotype_ == nullptr) {
         throw std::runtime_error {"HaplotypeLikelihoodModel: no buffered Haplotype"};
     }
-    const auto is_forward = !read.is_marked_reverse_mapped();
-    hmm::MutationModel model {is_forward ? haplotype_snv_forward_mask_ : haplotype_snv_reverse_mask_,
-                              is_forward ? haplotype_snv_forward_priors_ : haplotype_snv_reverse_priors_,
-                              haplotype_gap_open_penalities_, haplotype_gap_extend_penalities_};
+    const auto model = make_mutation_model(!read.is_marked_reverse_mapped());
+    auto result = compute_optimal_alignment(read, *haplotype_, first_mapping_position, last_mapping_position, model);
+    result.likelihood = adjust_for_mapping_quality(read, result.likelihood);
+    return result;
+}
+
+const std::vector<char>& HaplotypeLikelihoodModel::snv_mask(const bool is_forward) const noexcept
+{
+    return is_forward ? haplotype_snv_forward_mask_ : haplotype_snv_reverse_mask_;
+}
+
+const std::vector<HaplotypeLikelihoodModel::Penalty>& HaplotypeLikelihoodModel::snv_priors(const bool is_forward) const noexcept
+{
+    return is_forward ? haplotype_snv_forward_priors_ : haplotype_snv_reverse_priors_;
+}
+
+const std::vector<HaplotypeLikelihoodModel::Penalty>& HaplotypeLikelihoodModel::gap_open_penalties() const noexcept
+{
+    return haplotype_gap_open_penalities_;
+}
+
+const std::vector<HaplotypeLikelihoodModel::Penalty>& HaplotypeLikelihoodModel::gap_extend_penalties() const noexcept
+{
+    return haplotype_gap_extend_penalities_;
+}
+
+// private methods
+
+hmm::MutationModel HaplotypeLikelihoodModel::make_mutation_model(const bool is_forward) const
+{
+    hmm::MutationModel result {
+        is_forward ? haplotype_snv_forward_mask_ : haplotype_snv_reverse_mask_,
+        is_forward ? haplotype_snv_forward_priors_ : haplotype_snv_reverse_priors_,
+        haplotype_gap_open_penalities_,
+        haplotype_gap_extend_penalities_
+    };
     if (haplotype_flank_state_) {
-        model.lhs_flank_size = haplotype_flank_state_->lhs_flank;
-        model.rhs_flank_size = haplotype_flank_state_->rhs_flank;
+        result.lhs_flank_size = haplotype_flank_state_->lhs_flank;
+        result.rhs_flank_size = haplotype_flank_state_->rhs_flank;
     } else {
-        model.lhs_flank_size = 0;
-        model.rhs_flank_size = 0;
+        result.lhs_flank_size = 0;
+        result.rhs_flank_size = 0;
     }
-    auto result = compute_optimal_alignment(read, *haplotype_, first_mapping_position, last_mapping_position, model);
+    return result;
+}
+
+HaplotypeLikelihoodModel::LogProbability
+HaplotypeLikelihoodModel::adjust_for_mapping_quality(const AlignedRead& read, const LogProbability ln_prob_given_mapped) const noexcept
+{
     if (config_.use_mapping_quality) {
+        // This calculation is approximately
+        // p(read | hap) = p(read missmapped) p(read | hap, missmapped)
+        //                  + p(read correctly mapped) p(read | hap, correctly mapped)
+        // = p(read correctly mapped) p(read | hap, correctly mapped)
+        //      + p(read missmapped)
+        // assuming p(read | hap, missmapped) = 1
         auto mapping_quality = read.mapping_quality();
         if (config_.mapping_quality_cap_trigger && mapping_quality >= *config_.mapping_quality_cap_trigger) {
             mapping_quality = config_.mapping_quality_cap;
@@ -378,12 +441,11 @@ HaplotypeLikelihoodModel::align(const AlignedRead& read, MappingPositionItr firs
         using octopus::maths::constants::ln10Div10;
         const auto ln_prob_missmapped = -ln10Div10<> * mapping_quality;
         const auto ln_prob_mapped = std::log(1.0 - std::exp(ln_prob_missmapped));
-        result.likelihood = maths::log_sum_exp(ln_prob_mapped + result.likelihood, ln_prob_missmapped);
-        result.likelihood = result.likelihood > -1e-15 ? 0.0 : result.likelihood;
+        const auto result = maths::log_sum_exp(ln_prob_mapped + ln_prob_given_mapped, ln_prob_missmapped);
+        return result > -1e-15 ? 0.0 : result;
     } else {
-        result.likelihood = result.likelihood > -1e-15 ? 0.0 : result.likelihood;
+        return ln_prob_given_mapped  > -1e-15 ? 0.0 : ln_prob_given_mapped;
     }
-    return result;
 }
 
 HaplotypeLikelihoodModel make_haplotype_likelihood_model(const std::string label, bool use_mapping_quality)
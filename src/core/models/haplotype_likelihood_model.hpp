@@ -40,6 +40,7 @@ public:
         boost::optional<AlignedRead::MappingQuality> mapping_quality_cap_trigger = boost::none;
         AlignedRead::MappingQuality mapping_quality_cap = 120;
         bool use_flank_state = true;
+        bool use_read_batching = false;
     };
     
     struct FlankState
@@ -52,6 +53,8 @@ public:
     using MappingPosition       = std::size_t;
     using MappingPositionVector = std::vector<MappingPosition>;
     using MappingPositionItr    = MappingPositionVector::const_iterator;
+    using ReadReference         = std::reference_wrapper<const AlignedRead>;
+    using ReadIterator          = std::vector<ReadReference>::const_iterator;
     
     struct Alignment
     {
@@ -80,6 +83,7 @@ public:
     static unsigned pad_requirement() noexcept;
     
     bool can_use_flank_state() const noexcept;
+    bool can_batch_reads() const noexcept;
     
     void reset(const Haplotype& haplotype, boost::optional<FlankState> flank_state = boost::none);
     
@@ -90,10 +94,22 @@ public:
     LogProbability evaluate(const AlignedRead& read, const MappingPositionVector& mapping_positions) const;
     LogProbability evaluate(const AlignedRead& read, MappingPositionItr first_mapping_position, MappingPositionItr last_mapping_position) const;
     
+    // The same as evaluate for each read, with mapping_positions holding the mapping positions of each read,
+    // but alignments of the same length are scored together by the inter-read pair HMM kernel
+    void evaluate(ReadIterator first_read, ReadIterator last_read,
+                  const std::vector<MappingPositionVector>& mapping_positions,
+                  std::vector<LogProbability>& result) const;
+    
     Alignment align(const AlignedRead& read) const;
     Alignment align(const AlignedRead& read, const MappingPositionVector& mapping_positions) const;
     Alignment align(const AlignedRead& read, MappingPositionItr first_mapping_position, MappingPositionItr last_mapping_position) const;
     
+    // The mutation model parameters set for each base of the buffered haplotype
+    const std::vector<char>& snv_mask(bool is_forward) const noexcept;
+    const std::vector<Penalty>& snv_priors(bool is_forward) const noexcept;
+    const std::vector<Penalty>& gap_open_penalties() const noexcept;
+    const std::vector<Penalty>& gap_extend_penalties() const noexcept;
+    
 private:
     std::unique_ptr<SnvErrorModel> snv_error_model_;
     std::unique_ptr<IndelErrorModel> indel_error_model_;
@@ -107,6 +123,9 @@ private:
     
     std::vector<Penalty> haplotype_gap_open_penalities_, haplotype_gap_extend_penalities_;
     Config config_;
+    
+    hmm::MutationModel make_mutation_model(bool is_forward) const;
+    LogProbability adjust_for_mapping_quality(const AlignedRead& read, LogProbability ln_prob_given_mapped) const noexcept;
 };
 
 class HaplotypeLikelihoodModel::ShortHaplotypeError : public std::runtime_error
@@ -314,18 +314,21 @@ void validate(const std::string& truth, const std::string& target,
     }
 }
 
-double evaluate(const std::string& target, const std::string& truth,
-                const std::vector<std::uint8_t>& target_qualities,
-                const std::size_t target_offset,
-                const MutationModel& model)
+// Finds p(target | truth, model) without a full alignment when the target differs from the
+// truth by at most one base. Returns false if a full alignment is needed.
+bool evaluate_without_alignment(const std::string& target, const std::string& truth,
+                                const std::vector<std::uint8_t>& target_qualities,
+                                const std::size_t target_offset,
+                                const MutationModel& model,
+                                double& result) noexcept
 {
     using std::cbegin; using std::cend; using std::next; using std::distance;
     static constexpr auto lnProbability = make_phred_to_ln_prob_lookup<std::uint8_t>();
-    validate(truth, target, target_qualities, target_offset, model);
     const auto offsetted_truth_begin_itr = next(cbegin(truth), target_offset);
     const auto m1 = std::mismatch(cbegin(target), cend(target), offsetted_truth_begin_itr);
     if (m1.first == cend(target)) {
-        return 0; // sequences are equal, can't do better than this
+        result = 0; // sequences are equal, can't do better than this
+        return true;
     }
     const auto m2 = std::mismatch(next(m1.first), cend(target), next(m1.second));
     if (m2.first == cend(target)) {
@@ -334,7 +337,8 @@ double evaluate(const std::string& target, const std::string& truth,
         // truth:  ACGTTCGT
         const auto truth_mismatch_idx = distance(offsetted_truth_begin_itr, m1.second) + target_offset;
         if (truth_mismatch_idx < model.lhs_flank_size || truth_mismatch_idx >= (truth.size() - model.rhs_flank_size)) {
-            return 0;
+            result = 0;
+            return true;
         }
         const auto target_index = distance(cbegin(target), m1.first);
         auto mispatch_penalty = target_qualities[target_index];
@@ -343,23 +347,130 @@ double evaluate(const std::string& target, const std::string& truth,
                                         static_cast<std::uint8_t>(model.snv_priors[truth_mismatch_idx]));
         }
         if (mispatch_penalty <= model.gap_open[truth_mismatch_idx]) {
-            return lnProbability[mispatch_penalty];
+            result = lnProbability[mispatch_penalty];
+            return true;
         } else {
             if (std::equal(next(m1.first), cend(target), m1.second)) {
                 // target: AAAAGGGG
                 // truth:  AAA GGGGG
-                return lnProbability[model.gap_open[truth_mismatch_idx]];
+                result = lnProbability[model.gap_open[truth_mismatch_idx]];
+                return true;
             } else if (std::equal(m1.first, cend(target), next(m1.second))) {
                 // target: AAA GGGGG
                 // truth:  AAAAGGGGG
-                return lnProbability[model.gap_open[truth_mismatch_idx]];
+                result = lnProbability[model.gap_open[truth_mismatch_idx]];
+                return true;
             } else if (mispatch_penalty <= (model.gap_open[truth_mismatch_idx] + model.gap_extend[truth_mismatch_idx])) {
-                return lnProbability[mispatch_penalty];
+                result = lnProbability[mispatch_penalty];
+                return true;
             }
         }
     }
-    // TODO: we should be able to optimise the alignment based of the first mismatch postition
-    return simd_align(truth, target, target_qualities, target_offset, model);
+    return false;
+}
+
+double evaluate(const std::string& target, const std::string& truth,
+                const std::vector<std::uint8_t>& target_qualities,
+                const std::size_t target_offset,
+                const MutationModel& model)
+{
+    validate(truth, target, target_qualities, target_offset, model);
+    double result;
+    if (!evaluate_without_alignment(target, truth, target_qualities, target_offset, model, result)) {
+        // TODO: we should be able to optimise the alignment based of the first mismatch postition
+        result = simd_align(truth, target, target_qualities, target_offset, model);
+    }
+    return result;
+}
+
+namespace {
+
+// Whether simd_align would use the score only kernel without flank adjustment
+bool is_batchable(const std::string& truth, const std::string& target, const std::size_t target_offset,
+                  const MutationModel& model) noexcept
+{
+    constexpr auto pad = simd::min_flank_pad();
+    const auto truth_alignment_size = static_cast<int>(target.size() + 2 * pad - 1);
+    const auto alignment_offset = std::max(0, static_cast<int>(target_offset) - pad);
+    return alignment_offset + truth_alignment_size <= static_cast<int>(truth.size())
+           && !use_adjusted_alignment_score(truth, target, target_offset, model);
+}
+
+// Scores targets that are all batchable and of equal length. A partial batch costs as much as
+// a full one, so any remainder that does not fill a batch goes through simd_align.
+template <typename InputIt>
+void batch_simd_align(const std::vector<BatchTarget>& targets, InputIt first_target_idx, InputIt last_target_idx,
+                      const std::string& truth, std::vector<double>& result)
+{
+    constexpr auto pad = simd::min_flank_pad();
+    const auto batch_size = simd::batch_size();
+    thread_local std::vector<simd::BatchAlignment> alignments {};
+    thread_local std::vector<int> scores {};
+    while (first_target_idx != last_target_idx) {
+        const auto n = std::min(batch_size, static_cast<int>(std::distance(first_target_idx, last_target_idx)));
+        const auto last_batch_idx = std::next(first_target_idx, n);
+        if (n < batch_size) {
+            std::for_each(first_target_idx, last_batch_idx, [&] (const auto idx) {
+                const auto& target = targets[idx];
+                result[idx] = simd_align(truth, target.sequence, target.qualities, target.offset, target.model);
+            });
+        } else {
+            alignments.clear();
+            std::transform(first_target_idx, last_batch_idx, std::back_inserter(alignments), [&] (const auto idx) {
+                const auto& target = targets[idx];
+                const auto alignment_offset = std::max(0, static_cast<int>(target.offset) - pad);
+                return simd::BatchAlignment {truth.data() + alignment_offset,
+                                             target.sequence.data(),
+                                             reinterpret_cast<const std::int8_t*>(target.qualities.data()),
+                                             target.model.snv_mask.data() + alignment_offset,
+                                             target.model.snv_priors.data() + alignment_offset,
+                                             target.model.gap_open.data() + alignment_offset,
+                                             target.model.gap_extend.data() + alignment_offset};
+            });
+            const auto& front = targets[*first_target_idx];
+            const auto target_size = static_cast<int>(front.sequence.size());
+            scores.resize(n);
+            simd::align(alignments.data(), n, target_size + 2 * pad - 1, target_size, front.model.nuc_prior, scores.data());
+            auto score_itr = std::cbegin(scores);
+            std::for_each(first_target_idx, last_batch_idx, [&] (const auto idx) {
+                result[idx] = -ln10Div10<> * static_cast<double>(*score_itr++);
+            });
+        }
+        first_target_idx = last_batch_idx;
+    }
+}
+
+} // namespace
+
+void evaluate(const std::vector<BatchTarget>& targets, const std::string& truth,
+              std::vector<double>& result)
+{
+    result.resize(targets.size());
+    thread_local std::vector<std::size_t> pending {};
+    pending.clear();
+    for (std::size_t idx {0}; idx < targets.size(); ++idx) {
+        const auto& target = targets[idx];
+        validate(truth, target.sequence, target.qualities, target.offset, target.model);
+        if (!evaluate_without_alignment(target.sequence, truth, target.qualities, target.offset, target.model, result[idx])) {
+            if (is_batchable(truth, target.sequence, target.offset, target.model)) {
+                pending.push_back(idx);
+            } else {
+                result[idx] = simd_align(truth, target.sequence, target.qualities, target.offset, target.model);
+            }
+        }
+    }
+    // The batch kernel needs every alignment to have the same length and nucleotide prior
+    const auto batch_key = [&] (const std::size_t idx) {
+        return std::make_pair(targets[idx].sequence.size(), targets[idx].model.nuc_prior);
+    };
+    std::stable_sort(std::begin(pending), std::end(pending),
+                     [&] (const auto lhs, const auto rhs) { return batch_key(lhs) < batch_key(rhs); });
+    for (auto first_idx = std::cbegin(pending); first_idx != std::cend(pending); ) {
+        const auto last_idx = std::find_if(std::next(first_idx), std::cend(pending),
+                                           [&] (const auto idx) { return batch_key(idx) != batch_key(*first_idx); });
+        batch_simd_align(targets, first_idx, last_idx, truth, result);
+        first_idx = last_idx;
+    }
 }
 
 Alignment&
@@ -92,6 +92,20 @@ double evaluate(const std::string& target, const std::string& truth,
                 std::size_t target_offset,
                 const MutationModel& model);
 
+struct BatchTarget
+{
+    const std::string& sequence;
+    const std::vector<std::uint8_t>& qualities;
+    std::size_t offset;
+    const MutationModel& model;
+};
+
+// The same as calling evaluate on each target, but targets of equal length that need a full
+// alignment are scored together by the inter-read SIMD kernel. Small groups use the single
+// target kernel.
+void evaluate(const std::vector<BatchTarget>& targets, const std::string& truth,
+              std::vector<double>& result);
+
 Alignment&
 align(const std::string& target, const std::string& truth,
       const std::vector<std::uint8_t>& target_qualities,
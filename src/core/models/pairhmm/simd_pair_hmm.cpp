@@ -8,8 +8,16 @@
 #include "simd_pair_hmm.hpp"
 
 #include <vector>
+#include <string>
 #include <algorithm>
+#include <utility>
+#include <atomic>
+#include <random>
+#include <iterator>
+#include <type_traits>
+#include <stdexcept>
 #include <emmintrin.h>
+#include <immintrin.h>
 #include <cassert>
 
 #include <boost/container/small_vector.hpp>
@@ -55,1481 +63,281 @@ constexpr int bandSize {8};
 constexpr short inf {0x7800};
 constexpr char gap {'-'};
 
-auto extract_epi16(const __m128i a, const int imm) noexcept
+// The kernels are compiled once for each instruction set by including them inside a namespace
+// named after it. Only the functions defined between the target pragmas may use the wider
+// instruction set; the templates they instantiate (e.g. SmallVector) are defined outside and so
+// remain baseline, which keeps the binary safe to run on CPUs without AVX2 or AVX-512.
+
+namespace sse2 {
+namespace batch {
+    using Vector = __m128i;
+    constexpr int lanes {8};
+    inline Vector load(const short* values) noexcept { return _mm_loadu_si128(reinterpret_cast<const Vector*>(values)); }
+    inline void store(short* values, Vector a) noexcept { _mm_storeu_si128(reinterpret_cast<Vector*>(values), a); }
+    inline Vector set1(short value) noexcept { return _mm_set1_epi16(value); }
+    inline Vector add(Vector a, Vector b) noexcept { return _mm_add_epi16(a, b); }
+    inline Vector min(Vector a, Vector b) noexcept { return _mm_min_epi16(a, b); }
+    inline Vector cmpeq(Vector a, Vector b) noexcept { return _mm_cmpeq_epi16(a, b); }
+    inline Vector bit_and(Vector a, Vector b) noexcept { return _mm_and_si128(a, b); }
+    inline Vector bit_or(Vector a, Vector b) noexcept { return _mm_or_si128(a, b); }
+    inline Vector andnot(Vector a, Vector b) noexcept { return _mm_andnot_si128(a, b); }
+} // namespace batch
+#include "simd_pair_hmm_kernels.hpp"
+} // namespace sse2
+
+#if defined(__x86_64__) || defined(__i386__)
+#if defined(__GNUC__) && !defined(__clang__)
+    #define OCTOPUS_PAIR_HMM_MULTIVERSION
+    #define OCTOPUS_PAIR_HMM_BEGIN_AVX2 _Pragma("GCC push_options") _Pragma("GCC target(\"avx2\")")
+    #define OCTOPUS_PAIR_HMM_BEGIN_AVX512 _Pragma("GCC push_options") _Pragma("GCC target(\"avx512f,avx512bw,avx512vl\")")
+    #define OCTOPUS_PAIR_HMM_END_TARGET _Pragma("GCC pop_options")
+#elif defined(__clang__) && __clang_major__ >= 6
+    #define OCTOPUS_PAIR_HMM_MULTIVERSION
+    #define OCTOPUS_PAIR_HMM_BEGIN_AVX2 _Pragma("clang attribute push (__attribute__((target(\"avx2\"))), apply_to = function)")
+    #define OCTOPUS_PAIR_HMM_BEGIN_AVX512 _Pragma("clang attribute push (__attribute__((target(\"avx512f,avx512bw,avx512vl\"))), apply_to = function)")
+    #define OCTOPUS_PAIR_HMM_END_TARGET _Pragma("clang attribute pop")
+#endif
+#endif
+
+#ifdef OCTOPUS_PAIR_HMM_MULTIVERSION
+
+OCTOPUS_PAIR_HMM_BEGIN_AVX2
+namespace avx2 {
+namespace batch {
+    using Vector = __m256i;
+    constexpr int lanes {16};
+    inline Vector load(const short* values) noexcept { return _mm256_loadu_si256(reinterpret_cast<const Vector*>(values)); }
+    inline void store(short* values, Vector a) noexcept { _mm256_storeu_si256(reinterpret_cast<Vector*>(values), a); }
+    inline Vector set1(short value) noexcept { return _mm256_set1_epi16(value); }
+    inline Vector add(Vector a, Vector b) noexcept { return _mm256_add_epi16(a, b); }
+    inline Vector min(Vector a, Vector b) noexcept { return _mm256_min_epi16(a, b); }
+    inline Vector cmpeq(Vector a, Vector b) noexcept { return _mm256_cmpeq_epi16(a, b); }
+    inline Vector bit_and(Vector a, Vector b) noexcept { return _mm256_and_si256(a, b); }
+    inline Vector bit_or(Vector a, Vector b) noexcept { return _mm256_or_si256(a, b); }
+    inline Vector andnot(Vector a, Vector b) noexcept { return _mm256_andnot_si256(a, b); }
+} // namespace batch
+#include "simd_pair_hmm_kernels.hpp"
+} // namespace avx2
+OCTOPUS_PAIR_HMM_END_TARGET
+
+OCTOPUS_PAIR_HMM_BEGIN_AVX512
+namespace avx512 {
+namespace batch {
+    using Vector = __m512i;
+    constexpr int lanes {32};
+    inline Vector load(const short* values) noexcept { return _mm512_loadu_si512(values); }
+    inline void store(short* values, Vector a) noexcept { _mm512_storeu_si512(values, a); }
+    inline Vector set1(short value) noexcept { return _mm512_set1_epi16(value); }
+    inline Vector add(Vector a, Vector b) noexcept { return _mm512_add_epi16(a, b); }
+    inline Vector min(Vector a, Vector b) noexcept { return _mm512_min_epi16(a, b); }
+    inline Vector cmpeq(Vector a, Vector b) noexcept { return _mm512_movm_epi16(_mm512_cmpeq_epi16_mask(a, b)); }
+    inline Vector bit_and(Vector a, Vector b) noexcept { return _mm512_and_si512(a, b); }
+    inline Vector bit_or(Vector a, Vector b) noexcept { return _mm512_or_si512(a, b); }
+    inline Vector andnot(Vector a, Vector b) noexcept { return _mm512_andnot_si512(a, b); }
+} // namespace batch
+#include "simd_pair_hmm_kernels.hpp"
+} // namespace avx512
+OCTOPUS_PAIR_HMM_END_TARGET
+
+#endif // OCTOPUS_PAIR_HMM_MULTIVERSION
+
+namespace {
+
+bool is_supported(const InstructionSet isa) noexcept
 {
-    switch (imm) {
-        case 0:  return _mm_extract_epi16(a, 0);
-        case 1:  return _mm_extract_epi16(a, 1);
-        case 2:  return _mm_extract_epi16(a, 2);
-        case 3:  return _mm_extract_epi16(a, 3);
-        case 4:  return _mm_extract_epi16(a, 4);
-        case 5:  return _mm_extract_epi16(a, 5);
-        case 6:  return _mm_extract_epi16(a, 6);
-        default: return _mm_extract_epi16(a, 7);
+    switch (isa) {
+        case InstructionSet::sse2: return true;
+    #ifdef OCTOPUS_PAIR_HMM_MULTIVERSION
+        case InstructionSet::avx2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2");
+        case InstructionSet::avx512:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512vl");
+    #endif
+        default: return false;
     }
 }
 
-int align(const char* truth, const char* target, const std::int8_t* qualities,
-          int truth_len, int target_len,
-          short gap_open, short gap_extend, short nuc_prior) noexcept
+std::atomic<InstructionSet>& selected_instruction_set() noexcept
 {
-    // target is the read; the shorter of the sequences
-    // no checks for overflow are done
-    //
-    // the bottom-left and top-right corners of the DP table are just
-    // included at the extreme ends of the diagonal, which measures
-    // n=8 entries diagonally across.  This fixes the length of the
-    // longer (horizontal) sequence to 15 (2*8-1) more than the shorter
-    //
-    // the << 2's are because the lower two bits are reserved for back tracing
-    
-    assert(truth_len > bandSize && (truth_len == target_len + 2 * bandSize - 1));
-    
-    gap_open <<= 2;
-    gap_extend <<= 2;
-    nuc_prior <<= 2;
-    
-    using SimdInt = __m128i;
-    
-    SimdInt _m1 {_mm_set1_epi16(inf)};
-    auto _i1 = _m1;
-    auto _d1 = _m1;
-    auto _m2 = _m1;
-    auto _i2 = _m1;
-    auto _d2 = _m1;
-    
-    const SimdInt _gap_open {_mm_set1_epi16(gap_open)};
-    const SimdInt _gap_extend {_mm_set1_epi16(gap_extend)};
-    const SimdInt _nuc_prior  {_mm_set1_epi16(nuc_prior)};
-    
-    SimdInt _initmask   {_mm_set_epi16(0,0,0,0,0,0,0,-1)};
-    SimdInt _initmask2  {_mm_set_epi16(0,0,0,0,0,0,0,-0x8000)};
-    
-    // truth is initialized with the n-long prefix, in forward direction
-    // target is initialized as empty; reverse direction
-    SimdInt _truthwin  {_mm_set_epi16(truth[7], truth[6], truth[5], truth[4],
-                                      truth[3], truth[2], truth[1], truth[0])};
-    SimdInt _targetwin  {_m1};
-    SimdInt _qualitieswin {_mm_set1_epi16(64 << 2)};
-    
-    // if N, make nScore; if != N, make inf
-    SimdInt _truthnqual {_mm_add_epi16(_mm_and_si128(_mm_cmpeq_epi16(_truthwin, _mm_set1_epi16('N')),
-                                                     _mm_set1_epi16(nScore - inf)),
-                                       _mm_set1_epi16(inf))};
-    
-    short minscore {inf};
-    
-    for (int s {0}; s <= 2 * (target_len + bandSize); s += 2) {
-        // truth is current; target needs updating
-        _targetwin    = _mm_slli_si128(_targetwin, 2);
-        _qualitieswin = _mm_slli_si128(_qualitieswin, 2);
-        
-        if (s / 2 < target_len) {
-            _targetwin    = _mm_insert_epi16(_targetwin, target[s / 2], 0);
-            _qualitieswin = _mm_insert_epi16(_qualitieswin, qualities[s / 2] << 2, 0);
-        } else {
-            _targetwin    = _mm_insert_epi16(_targetwin, '0', 0);
-            _qualitieswin = _mm_insert_epi16(_qualitieswin, 64 << 2, 0);
-        }
-        
-        // S even
-        
-        _m1 = _mm_or_si128(_initmask2, _mm_andnot_si128(_initmask, _m1));
-        _m2 = _mm_or_si128(_initmask2, _mm_andnot_si128(_initmask, _m2));
-        _m1 = _mm_min_epi16(_m1, _mm_min_epi16(_i1, _d1));
-        
-        short score = extract_epi16(_m1, std::max(0, s / 2 - target_len));
-        if (s / 2 >= target_len) {
-            minscore = std::min(score, minscore);
-        }
-        
-        _m1 = _mm_add_epi16(_m1, _mm_min_epi16(_mm_andnot_si128(_mm_cmpeq_epi16(_targetwin, _truthwin),
-                                                                _qualitieswin), _truthnqual));
-        _d1 = _mm_min_epi16(_mm_add_epi16(_d2, _gap_extend),
-                            _mm_add_epi16(_mm_min_epi16(_m2, _i2),
-                                          _mm_srli_si128(_gap_open, 2))); // allow I->D
-        _d1 = _mm_insert_epi16(_mm_slli_si128(_d1, 2), inf, 0);
-        _i1 = _mm_add_epi16(_mm_min_epi16(_mm_add_epi16(_i2, _gap_extend),
-                                          _mm_add_epi16(_m2, _gap_open)),
-                            _nuc_prior);
-        
-        // S odd
-        // truth needs updating; target is current
-        const auto pos = bandSize + s / 2;
-        const char base {(pos < truth_len) ? truth[pos] : 'N'};
-        
-        _truthwin   = _mm_insert_epi16(_mm_srli_si128(_truthwin, 2), base,
-                                       bandSize - 1);
-        _truthnqual = _mm_insert_epi16(_mm_srli_si128(_truthnqual, 2), base == 'N' ? nScore : inf,
-                                       bandSize - 1);
-        
-        _initmask  = _mm_slli_si128(_initmask, 2);
-        _initmask2 = _mm_slli_si128(_initmask2, 2);
-        _m2 = _mm_min_epi16(_m2, _mm_min_epi16(_i2, _d2));
-        
-        if (s / 2 >= target_len) {
-            minscore = std::min(static_cast<short>(extract_epi16(_m2, s / 2 - target_len)), minscore);
+    static std::atomic<InstructionSet> result {supported_instruction_sets().back()};
+    return result;
+}
+
+template <typename... Args>
+int dispatch_align(const InstructionSet isa, Args&&... args) noexcept
+{
+    switch (isa) {
+    #ifdef OCTOPUS_PAIR_HMM_MULTIVERSION
+        case InstructionSet::avx512: return avx512::align(std::forward<Args>(args)...);
+        case InstructionSet::avx2:   return avx2::align(std::forward<Args>(args)...);
+    #endif
+        default: return sse2::align(std::forward<Args>(args)...);
+    }
+}
+
+int batch_lanes(const InstructionSet isa) noexcept
+{
+    switch (isa) {
+    #ifdef OCTOPUS_PAIR_HMM_MULTIVERSION
+        case InstructionSet::avx512: return avx512::batch::lanes;
+        case InstructionSet::avx2:   return avx2::batch::lanes;
+    #endif
+        default: return sse2::batch::lanes;
+    }
+}
+
+void align_batch(const InstructionSet isa, const BatchAlignment* alignments, const int num_alignments,
+                 const int truth_len, const int target_len, const short nuc_prior,
+                 int* scores) noexcept
+{
+    const auto lanes = batch_lanes(isa);
+    for (int i {0}; i < num_alignments; i += lanes) {
+        const auto n = std::min(lanes, num_alignments - i);
+        switch (isa) {
+        #ifdef OCTOPUS_PAIR_HMM_MULTIVERSION
+            case InstructionSet::avx512:
+                avx512::align(alignments + i, n, truth_len, target_len, nuc_prior, scores + i);
+                break;
+            case InstructionSet::avx2:
+                avx2::align(alignments + i, n, truth_len, target_len, nuc_prior, scores + i);
+                break;
+        #endif
+            default:
+                sse2::align(alignments + i, n, truth_len, target_len, nuc_prior, scores + i);
         }
-        
-        _m2 = _mm_add_epi16(_m2, _mm_min_epi16(_mm_andnot_si128(_mm_cmpeq_epi16(_targetwin, _truthwin),
-                                                                _qualitieswin), _truthnqual));
-        _d2 = _mm_min_epi16(_mm_add_epi16(_d1, _gap_extend),
-                            _mm_add_epi16(_mm_min_epi16(_m1, _i1), _gap_open)); // allow I->D
-        _i2 = _mm_insert_epi16(_mm_add_epi16(_mm_min_epi16(_mm_add_epi16(_mm_srli_si128(_i1, 2),
-                                                                         _gap_extend),
-                                                           _mm_add_epi16(_mm_srli_si128(_m1, 2),
-                                                                         _gap_open)),
-                                             _nuc_prior), inf, bandSize - 1);
-        
     }
-    
-    return (minscore + 0x8000) >> 2;
+}
+
+} // namespace
+
+std::vector<InstructionSet> supported_instruction_sets()
+{
+    std::vector<InstructionSet> result {};
+    for (auto isa : {InstructionSet::sse2, InstructionSet::avx2, InstructionSet::avx512}) {
+        if (is_supported(isa)) result.push_back(isa);
+    }
+    return result;
+}
+
+InstructionSet get_instruction_set() noexcept
+{
+    return selected_instruction_set().load(std::memory_order_relaxed);
+}
+
+void set_instruction_set(const InstructionSet isa)
+{
+    if (!is_supported(isa)) {
+        throw std::invalid_argument {"set_instruction_set: " + to_string(isa) + " is not supported"};
+    }
+    selected_instruction_set().store(isa, std::memory_order_relaxed);
+}
+
+std::string to_string(const InstructionSet isa)
+{
+    switch (isa) {
+        case InstructionSet::sse2:   return "SSE2";
+        case InstructionSet::avx2:   return "AVX2";
+        case InstructionSet::avx512: return "AVX-512";
+        default: return "unknown";
+    }
 }
 
 int align(const char* truth, const char* target, const std::int8_t* qualities,
           const int truth_len, const int target_len,
-          const std::int8_t* gap_open, short gap_extend, short nuc_prior) noexcept
+          const short gap_open, const short gap_extend, const short nuc_prior) noexcept
 {
-    // target is the read; the shorter of the sequences
-    // no checks for overflow are done
-    //
-    // the bottom-left and top-right corners of the DP table are just
-    // included at the extreme ends of the diagonal, which measures
-    // n=8 entries diagonally across.  This fixes the length of the
-    // longer (horizontal) sequence to 15 (2*8-1) more than the shorter
-    //
-    // the << 2's are because the lower two bits are reserved for back tracing
-    
-    assert(truth_len > bandSize && (truth_len == target_len + 2 * bandSize - 1));
-    
-    gap_extend <<= 2;
-    nuc_prior <<= 2;
-    
-    using SimdInt = __m128i;
-    
-    SimdInt _m1 {_mm_set1_epi16(inf)};
-    auto _i1 = _m1;
-    auto _d1 = _m1;
-    auto _m2 = _m1;
-    auto _i2 = _m1;
-    auto _d2 = _m1;
-    
-    SimdInt _gap_extend {_mm_set1_epi16(gap_extend)};
-    SimdInt _nuc_prior  {_mm_set1_epi16(nuc_prior)};
-    
-    SimdInt _initmask   {_mm_set_epi16(0,0,0,0,0,0,0,-1)};
-    SimdInt _initmask2  {_mm_set_epi16(0,0,0,0,0,0,0,-0x8000)};
-    
-    // truth is initialized with the n-long prefix, in forward direction
-    // target is initialized as empty; reverse direction
-    SimdInt _truthwin  {_mm_set_epi16(truth[7], truth[6], truth[5], truth[4],
-                                      truth[3], truth[2], truth[1], truth[0])};
-    SimdInt _targetwin  {_m1};
-    SimdInt _qualitieswin {_mm_set1_epi16(64 << 2)};
-    
-    // if N, make nScore; if != N, make inf
-    SimdInt _truthnqual {_mm_add_epi16(_mm_and_si128(_mm_cmpeq_epi16(_truthwin, _mm_set1_epi16('N')),
-                                                     _mm_set1_epi16(nScore - inf)),
-                                       _mm_set1_epi16(inf))};
-    
-    SimdInt _gap_open {_mm_set_epi16(gap_open[7] << 2,gap_open[6] << 2,gap_open[5] << 2,gap_open[4] << 2,
-                                     gap_open[3] << 2,gap_open[2] << 2,gap_open[1] << 2,gap_open[0] << 2)};
-    
-    short minscore {inf};
-    
-    for (int s {0}; s <= 2 * (target_len + bandSize); s += 2) {
-        // truth is current; target needs updating
-        _targetwin    = _mm_slli_si128(_targetwin, 2);
-        _qualitieswin = _mm_slli_si128(_qualitieswin, 2);
-        
-        if (s / 2 < target_len) {
-            _targetwin    = _mm_insert_epi16(_targetwin, target[s / 2], 0);
-            _qualitieswin = _mm_insert_epi16(_qualitieswin, qualities[s / 2] << 2, 0);
-        } else {
-            _targetwin    = _mm_insert_epi16(_targetwin, '0', 0);
-            _qualitieswin = _mm_insert_epi16(_qualitieswin, 64 << 2, 0);
-        }
-        
-        // S even
-        
-        _m1 = _mm_or_si128(_initmask2, _mm_andnot_si128(_initmask, _m1));
-        _m2 = _mm_or_si128(_initmask2, _mm_andnot_si128(_initmask, _m2));
-        _m1 = _mm_min_epi16(_m1, _mm_min_epi16(_i1, _d1));
-        
-        if (s / 2 >= target_len) {
-            minscore = std::min(static_cast<short>(extract_epi16(_m1, s / 2 - target_len)), minscore);
-        }
-        
-        _m1 = _mm_add_epi16(_m1, _mm_min_epi16(_mm_andnot_si128(_mm_cmpeq_epi16(_targetwin, _truthwin),
-                                                                _qualitieswin), _truthnqual));
-        _d1 = _mm_min_epi16(_mm_add_epi16(_d2, _gap_extend),
-                            _mm_add_epi16(_mm_min_epi16(_m2, _i2),
-                                          _mm_srli_si128(_gap_open, 2))); // allow I->D
-        _d1 = _mm_insert_epi16(_mm_slli_si128(_d1, 2), inf, 0);
-        _i1 = _mm_add_epi16(_mm_min_epi16(_mm_add_epi16(_i2, _gap_extend),
-                                          _mm_add_epi16(_m2, _gap_open)),
-                            _nuc_prior);
-        
-        // S odd
-        // truth needs updating; target is current
-        const auto pos = bandSize + s / 2;
-        const char base {(pos < truth_len) ? truth[pos] : 'N'};
-        
-        _truthwin   = _mm_insert_epi16(_mm_srli_si128(_truthwin, 2), base,
-                                       bandSize - 1);
-        _truthnqual = _mm_insert_epi16(_mm_srli_si128(_truthnqual, 2), base == 'N' ? nScore : inf,
-                                       bandSize - 1);
-        _gap_open   = _mm_insert_epi16(_mm_srli_si128(_gap_open, 2),
-                                       gap_open[pos < truth_len ? pos : truth_len - 1] << 2,
-                                       bandSize - 1);
-        
-        _initmask  = _mm_slli_si128(_initmask, 2);
-        _initmask2 = _mm_slli_si128(_initmask2, 2);
-        
-        _m2 = _mm_min_epi16(_m2, _mm_min_epi16(_i2, _d2));
-        
-        if (s / 2 >= target_len) {
-            minscore = std::min(static_cast<short>(extract_epi16(_m2, s / 2 - target_len)), minscore);
-        }
-        
-        _m2 = _mm_add_epi16(_m2, _mm_min_epi16(_mm_andnot_si128(_mm_cmpeq_epi16(_targetwin, _truthwin),
-                                                                 _qualitieswin), _truthnqual));
-        _d2 = _mm_min_epi16(_mm_add_epi16(_d1, _gap_extend),
-                            _mm_add_epi16(_mm_min_epi16(_m1, _i1), _gap_open)); // allow I->D
-        _i2 = _mm_insert_epi16(_mm_add_epi16(_mm_min_epi16(_mm_add_epi16(_mm_srli_si128(_i1, 2),
-                                                                         _gap_extend),
-                                                           _mm_add_epi16(_mm_srli_si128(_m1, 2),
-                                                                         _gap_open)),
-                                             _nuc_prior), inf, bandSize - 1);
-        
-    }
-    
-    return (minscore + 0x8000) >> 2;
+    return dispatch_align(get_instruction_set(), truth, target, qualities, truth_len, target_len,
+                          gap_open, gap_extend, nuc_prior);
+}
+
+int align(const char* truth, const char* target, const std::int8_t* qualities,
+          const int truth_len, const int target_len,
+          const std::int8_t* gap_open, const short gap_extend, const short nuc_prior) noexcept
+{
+    return dispatch_align(get_instruction_set(), truth, target, qualities, truth_len, target_len,
+                          gap_open, gap_extend, nuc_prior);
 }
 
 int align(const char* truth, const char* target, const std::int8_t* qualities,
           const int truth_len, const int target_len,
           const std::int8_t* gap_open, const std::int8_t* gap_extend,
-          short nuc_prior) noexcept
+          const short nuc_prior) noexcept
 {
-    assert(truth_len > bandSize && (truth_len == target_len + 2 * bandSize - 1));
-    
-    nuc_prior <<= 2;
-    
-    using SimdInt = __m128i;
-    
-    SimdInt _m1 {_mm_set1_epi16(inf)};
-    auto _i1 = _m1;
-    auto _d1 = _m1;
-    auto _m2 = _m1;
-    auto _i2 = _m1;
-    auto _d2 = _m1;
-    
-    SimdInt _nuc_prior  {_mm_set1_epi16(nuc_prior)};
-    
-    SimdInt _initmask   {_mm_set_epi16(0,0,0,0,0,0,0,-1)};
-    SimdInt _initmask2  {_mm_set_epi16(0,0,0,0,0,0,0,-0x8000)};
-    
-    // truth is initialized with the n-long prefix, in forward direction
-    // target is initialized as empty; reverse direction
-    SimdInt _truthwin  {_mm_set_epi16(truth[7], truth[6], truth[5], truth[4],
-                                      truth[3], truth[2], truth[1], truth[0])};
-    SimdInt _targetwin  {_m1};
-    SimdInt _qualitieswin {_mm_set1_epi16(64 << 2)};
-    
-    // if N, make nScore; if != N, make inf
-    SimdInt _truthnqual {_mm_add_epi16(_mm_and_si128(_mm_cmpeq_epi16(_truthwin, _mm_set1_epi16('N')),
-                                                     _mm_set1_epi16(nScore - inf)),
-                                       _mm_set1_epi16(inf))};
-    
-    SimdInt _gap_open {_mm_set_epi16(gap_open[7] << 2,gap_open[6] << 2,gap_open[5] << 2,gap_open[4] << 2,
-                                     gap_open[3] << 2,gap_open[2] << 2,gap_open[1] << 2,gap_open[0] << 2)};
-    SimdInt _gap_extend {_mm_set_epi16(gap_extend[7] << 2,gap_extend[6] << 2,gap_extend[5] << 2,gap_extend[4] << 2,
-                                       gap_extend[3] << 2,gap_extend[2] << 2,gap_extend[1] << 2,gap_extend[0] << 2)};
-    
-    short minscore {inf};
-    
-    for (int s {0}; s <= 2 * (target_len + bandSize); s += 2) {
-        // truth is current; target needs updating
-        _targetwin    = _mm_slli_si128(_targetwin, 2);
-        _qualitieswin = _mm_slli_si128(_qualitieswin, 2);
-        
-        if (s / 2 < target_len) {
-            _targetwin    = _mm_insert_epi16(_targetwin, target[s / 2], 0);
-            _qualitieswin = _mm_insert_epi16(_qualitieswin, qualities[s / 2] << 2, 0);
-        } else {
-            _targetwin    = _mm_insert_epi16(_targetwin, '0', 0);
-            _qualitieswin = _mm_insert_epi16(_qualitieswin, 64 << 2, 0);
-        }
-        
-        // S even
-        _m1 = _mm_or_si128(_initmask2, _mm_andnot_si128(_initmask, _m1));
-        _m2 = _mm_or_si128(_initmask2, _mm_andnot_si128(_initmask, _m2));
-        _m1 = _mm_min_epi16(_m1, _mm_min_epi16(_i1, _d1));
-        
-        if (s / 2 >= target_len) {
-            minscore = std::min(static_cast<short>(extract_epi16(_m1, s / 2 - target_len)), minscore);
-        }
-        
-        _m1 = _mm_add_epi16(_m1, _mm_min_epi16(_mm_andnot_si128(_mm_cmpeq_epi16(_targetwin, _truthwin),
-                                                                _qualitieswin), _truthnqual));
-        _d1 = _mm_min_epi16(_mm_add_epi16(_d2, _gap_extend),
-                            _mm_add_epi16(_mm_min_epi16(_m2, _i2),
-                                          _mm_srli_si128(_gap_open, 2))); // allow I->D
-        _d1 = _mm_insert_epi16(_mm_slli_si128(_d1, 2), inf, 0);
-        _i1 = _mm_add_epi16(_mm_min_epi16(_mm_add_epi16(_i2, _gap_extend),
-                                          _mm_add_epi16(_m2, _gap_open)),
-                            _nuc_prior);
-        
-        // S odd; truth needs updating; target is current
-        const auto pos = bandSize + s / 2;
-        const char base {(pos < truth_len) ? truth[pos] : 'N'};
-        _truthwin   = _mm_insert_epi16(_mm_srli_si128(_truthwin, 2), base, bandSize - 1);
-        _truthnqual = _mm_insert_epi16(_mm_srli_si128(_truthnqual, 2), base == 'N' ? nScore : inf, bandSize - 1);
-        const auto gap_idx = pos < truth_len ? pos : truth_len - 1;
-        _gap_open   = _mm_insert_epi16(_mm_srli_si128(_gap_open, 2), gap_open[gap_idx] << 2, bandSize - 1);
-        _gap_extend = _mm_insert_epi16(_mm_srli_si128(_gap_extend, 2), gap_extend[gap_idx] << 2, bandSize - 1);
-        
-        _initmask  = _mm_slli_si128(_initmask, 2);
-        _initmask2 = _mm_slli_si128(_initmask2, 2);
-        
-        _m2 = _mm_min_epi16(_m2, _mm_min_epi16(_i2, _d2));
-        
-        if (s / 2 >= target_len) {
-            minscore = std::min(static_cast<short>(extract_epi16(_m2, s / 2 - target_len)), minscore);
-        }
-        
-        _m2 = _mm_add_epi16(_m2, _mm_min_epi16(_mm_andnot_si128(_mm_cmpeq_epi16(_targetwin, _truthwin),
-                                                                _qualitieswin), _truthnqual));
-        _d2 = _mm_min_epi16(_mm_add_epi16(_d1, _gap_extend),
-                            _mm_add_epi16(_mm_min_epi16(_m1, _i1), _gap_open)); // allow I->D
-        _i2 = _mm_insert_epi16(_mm_add_epi16(_mm_min_epi16(_mm_add_epi16(_mm_srli_si128(_i1, 2),
-                                                                         _gap_extend),
-                                                           _mm_add_epi16(_mm_srli_si128(_m1, 2),
-                                                                         _gap_open)),
-                                             _nuc_prior), inf, bandSize - 1);
-        
-    }
-    
-    return (minscore + 0x8000) >> 2;
+    return dispatch_align(get_instruction_set(), truth, target, qualities, truth_len, target_len,
+                          gap_open, gap_extend, nuc_prior);
 }
 
 int align(const char* truth, const char* target, const std::int8_t* qualities,
           const int truth_len, const int target_len,
           const std::int8_t* gap_open, const std::int8_t* gap_extend,
-          short nuc_prior,
+          const short nuc_prior,
           int& first_pos, char* aln1, char* aln2) noexcept
 {
-    using SimdInt = __m128i;
-    
-    assert(truth_len > bandSize && (truth_len == target_len + 2 * bandSize - 1));
-    
-    constexpr int matchLabel  {0};
-    constexpr int insertLabel {1};
-    constexpr int deleteLabel {3};
-    static const SimdInt _three {_mm_set1_epi16(3)};
-    
-    nuc_prior <<= 2;
-    
-    SimdInt _m1 {_mm_set1_epi16(inf)};
-    auto _i1 = _m1;
-    auto _d1 = _m1;
-    auto _m2 = _m1;
-    auto _i2 = _m1;
-    auto _d2 = _m1;
-    
-    SimdInt _nuc_prior  {_mm_set1_epi16(nuc_prior)};
-    
-    SimdInt _initmask   {_mm_set_epi16(0,0,0,0,0,0,0,-1)};
-    SimdInt _initmask2  {_mm_set_epi16(0,0,0,0,0,0,0,-0x8000)};
-    
-    // truth is initialized with the n-long prefix, in forward direction
-    // target is initialized as empty; reverse direction
-    SimdInt _truthwin  {_mm_set_epi16(truth[7], truth[6], truth[5], truth[4],
-                                      truth[3], truth[2], truth[1], truth[0])};
-    SimdInt _targetwin  {_m1};
-    SimdInt _qualitieswin {_mm_set1_epi16(64 << 2)};
-    
-    // if N, make nScore; if != N, make inf
-    SimdInt _truthnqual {_mm_add_epi16(_mm_and_si128(_mm_cmpeq_epi16(_truthwin, _mm_set1_epi16('N')),
-                                                     _mm_set1_epi16(nScore - inf)),
-                                       _mm_set1_epi16(inf))};
-    
-    SimdInt _gap_open {_mm_set_epi16(gap_open[7] << 2,gap_open[6] << 2,gap_open[5] << 2,gap_open[4] << 2,
-                                     gap_open[3] << 2,gap_open[2] << 2,gap_open[1] << 2,gap_open[0] << 2)};
-    SimdInt _gap_extend {_mm_set_epi16(gap_extend[7] << 2,gap_extend[6] << 2,gap_extend[5] << 2,gap_extend[4] << 2,
-                                       gap_extend[3] << 2,gap_extend[2] << 2,gap_extend[1] << 2,gap_extend[0] << 2)};
-    
-    SmallVector<SimdInt> _backpointers(2 * (truth_len + bandSize));
-    
-    short cur_score {0}, minscore {inf}, minscoreidx {-1};
-    
-    int s {0};
-    for (; s <= 2 * (target_len + bandSize); s += 2) {
-        // truth is current; target needs updating
-        _targetwin    = _mm_slli_si128(_targetwin, 2);
-        _qualitieswin = _mm_slli_si128(_qualitieswin, 2);
-        
-        if (s / 2 < target_len) {
-            _targetwin    = _mm_insert_epi16(_targetwin, target[s / 2], 0);
-            _qualitieswin = _mm_insert_epi16(_qualitieswin, qualities[s / 2] << 2, 0);
-        } else {
-            _targetwin    = _mm_insert_epi16(_targetwin, '0', 0);
-            _qualitieswin = _mm_insert_epi16(_qualitieswin, 64 << 2, 0);
-        }
-        
-        // S even
-        _m1 = _mm_or_si128(_initmask2, _mm_andnot_si128(_initmask, _m1));
-        _m2 = _mm_or_si128(_initmask2, _mm_andnot_si128(_initmask, _m2));
-        _m1 = _mm_min_epi16(_m1, _mm_min_epi16(_i1, _d1));
-        
-        if (s / 2 >= target_len) {
-            cur_score = extract_epi16(_m1, s / 2 - target_len);
-            if (cur_score < minscore) {
-                minscore = cur_score;
-                minscoreidx = s;     // point back to the match state at this entry, so as not to
-            }                        // have to store the state at s-2
-        }
-        
-        _m1 = _mm_add_epi16(_m1, _mm_min_epi16(_mm_andnot_si128(_mm_cmpeq_epi16(_targetwin, _truthwin),
-                                                                _qualitieswin), _truthnqual));
-        _d1 = _mm_min_epi16(_mm_add_epi16(_d2, _gap_extend),
-                            _mm_add_epi16(_mm_min_epi16(_m2, _i2),
-                                          _mm_srli_si128(_gap_open, 2))); // allow I->D
-        _d1 = _mm_insert_epi16(_mm_slli_si128(_d1, 2), inf, 0);
-        _i1 = _mm_add_epi16(_mm_min_epi16(_mm_add_epi16(_i2, _gap_extend),
-                                          _mm_add_epi16(_m2, _gap_open)),
-                            _nuc_prior);
-    
-        _backpointers[s] = _mm_or_si128(_mm_or_si128(_mm_and_si128(_three, _m1),
-                                                     _mm_slli_epi16(_mm_and_si128(_three, _i1),
-                                                                    2 * insertLabel)),
-                                        _mm_slli_epi16(_mm_and_si128(_three, _d1), 2 * deleteLabel));
-        // set state labels
-        _m1 = _mm_andnot_si128(_three, _m1);
-        _i1 = _mm_or_si128(_mm_andnot_si128(_three, _i1), _mm_srli_epi16(_three, 1));
-        _d1 = _mm_or_si128(_mm_andnot_si128(_three, _d1), _three);
-        
-        // S odd; truth needs updating; target is current
-        const auto pos = bandSize + s / 2;
-        const char base {(pos < truth_len) ? truth[pos] : 'N'};
-        _truthwin   = _mm_insert_epi16(_mm_srli_si128(_truthwin, 2), base, bandSize - 1);
-        _truthnqual = _mm_insert_epi16(_mm_srli_si128(_truthnqual, 2), base == 'N' ? nScore : inf, bandSize - 1);
-        const auto gap_idx = pos < truth_len ? pos : truth_len - 1;
-        _gap_open   = _mm_insert_epi16(_mm_srli_si128(_gap_open, 2), gap_open[gap_idx] << 2, bandSize - 1);
-        _gap_extend = _mm_insert_epi16(_mm_srli_si128(_gap_extend, 2), gap_extend[gap_idx] << 2, bandSize - 1);
-        
-        _initmask  = _mm_slli_si128(_initmask, 2);
-        _initmask2 = _mm_slli_si128(_initmask2, 2);
-        
-        _m2 = _mm_min_epi16(_m2, _mm_min_epi16(_i2, _d2));
-        
-        if (s / 2 >= target_len) {
-            cur_score = extract_epi16(_m2, s / 2 - target_len);
-            if (cur_score < minscore) {
-                minscore = cur_score;
-                minscoreidx = s + 1;
-            }
-        }
-        
-        _m2 = _mm_add_epi16(_m2, _mm_min_epi16(_mm_andnot_si128(_mm_cmpeq_epi16(_targetwin, _truthwin),
-                                                                _qualitieswin), _truthnqual));
-        _d2 = _mm_min_epi16(_mm_add_epi16(_d1, _gap_extend),
-                            _mm_add_epi16(_mm_min_epi16(_m1, _i1), _gap_open)); // allow I->D
-        _i2 = _mm_insert_epi16(_mm_add_epi16(_mm_min_epi16(_mm_add_epi16(_mm_srli_si128(_i1, 2),
-                                                                         _gap_extend),
-                                                           _mm_add_epi16(_mm_srli_si128(_m1, 2),
-                                                                         _gap_open)),
-                                             _nuc_prior), inf, bandSize - 1);
-        
-        _backpointers[s + 1] = _mm_or_si128(_mm_or_si128(_mm_and_si128(_three, _m2),
-                                                         _mm_slli_epi16(_mm_and_si128(_three, _i2), 2 * insertLabel)),
-                                            _mm_slli_epi16(_mm_and_si128(_three, _d2), 2 * deleteLabel));
-        // set state labels
-        _m2 = _mm_andnot_si128(_three, _m2);
-        _i2 = _mm_or_si128(_mm_andnot_si128(_three, _i2), _mm_srli_epi16(_three, 1));
-        _d2 = _mm_or_si128(_mm_andnot_si128(_three, _d2), _three);
-    }
-    
-    if (minscoreidx < 0) {
-        // minscore was never updated so we must have overflowed badly
-        first_pos = -1;
-        return -1;
-    }
-    
-    s = minscoreidx;    // point to the dummy match transition
-    
-    auto i      = s / 2 - target_len;
-    auto y      = target_len;
-    auto x      = s - y;
-    auto alnidx = 0;
-    
-    auto ptr = reinterpret_cast<short*>(_backpointers.data() + s);
-    if ((ptr + i) < reinterpret_cast<short*>(_backpointers.data())
-        || (ptr + i) >= reinterpret_cast<short*>(_backpointers.data() + _backpointers.size())) {
-        first_pos = -1;
-        return -1;
-    }
-    auto state = (ptr[i] >> (2 * matchLabel)) & 3;
-    
-    s -= 2;
-    
-    // this is 2*y (s even) or 2*y+1 (s odd)
-    while (y > 0) {
-        if (s < 0 || i < 0) {
-            // This should never happen so must have overflowed
-            first_pos = -1;
-            return -1;
-        }
-        const auto new_state = (reinterpret_cast<short*>(_backpointers.data() + s)[i] >> (2 * state)) & 3;
-        if (state == matchLabel) {
-            s -= 2;
-            aln1[alnidx] = truth[--x];
-            aln2[alnidx] = target[--y];
-        } else if (state == insertLabel) {
-            i += s & 1;
-            s -= 1;
-            aln1[alnidx] = gap;
-            aln2[alnidx] = target[--y];
-        } else {
-            s -= 1;
-            i -= s & 1;
-            aln1[alnidx] = truth[--x];
-            aln2[alnidx] = gap;
-        }
-        state = new_state;
-        alnidx++;
-    }
-    aln1[alnidx] = 0;
-    aln2[alnidx] = 0;
-    first_pos = x;
-    // reverse them
-    for (int j {alnidx - 1}, i = 0; i < j; ++i, j--) {
-        x = aln1[i];
-        y = aln2[i];
-        aln1[i] = aln1[j];
-        aln2[i] = aln2[j];
-        aln1[j] = x;
-        aln2[j] = y;
-    }
-    return (minscore + 0x8000) >> 2;
+    return dispatch_align(get_instruction_set(), truth, target, qualities, truth_len, target_len,
+                          gap_open, gap_extend, nuc_prior, first_pos, aln1, aln2);
 }
 
 int align(const char* truth, const char* target, const std::int8_t* qualities,
           const int truth_len, const int target_len,
           const char* snv_mask, const std::int8_t* snv_prior,
-          const std::int8_t* gap_open, short gap_extend, short nuc_prior) noexcept
+          const std::int8_t* gap_open, const short gap_extend, const short nuc_prior) noexcept
 {
-    assert(truth_len > bandSize && (truth_len == target_len + 2 * bandSize - 1));
-    
-    gap_extend <<= 2;
-    nuc_prior <<= 2;
-    
-    using SimdInt = __m128i;
-    
-    SimdInt _m1 {_mm_set1_epi16(inf)};
-    auto _i1 = _m1;
-    auto _d1 = _m1;
-    auto _m2 = _m1;
-    auto _i2 = _m1;
-    auto _d2 = _m1;
-    
-    SimdInt _gap_extend {_mm_set1_epi16(gap_extend)};
-    SimdInt _nuc_prior  {_mm_set1_epi16(nuc_prior)};
-    SimdInt _initmask   {_mm_set_epi16(0,0,0,0,0,0,0,-1)};
-    SimdInt _initmask2  {_mm_set_epi16(0,0,0,0,0,0,0,-0x8000)};
-    
-    SimdInt _truthwin  {_mm_set_epi16(truth[7], truth[6], truth[5], truth[4],
-                                      truth[3], truth[2], truth[1], truth[0])};
-    SimdInt _targetwin  {_m1};
-    SimdInt _qualitieswin {_mm_set1_epi16(64 << 2)};
-    
-    SimdInt _snvmaskwin  {_mm_set_epi16(snv_mask[7], snv_mask[6], snv_mask[5], snv_mask[4],
-                                        snv_mask[3], snv_mask[2], snv_mask[1], snv_mask[0])};
-    SimdInt _snv_priorwin {_mm_set_epi16(snv_prior[7] << 2, snv_prior[6] << 2, snv_prior[5] << 2, snv_prior[4] << 2,
-                                         snv_prior[3] << 2, snv_prior[2] << 2, snv_prior[1] << 2, snv_prior[0] << 2)};
-    
-    SimdInt _snvmask;
-    
-    // if N, make nScore; if != N, make inf
-    SimdInt _truthnqual {_mm_add_epi16(_mm_and_si128(_mm_cmpeq_epi16(_truthwin, _mm_set1_epi16('N')),
-                                                     _mm_set1_epi16(nScore - inf)),
-                                       _mm_set1_epi16(inf))};
-    
-    SimdInt _gap_open {_mm_set_epi16(gap_open[7] << 2,gap_open[6] << 2,gap_open[5] << 2,gap_open[4] << 2,
-                                     gap_open[3] << 2,gap_open[2] << 2,gap_open[1] << 2,gap_open[0] << 2)};
-    
-    short minscore {inf};
-    
-    for (int s {0}; s <= 2 * (target_len + bandSize); s += 2) {
-        // truth is current; target needs updating
-        _targetwin    = _mm_slli_si128(_targetwin, 2);
-        _qualitieswin = _mm_slli_si128(_qualitieswin, 2);
-        
-        if (s / 2 < target_len) {
-            _targetwin    = _mm_insert_epi16(_targetwin, target[s / 2], 0);
-            _qualitieswin = _mm_insert_epi16(_qualitieswin, qualities[s / 2] << 2, 0);
-        } else {
-            _targetwin    = _mm_insert_epi16(_targetwin, '0', 0);
-            _qualitieswin = _mm_insert_epi16(_qualitieswin, 64 << 2, 0);
-        }
-        
-        // S even
-        
-        _m1 = _mm_or_si128(_initmask2, _mm_andnot_si128(_initmask, _m1));
-        _m2 = _mm_or_si128(_initmask2, _mm_andnot_si128(_initmask, _m2));
-        _m1 = _mm_min_epi16(_m1, _mm_min_epi16(_i1, _d1));
-        
-        if (s / 2 >= target_len) {
-            minscore = std::min(static_cast<short>(extract_epi16(_m1, s / 2 - target_len)), minscore);
-        }
-        
-        _snvmask = _mm_cmpeq_epi16(_targetwin, _snvmaskwin);
-        
-        _m1 = _mm_add_epi16(_m1, _mm_min_epi16(_mm_andnot_si128(_mm_cmpeq_epi16(_targetwin, _truthwin),
-                                                                 _mm_min_epi16(_qualitieswin,
-                                                                               _mm_or_si128(_mm_and_si128(_snvmask, _snv_priorwin),
-                                                                                            _mm_andnot_si128(_snvmask, _qualitieswin)))),
-                                               _truthnqual));
-        _d1 = _mm_min_epi16(_mm_add_epi16(_d2, _gap_extend),
-                            _mm_add_epi16(_mm_min_epi16(_m2, _i2),
-                                          _mm_srli_si128(_gap_open, 2))); // allow I->D
-        _d1 = _mm_insert_epi16(_mm_slli_si128(_d1, 2), inf, 0);
-        _i1 = _mm_add_epi16(_mm_min_epi16(_mm_add_epi16(_i2, _gap_extend),
-                                          _mm_add_epi16(_m2, _gap_open)),
-                            _nuc_prior);
-        
-        // S odd
-        // truth needs updating; target is current
-        const auto pos = bandSize + s / 2;
-        const char base {pos < truth_len ? truth[pos] : 'N'};
-        
-        _truthwin     = _mm_insert_epi16(_mm_srli_si128(_truthwin, 2),
-                                         base,
-                                         bandSize - 1);
-        _truthnqual   = _mm_insert_epi16(_mm_srli_si128(_truthnqual, 2),
-                                         base == 'N' ? nScore : inf,
-                                         bandSize - 1);
-        _snvmaskwin   = _mm_insert_epi16(_mm_srli_si128(_snvmaskwin, 2),
-                                         pos < truth_len ? snv_mask[pos] : 'N',
-                                         bandSize - 1);
-        _snv_priorwin = _mm_insert_epi16(_mm_srli_si128(_snv_priorwin, 2),
-                                         (pos < truth_len ? snv_prior[pos] : inf) << 2,
-                                         bandSize - 1);
-        _gap_open     = _mm_insert_epi16(_mm_srli_si128(_gap_open, 2),
-                                         gap_open[pos < truth_len ? pos : truth_len - 1] << 2,
-                                         bandSize - 1);
-        
-        _initmask  = _mm_slli_si128(_initmask, 2);
-        _initmask2 = _mm_slli_si128(_initmask2, 2);
-        
-        _m2 = _mm_min_epi16(_m2, _mm_min_epi16(_i2, _d2));
-        
-        if (s / 2 >= target_len) {
-            minscore = std::min(static_cast<short>(extract_epi16(_m2, s / 2 - target_len)), minscore);
-        }
-        
-        _snvmask = _mm_cmpeq_epi16(_targetwin, _snvmaskwin);
-        
-        _m2 = _mm_add_epi16(_m2, _mm_min_epi16(_mm_andnot_si128(_mm_cmpeq_epi16(_targetwin, _truthwin),
-                                                                _mm_min_epi16(_qualitieswin,
-                                                                              _mm_or_si128(_mm_and_si128(_snvmask, _snv_priorwin),
-                                                                                           _mm_andnot_si128(_snvmask, _qualitieswin)))),
-                                               _truthnqual));
-        _d2 = _mm_min_epi16(_mm_add_epi16(_d1, _gap_extend),
-                            _mm_add_epi16(_mm_min_epi16(_m1, _i1), _gap_open)); // allow I->D
-        _i2 = _mm_insert_epi16(_mm_add_epi16(_mm_min_epi16(_mm_add_epi16(_mm_srli_si128(_i1, 2),
-                                                                         _gap_extend),
-                                                           _mm_add_epi16(_mm_srli_si128(_m1, 2),
-                                                                         _gap_open)),
-                                             _nuc_prior), inf, bandSize - 1);
-    }
-    
-    return (minscore + 0x8000) >> 2;
+    return dispatch_align(get_instruction_set(), truth, target, qualities, truth_len, target_len,
+                          snv_mask, snv_prior, gap_open, gap_extend, nuc_prior);
 }
 
 int align(const char* truth, const char* target, const std::int8_t* qualities,
-          int truth_len, int target_len,
+          const int truth_len, const int target_len,
           const char* snv_mask, const std::int8_t* snv_prior,
           const std::int8_t* gap_open, const std::int8_t* gap_extend,
-          short nuc_prior) noexcept
+          const short nuc_prior) noexcept
 {
-    assert(truth_len > bandSize && (truth_len == target_len + 2 * bandSize - 1));
-    
-    nuc_prior <<= 2;
-    
-    using SimdInt = __m128i;
-    
-    SimdInt _m1 {_mm_set1_epi16(inf)};
-    auto _i1 = _m1;
-    auto _d1 = _m1;
-    auto _m2 = _m1;
-    auto _i2 = _m1;
-    auto _d2 = _m1;
-    
-    SimdInt _nuc_prior  {_mm_set1_epi16(nuc_prior)};
-    SimdInt _initmask   {_mm_set_epi16(0,0,0,0,0,0,0,-1)};
-    SimdInt _initmask2  {_mm_set_epi16(0,0,0,0,0,0,0,-0x8000)};
-    
-    SimdInt _truthwin  {_mm_set_epi16(truth[7], truth[6], truth[5], truth[4],
-                                      truth[3], truth[2], truth[1], truth[0])};
-    SimdInt _targetwin  {_m1};
-    SimdInt _qualitieswin {_mm_set1_epi16(64 << 2)};
-    
-    SimdInt _snvmaskwin  {_mm_set_epi16(snv_mask[7], snv_mask[6], snv_mask[5], snv_mask[4],
-                                        snv_mask[3], snv_mask[2], snv_mask[1], snv_mask[0])};
-    SimdInt _snv_priorwin {_mm_set_epi16(snv_prior[7] << 2, snv_prior[6] << 2, snv_prior[5] << 2, snv_prior[4] << 2,
-                                         snv_prior[3] << 2, snv_prior[2] << 2, snv_prior[1] << 2, snv_prior[0] << 2)};
-    
-    SimdInt _snvmask;
-    
-    // if N, make nScore; if != N, make inf
-    SimdInt _truthnqual {_mm_add_epi16(_mm_and_si128(_mm_cmpeq_epi16(_truthwin, _mm_set1_epi16('N')),
-                                                     _mm_set1_epi16(nScore - inf)),
-                                       _mm_set1_epi16(inf))};
-    
-    SimdInt _gap_open {_mm_set_epi16(gap_open[7] << 2,gap_open[6] << 2,gap_open[5] << 2,gap_open[4] << 2,
-                                     gap_open[3] << 2,gap_open[2] << 2,gap_open[1] << 2,gap_open[0] << 2)};
-    SimdInt _gap_extend {_mm_set_epi16(gap_extend[7] << 2,gap_extend[6] << 2,gap_extend[5] << 2,gap_extend[4] << 2,
-                                       gap_extend[3] << 2,gap_extend[2] << 2,gap_extend[1] << 2,gap_extend[0] << 2)};
-    
-    short minscore {inf};
-    
-    for (int s {0}; s <= 2 * (target_len + bandSize); s += 2) {
-        // truth is current; target needs updating
-        _targetwin    = _mm_slli_si128(_targetwin, 2);
-        _qualitieswin = _mm_slli_si128(_qualitieswin, 2);
-        
-        if (s / 2 < target_len) {
-            _targetwin    = _mm_insert_epi16(_targetwin, target[s / 2], 0);
-            _qualitieswin = _mm_insert_epi16(_qualitieswin, qualities[s / 2] << 2, 0);
-        } else {
-            _targetwin    = _mm_insert_epi16(_targetwin, '0', 0);
-            _qualitieswin = _mm_insert_epi16(_qualitieswin, 64 << 2, 0);
-        }
-        
-        // S even
-        
-        _m1 = _mm_or_si128(_initmask2, _mm_andnot_si128(_initmask, _m1));
-        _m2 = _mm_or_si128(_initmask2, _mm_andnot_si128(_initmask, _m2));
-        _m1 = _mm_min_epi16(_m1, _mm_min_epi16(_i1, _d1));
-        
-        if (s / 2 >= target_len) {
-            minscore = std::min(static_cast<short>(extract_epi16(_m1, s / 2 - target_len)), minscore);
-        }
-        
-        _snvmask = _mm_cmpeq_epi16(_targetwin, _snvmaskwin);
-        
-        _m1 = _mm_add_epi16(_m1, _mm_min_epi16(_mm_andnot_si128(_mm_cmpeq_epi16(_targetwin, _truthwin),
-                                                                _mm_min_epi16(_qualitieswin,
-                                                                              _mm_or_si128(_mm_and_si128(_snvmask, _snv_priorwin),
-                                                                                           _mm_andnot_si128(_snvmask, _qualitieswin)))),
-                                               _truthnqual));
-        _d1 = _mm_min_epi16(_mm_add_epi16(_d2, _gap_extend),
-                            _mm_add_epi16(_mm_min_epi16(_m2, _i2),
-                                          _mm_srli_si128(_gap_open, 2))); // allow I->D
-        _d1 = _mm_insert_epi16(_mm_slli_si128(_d1, 2), inf, 0);
-        _i1 = _mm_add_epi16(_mm_min_epi16(_mm_add_epi16(_i2, _gap_extend),
-                                          _mm_add_epi16(_m2, _gap_open)),
-                            _nuc_prior);
-        
-        // S odd
-        // truth needs updating; target is current
-        const auto pos = bandSize + s / 2;
-        const char base {pos < truth_len ? truth[pos] : 'N'};
-        
-        _truthwin     = _mm_insert_epi16(_mm_srli_si128(_truthwin, 2),
-                                         base,
-                                         bandSize - 1);
-        _truthnqual   = _mm_insert_epi16(_mm_srli_si128(_truthnqual, 2),
-                                         base == 'N' ? nScore : inf,
-                                         bandSize - 1);
-        _snvmaskwin   = _mm_insert_epi16(_mm_srli_si128(_snvmaskwin, 2),
-                                         pos < truth_len ? snv_mask[pos] : 'N',
-                                         bandSize - 1);
-        _snv_priorwin = _mm_insert_epi16(_mm_srli_si128(_snv_priorwin, 2),
-                                         (pos < truth_len ? snv_prior[pos] : inf) << 2,
-                                         bandSize - 1);
-        const auto gap_idx = pos < truth_len ? pos : truth_len - 1;
-        _gap_open     = _mm_insert_epi16(_mm_srli_si128(_gap_open, 2), gap_open[gap_idx] << 2, bandSize - 1);
-        _gap_extend = _mm_insert_epi16(_mm_srli_si128(_gap_extend, 2), gap_extend[gap_idx] << 2, bandSize - 1);
-        
-        _initmask  = _mm_slli_si128(_initmask, 2);
-        _initmask2 = _mm_slli_si128(_initmask2, 2);
-        
-        _m2 = _mm_min_epi16(_m2, _mm_min_epi16(_i2, _d2));
-        
-        if (s / 2 >= target_len) {
-            minscore = std::min(static_cast<short>(extract_epi16(_m2, s / 2 - target_len)), minscore);
-        }
-        
-        _snvmask = _mm_cmpeq_epi16(_targetwin, _snvmaskwin);
-        
-        _m2 = _mm_add_epi16(_m2, _mm_min_epi16(_mm_andnot_si128(_mm_cmpeq_epi16(_targetwin, _truthwin),
-                                                                _mm_min_epi16(_qualitieswin,
-                                                                              _mm_or_si128(_mm_and_si128(_snvmask, _snv_priorwin),
-                                                                                           _mm_andnot_si128(_snvmask, _qualitieswin)))),
-                                               _truthnqual));
-        _d2 = _mm_min_epi16(_mm_add_epi16(_d1, _gap_extend),
-                            _mm_add_epi16(_mm_min_epi16(_m1, _i1), _gap_open)); // allow I->D
-        _i2 = _mm_insert_epi16(_mm_add_epi16(_mm_min_epi16(_mm_add_epi16(_mm_srli_si128(_i1, 2),
-                                                                         _gap_extend),
-                                                           _mm_add_epi16(_mm_srli_si128(_m1, 2),
-                                                                         _gap_open)),
-                                             _nuc_prior), inf, bandSize - 1);
-    }
-    
-    return (minscore + 0x8000) >> 2;
+    return dispatch_align(get_instruction_set(), truth, target, qualities, truth_len, target_len,
+                          snv_mask, snv_prior, gap_open, gap_extend, nuc_prior);
 }
 
 int align(const char* truth, const char* target, const std::int8_t* qualities,
           const int truth_len, const int target_len,
-          const std::int8_t* gap_open, short gap_extend, short nuc_prior,
+          const std::int8_t* gap_open, const short gap_extend, const short nuc_prior,
           int& first_pos, char* aln1, char* aln2) noexcept
 {
-    // target is the read; the shorter of the sequences
-    // no checks for overflow are done
-    
-    // the bottom-left and top-right corners of the DP table are just
-    // included at the extreme ends of the diagonal, which measures
-    // n=8 entries diagonally across.  This fixes the length of the
-    // longer (horizontal) sequence to 15 (2*8-1) more than the shorter
-    
-    assert(truth_len > bandSize && (truth_len == target_len + 2 * bandSize - 1));
-    assert(aln1 != nullptr && aln2 != nullptr);
-    
-    gap_extend <<= 2;
-    nuc_prior <<= 2;
-    
-    constexpr int matchLabel  {0};
-    constexpr int insertLabel {1};
-    constexpr int deleteLabel {3};
-    
-    using SimdInt = __m128i;
-    
-    SimdInt _m1 {_mm_set1_epi16(inf)};
-    auto _i1 = _m1;
-    auto _d1 = _m1;
-    auto _m2 = _m1;
-    auto _i2 = _m1;
-    auto _d2 = _m1;
-    
-    SimdInt _gap_extend {_mm_set1_epi16(gap_extend)};
-    SimdInt _nuc_prior  {_mm_set1_epi16(nuc_prior)};
-    SimdInt _initmask   {_mm_set_epi16(0,0,0,0,0,0,0,-1)};
-    SimdInt _initmask2  {_mm_set_epi16(0,0,0,0,0,0,0,-0x8000)};
-    
-    static const SimdInt _three {_mm_set1_epi16(3)};
-    SmallVector<SimdInt> _backpointers(2 * (truth_len + bandSize));
-    
-    // sequence 1 is initialized with the n-long prefix, in forward direction
-    // sequence 2 is initialized as empty; reverse direction
-    SimdInt _truthwin  {_mm_set_epi16(truth[7], truth[6], truth[5], truth[4],
-                                      truth[3], truth[2], truth[1], truth[0])};
-    SimdInt _targetwin  {_m1};
-    SimdInt _qualitieswin {_mm_set1_epi16(64 << 2)};
-    
-    // if N, make nScore; if != N, make inf
-    SimdInt _truthnqual {_mm_add_epi16(_mm_and_si128(_mm_cmpeq_epi16(_truthwin, _mm_set1_epi16('N')),
-                                                     _mm_set1_epi16(nScore - inf)),
-                                       _mm_set1_epi16(inf))};
-    
-    SimdInt _gap_open {_mm_set_epi16(gap_open[7] << 2,gap_open[6] << 2,gap_open[5] << 2,gap_open[4] << 2,
-                                     gap_open[3] << 2,gap_open[2] << 2,gap_open[1] << 2,gap_open[0] << 2)};
-    
-    short cur_score {0}, minscore {inf}, minscoreidx {-1};
-    
-    // main loop.  Do one extra iteration, with nucs from sequence 2 just moved out
-    // of the targetwin/qual arrays, to simplify getting back pointers
-    int s;
-    for (s = 0; s <= 2 * (target_len + bandSize); s += 2) {
-        // truth is current; target needs updating
-        _targetwin    = _mm_slli_si128(_targetwin, 2);
-        _qualitieswin = _mm_slli_si128(_qualitieswin, 2);
-        
-        if (s / 2 < target_len) {
-            _targetwin    = _mm_insert_epi16(_targetwin, target[s / 2], 0);
-            _qualitieswin = _mm_insert_epi16(_qualitieswin, qualities[s / 2] << 2, 0);
-        } else {
-            _targetwin    = _mm_insert_epi16(_targetwin, '0', 0);
-            _qualitieswin = _mm_insert_epi16(_qualitieswin, 64 << 2, 0);
-        }
-        
-        // S even
-        _m1 = _mm_or_si128(_initmask2, _mm_andnot_si128(_initmask, _m1));
-        _m2 = _mm_or_si128(_initmask2, _mm_andnot_si128(_initmask, _m2));
-        _m1 = _mm_min_epi16(_m1, _mm_min_epi16(_i1, _d1));
-        
-        if (s / 2 >= target_len) {
-            cur_score = extract_epi16(_m1, s / 2 - target_len);
-            if (cur_score < minscore) {
-                minscore = cur_score;
-                minscoreidx = s;     // point back to the match state at this entry, so as not to
-            }                        // have to store the state at s-2
-        }
-        
-        _m1 = _mm_add_epi16(_m1, _mm_min_epi16(_mm_andnot_si128(_mm_cmpeq_epi16(_targetwin, _truthwin),
-                                                                _qualitieswin), _truthnqual));
-        _d1 = _mm_min_epi16(_mm_add_epi16(_d2, _gap_extend),
-                            _mm_add_epi16(_mm_min_epi16(_m2, _i2),
-                                          _mm_srli_si128(_gap_open, 2))); // allow I->D
-        _d1 = _mm_insert_epi16(_mm_slli_si128(_d1, 2), inf, 0);
-        _i1 = _mm_add_epi16(_mm_min_epi16(_mm_add_epi16(_i2, _gap_extend),
-                                          _mm_add_epi16(_m2, _gap_open)), _nuc_prior);
-        
-        _backpointers[s] = _mm_or_si128(_mm_or_si128(_mm_and_si128(_three, _m1),
-                                                     _mm_slli_epi16(_mm_and_si128(_three, _i1), 2 * insertLabel)),
-                                        _mm_slli_epi16(_mm_and_si128(_three, _d1), 2 * deleteLabel));
-        
-        // set state labels
-        _m1 = _mm_andnot_si128(_three, _m1);
-        _i1 = _mm_or_si128(_mm_andnot_si128(_three, _i1), _mm_srli_epi16(_three, 1));
-        _d1 = _mm_or_si128(_mm_andnot_si128(_three, _d1), _three);
-        
-        // S odd
-        
-        // truth needs updating; target is current
-        const char c {(bandSize + s / 2 < truth_len) ? truth[bandSize + (s / 2)] : 'N'};
-        
-        _truthwin   = _mm_insert_epi16(_mm_srli_si128(_truthwin,   2), c, bandSize - 1);
-        _truthnqual = _mm_insert_epi16(_mm_srli_si128(_truthnqual, 2), (c == 'N') ? nScore : inf, bandSize - 1);
-        _gap_open   = _mm_insert_epi16(_mm_srli_si128(_gap_open,  2),
-                                       gap_open[bandSize + s / 2 < truth_len ? bandSize + s / 2 : truth_len - 1] << 2, bandSize - 1);
-        _initmask  = _mm_slli_si128(_initmask, 2);
-        _initmask2 = _mm_slli_si128(_initmask2, 2);
-        _m2 = _mm_min_epi16(_m2, _mm_min_epi16(_i2, _d2));
-        
-        // at this point, extract minimum score.  Referred-to position must
-        // be y==target_len-1, so that current position has y==target_len; i==0 so d=0 and y=s/2
-        if (s / 2 >= target_len) {
-            cur_score = extract_epi16(_m2, s / 2 - target_len);
-            if (cur_score < minscore) {
-                minscore = cur_score;
-                minscoreidx = s + 1;
-            }
-        }
-        
-        _m2 = _mm_add_epi16(_m2, _mm_min_epi16(_mm_andnot_si128(_mm_cmpeq_epi16(_targetwin, _truthwin), _qualitieswin),
-                                               _truthnqual));
-        _d2 = _mm_min_epi16(_mm_add_epi16(_d1, _gap_extend),
-                            _mm_add_epi16(_mm_min_epi16(_m1, _i1),  // allow I->D
-                                          _gap_open));
-        _i2 = _mm_insert_epi16(_mm_add_epi16(_mm_min_epi16(_mm_add_epi16(_mm_srli_si128(_i1, 2), _gap_extend),
-                                                           _mm_add_epi16(_mm_srli_si128(_m1, 2), _gap_open)),
-                                             _nuc_prior),
-                               inf, bandSize - 1);
-        _backpointers[s + 1] = _mm_or_si128(_mm_or_si128(_mm_and_si128(_three, _m2),
-                                                         _mm_slli_epi16(_mm_and_si128(_three, _i2), 2 * insertLabel)),
-                                            _mm_slli_epi16(_mm_and_si128(_three, _d2), 2 * deleteLabel));
-        
-        // set state labels
-        _m2 = _mm_andnot_si128(_three, _m2);
-        _i2 = _mm_or_si128(_mm_andnot_si128(_three, _i2), _mm_srli_epi16(_three, 1));
-        _d2 = _mm_or_si128(_mm_andnot_si128(_three, _d2), _three);
-    }
-    
-    if (minscoreidx < 0) {
-        // minscore was never updated so we must have overflowed badly
-        first_pos = -1;
-        return -1;
-    }
-    
-    s = minscoreidx;    // point to the dummy match transition
-    
-    auto i      = s / 2 - target_len;
-    auto y      = target_len;
-    auto x      = s - y;
-    auto alnidx = 0;
-    auto state = (reinterpret_cast<short*>(_backpointers.data() + s)[i] >> (2 * matchLabel)) & 3;
-    
-    s -= 2;
-    
-    // this is 2*y (s even) or 2*y+1 (s odd)
-    while (y > 0) {
-        if (s < 0 || i < 0) {
-            // This should never happen so must have overflowed
-            first_pos = -1;
-            return -1;
-        }
-        const auto new_state = (reinterpret_cast<short*>(_backpointers.data() + s)[i] >> (2 * state)) & 3;
-        if (state == matchLabel) {
-            s -= 2;
-            aln1[alnidx] = truth[--x];
-            aln2[alnidx] = target[--y];
-        } else if (state == insertLabel) {
-            i += s & 1;
-            s -= 1;
-            aln1[alnidx] = gap;
-            aln2[alnidx] = target[--y];
-        } else {
-            s -= 1;
-            i -= s & 1;
-            aln1[alnidx] = truth[--x];
-            aln2[alnidx] = gap;
-        }
-        state = new_state;
-        alnidx++;
-    }
-    aln1[alnidx] = 0;
-    aln2[alnidx] = 0;
-    first_pos = x;
-    // reverse them
-    for (int j {alnidx - 1}, i = 0; i < j; ++i, j--) {
-        x = aln1[i];
-        y = aln2[i];
-        aln1[i] = aln1[j];
-        aln2[i] = aln2[j];
-        aln1[j] = x;
-        aln2[j] = y;
-    }
-    return (minscore + 0x8000) >> 2;
+    return dispatch_align(get_instruction_set(), truth, target, qualities, truth_len, target_len,
+                          gap_open, gap_extend, nuc_prior, first_pos, aln1, aln2);
 }
 
 int align(const char* truth, const char* target, const std::int8_t* qualities,
-          int truth_len, int target_len,
+          const int truth_len, const int target_len,
           const char* snv_mask, const std::int8_t* snv_prior,
-          const std::int8_t* gap_open, short gap_extend, short nuc_prior,
+          const std::int8_t* gap_open, const short gap_extend, const short nuc_prior,
           char* aln1, char* aln2, int& first_pos) noexcept
 {
-    assert(truth_len > bandSize && (truth_len == target_len + 2 * bandSize - 1));
-    assert(aln1 != nullptr && aln2 != nullptr);
-    
-    gap_extend <<= 2;
-    nuc_prior <<= 2;
-    
-    constexpr int matchLabel  {0};
-    constexpr int insertLabel {1};
-    constexpr int deleteLabel {3};
-    
-    using SimdInt = __m128i;
-    
-    SimdInt _m1 {_mm_set1_epi16(inf)};
-    auto _i1 = _m1;
-    auto _d1 = _m1;
-    auto _m2 = _m1;
-    auto _i2 = _m1;
-    auto _d2 = _m1;
-    
-    SimdInt _gap_extend {_mm_set1_epi16(gap_extend)};
-    SimdInt _nuc_prior  {_mm_set1_epi16(nuc_prior)};
-    SimdInt _initmask   {_mm_set_epi16(0,0,0,0,0,0,0,-1)};
-    SimdInt _initmask2  {_mm_set_epi16(0,0,0,0,0,0,0,-0x8000)};
-    
-    static const SimdInt _three {_mm_set1_epi16(3)};
-    SmallVector<SimdInt> _backpointers(2 * (truth_len + bandSize));
-    
-    SimdInt _truthwin  {_mm_set_epi16(truth[7], truth[6], truth[5], truth[4],
-                                      truth[3], truth[2], truth[1], truth[0])};
-    SimdInt _targetwin  {_m1};
-    SimdInt _qualitieswin {_mm_set1_epi16(64 << 2)};
-    
-    SimdInt _snvmaskwin  {_mm_set_epi16(snv_mask[7], snv_mask[6], snv_mask[5], snv_mask[4],
-                                        snv_mask[3], snv_mask[2], snv_mask[1], snv_mask[0])};
-    SimdInt _snv_priorwin {_mm_set_epi16(snv_prior[7] << 2, snv_prior[6] << 2, snv_prior[5] << 2, snv_prior[4] << 2,
-                                         snv_prior[3] << 2, snv_prior[2] << 2, snv_prior[1] << 2, snv_prior[0] << 2)};
-    
-    SimdInt _snvmask;
-    
-    // if N, make nScore; if != N, make inf
-    SimdInt _truthnqual {_mm_add_epi16(_mm_and_si128(_mm_cmpeq_epi16(_truthwin, _mm_set1_epi16('N')),
-                                                     _mm_set1_epi16(nScore - inf)),
-                                       _mm_set1_epi16(inf))};
-    SimdInt _gap_open {_mm_set_epi16(gap_open[7] << 2,gap_open[6] << 2,gap_open[5] << 2,gap_open[4] << 2,
-                                     gap_open[3] << 2,gap_open[2] << 2,gap_open[1] << 2,gap_open[0] << 2)};
-    
-    short cur_score {0}, minscore {inf}, minscoreidx {-1};
-    
-    int s;
-    for (s = 0; s <= 2 * (target_len + bandSize); s += 2) {
-        // truth is current; target needs updating
-        _targetwin    = _mm_slli_si128(_targetwin, 2);
-        _qualitieswin = _mm_slli_si128(_qualitieswin, 2);
-        
-        if (s / 2 < target_len) {
-            _targetwin    = _mm_insert_epi16(_targetwin, target[s / 2], 0);
-            _qualitieswin = _mm_insert_epi16(_qualitieswin, qualities[s / 2] << 2, 0);
-        } else {
-            _targetwin    = _mm_insert_epi16(_targetwin, '0', 0);
-            _qualitieswin = _mm_insert_epi16(_qualitieswin, 64 << 2, 0);
-        }
-        
-        // S even
-        
-        // initialize to -0x8000
-        _m1 = _mm_or_si128(_initmask2, _mm_andnot_si128(_initmask, _m1));
-        _m2 = _mm_or_si128(_initmask2, _mm_andnot_si128(_initmask, _m2));
-        _m1 = _mm_min_epi16(_m1, _mm_min_epi16(_i1, _d1));
-        
-        // at this point, extract minimum score.  Referred-to position must
-        // be y==target_len-1, so that current position has y==target_len; i==0 so d=0 and y=s/2
-        
-        if (s / 2 >= target_len) {
-            cur_score = extract_epi16(_m1, s / 2 - target_len);
-            if (cur_score < minscore) {
-                minscore = cur_score;
-                minscoreidx = s;     // point back to the match state at this entry, so as not to
-            }                        // have to store the state at s-2
-        }
-        
-        _snvmask = _mm_cmpeq_epi16(_targetwin, _snvmaskwin);
-        _m1 = _mm_add_epi16(_m1, _mm_min_epi16(_mm_andnot_si128(_mm_cmpeq_epi16(_targetwin, _truthwin),
-                                                                _mm_min_epi16(_qualitieswin,
-                                                                              _mm_or_si128(_mm_and_si128(_snvmask, _snv_priorwin),
-                                                                                           _mm_andnot_si128(_snvmask, _qualitieswin)))),
-                                               _truthnqual));
-        _d1 = _mm_min_epi16(_mm_add_epi16(_d2, _gap_extend),
-                            _mm_add_epi16(_mm_min_epi16(_m2, _i2),
-                                          _mm_srli_si128(_gap_open, 2))); // allow I->D
-        _d1 = _mm_insert_epi16(_mm_slli_si128(_d1, 2), inf, 0);
-        _i1 = _mm_add_epi16(_mm_min_epi16(_mm_add_epi16(_i2, _gap_extend),
-                                          _mm_add_epi16(_m2, _gap_open)), _nuc_prior);
-        
-        _backpointers[s] = _mm_or_si128(_mm_or_si128(_mm_and_si128(_three, _m1),
-                                                     _mm_slli_epi16(_mm_and_si128(_three, _i1),
-                                                                    2 * insertLabel)),
-                                        _mm_slli_epi16(_mm_and_si128(_three, _d1), 2 * deleteLabel));
-        
-        // set state labels
-        _m1 = _mm_andnot_si128(_three, _m1);
-        _i1 = _mm_or_si128(_mm_andnot_si128(_three, _i1), _mm_srli_epi16(_three, 1));
-        _d1 = _mm_or_si128(_mm_andnot_si128(_three, _d1), _three);
-        
-        // S odd
-        
-        // truth needs updating; target is current
-        const auto pos = bandSize + s / 2;
-        const char base {(pos < truth_len) ? truth[pos] : 'N'};
-        
-        _truthwin   = _mm_insert_epi16(_mm_srli_si128(_truthwin, 2), base, bandSize - 1);
-        _truthnqual = _mm_insert_epi16(_mm_srli_si128(_truthnqual, 2),
-                                       (base == 'N') ? nScore : inf, bandSize - 1);
-        _snvmaskwin   = _mm_insert_epi16(_mm_srli_si128(_snvmaskwin, 2),
-                                         pos < truth_len ? snv_mask[pos] : 'N', bandSize - 1);
-        _snv_priorwin = _mm_insert_epi16(_mm_srli_si128(_snv_priorwin, 2),
-                                         (pos < truth_len) ? snv_prior[pos] << 2 : inf << 2,
-                                         bandSize - 1);
-        _gap_open  = _mm_insert_epi16(_mm_srli_si128(_gap_open,  2),
-                                      gap_open[pos < truth_len ? pos : truth_len - 1] << 2,
-                                      bandSize - 1);
-        
-        _initmask  = _mm_slli_si128(_initmask, 2);
-        _initmask2 = _mm_slli_si128(_initmask2, 2);
-        
-        _m2 = _mm_min_epi16(_m2, _mm_min_epi16(_i2, _d2));
-        
-        // at this point, extract minimum score.  Referred-to position must
-        // be y==target_len-1, so that current position has y==target_len; i==0 so d=0 and y=s/2
-        if (s / 2 >= target_len) {
-            cur_score = extract_epi16(_m2, s / 2 - target_len);
-            if (cur_score < minscore) {
-                minscore = cur_score;
-                minscoreidx = s + 1;
-            }
-        }
-        
-        _snvmask = _mm_cmpeq_epi16(_targetwin, _snvmaskwin);
-        
-        _m2 = _mm_add_epi16(_m2, _mm_min_epi16(_mm_andnot_si128(_mm_cmpeq_epi16(_targetwin, _truthwin),
-                                                                _mm_min_epi16(_qualitieswin,
-                                                                              _mm_or_si128(_mm_and_si128(_snvmask, _snv_priorwin),
-                                                                                           _mm_andnot_si128(_snvmask, _qualitieswin)))),
-                                               _truthnqual));
-        _d2 = _mm_min_epi16(_mm_add_epi16(_d1, _gap_extend),
-                            _mm_add_epi16(_mm_min_epi16(_m1, _i1),  // allow I->D
-                                          _gap_open));
-        _i2 = _mm_insert_epi16(_mm_add_epi16(_mm_min_epi16(_mm_add_epi16(_mm_srli_si128(_i1, 2), _gap_extend),
-                                                           _mm_add_epi16(_mm_srli_si128(_m1, 2), _gap_open)),
-                                             _nuc_prior),
-                               inf, bandSize - 1);
-        _backpointers[s + 1] = _mm_or_si128(_mm_or_si128(_mm_and_si128(_three, _m2),
-                                                         _mm_slli_epi16(_mm_and_si128(_three, _i2), 2 * insertLabel)),
-                                            _mm_slli_epi16(_mm_and_si128(_three, _d2), 2 * deleteLabel));
-        
-        // set state labels
-        _m2 = _mm_andnot_si128(_three, _m2);
-        _i2 = _mm_or_si128(_mm_andnot_si128(_three, _i2), _mm_srli_epi16(_three, 1));
-        _d2 = _mm_or_si128(_mm_andnot_si128(_three, _d2), _three);
-    }
-    
-    if (minscoreidx < 0) {
-        // minscore was never updated so we must have overflowed badly
-        first_pos = -1;
-        return -1;
-    }
-    
-    s = minscoreidx;    // point to the dummy match transition
-    
-    auto i      = s / 2 - target_len;
-    auto y      = target_len;
-    auto x      = s - y;
-    auto alnidx = 0;
-    auto state  = (reinterpret_cast<short*>(_backpointers.data() + s)[i] >> (2 * matchLabel)) & 3;
-    
-    s -= 2;
-    
-    // this is 2*y (s even) or 2*y+1 (s odd)
-    while (y > 0) {
-        if (s < 0 || i < 0) {
-            // This should never happen so must have overflowed
-            first_pos = -1;
-            return -1;
-        }
-        const auto new_state = (reinterpret_cast<short*>(_backpointers.data() + s)[i] >> (2 * state)) & 3;
-        if (state == matchLabel) {
-            s -= 2;
-            aln1[alnidx] = truth[--x];
-            aln2[alnidx] = target[--y];
-        } else if (state == insertLabel) {
-            i += s & 1;
-            s -= 1;
-            aln1[alnidx] = gap;
-            aln2[alnidx] = target[--y];
-        } else {
-            s -= 1;
-            i -= s & 1;
-            aln1[alnidx] = truth[--x];
-            aln2[alnidx] = gap;
-        }
-        state = new_state;
-        alnidx++;
-    }
-    aln1[alnidx] = 0;
-    aln2[alnidx] = 0;
-    first_pos = x;
-    // reverse them
-    for (int j {alnidx - 1}, i = 0; i < j; ++i, j--) {
-        x = aln1[i];
-        y = aln2[i];
-        aln1[i] = aln1[j];
-        aln2[i] = aln2[j];
-        aln1[j] = x;
-        aln2[j] = y;
-    }
-    return (minscore + 0x8000) >> 2;
+    return dispatch_align(get_instruction_set(), truth, target, qualities, truth_len, target_len,
+                          snv_mask, snv_prior, gap_open, gap_extend, nuc_prior, aln1, aln2, first_pos);
 }
 
 int align(const char* truth, const char* target, const std::int8_t* qualities,
-          int truth_len, int target_len,
+          const int truth_len, const int target_len,
           const char* snv_mask, const std::int8_t* snv_prior,
           const std::int8_t* gap_open, const std::int8_t* gap_extend,
-          short nuc_prior,
+          const short nuc_prior,
           char* aln1, char* aln2, int& first_pos) noexcept
 {
-    assert(truth_len > bandSize && (truth_len == target_len + 2 * bandSize - 1));
-    assert(aln1 != nullptr && aln2 != nullptr);
-    
-    nuc_prior <<= 2;
-    
-    constexpr int matchLabel  {0};
-    constexpr int insertLabel {1};
-    constexpr int deleteLabel {3};
-    
-    using SimdInt = __m128i;
-    
-    SimdInt _m1 {_mm_set1_epi16(inf)};
-    auto _i1 = _m1;
-    auto _d1 = _m1;
-    auto _m2 = _m1;
-    auto _i2 = _m1;
-    auto _d2 = _m1;
-    
-    SimdInt _nuc_prior  {_mm_set1_epi16(nuc_prior)};
-    SimdInt _initmask   {_mm_set_epi16(0,0,0,0,0,0,0,-1)};
-    SimdInt _initmask2  {_mm_set_epi16(0,0,0,0,0,0,0,-0x8000)};
-    
-    static const SimdInt _three {_mm_set1_epi16(3)};
-    SmallVector<SimdInt> _backpointers(2 * (truth_len + bandSize));
-    
-    SimdInt _truthwin  {_mm_set_epi16(truth[7], truth[6], truth[5], truth[4],
-                                      truth[3], truth[2], truth[1], truth[0])};
-    SimdInt _targetwin  {_m1};
-    SimdInt _qualitieswin {_mm_set1_epi16(64 << 2)};
-    
-    SimdInt _snvmaskwin  {_mm_set_epi16(snv_mask[7], snv_mask[6], snv_mask[5], snv_mask[4],
-                                        snv_mask[3], snv_mask[2], snv_mask[1], snv_mask[0])};
-    SimdInt _snv_priorwin {_mm_set_epi16(snv_prior[7] << 2, snv_prior[6] << 2, snv_prior[5] << 2, snv_prior[4] << 2,
-                                         snv_prior[3] << 2, snv_prior[2] << 2, snv_prior[1] << 2, snv_prior[0] << 2)};
-    
-    SimdInt _snvmask;
-    
-    // if N, make nScore; if != N, make inf
-    SimdInt _truthnqual {_mm_add_epi16(_mm_and_si128(_mm_cmpeq_epi16(_truthwin, _mm_set1_epi16('N')),
-                                                     _mm_set1_epi16(nScore - inf)),
-                                       _mm_set1_epi16(inf))};
-    SimdInt _gap_open {_mm_set_epi16(gap_open[7] << 2,gap_open[6] << 2,gap_open[5] << 2,gap_open[4] << 2,
-                                     gap_open[3] << 2,gap_open[2] << 2,gap_open[1] << 2,gap_open[0] << 2)};
-    SimdInt _gap_extend {_mm_set_epi16(gap_extend[7] << 2,gap_extend[6] << 2,gap_extend[5] << 2,gap_extend[4] << 2,
-                                       gap_extend[3] << 2,gap_extend[2] << 2,gap_extend[1] << 2,gap_extend[0] << 2)};
-    
-    short cur_score {0}, minscore {inf}, minscoreidx {-1};
-    
-    int s;
-    for (s = 0; s <= 2 * (target_len + bandSize); s += 2) {
-        // truth is current; target needs updating
-        _targetwin    = _mm_slli_si128(_targetwin, 2);
-        _qualitieswin = _mm_slli_si128(_qualitieswin, 2);
-        
-        if (s / 2 < target_len) {
-            _targetwin    = _mm_insert_epi16(_targetwin, target[s / 2], 0);
-            _qualitieswin = _mm_insert_epi16(_qualitieswin, qualities[s / 2] << 2, 0);
-        } else {
-            _targetwin    = _mm_insert_epi16(_targetwin, '0', 0);
-            _qualitieswin = _mm_insert_epi16(_qualitieswin, 64 << 2, 0);
-        }
-        
-        // S even
-        
-        // initialize to -0x8000
-        _m1 = _mm_or_si128(_initmask2, _mm_andnot_si128(_initmask, _m1));
-        _m2 = _mm_or_si128(_initmask2, _mm_andnot_si128(_initmask, _m2));
-        _m1 = _mm_min_epi16(_m1, _mm_min_epi16(_i1, _d1));
-        
-        // at this point, extract minimum score.  Referred-to position must
-        // be y==target_len-1, so that current position has y==target_len; i==0 so d=0 and y=s/2
-        
-        if (s / 2 >= target_len) {
-            cur_score = extract_epi16(_m1, s / 2 - target_len);
-            if (cur_score < minscore) {
-                minscore = cur_score;
-                minscoreidx = s;     // point back to the match state at this entry, so as not to
-            }                        // have to store the state at s-2
-        }
-        
-        _snvmask = _mm_cmpeq_epi16(_targetwin, _snvmaskwin);
-        _m1 = _mm_add_epi16(_m1, _mm_min_epi16(_mm_andnot_si128(_mm_cmpeq_epi16(_targetwin, _truthwin),
-                                                                _mm_min_epi16(_qualitieswin,
-                                                                              _mm_or_si128(_mm_and_si128(_snvmask, _snv_priorwin),
-                                                                                           _mm_andnot_si128(_snvmask, _qualitieswin)))),
-                                               _truthnqual));
-        _d1 = _mm_min_epi16(_mm_add_epi16(_d2, _gap_extend),
-                            _mm_add_epi16(_mm_min_epi16(_m2, _i2),
-                                          _mm_srli_si128(_gap_open, 2))); // allow I->D
-        _d1 = _mm_insert_epi16(_mm_slli_si128(_d1, 2), inf, 0);
-        _i1 = _mm_add_epi16(_mm_min_epi16(_mm_add_epi16(_i2, _gap_extend),
-                                          _mm_add_epi16(_m2, _gap_open)), _nuc_prior);
-        
-        _backpointers[s] = _mm_or_si128(_mm_or_si128(_mm_and_si128(_three, _m1),
-                                                     _mm_slli_epi16(_mm_and_si128(_three, _i1),
-                                                                    2 * insertLabel)),
-                                        _mm_slli_epi16(_mm_and_si128(_three, _d1), 2 * deleteLabel));
-        
-        // set state labels
-        _m1 = _mm_andnot_si128(_three, _m1);
-        _i1 = _mm_or_si128(_mm_andnot_si128(_three, _i1), _mm_srli_epi16(_three, 1));
-        _d1 = _mm_or_si128(_mm_andnot_si128(_three, _d1), _three);
-        
-        // S odd
-        
-        // truth needs updating; target is current
-        const auto pos = bandSize + s / 2;
-        const char base {(pos < truth_len) ? truth[pos] : 'N'};
-        
-        _truthwin   = _mm_insert_epi16(_mm_srli_si128(_truthwin, 2), base, bandSize - 1);
-        _truthnqual = _mm_insert_epi16(_mm_srli_si128(_truthnqual, 2),
-                                       (base == 'N') ? nScore : inf, bandSize - 1);
-        _snvmaskwin   = _mm_insert_epi16(_mm_srli_si128(_snvmaskwin, 2),
-                                         pos < truth_len ? snv_mask[pos] : 'N', bandSize - 1);
-        _snv_priorwin = _mm_insert_epi16(_mm_srli_si128(_snv_priorwin, 2),
-                                         (pos < truth_len) ? snv_prior[pos] << 2 : inf << 2,
-                                         bandSize - 1);
-        const auto gap_idx = pos < truth_len ? pos : truth_len - 1;
-        _gap_open     = _mm_insert_epi16(_mm_srli_si128(_gap_open, 2), gap_open[gap_idx] << 2, bandSize - 1);
-        _gap_extend = _mm_insert_epi16(_mm_srli_si128(_gap_extend, 2), gap_extend[gap_idx] << 2, bandSize - 1);
-        
-        _initmask  = _mm_slli_si128(_initmask, 2);
-        _initmask2 = _mm_slli_si128(_initmask2, 2);
-        
-        _m2 = _mm_min_epi16(_m2, _mm_min_epi16(_i2, _d2));
-        
-        // at this point, extract minimum score.  Referred-to position must
-        // be y==target_len-1, so that current position has y==target_len; i==0 so d=0 and y=s/2
-        if (s / 2 >= target_len) {
-            cur_score = extract_epi16(_m2, s / 2 - target_len);
-            if (cur_score < minscore) {
-                minscore = cur_score;
-                minscoreidx = s + 1;
-            }
-        }
-        
-        _snvmask = _mm_cmpeq_epi16(_targetwin, _snvmaskwin);
-        
-        _m2 = _mm_add_epi16(_m2, _mm_min_epi16(_mm_andnot_si128(_mm_cmpeq_epi16(_targetwin, _truthwin),
-                                                                _mm_min_epi16(_qualitieswin,
-                                                                              _mm_or_si128(_mm_and_si128(_snvmask, _snv_priorwin),
-                                                                                           _mm_andnot_si128(_snvmask, _qualitieswin)))),
-                                               _truthnqual));
-        _d2 = _mm_min_epi16(_mm_add_epi16(_d1, _gap_extend),
-                            _mm_add_epi16(_mm_min_epi16(_m1, _i1),  // allow I->D
-                                          _gap_open));
-        _i2 = _mm_insert_epi16(_mm_add_epi16(_mm_min_epi16(_mm_add_epi16(_mm_srli_si128(_i1, 2), _gap_extend),
-                                                           _mm_add_epi16(_mm_srli_si128(_m1, 2), _gap_open)),
-                                             _nuc_prior),
-                               inf, bandSize - 1);
-        _backpointers[s + 1] = _mm_or_si128(_mm_or_si128(_mm_and_si128(_three, _m2),
-                                                         _mm_slli_epi16(_mm_and_si128(_three, _i2), 2 * insertLabel)),
-                                            _mm_slli_epi16(_mm_and_si128(_three, _d2), 2 * deleteLabel));
-        
-        // set state labels
-        _m2 = _mm_andnot_si128(_three, _m2);
-        _i2 = _mm_or_si128(_mm_andnot_si128(_three, _i2), _mm_srli_epi16(_three, 1));
-        _d2 = _mm_or_si128(_mm_andnot_si128(_three, _d2), _three);
-    }
-    
-    if (minscoreidx < 0) {
-        // minscore was never updated so we must have overflowed badly
-        first_pos = -1;
-        return -1;
-    }
-    
-    s = minscoreidx;    // point to the dummy match transition
-    
-    auto i      = s / 2 - target_len;
-    auto y      = target_len;
-    auto x      = s - y;
-    auto alnidx = 0;
-    auto state  = (reinterpret_cast<short*>(_backpointers.data() + s)[i] >> (2 * matchLabel)) & 3;
-    
-    s -= 2;
-    
-    // this is 2*y (s even) or 2*y+1 (s odd)
-    while (y > 0) {
-        if (s < 0 || i < 0) {
-            // This should never happen so must have overflowed
-            first_pos = -1;
-            return -1;
-        }
-        const auto new_state = (reinterpret_cast<short*>(_backpointers.data() + s)[i] >> (2 * state)) & 3;
-        if (state == matchLabel) {
-            s -= 2;
-            aln1[alnidx] = truth[--x];
-            aln2[alnidx] = target[--y];
-        } else if (state == insertLabel) {
-            i += s & 1;
-            s -= 1;
-            aln1[alnidx] = gap;
-            aln2[alnidx] = target[--y];
-        } else {
-            s -= 1;
-            i -= s & 1;
-            aln1[alnidx] = truth[--x];
-            aln2[alnidx] = gap;
-        }
-        state = new_state;
-        alnidx++;
-    }
-    aln1[alnidx] = 0;
-    aln2[alnidx] = 0;
-    first_pos = x;
-    // reverse them
-    for (int j {alnidx - 1}, i = 0; i < j; ++i, j--) {
-        x = aln1[i];
-        y = aln2[i];
-        aln1[i] = aln1[j];
-        aln2[i] = aln2[j];
-        aln1[j] = x;
-        aln2[j] = y;
-    }
-    return (minscore + 0x8000) >> 2;
+    return dispatch_align(get_instruction_set(), truth, target, qualities, truth_len, target_len,
+                          snv_mask, snv_prior, gap_open, gap_extend, nuc_prior, aln1, aln2, first_pos);
+}
+
+int batch_size() noexcept
+{
+    return batch_lanes(get_instruction_set());
+}
+
+void align(const BatchAlignment* alignments, const int num_alignments,
+           const int truth_len, const int target_len, const short nuc_prior,
+           int* scores) noexcept
+{
+    align_batch(get_instruction_set(), alignments, num_alignments, truth_len, target_len, nuc_prior, scores);
 }
 
 int calculate_flank_score(int truth_len, int lhs_flank_len, int rhs_flank_len,
@@ -1757,6 +565,174 @@ int calculate_flank_score(const int truth_len, const int lhs_flank_len, const in
     return result;
 }
 
+namespace {
+
+struct KernelInput
+{
+    std::string truth, target, snv_mask;
+    std::vector<std::int8_t> qualities, snv_prior, gap_open, gap_extend;
+    short gap_open_penalty, gap_extend_penalty, nuc_prior;
+};
+
+// The target is a mutated copy of the middle of the truth so that most alignments stay in the band
+KernelInput make_random_input(std::mt19937& generator, const int target_len)
+{
+    static const std::string bases {"ACGTACGTACGTACGTACGN"};
+    std::uniform_int_distribution<std::size_t> base_dist {0, bases.size() - 1};
+    std::uniform_int_distribution<int> event_dist {0, 99};
+    std::uniform_int_distribution<int> quality_dist {1, 40}, gap_open_dist {10, 50}, gap_extend_dist {1, 10};
+    KernelInput result {};
+    const auto truth_len = target_len + 2 * bandSize - 1;
+    const auto random_base = [&] () { return bases[base_dist(generator)]; };
+    std::generate_n(std::back_inserter(result.truth), truth_len, random_base);
+    for (int truth_idx {bandSize}; static_cast<int>(result.target.size()) < target_len; ) {
+        const auto event = event_dist(generator);
+        if (event < 2) {
+            result.target += random_base(); // insertion
+        } else if (event < 4) {
+            ++truth_idx; // deletion
+        } else {
+            result.target += event < 8 ? random_base() : result.truth[std::min(truth_idx, truth_len - 1)];
+            ++truth_idx;
+        }
+    }
+    std::generate_n(std::back_inserter(result.snv_mask), truth_len, random_base);
+    const auto random_quality = [&] () { return static_cast<std::int8_t>(quality_dist(generator)); };
+    std::generate_n(std::back_inserter(result.qualities), target_len, random_quality);
+    std::generate_n(std::back_inserter(result.snv_prior), truth_len, random_quality);
+    std::generate_n(std::back_inserter(result.gap_open), truth_len,
+                    [&] () { return static_cast<std::int8_t>(gap_open_dist(generator)); });
+    std::generate_n(std::back_inserter(result.gap_extend), truth_len,
+                    [&] () { return static_cast<std::int8_t>(gap_extend_dist(generator)); });
+    result.gap_open_penalty   = static_cast<short>(gap_open_dist(generator));
+    result.gap_extend_penalty = static_cast<short>(gap_extend_dist(generator));
+    result.nuc_prior          = 2;
+    return result;
+}
+
+struct KernelOutput
+{
+    std::vector<int> scores;
+    std::vector<std::string> alignments;
+};
+
+bool operator==(const KernelOutput& lhs, const KernelOutput& rhs)
+{
+    return lhs.scores == rhs.scores && lhs.alignments == rhs.alignments;
+}
+
+// Runs every align overload
+KernelOutput run_kernels(const InstructionSet isa, const KernelInput& input)
+{
+    const auto truth = input.truth.data();
+    const auto target = input.target.data();
+    const auto quals = input.qualities.data();
+    const auto truth_len = static_cast<int>(input.truth.size());
+    const auto target_len = static_cast<int>(input.target.size());
+    const auto snv_mask = input.snv_mask.data();
+    const auto snv_prior = input.snv_prior.data();
+    const auto gap_open = input.gap_open.data();
+    const auto gap_extend = input.gap_extend.data();
+    const auto max_alignment_size = 2 * (target_len + min_flank_pad()) + 1;
+    KernelOutput result {};
+    const auto add_traceback = [&] (const auto& kernel) {
+        std::vector<char> aln1(max_alignment_size, 0), aln2(max_alignment_size, 0);
+        int first_pos {-1};
+        result.scores.push_back(kernel(aln1.data(), aln2.data(), first_pos));
+        result.scores.push_back(first_pos);
+        result.alignments.emplace_back(aln1.data());
+        result.alignments.emplace_back(aln2.data());
+    };
+    result.scores.push_back(dispatch_align(isa, truth, target, quals, truth_len, target_len,
+                                           input.gap_open_penalty, input.gap_extend_penalty, input.nuc_prior));
+    result.scores.push_back(dispatch_align(isa, truth, target, quals, truth_len, target_len,
+                                           gap_open, input.gap_extend_penalty, input.nuc_prior));
+    result.scores.push_back(dispatch_align(isa, truth, target, quals, truth_len, target_len,
+                                           gap_open, gap_extend, input.nuc_prior));
+    result.scores.push_back(dispatch_align(isa, truth, target, quals, truth_len, target_len,
+                                           snv_mask, snv_prior, gap_open, input.gap_extend_penalty, input.nuc_prior));
+    result.scores.push_back(dispatch_align(isa, truth, target, quals, truth_len, target_len,
+                                           snv_mask, snv_prior, gap_open, gap_extend, input.nuc_prior));
+    add_traceback([&] (char* aln1, char* aln2, int& first_pos) {
+        return dispatch_align(isa, truth, target, quals, truth_len, target_len,
+                              gap_open, gap_extend, input.nuc_prior, first_pos, aln1, aln2);
+    });
+    add_traceback([&] (char* aln1, char* aln2, int& first_pos) {
+        return dispatch_align(isa, truth, target, quals, truth_len, target_len,
+                              gap_open, input.gap_extend_penalty, input.nuc_prior, first_pos, aln1, aln2);
+    });
+    add_traceback([&] (char* aln1, char* aln2, int& first_pos) {
+        return dispatch_align(isa, truth, target, quals, truth_len, target_len,
+                              snv_mask, snv_prior, gap_open, input.gap_extend_penalty, input.nuc_prior,
+                              aln1, aln2, first_pos);
+    });
+    add_traceback([&] (char* aln1, char* aln2, int& first_pos) {
+        return dispatch_align(isa, truth, target, quals, truth_len, target_len,
+                              snv_mask, snv_prior, gap_open, gap_extend, input.nuc_prior,
+                              aln1, aln2, first_pos);
+    });
+    return result;
+}
+
+std::vector<int> run_batch_kernel(const InstructionSet isa, const std::vector<KernelInput>& inputs)
+{
+    std::vector<BatchAlignment> alignments {};
+    alignments.reserve(inputs.size());
+    for (const auto& input : inputs) {
+        alignments.push_back({input.truth.data(), input.target.data(), input.qualities.data(),
+                              input.snv_mask.data(), input.snv_prior.data(),
+                              input.gap_open.data(), input.gap_extend.data()});
+    }
+    std::vector<int> result(inputs.size());
+    align_batch(isa, alignments.data(), static_cast<int>(alignments.size()),
+                static_cast<int>(inputs.front().truth.size()), static_cast<int>(inputs.front().target.size()),
+                inputs.front().nuc_prior, result.data());
+    return result;
+}
+
+std::vector<int> run_single_kernel(const std::vector<KernelInput>& inputs)
+{
+    std::vector<int> result {};
+    result.reserve(inputs.size());
+    for (const auto& input : inputs) {
+        result.push_back(sse2::align(input.truth.data(), input.target.data(), input.qualities.data(),
+                                     static_cast<int>(input.truth.size()), static_cast<int>(input.target.size()),
+                                     input.snv_mask.data(), input.snv_prior.data(),
+                                     input.gap_open.data(), input.gap_extend.data(), input.nuc_prior));
+    }
+    return result;
+}
+
+} // namespace
+
+std::vector<InstructionSet> verify_instruction_sets(const std::size_t num_trials, const unsigned seed)
+{
+    const auto isas = supported_instruction_sets();
+    std::vector<InstructionSet> result {};
+    const auto has_failed = [&] (const InstructionSet isa) {
+        return std::find(std::cbegin(result), std::cend(result), isa) != std::cend(result);
+    };
+    std::mt19937 generator {seed};
+    std::uniform_int_distribution<int> length_dist {1, 250}, batch_size_dist {1, 40};
+    for (std::size_t trial {0}; trial < num_trials && result.size() < isas.size(); ++trial) {
+        const auto target_len = length_dist(generator);
+        const auto input = make_random_input(generator, target_len);
+        const auto expected = run_kernels(InstructionSet::sse2, input);
+        std::vector<KernelInput> batch_inputs {input};
+        std::generate_n(std::back_inserter(batch_inputs), batch_size_dist(generator) - 1,
+                        [&] () { return make_random_input(generator, target_len); });
+        const auto expected_batch = run_single_kernel(batch_inputs);
+        for (const auto isa : isas) {
+            if (has_failed(isa)) continue;
+            if ((isa != InstructionSet::sse2 && !(run_kernels(isa, input) == expected))
+                || run_batch_kernel(isa, batch_inputs) != expected_batch) {
+                result.push_back(isa);
+            }
+        }
+    }
+    return result;
+}
+
 } // namespace simd
 } // namespace hmm
 } // namespace octopus
@@ -5,11 +5,49 @@
 #define simd_pair_hmm_hpp
 
 #include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <string>
 
 namespace octopus { namespace hmm { namespace simd {
 
 constexpr int min_flank_pad() noexcept { return 8; }
 
+// The align kernels are compiled for each of these instruction sets and one is chosen at
+// startup from those supported by the CPU. All give identical results.
+enum class InstructionSet { sse2, avx2, avx512 };
+
+std::vector<InstructionSet> supported_instruction_sets(); // in order of preference, best last
+InstructionSet get_instruction_set() noexcept;
+void set_instruction_set(InstructionSet isa); // throws std::invalid_argument if unsupported
+std::string to_string(InstructionSet isa);
+
+// One alignment of a batch; the arguments of the score only align overload with SNV and gap vectors
+struct BatchAlignment
+{
+    const char* truth;
+    const char* target;
+    const std::int8_t* qualities;
+    const char* snv_mask;
+    const std::int8_t* snv_prior;
+    const std::int8_t* gap_open;
+    const std::int8_t* gap_extend;
+};
+
+// The number of alignments the selected instruction set scores together
+int batch_size() noexcept;
+
+// Scores alignments that all have the given truth and target lengths. The scores are identical
+// to calling align on each alignment separately.
+void align(const BatchAlignment* alignments, int num_alignments,
+           int truth_len, int target_len, short nuc_prior,
+           int* scores) noexcept;
+
+// Cross-checks the kernels of every supported instruction set against the SSE2 kernels on
+// num_trials randomised inputs. The batch kernels, including SSE2's, are checked against the
+// single alignment SSE2 kernel. Returns the instruction sets that gave any different result.
+std::vector<InstructionSet> verify_instruction_sets(std::size_t num_trials, unsigned seed = 0);
+
 int align(const char* truth, const char* target, const std::int8_t* qualities,
           int truth_len, int target_len,
           short gap_open, short gap_extend, short nuc_prior) noexcept;
@@ -0,0 +1,253 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "read_likelihood_cache.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <cassert>
+
+#include <boost/functional/hash.hpp>
+
+namespace octopus {
+
+namespace {
+
+// Conservative estimate of the memory used by each entry, including the node and bucket
+constexpr std::size_t entryFootprint {sizeof(std::pair<ReadLikelihoodCache::Key, ReadLikelihoodCache::LogProbability>) + 3 * sizeof(void*)};
+
+std::size_t footprint(const ReadLikelihoodCache::ReadIdentity& read) noexcept
+{
+    return sizeof(read) + read.contig.size() + read.sequence.size() + read.base_qualities.size();
+}
+
+std::size_t footprint(const ReadLikelihoodCache::HaplotypeContext& context) noexcept
+{
+    return sizeof(context) + context.sequence.size() + context.snv_forward_mask.size() + context.snv_reverse_mask.size()
+           + context.snv_forward_priors.size() + context.snv_reverse_priors.size()
+           + context.gap_open.size() + context.gap_extend.size();
+}
+
+} // namespace
+
+ReadLikelihoodCache::ReadLikelihoodCache(MemoryFootprint max_memory)
+: likelihoods_ {}
+, counted_shared_data_ {}
+, max_bytes_ {std::max(max_memory.bytes(), entryFootprint)}
+{}
+
+std::shared_ptr<const ReadLikelihoodCache::ReadIdentity> ReadLikelihoodCache::identify(const AlignedRead& read)
+{
+    using boost::hash_combine;
+    auto result = std::make_shared<ReadIdentity>();
+    result->contig = contig_name(read);
+    result->begin = mapped_begin(read);
+    result->mapping_quality = read.mapping_quality();
+    result->is_reverse_mapped = read.is_marked_reverse_mapped();
+    result->sequence = read.sequence();
+    result->base_qualities = read.base_qualities();
+    result->fingerprint = 0;
+    hash_combine(result->fingerprint, result->contig);
+    hash_combine(result->fingerprint, result->begin);
+    hash_combine(result->fingerprint, result->mapping_quality);
+    hash_combine(result->fingerprint, result->is_reverse_mapped);
+    hash_combine(result->fingerprint, result->sequence);
+    boost::hash_range(result->fingerprint, std::cbegin(result->base_qualities), std::cend(result->base_qualities));
+    return result;
+}
+
+std::shared_ptr<const ReadLikelihoodCache::HaplotypeContext>
+ReadLikelihoodCache::share_context(const Haplotype& haplotype, const HaplotypeLikelihoodModel& model)
+{
+    auto result = std::make_shared<HaplotypeContext>();
+    result->sequence = haplotype.sequence();
+    result->snv_forward_mask = model.snv_mask(true);
+    result->snv_reverse_mask = model.snv_mask(false);
+    result->snv_forward_priors = model.snv_priors(true);
+    result->snv_reverse_priors = model.snv_priors(false);
+    result->gap_open = model.gap_open_penalties();
+    result->gap_extend = model.gap_extend_penalties();
+    return result;
+}
+
+namespace {
+
+bool has_parameters_for_each_base(const ReadLikelihoodCache::HaplotypeContext& context) noexcept
+{
+    const auto n = context.sequence.size();
+    return context.snv_forward_mask.size() == n && context.snv_reverse_mask.size() == n
+        && context.snv_forward_priors.size() == n && context.snv_reverse_priors.size() == n
+        && context.gap_open.size() == n && context.gap_extend.size() == n;
+}
+
+} // namespace
+
+boost::optional<ReadLikelihoodCache::Key>
+ReadLikelihoodCache::make_key(const std::shared_ptr<const ReadIdentity>& read_identity, const AlignedRead& read,
+                              const std::shared_ptr<const HaplotypeContext>& haplotype_context, const Haplotype& haplotype,
+                              const boost::optional<FlankState>& flank_state,
+                              MappingPositionItr first_mapping_position, MappingPositionItr last_mapping_position,
+                              const std::size_t max_mapping_positions) noexcept
+{
+    using boost::hash_combine;
+    assert(read_identity && haplotype_context);
+    // The mapper stops at max_mapping_positions, so there may be others
+    if (static_cast<std::size_t>(std::distance(first_mapping_position, last_mapping_position)) >= max_mapping_positions) {
+        return boost::none;
+    }
+    if (!has_parameters_for_each_base(*haplotype_context)) return boost::none;
+    const auto& haplotype_sequence = haplotype_context->sequence;
+    const auto haplotype_size = static_cast<long>(haplotype_sequence.size());
+    const auto read_size = static_cast<long>(sequence_size(read));
+    const auto hmm_pad = static_cast<long>(HaplotypeLikelihoodModel::pad_requirement());
+    const auto pad = read_size + hmm_pad;
+    Key result {};
+    result.read_fingerprint = read_identity->fingerprint;
+    result.read = read_identity;
+    result.haplotype = haplotype_context;
+    result.read_begin = static_cast<long>(begin_distance(haplotype, read));
+    result.context_begin = std::max(result.read_begin - pad, 0l);
+    result.context_end = std::min(std::max(result.read_begin + pad, result.context_begin), haplotype_size);
+    // The pair HMM only looks at the haplotype within hmm_pad of the read at each position it is evaluated at
+    const auto is_band_in_context = [&] (const long mapping_position) noexcept {
+        return mapping_position - hmm_pad >= result.context_begin && mapping_position + pad <= result.context_end;
+    };
+    if (!is_band_in_context(result.read_begin)
+        || !std::all_of(first_mapping_position, last_mapping_position,
+                        [&] (const auto position) noexcept { return is_band_in_context(static_cast<long>(position)); })) {
+        return boost::none;
+    }
+    const auto context_size = result.context_end - result.context_begin;
+    result.has_flank_state = static_cast<bool>(flank_state);
+    if (flank_state) {
+        // Only the part of each inactive flank inside the context can affect the likelihood
+        const auto lhs_flank_end = static_cast<long>(flank_state->lhs_flank);
+        const auto rhs_flank_begin = haplotype_size - static_cast<long>(flank_state->rhs_flank);
+        result.lhs_flank_overlap = std::min(std::max(lhs_flank_end - result.context_begin, 0l), context_size);
+        result.rhs_flank_overlap = std::min(std::max(result.context_end - rhs_flank_begin, 0l), context_size);
+    }
+    const auto context_itr = std::next(std::cbegin(haplotype_sequence), result.context_begin);
+    boost::hash_range(result.context_fingerprint, context_itr, std::next(context_itr, context_size));
+    hash_combine(result.context_fingerprint, result.read_begin - result.context_begin);
+    hash_combine(result.context_fingerprint, result.context_begin == 0);
+    hash_combine(result.context_fingerprint, result.context_end == haplotype_size);
+    if (flank_state) {
+        hash_combine(result.context_fingerprint, result.lhs_flank_overlap);
+        hash_combine(result.context_fingerprint, result.rhs_flank_overlap);
+    }
+    return result;
+}
+
+boost::optional<ReadLikelihoodCache::LogProbability> ReadLikelihoodCache::find(const Key& key) noexcept
+{
+    const auto itr = likelihoods_.find(key);
+    if (itr != std::cend(likelihoods_)) {
+        ++num_hits_;
+        return itr->second;
+    } else {
+        ++num_misses_;
+        return boost::none;
+    }
+}
+
+void ReadLikelihoodCache::insert(const Key& key, const LogProbability likelihood)
+{
+    if (bytes_ + entryFootprint > max_bytes_) {
+        clear();
+    }
+    if (likelihoods_.emplace(key, likelihood).second) {
+        bytes_ += entryFootprint;
+        // Read and haplotype data is shared between keys, so is only counted once while the cache holds it
+        if (counted_shared_data_.insert(key.read.get()).second) {
+            bytes_ += footprint(*key.read) + sizeof(void*);
+        }
+        if (counted_shared_data_.insert(key.haplotype.get()).second) {
+            bytes_ += footprint(*key.haplotype) + sizeof(void*);
+        }
+    }
+}
+
+std::size_t ReadLikelihoodCache::size() const noexcept
+{
+    return likelihoods_.size();
+}
+
+std::size_t ReadLikelihoodCache::num_hits() const noexcept
+{
+    return num_hits_;
+}
+
+std::size_t ReadLikelihoodCache::num_misses() const noexcept
+{
+    return num_misses_;
+}
+
+void ReadLikelihoodCache::clear() noexcept
+{
+    likelihoods_.clear();
+    counted_shared_data_.clear();
+    bytes_ = 0;
+}
+
+// private methods
+
+std::size_t ReadLikelihoodCache::KeyHash::operator()(const Key& key) const noexcept
+{
+    auto result = key.read_fingerprint;
+    boost::hash_combine(result, key.context_fingerprint);
+    return result;
+}
+
+namespace {
+
+bool is_same_read(const ReadLikelihoodCache::ReadIdentity& lhs, const ReadLikelihoodCache::ReadIdentity& rhs) noexcept
+{
+    return lhs.begin == rhs.begin && lhs.mapping_quality == rhs.mapping_quality
+        && lhs.is_reverse_mapped == rhs.is_reverse_mapped && lhs.contig == rhs.contig
+        && lhs.sequence == rhs.sequence && lhs.base_qualities == rhs.base_qualities;
+}
+
+template <typename Container>
+bool is_equal_in_context(const Container& lhs, const ReadLikelihoodCache::Key& lhs_key,
+                         const Container& rhs, const ReadLikelihoodCache::Key& rhs_key) noexcept
+{
+    const auto lhs_itr = std::next(std::cbegin(lhs), lhs_key.context_begin);
+    const auto rhs_itr = std::next(std::cbegin(rhs), rhs_key.context_begin);
+    return std::equal(lhs_itr, std::next(lhs_itr, lhs_key.context_end - lhs_key.context_begin), rhs_itr);
+}
+
+bool is_same_context(const ReadLikelihoodCache::Key& lhs, const ReadLikelihoodCache::Key& rhs) noexcept
+{
+    const auto& lhs_haplotype = *lhs.haplotype;
+    const auto& rhs_haplotype = *rhs.haplotype;
+    const auto lhs_size = static_cast<long>(lhs_haplotype.sequence.size());
+    const auto rhs_size = static_cast<long>(rhs_haplotype.sequence.size());
+    if (lhs.read_begin - lhs.context_begin != rhs.read_begin - rhs.context_begin
+        || (lhs.context_begin == 0) != (rhs.context_begin == 0)
+        || (lhs.context_end == lhs_size) != (rhs.context_end == rhs_size)
+        || lhs.context_end - lhs.context_begin != rhs.context_end - rhs.context_begin
+        || lhs.has_flank_state != rhs.has_flank_state) {
+        return false;
+    }
+    if (lhs.has_flank_state && (lhs.lhs_flank_overlap != rhs.lhs_flank_overlap || lhs.rhs_flank_overlap != rhs.rhs_flank_overlap)) {
+        return false;
+    }
+    if (lhs.haplotype == rhs.haplotype && lhs.context_begin == rhs.context_begin) return true;
+    return is_equal_in_context(lhs_haplotype.sequence, lhs, rhs_haplotype.sequence, rhs)
+        && is_equal_in_context(lhs_haplotype.gap_open, lhs, rhs_haplotype.gap_open, rhs)
+        && is_equal_in_context(lhs_haplotype.gap_extend, lhs, rhs_haplotype.gap_extend, rhs)
+        && is_equal_in_context(lhs_haplotype.snv_forward_priors, lhs, rhs_haplotype.snv_forward_priors, rhs)
+        && is_equal_in_context(lhs_haplotype.snv_reverse_priors, lhs, rhs_haplotype.snv_reverse_priors, rhs)
+        && is_equal_in_context(lhs_haplotype.snv_forward_mask, lhs, rhs_haplotype.snv_forward_mask, rhs)
+        && is_equal_in_context(lhs_haplotype.snv_reverse_mask, lhs, rhs_haplotype.snv_reverse_mask, rhs);
+}
+
+} // namespace
+
+bool ReadLikelihoodCache::KeyEqual::operator()(const Key& lhs, const Key& rhs) const noexcept
+{
+    if (lhs.read_fingerprint != rhs.read_fingerprint || lhs.context_fingerprint != rhs.context_fingerprint) return false;
+    return (lhs.read == rhs.read || is_same_read(*lhs.read, *rhs.read)) && is_same_context(lhs, rhs);
+}
+
+} // namespace octopus
@@ -0,0 +1,134 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef read_likelihood_cache_hpp
+#define read_likelihood_cache_hpp
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <memory>
+#include <cstddef>
+
+#include <boost/optional.hpp>
+
+#include "basics/aligned_read.hpp"
+#include "core/types/haplotype.hpp"
+#include "utils/memory_footprint.hpp"
+#include "haplotype_likelihood_model.hpp"
+
+namespace octopus {
+
+/*
+    ReadLikelihoodCache remembers p(read | haplotype) across HaplotypeLikelihoodArray populations,
+    so reads that are evaluated again against the same local haplotype sequence in a later (e.g.
+    extended or backtracked) active region are not realigned.
+
+    Entries are keyed on the read and on the haplotype context around the read: the haplotype
+    sequence within one read length (plus the pair HMM pad) of the read, the SNV priors and gap
+    penalties the likelihood model set over it, where the read sits in that context, and how the
+    context meets the haplotype ends and inactive flanks. Fingerprints of the read and context are
+    only used for bucketing; keys own copies of the read data and haplotype context they were made
+    from (shared between keys) so they are compared exactly.
+
+    A read only gets a key if the pair HMM band at each position it is evaluated at, including every
+    kmer mapping position in the whole haplotype, lies inside the context, and the mapper did not stop
+    at its position limit. Mapping positions are those with the most kmer hits, and the hit counts of
+    positions with bands inside the context only depend on the context, so two haplotypes with equal
+    contexts for a keyed read give it the same mapping positions and likelihood.
+
+    The cache is cleared whenever it would exceed its memory budget.
+ */
+class ReadLikelihoodCache
+{
+public:
+    using LogProbability     = HaplotypeLikelihoodModel::LogProbability;
+    using FlankState         = HaplotypeLikelihoodModel::FlankState;
+    using Penalty            = HaplotypeLikelihoodModel::Penalty;
+    using MappingPositionItr = HaplotypeLikelihoodModel::MappingPositionItr;
+
+    using NucleotideSequence = Haplotype::NucleotideSequence;
+
+    // The parts of a read that can affect its likelihood
+    struct ReadIdentity
+    {
+        std::size_t fingerprint;
+        GenomicRegion::ContigName contig;
+        GenomicRegion::Position begin;
+        AlignedRead::MappingQuality mapping_quality;
+        bool is_reverse_mapped;
+        AlignedRead::NucleotideSequence sequence;
+        AlignedRead::BaseQualityVector base_qualities;
+    };
+
+    // A haplotype sequence and the mutation model parameters set for it
+    struct HaplotypeContext
+    {
+        NucleotideSequence sequence;
+        std::vector<char> snv_forward_mask, snv_reverse_mask;
+        std::vector<Penalty> snv_forward_priors, snv_reverse_priors, gap_open, gap_extend;
+    };
+
+    struct Key
+    {
+        std::size_t read_fingerprint, context_fingerprint;
+        std::shared_ptr<const ReadIdentity> read;
+        std::shared_ptr<const HaplotypeContext> haplotype;
+        long context_begin, context_end, read_begin;
+        bool has_flank_state;
+        long lhs_flank_overlap, rhs_flank_overlap;
+    };
+
+    ReadLikelihoodCache() = delete;
+
+    ReadLikelihoodCache(MemoryFootprint max_memory);
+
+    ReadLikelihoodCache(const ReadLikelihoodCache&)            = default;
+    ReadLikelihoodCache& operator=(const ReadLikelihoodCache&) = default;
+    ReadLikelihoodCache(ReadLikelihoodCache&&)                 = default;
+    ReadLikelihoodCache& operator=(ReadLikelihoodCache&&)      = default;
+
+    ~ReadLikelihoodCache() = default;
+
+    static std::shared_ptr<const ReadIdentity> identify(const AlignedRead& read);
+    // model must have been reset with haplotype
+    static std::shared_ptr<const HaplotypeContext> share_context(const Haplotype& haplotype, const HaplotypeLikelihoodModel& model);
+
+    // The mapping positions are those found for the read in the whole haplotype, at most max_mapping_positions.
+    // Returns none if the likelihood could depend on the haplotype outside the context.
+    static boost::optional<Key>
+    make_key(const std::shared_ptr<const ReadIdentity>& read_identity, const AlignedRead& read,
+             const std::shared_ptr<const HaplotypeContext>& haplotype_context, const Haplotype& haplotype,
+             const boost::optional<FlankState>& flank_state,
+             MappingPositionItr first_mapping_position, MappingPositionItr last_mapping_position,
+             std::size_t max_mapping_positions) noexcept;
+
+    boost::optional<LogProbability> find(const Key& key) noexcept;
+
+    void insert(const Key& key, LogProbability likelihood);
+
+    std::size_t size() const noexcept;
+    std::size_t num_hits() const noexcept;
+    std::size_t num_misses() const noexcept;
+
+    void clear() noexcept;
+
+private:
+    struct KeyHash
+    {
+        std::size_t operator()(const Key& key) const noexcept;
+    };
+    struct KeyEqual
+    {
+        bool operator()(const Key& lhs, const Key& rhs) const noexcept;
+    };
+
+    std::unordered_map<Key, LogProbability, KeyHash, KeyEqual> likelihoods_;
+    std::unordered_set<const void*> counted_shared_data_;
+    std::size_t max_bytes_, bytes_ = 0;
+    std::size_t num_hits_ = 0, num_misses_ = 0;
+};
+
+} // namespace octopus
+
+#endif
@@ -7,6 +7,7 @@
 #include <deque>
 #include <queue>
 #include <map>
+#include <unordered_map>
 #include <set>
 #include <algorithm>
 #include <numeric>
@@ -19,12 +20,14 @@
 #include <condition_variable>
 #include <mutex>
 #include <atomic>
+#include <exception>
 #include <chrono>
 #include <sstream>
 #include <iostream>
 #include <cassert>
 
 #include <boost/optional.hpp>
+#include <boost/filesystem/operations.hpp>
 
 #include "config/common.hpp"
 #include "basics/genomic_region.hpp"
@@ -37,6 +40,7 @@
 #include "readpipe/read_pipe_fwd.hpp"
 #include "readpipe/buffered_read_pipe.hpp"
 #include "utils/mappable_algorithms.hpp"
+#include "utils/repeat_finder.hpp"
 #include "utils/read_stats.hpp"
 #include "utils/append.hpp"
 #include "config/octopus_vcf.hpp"
@@ -49,6 +53,9 @@
 #include "core/tools/vcf_header_factory.hpp"
 #include "io/variant/vcf.hpp"
 #include "utils/timing.hpp"
+#include "utils/work_stealing_deque.hpp"
+#include "utils/mpsc_queue.hpp"
+#include "utils/executor.hpp"
 #include "exceptions/program_error.hpp"
 #include "exceptions/system_error.hpp"
 #include "csr/filters/variant_call_filter.hpp"
@@ -56,6 +63,9 @@
 #include "readpipe/buffered_read_pipe.hpp"
 #include "core/tools/bam_realigner.hpp"
 #include "core/tools/indel_profiler.hpp"
+#include "core/models/pairhmm/simd_pair_hmm.hpp"
+#include "calling_task.hpp"
+#include "task_writer.hpp"
 
 #include "timers.hpp" // BENCHMARK
 
@@ -146,15 +156,17 @@ auto get_call_types(const GenomeCallingComponents& components, const std::vector
     return result;
 }
 
-void write_caller_output_header(GenomeCallingComponents& components, const std::string& command)
+VcfHeader write_caller_output_header(GenomeCallingComponents& components, const std::string& command)
 {
     const auto call_types = get_call_types(components, components.contigs());
     if (components.sites_only() && !apply_csr(components)) {
-        components.output() << make_vcf_header({}, components.contigs(), components.reference(),
-                                               call_types, command);
+        auto result = make_vcf_header({}, components.contigs(), components.reference(), call_types, command);
+        components.output() << result;
+        return result;
     } else {
-        components.output() << make_vcf_header(components.samples(), components.contigs(),
-                                               components.reference(), call_types, command);
+        auto result = make_vcf_header(components.samples(), components.contigs(), components.reference(), call_types, command);
+        components.output() << result;
+        return result;
     }
 }
 
@@ -240,6 +252,8 @@ void log_startup_info(const GenomeCallingComponents& components)
     } else {
         sl << "stdout";
     }
+    static auto debug_log = get_debug_log();
+    if (debug_log) stream(*debug_log) << "Using " << hmm::simd::to_string(hmm::simd::get_instruction_set()) << " pair HMM kernels";
 }
 
 VcfWriter& get_final_output(GenomeCallingComponents& components)
@@ -272,19 +286,6 @@ void log_finish_info(const GenomeCallingComponents& components, const utils::Tim
     if (output_path) stream(info_log) << "Calls have been written to " << *output_path;
 }
 
-void write_calls(std::deque<VcfRecord>&& calls, VcfWriter& out)
-{
-    if (calls.empty()) return;
-    static auto debug_log = get_debug_log();
-    if (debug_log) stream(*debug_log) << "Writing " << calls.size() << " calls to output";
-    const bool was_closed {!out.is_open()};
-    if (was_closed) out.open();
-    write(calls, out);
-    if (was_closed) out.close();
-    calls.clear();
-    calls.shrink_to_fit();
-}
-
 auto find_max_window(const ContigCallingComponents& components,
                      const GenomicRegion& remaining_call_region)
 {
@@ -402,7 +403,7 @@ void resolve_connecting_calls(std::vector<VcfRecord>& old_connecting_calls,
     }
 }
 
-void run_octopus_on_contig(ContigCallingComponents&& components)
+void run_octopus_on_contig(ContigCallingComponents&& components, FusedCallFilter filter)
 {
     // TODO: refactor to use connection resolution developed for multithreaded version
     static auto debug_log = get_debug_log();
@@ -440,7 +441,7 @@ void run_octopus_on_contig(ContigCallingComponents&& components)
         
         buffer_connecting_calls(calls, next_subregion, connecting_calls);
         try {
-            write_calls(std::move(calls), components.output);
+            write_calls(std::move(calls), components.output, filter);
         } catch(...) {
             // TODO: which exceptions can we recover from?
             throw;
@@ -449,14 +450,14 @@ void run_octopus_on_contig(ContigCallingComponents&& components)
     }
 }
 
-void run_octopus_single_threaded(GenomeCallingComponents& components)
+void run_octopus_single_threaded(GenomeCallingComponents& components, FusedCallFilter filter)
 {
     #ifdef BENCHMARK
     init_timers();
     #endif
     components.progress_meter().start();
     for (const auto& contig : components.contigs()) {
-        run_octopus_on_contig(ContigCallingComponents {contig, components});
+        run_octopus_on_contig(ContigCallingComponents {contig, components}, filter);
     }
     components.progress_meter().stop();
     #ifdef BENCHMARK
@@ -503,151 +504,399 @@ VcfWriter create_unique_temp_output_file(const GenomicRegion::ContigName& contig
     return create_unique_temp_output_file(components.reference().contig_region(contig), components);
 }
 
-using TempVcfWriterMap = std::unordered_map<ContigName, VcfWriter>;
+// Sent by the task maker once all tasks for a contig have been scheduled
+struct MadeContigTasks
+{
+    ContigName contig;
+    std::size_t num_tasks;
+};
 
-TempVcfWriterMap make_temp_vcf_writers(const GenomeCallingComponents& components)
+struct TaskOutcome
 {
-    if (!components.temp_directory()) {
-        throw std::runtime_error {"Could not make temp writers"};
-    }
-    TempVcfWriterMap result {};
-    result.reserve(components.contigs().size());
-    for (const auto& contig : components.contigs()) {
-        auto contig_writer = create_unique_temp_output_file(contig, components);
-        contig_writer.close();
-        result.emplace(contig, std::move(contig_writer));
-    }
-    return result;
-}
+    boost::optional<CompletedTask> task = boost::none;
+    boost::optional<MadeContigTasks> made_contig = boost::none;
+    std::exception_ptr error = nullptr;
+};
 
-struct Task : public Mappable<Task>
+// Runs calling tasks on a persistent pool of workers. Each worker owns a deque of pending tasks
+// and steals from other workers when its own deque is empty, so there is no shared task queue to
+// contend on. Completed tasks are passed to the consuming thread through a lock-free queue.
+// Idle workers, and the consumer when there is nothing to consume, block until they are notified.
+class CallingTaskScheduler
 {
-    GenomicRegion region;
-    ExecutionPolicy policy;
+public:
+    using TaskMaker = std::function<void(CallingTaskScheduler&)>;
+    
+    CallingTaskScheduler() = delete;
+    
+    CallingTaskScheduler(GenomeCallingComponents& components, unsigned num_workers);
+    
+    CallingTaskScheduler(const CallingTaskScheduler&)            = delete;
+    CallingTaskScheduler& operator=(const CallingTaskScheduler&) = delete;
+    CallingTaskScheduler(CallingTaskScheduler&&)                 = delete;
+    CallingTaskScheduler& operator=(CallingTaskScheduler&&)      = delete;
     
-    Task() = delete;
+    ~CallingTaskScheduler() noexcept;
     
-    Task(GenomicRegion region, ExecutionPolicy policy = ExecutionPolicy::seq)
-    : region {std::move(region)}
-    , policy {policy}
-    {};
+    unsigned num_workers() const noexcept;
     
-    const GenomicRegion& mapped_region() const noexcept { return region; }
+    // The task maker runs on its own thread and must call finish once it has pushed all tasks
+    void start(TaskMaker task_maker);
+    
+    // Returns false if the scheduler has been stopped and the task was not accepted
+    bool push(Task task);
+    // Tells the consumer that all tasks for the contig have been pushed
+    void finish(ContigName contig, std::size_t num_tasks);
+    void finish() noexcept;
+    
+    // Blocks until a task completes, or a contig is finished. Returns boost::none once all tasks have completed.
+    boost::optional<TaskOutcome> pop();
+    
+    void stop() noexcept;
+    
+private:
+    GenomeCallingComponents& components_;
+    
+    std::vector<std::unique_ptr<WorkStealingDeque<Task>>> pending_tasks_;
+    std::vector<std::thread> workers_;
+    std::thread task_maker_;
+    std::atomic<std::size_t> next_worker_, num_pending_, num_unfinished_, num_parked_;
+    std::atomic<bool> finished_, stopped_, consumer_waiting_;
+    std::mutex park_mutex_, consumer_mutex_;
+    std::condition_variable park_cv_, consumer_cv_;
+    MPSCQueue<TaskOutcome> completed_tasks_;
+    
+    void run_worker(std::size_t id);
+    boost::optional<Task> try_take(std::size_t id);
+    void park();
+    void complete(TaskOutcome outcome);
+    void notify_consumer();
 };
 
-std::ostream& operator<<(std::ostream& os, const Task& task)
+CallingTaskScheduler::CallingTaskScheduler(GenomeCallingComponents& components, const unsigned num_workers)
+: components_ {components}
+, pending_tasks_ {}
+, workers_ {}
+, task_maker_ {}
+, next_worker_ {0}
+, num_pending_ {0}
+, num_unfinished_ {0}
+, num_parked_ {0}
+, finished_ {false}
+, stopped_ {false}
+, consumer_waiting_ {false}
+, completed_tasks_ {}
 {
-    os << task.region;
-    return os;
+    pending_tasks_.reserve(std::max(num_workers, 1u));
+    for (unsigned i {0}; i < std::max(num_workers, 1u); ++i) {
+        pending_tasks_.push_back(std::make_unique<WorkStealingDeque<Task>>());
+    }
+    workers_.reserve(pending_tasks_.size());
+    for (std::size_t i {0}; i < pending_tasks_.size(); ++i) {
+        workers_.emplace_back(&CallingTaskScheduler::run_worker, this, i);
+    }
 }
 
-struct ContigOrder
+CallingTaskScheduler::~CallingTaskScheduler() noexcept
+{
+    stop();
+    if (task_maker_.joinable()) task_maker_.join();
+    for (auto& worker : workers_) {
+        if (worker.joinable()) worker.join();
+    }
+}
+
+unsigned CallingTaskScheduler::num_workers() const noexcept
+{
+    return workers_.size();
+}
+
+void CallingTaskScheduler::start(TaskMaker task_maker)
+{
+    assert(!task_maker_.joinable());
+    task_maker_ = std::thread {std::move(task_maker), std::ref(*this)};
+}
+
+bool CallingTaskScheduler::push(Task task)
+{
+    if (stopped_) return false;
+    static auto debug_log = get_debug_log();
+    if (debug_log) stream(*debug_log) << "Scheduling task " << task;
+    ++num_unfinished_;
+    pending_tasks_[next_worker_++ % pending_tasks_.size()]->push(std::move(task));
+    ++num_pending_;
+    if (num_parked_ > 0) {
+        { std::lock_guard<std::mutex> lk {park_mutex_}; }
+        park_cv_.notify_one();
+    }
+    return true;
+}
+
+void CallingTaskScheduler::finish(ContigName contig, const std::size_t num_tasks)
+{
+    TaskOutcome outcome {};
+    outcome.made_contig = MadeContigTasks {std::move(contig), num_tasks};
+    completed_tasks_.push(std::move(outcome));
+    notify_consumer();
+}
+
+void CallingTaskScheduler::finish() noexcept
+{
+    finished_ = true;
+    notify_consumer();
+}
+
+boost::optional<TaskOutcome> CallingTaskScheduler::pop()
+{
+    while (true) {
+        auto result = completed_tasks_.try_pop();
+        if (result) return result;
+        if (finished_ && num_unfinished_ == 0) {
+            // Workers only mark a task finished once its outcome is pushed
+            return completed_tasks_.try_pop();
+        }
+        std::unique_lock<std::mutex> lk {consumer_mutex_};
+        consumer_waiting_ = true;
+        // Pairs with the fence in notify_consumer so either we see the new outcome or the producer sees us waiting
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        consumer_cv_.wait(lk, [this] () { return !completed_tasks_.empty() || (finished_ && num_unfinished_ == 0); });
+        consumer_waiting_ = false;
+    }
+}
+
+void CallingTaskScheduler::stop() noexcept
 {
-    using ContigName = GenomicRegion::ContigName;
-    
-    template <typename Container>
-    ContigOrder(const Container& contigs)
-    : contigs_ {std::cbegin(contigs)
-    , std::cend(contigs)}
-    {}
-    
-    bool operator()(const ContigName& lhs, const ContigName& rhs) const
     {
-        const auto it1 = std::find(std::cbegin(contigs_), std::cend(contigs_), lhs);
-        const auto it2 = std::find(std::cbegin(contigs_), std::cend(contigs_), rhs);
-        return it1 < it2;
+        std::lock_guard<std::mutex> lk {park_mutex_};
+        stopped_ = true;
+    }
+    park_cv_.notify_all();
+}
+
+void CallingTaskScheduler::run_worker(const std::size_t id)
+{
+    static auto debug_log = get_debug_log();
+    const auto executor = get_executor();
+    boost::optional<ContigCallingComponents> calling_components {};
+    boost::optional<ContigName> calling_contig {};
+    while (!stopped_) {
+        auto task = try_take(id);
+        if (!task) {
+            park();
+            continue;
+        }
+        if (debug_log) stream(*debug_log) << "Worker " << id << " starting task " << *task;
+        TaskOutcome outcome {};
+        try {
+            // Parallel work within the task may only use helpers while there are spare cores
+            const Executor::Participant participant {executor.get()};
+            // Callers are reused for consecutive tasks on the same contig
+            if (!calling_contig || *calling_contig != contig_name(*task)) {
+                calling_components = boost::none;
+                calling_contig = contig_name(*task);
+                calling_components.emplace(*calling_contig, components_);
+            }
+            CompletedTask result {*task};
+            result.runtime.start = std::chrono::system_clock::now();
+            result.calls = calling_components->caller->call(task->region, calling_components->progress_meter);
+            result.runtime.end = std::chrono::system_clock::now();
+            outcome.task = std::move(result);
+        } catch (...) {
+            logging::ErrorLogger error_log {};
+            stream(error_log) << "Encountered a problem whilst calling " << *task;
+            outcome.error = std::current_exception();
+        }
+        complete(std::move(outcome));
     }
+}
+
+boost::optional<Task> CallingTaskScheduler::try_take(const std::size_t id)
+{
+    auto result = pending_tasks_[id]->pop();
+    for (std::size_t i {1}; !result && i < pending_tasks_.size(); ++i) {
+        result = pending_tasks_[(id + i) % pending_tasks_.size()]->steal();
+    }
+    if (result) --num_pending_;
+    return result;
+}
+
+void CallingTaskScheduler::park()
+{
+    std::unique_lock<std::mutex> lk {park_mutex_};
+    ++num_parked_;
+    park_cv_.wait(lk, [this] () { return num_pending_ > 0 || stopped_; });
+    --num_parked_;
+}
+
+void CallingTaskScheduler::complete(TaskOutcome outcome)
+{
+    completed_tasks_.push(std::move(outcome));
+    --num_unfinished_;
+    notify_consumer();
+}
+
+void CallingTaskScheduler::notify_consumer()
+{
+    // The outcome push is only a release store, so without this fence the load of consumer_waiting_
+    // could be ordered before it and miss a consumer that has just checked the queue
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (consumer_waiting_) {
+        { std::lock_guard<std::mutex> lk {consumer_mutex_}; }
+        consumer_cv_.notify_one();
+    }
+}
+
+// Predicts the relative cost of calling a region. Calling time is dominated by the number of reads
+// and, in repetitive sequence, by the number of candidate haplotypes, so reads in tandem repeat
+// regions are weighted more heavily. Predictions are logged next to actual task runtimes so the
+// parameters can be tuned.
+class TaskCostModel
+{
+public:
+    struct Parameters
+    {
+        double read_cost = 1.0;
+        double repeat_read_cost = 4.0; // additional cost of a read in fully repetitive sequence
+        double base_cost = 0.01;
+    };
+    
+    TaskCostModel() = delete;
+    
+    TaskCostModel(const ContigCallingComponents& components);
+    TaskCostModel(const ContigCallingComponents& components, Parameters params);
+    
+    TaskCost predict(const GenomicRegion& region) const;
+    
+    // The cost of a task that fills the read buffer in non-repetitive sequence
+    double target() const noexcept;
     
 private:
-    std::vector<ContigName> contigs_;
+    const ContigCallingComponents& components_;
+    Parameters params_;
 };
 
-using TaskQueue = std::queue<Task>;
-using TaskMap   = std::map<ContigName, TaskQueue, ContigOrder>;
+TaskCostModel::TaskCostModel(const ContigCallingComponents& components)
+: TaskCostModel {components, Parameters {}}
+{}
 
-auto count_tasks(const TaskMap& tasks) noexcept
+TaskCostModel::TaskCostModel(const ContigCallingComponents& components, Parameters params)
+: components_ {components}
+, params_ {params}
+{}
+
+TaskCost TaskCostModel::predict(const GenomicRegion& region) const
 {
-    return std::accumulate(std::cbegin(tasks), std::cend(tasks), std::size_t {0},
-                           [] (auto curr, const auto& p) noexcept { return curr + p.second.size(); });
+    TaskCost result {};
+    result.num_reads = components_.read_manager.get().count_reads(components_.samples, region);
+    if (result.num_reads > 0 && !is_empty(region)) {
+        const auto repeat_regions = find_repeat_regions(components_.reference, region);
+        result.repeat_fraction = static_cast<double>(sum_region_sizes(repeat_regions)) / size(region);
+    }
+    result.predicted = result.num_reads * (params_.read_cost + params_.repeat_read_cost * result.repeat_fraction)
+                       + params_.base_cost * size(region);
+    return result;
 }
 
-struct TaskMakerSyncPacket
+double TaskCostModel::target() const noexcept
 {
-    TaskMakerSyncPacket() : batch_size_hint {1}, waiting {true}, num_tasks {0}, finished {}, all_done {false} {}
-    std::condition_variable cv;
-    std::mutex mutex;
-    bool ready = true;
-    std::atomic_uint batch_size_hint; // Only read by task maker
-    std::atomic_bool waiting; // Only read by task maker
-    std::atomic_uint num_tasks;
-    std::unordered_map<ContigName, bool> finished;
-    std::atomic_bool all_done;
-};
+    return params_.read_cost * components_.read_buffer_size;
+}
+
+void merge(Task& lhs, const Task& rhs)
+{
+    const auto lhs_size = size(lhs.region), rhs_size = size(rhs.region);
+    lhs.region = encompassing_region(lhs, rhs);
+    lhs.cost.num_reads += rhs.cost.num_reads;
+    if (lhs_size + rhs_size > 0) {
+        lhs.cost.repeat_fraction = (lhs.cost.repeat_fraction * lhs_size + rhs.cost.repeat_fraction * rhs_size) / (lhs_size + rhs_size);
+    }
+    lhs.cost.predicted += rhs.cost.predicted;
+}
 
-void make_region_tasks(const GenomicRegion& region, const ContigCallingComponents& components, const ExecutionPolicy policy,
-                       TaskQueue& result, TaskMakerSyncPacket& sync, const bool last_region_in_contig, const bool last_contig)
+void split_costly_task(Task task, const TaskCostModel& cost_model, const GenomicRegion::Size min_size,
+                       std::vector<Task>& result)
 {
-    static constexpr GenomicRegion::Size minTaskSize {5'000};
-    std::unique_lock<std::mutex> lock {sync.mutex, std::defer_lock};
+    if (task.cost.predicted > 2 * cost_model.target() && size(task.region) >= 2 * min_size) {
+        const auto mid = task.region.begin() + size(task.region) / 2;
+        Task lhs {GenomicRegion {task.region.contig_name(), task.region.begin(), mid}, task.policy};
+        Task rhs {GenomicRegion {task.region.contig_name(), mid, task.region.end()}, task.policy};
+        lhs.cost = cost_model.predict(lhs.region);
+        rhs.cost = cost_model.predict(rhs.region);
+        split_costly_task(std::move(lhs), cost_model, min_size, result);
+        split_costly_task(std::move(rhs), cost_model, min_size, result);
+    } else {
+        result.push_back(std::move(task));
+    }
+}
+
+void add_task(Task task, const TaskCostModel& cost_model, const std::size_t max_reads, std::vector<Task>& batch)
+{
+    // Consecutive cheap tasks are merged to amortise the per-task overhead
+    if (!batch.empty()) {
+        auto& prev = batch.back();
+        if (are_adjacent(prev, task) && prev.cost.predicted + task.cost.predicted <= cost_model.target()
+            && prev.cost.num_reads + task.cost.num_reads <= max_reads) {
+            merge(prev, task);
+            return;
+        }
+    }
+    batch.push_back(std::move(task));
+}
+
+// Tasks are numbered in genomic order, for writing, but scheduled most costly first so that
+// expensive tasks do not start last and leave the remaining workers idle
+bool schedule(std::vector<Task>& batch, std::size_t& task_index, CallingTaskScheduler& scheduler)
+{
+    static auto debug_log = get_debug_log();
+    for (auto& task : batch) task.index = task_index++;
+    std::stable_sort(std::begin(batch), std::end(batch),
+                     [] (const Task& lhs, const Task& rhs) { return lhs.cost.predicted > rhs.cost.predicted; });
+    for (auto& task : batch) {
+        if (debug_log) stream(*debug_log) << "Task " << task << " has predicted cost " << task.cost;
+        if (!scheduler.push(std::move(task))) return false;
+    }
+    batch.clear();
+    return true;
+}
+
+bool make_region_tasks(const GenomicRegion& region, const ContigCallingComponents& components,
+                       const TaskCostModel& cost_model, const ExecutionPolicy policy,
+                       std::size_t& task_index, CallingTaskScheduler& scheduler)
+{
+    static constexpr GenomicRegion::Size minTaskSize {5'000}, minSplitTaskSize {1'000};
+    const std::size_t max_batch_size {2 * scheduler.num_workers()};
+    std::vector<Task> batch {}, splits {};
+    batch.reserve(max_batch_size + 1);
     auto subregion = propose_call_subregion(components, region, minTaskSize);
-    if (ends_equal(subregion, region)) {
-        lock.lock();
-        sync.cv.wait(lock, [&] () { return sync.ready; });
-        result.emplace(std::move(subregion), policy);
-        ++sync.num_tasks;
-        if (last_region_in_contig) {
-            sync.finished.at(region.contig_name()) = true;
-            if (last_contig) sync.all_done = true;
+    while (true) {
+        assert(!ends_before(region, subregion));
+        const bool done {ends_equal(subregion, region)};
+        Task task {subregion, policy};
+        task.cost = cost_model.predict(subregion);
+        split_costly_task(std::move(task), cost_model, minSplitTaskSize, splits);
+        for (auto& split : splits) {
+            add_task(std::move(split), cost_model, components.read_buffer_size, batch);
         }
-        lock.unlock();
-        sync.cv.notify_one();
-    } else {
-        std::deque<GenomicRegion> batch {};
-        batch.push_back(subregion);
-        bool done {false};
-        while (true) {
-            while (batch.size() < std::max(sync.batch_size_hint.load(), 1u) || !sync.waiting) {
-                subregion = propose_call_subregion(components, subregion, region, minTaskSize);
-                batch.push_back(subregion);
-                assert(!ends_before(region, subregion));
-                if (ends_equal(subregion, region)) {
-                    done = true;
-                    break;
-                }
-            }
-            assert(!batch.empty());
-            assert(!lock.owns_lock());
-            lock.lock();
-            sync.cv.wait(lock, [&] () { return sync.ready; });
-            for (auto&& r : batch) result.emplace(std::move(r), policy);
-            sync.num_tasks += batch.size();
-            if (done) {
-                if (last_region_in_contig) {
-                    sync.finished.at(region.contig_name()) = true;
-                    if (last_contig) sync.all_done = true;
-                } else {
-                    assert(!last_contig);
-                }
-                lock.unlock();
-                sync.cv.notify_one();
-                break;
-            } else {
-                batch.clear();
-                lock.unlock();
-                sync.cv.notify_one();
-            }
+        splits.clear();
+        if (done || batch.size() > max_batch_size) {
+            if (!schedule(batch, task_index, scheduler)) return false;
         }
+        if (done) return true;
+        subregion = propose_call_subregion(components, subregion, region, minTaskSize);
     }
 }
 
-void make_contig_tasks(const ContigCallingComponents& components, const ExecutionPolicy policy,
-                       TaskQueue& result, TaskMakerSyncPacket& sync, const bool last_contig)
+// Returns the number of tasks made, or boost::none if the scheduler stopped before all tasks were made
+boost::optional<std::size_t>
+make_contig_tasks(const ContigCallingComponents& components, const ExecutionPolicy policy,
+                  CallingTaskScheduler& scheduler)
 {
-    if (components.regions.empty()) return;
-    std::for_each(std::cbegin(components.regions), std::prev(std::cend(components.regions)), [&] (const auto& region) {
-        make_region_tasks(region, components, policy, result, sync, false, last_contig);
-    });
-    make_region_tasks(components.regions.back(), components, policy, result, sync, true, last_contig);
+    const TaskCostModel cost_model {components};
+    std::size_t task_index {0};
+    for (const auto& region : components.regions) {
+        if (!make_region_tasks(region, components, cost_model, policy, task_index, scheduler)) return boost::none;
+    }
+    return task_index;
 }
 
 ExecutionPolicy make_execution_policy(const GenomeCallingComponents& components)
@@ -665,20 +914,25 @@ auto make_contig_components(const ContigName& contig, GenomeCallingComponents& c
     return result;
 }
 
-void make_tasks_helper(TaskMap& tasks, std::vector<ContigName> contigs, GenomeCallingComponents& components,
-                       const unsigned num_threads, ExecutionPolicy execution_policy, TaskMakerSyncPacket& sync)
+void make_tasks_helper(CallingTaskScheduler& scheduler, const std::vector<ContigName>& contigs,
+                       GenomeCallingComponents& components, ExecutionPolicy execution_policy)
 {
     try {
         static auto debug_log = get_debug_log();
         if (debug_log) stream(*debug_log) << "Making tasks for " << contigs.size() << " contigs";
-        for (std::size_t i {0}; i < contigs.size(); ++i) {
-            const auto& contig = contigs[i];
+        for (const auto& contig : contigs) {
             if (debug_log) stream(*debug_log) << "Making tasks for contig " << contig;
-            auto contig_components = make_contig_components(contig, components, num_threads);
-            make_contig_tasks(contig_components, execution_policy, tasks[contig], sync, i == contigs.size() - 1);
+            auto contig_components = make_contig_components(contig, components, scheduler.num_workers());
+            const auto num_tasks = make_contig_tasks(contig_components, execution_policy, scheduler);
+            if (!num_tasks) {
+                if (debug_log) *debug_log << "Task scheduler stopped before all tasks were made";
+                break;
+            }
+            scheduler.finish(contig, *num_tasks);
             if (debug_log) stream(*debug_log) << "Finished making tasks for contig " << contig;
         }
         if (debug_log) *debug_log << "Finished making tasks";
+        scheduler.finish();
     } catch (const Error& e) {
         log_error(e);
         logging::FatalLogger fatal_log {};
@@ -696,20 +950,13 @@ void make_tasks_helper(TaskMap& tasks, std::vector<ContigName> contigs, GenomeCa
     }
 }
 
-std::thread make_task_maker_thread(TaskMap& tasks, GenomeCallingComponents& components, const unsigned num_threads,
-                                   TaskMakerSyncPacket& sync)
+void start_task_maker(CallingTaskScheduler& scheduler, GenomeCallingComponents& components)
 {
     auto contigs = components.contigs();
-    if (contigs.empty()) {
-        sync.all_done = true;
-        return std::thread {};
-    }
-    sync.finished.reserve(contigs.size());
-    for (const auto& contig : contigs) {
-        sync.finished.emplace(contig, false);
-    }
-    return std::thread {make_tasks_helper, std::ref(tasks), std::move(contigs), std::ref(components),
-                        num_threads, make_execution_policy(components), std::ref(sync)};
+    const auto execution_policy = make_execution_policy(components);
+    scheduler.start([contigs = std::move(contigs), &components, execution_policy] (CallingTaskScheduler& scheduler) {
+        make_tasks_helper(scheduler, contigs, components, execution_policy);
+    });
 }
 
 unsigned calculate_num_task_threads(const GenomeCallingComponents& components)
@@ -724,117 +971,30 @@ unsigned calculate_num_task_threads(const GenomeCallingComponents& components)
     return num_cores;
 }
 
-Task pop(TaskMap& tasks, TaskMakerSyncPacket& sync)
+void log_executor_metrics(logging::DebugLogger& log)
 {
-    assert(!tasks.empty());
-    std::unique_lock<std::mutex> lock {sync.mutex};
-    sync.ready = false;
-    assert(sync.num_tasks > 0);
-    const auto contig_task_itr = std::begin(tasks);
-    assert(!contig_task_itr->second.empty());
-    const auto result = std::move(contig_task_itr->second.front());
-    contig_task_itr->second.pop();
-    if (sync.finished.at(contig_task_itr->first) && contig_task_itr->second.empty()) {
-        static auto debug_log = get_debug_log();
-        if (debug_log) stream(*debug_log) << "Finished calling contig " << contig_task_itr->first;
-        tasks.erase(contig_task_itr);
+    const auto executor = get_executor();
+    if (!executor) return;
+    for (const auto& p : executor->metrics()) {
+        stream(log) << "Executor callsite " << p.first << ": " << p.second.submissions << " submissions, "
+                    << p.second.tasks << " tasks, " << p.second.helper_tasks << " run by helpers, "
+                    << p.second.refused_helpers << " helpers refused";
     }
-    --sync.num_tasks;
-    sync.ready = true;
-    lock.unlock();
-    sync.cv.notify_one();
-    return result;
-}
-
-struct CompletedTask : public Task
-{
-    CompletedTask(Task task) : Task {std::move(task)}, calls {}, runtime {} {}
-    std::deque<VcfRecord> calls;
-    utils::TimeInterval runtime;
-};
-
-std::string duration(const CompletedTask& task)
-{
-    std::ostringstream ss {};
-    ss << task.runtime;
-    return ss.str();
 }
 
-std::ostream& operator<<(std::ostream& os, const CompletedTask& task)
+// Completed tasks for a contig that cannot be written until all preceding tasks have completed.
+// The last written task is held back to enable connection resolution when the next task completes.
+// The number of tasks is known once the task maker has finished the contig.
+struct CompletedTaskBuffer
 {
-    os << task.region;
-    return os;
-}
-
-struct CallerSyncPacket
-{
-    CallerSyncPacket() : num_finished {0} {}
-    std::condition_variable cv;
-    std::mutex mutex;
-    std::atomic_uint num_finished;
+    std::size_t next_index = 0;
+    std::map<std::size_t, CompletedTask> pending = {};
+    boost::optional<CompletedTask> holdback = boost::none;
+    boost::optional<std::size_t> num_tasks = boost::none;
+    bool closed = false;
 };
 
-template<typename R>
-bool is_ready(const std::future<R>& f)
-{
-    return f.valid() && f.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
-}
-
-auto run(Task task, ContigCallingComponents components, CallerSyncPacket& sync)
-{
-    static auto debug_log = get_debug_log();
-    if (debug_log) stream(*debug_log) << "Spawning task " << task;
-    return std::async(std::launch::async, [task = std::move(task), components = std::move(components), &sync] () {
-        try {
-            CompletedTask result {task};
-            result.runtime.start = std::chrono::system_clock::now();
-            result.calls = components.caller->call(task.region, components.progress_meter);
-            result.runtime.end = std::chrono::system_clock::now();
-            std::unique_lock<std::mutex> lock {sync.mutex};
-            ++sync.num_finished;
-            lock.unlock();
-            sync.cv.notify_all();
-            return result;
-        } catch (...) {
-            logging::ErrorLogger error_log {};
-            stream(error_log) << "Encountered a problem whilst calling " << task;
-            using namespace std::chrono_literals;
-            std::this_thread::sleep_for(2s); // Try to make sure the error is logged before raising
-            std::unique_lock<std::mutex> lock {sync.mutex};
-            ++sync.num_finished;
-            lock.unlock();
-            sync.cv.notify_all();
-            throw;
-        }
-    });
-}
-
-using CompletedTaskMap = std::map<ContigName, std::map<ContigRegion, CompletedTask>>;
-using HoldbackTask = boost::optional<std::reference_wrapper<const CompletedTask>>;
-
-auto get_writable_completed_tasks(CompletedTask&& task, CompletedTaskMap::mapped_type& buffered_tasks,
-                                  TaskQueue& running_tasks, HoldbackTask& holdback)
-{
-    std::deque<CompletedTask> result {std::move(task)};
-    while (!running_tasks.empty()) {
-        const auto itr = buffered_tasks.find(contig_region(running_tasks.front()));
-        if (itr != std::end(buffered_tasks)) {
-            result.push_back(std::move(itr->second));
-            buffered_tasks.erase(itr);
-            running_tasks.pop();
-        } else {
-            break;
-        }
-    }
-    if (holdback) {
-        const auto itr = buffered_tasks.find(contig_region(holdback->get()));
-        assert(itr->second < result.front());
-        result.push_front(std::move(itr->second));
-        buffered_tasks.erase(itr);
-        holdback = boost::none;
-    }
-    return result;
-}
+using CompletedTaskBufferMap = std::map<ContigName, CompletedTaskBuffer>;
 
 using ContigCallingComponentFactory    = std::function<ContigCallingComponents()>;
 using ContigCallingComponentFactoryMap = std::map<ContigName, ContigCallingComponentFactory>;
@@ -848,7 +1008,6 @@ auto make_contig_calling_component_factory_map(GenomeCallingComponents& componen
     }
     return result;
 }
-
 auto find_first_lhs_connecting(const std::deque<VcfRecord>& lhs_calls, const GenomicRegion& rhs_region)
 {
     const auto rhs_begin = mapped_begin(rhs_region);
@@ -931,246 +1090,112 @@ void resolve_connecting_calls(std::deque<CompletedTask>& adjacent_tasks,
                   [&] (auto& rhs) { resolve_connecting_calls(*lhs++, rhs, calling_components); });
 }
 
-struct TaskWriterSyncPacket
+// Calls buffered by the OrderedTaskWriter are only spilled if there is a temporary directory
+OrderedTaskWriter::SpillFileFactory make_spill_file_factory(const GenomeCallingComponents& components)
 {
-    std::condition_variable cv;
-    std::mutex mutex;
-    std::deque<CompletedTask> tasks = {};
-    bool done = false;
-};
-
-void write(std::deque<CompletedTask>& tasks, TempVcfWriterMap& writers)
-{
-    static auto debug_log = get_debug_log();
-    for (auto&& task : tasks) {
-        if (debug_log) {
-            stream(*debug_log) << "Writing completed task " << task << " that finished in " << duration(task);
-        }
-        auto& writer = writers.at(contig_name(task));
-        write_calls(std::move(task.calls), writer);
-    }
-    tasks.clear();
+    if (!components.temp_directory()) return nullptr;
+    return [&components] (const ContigName& contig) { return create_unique_temp_output_file(contig, components); };
 }
 
-void write_temp_vcf_helper(TempVcfWriterMap& writers, TaskWriterSyncPacket& sync)
+auto get_writable_completed_tasks(CompletedTask&& task, CompletedTaskBuffer& buffer)
 {
-    try {
-        std::unique_lock<std::mutex> lock {sync.mutex, std::defer_lock};
-        std::deque<CompletedTask> buffer {};
-        while (!sync.done) {
-            lock.lock();
-            sync.cv.wait(lock, [&] () { return !sync.tasks.empty() || sync.done; });
-            assert(buffer.empty());
-            std::swap(sync.tasks, buffer);
-            lock.unlock();
-            sync.cv.notify_one();
-            write(buffer, writers);
-        }
-        logging::DebugLogger debug_log {};
-        debug_log << "Task writer finished";
-    } catch (const Error& e) {
-        log_error(e);
-        logging::FatalLogger fatal_log {};
-        fatal_log << "Encountered error in task writer thread. Calling terminate";
-        std::terminate();
-    } catch (const std::exception& e) {
-        log_error(e);
-        logging::FatalLogger fatal_log {};
-        fatal_log << "Encountered error in task writer thread. Calling terminate";
-        std::terminate();
-    } catch (...) {
-        logging::FatalLogger fatal_log {};
-        fatal_log << "Encountered error in task writer thread. Calling terminate";
-        std::terminate();
+    assert(task.index == buffer.next_index);
+    std::deque<CompletedTask> result {};
+    if (buffer.holdback) {
+        result.push_back(std::move(*buffer.holdback));
+        buffer.holdback = boost::none;
     }
-}
-
-std::thread make_task_writer_thread(TempVcfWriterMap& temp_writers, TaskWriterSyncPacket& writer_sync)
-{
-    return std::thread {write_temp_vcf_helper, std::ref(temp_writers), std::ref(writer_sync)};
-}
-
-void write(std::deque<CompletedTask>&& tasks, VcfWriter& temp_vcf)
-{
-    static auto debug_log = get_debug_log();
-    for (auto&& task : tasks) {
-        if (debug_log) stream(*debug_log) << "Writing completed task " << task << " that finished in " << duration(task);
-        write_calls(std::move(task.calls), temp_vcf);
+    result.push_back(std::move(task));
+    ++buffer.next_index;
+    auto itr = std::begin(buffer.pending);
+    for (; itr != std::end(buffer.pending) && itr->first == buffer.next_index; ++itr, ++buffer.next_index) {
+        result.push_back(std::move(itr->second));
     }
-}
-
-void write(std::deque<CompletedTask>&& tasks, TaskWriterSyncPacket& sync)
-{
-    std::unique_lock<std::mutex> lock {sync.mutex};
-    utils::append(std::move(tasks), sync.tasks);
-    lock.unlock();
-    sync.cv.notify_one();
+    buffer.pending.erase(std::begin(buffer.pending), itr);
+    return result;
 }
 
 // A CompletedTask can only be written if all proceeding tasks have completed (either written or buffered)
-void write_or_buffer(CompletedTask&& task, CompletedTaskMap::mapped_type& buffered_tasks,
-                     TaskQueue& running_tasks, HoldbackTask& holdback,
-                     TaskWriterSyncPacket& sync, const ContigCallingComponentFactory& calling_components)
+void write_or_buffer(CompletedTask&& task, CompletedTaskBuffer& buffer,
+                     OrderedTaskWriter& writer, const ContigCallingComponentFactory& calling_components)
 {
     static auto debug_log = get_debug_log();
-    if (is_same_region(task, running_tasks.front())) {
-        running_tasks.pop();
-        auto writable_tasks = get_writable_completed_tasks(std::move(task), buffered_tasks, running_tasks, holdback);
-        assert(holdback == boost::none);
+    if (debug_log) stream(*debug_log) << "Completed task " << task << " in " << duration(task)
+                                      << " (predicted cost " << task.cost.predicted << ")";
+    if (task.index == buffer.next_index) {
+        auto writable_tasks = get_writable_completed_tasks(std::move(task), buffer);
         resolve_connecting_calls(writable_tasks, calling_components);
         // Keep the last task buffered to enable connection resolution when the next task finishes
-        const auto p = buffered_tasks.emplace(contig_region(writable_tasks.back()), std::move(writable_tasks.back()));
-        assert(p.second);
-        holdback = p.first->second;
-        if (debug_log) stream(*debug_log) << "Holding back completed task " << *holdback;
+        buffer.holdback = std::move(writable_tasks.back());
         writable_tasks.pop_back();
-        write(std::move(writable_tasks), sync);
+        if (debug_log) stream(*debug_log) << "Holding back completed task " << *buffer.holdback;
+        writer.write(std::move(writable_tasks));
     } else {
         if (debug_log) stream(*debug_log) << "Buffering completed task " << task;
-        buffered_tasks.emplace(contig_region(task), std::move(task));
+        buffer.pending.emplace(task.index, std::move(task));
     }
 }
 
-void wait_until_finished(TaskWriterSyncPacket& sync)
-{
-    std::unique_lock<std::mutex> lock {sync.mutex};
-    sync.cv.wait(lock, [&] () { return sync.tasks.empty(); });
-    sync.done = true;
-    lock.unlock();
-    sync.cv.notify_one();
-}
-
-using FutureCompletedTasks = std::vector<std::future<CompletedTask>>;
-using RemainingTaskMap = std::map<ContigName, std::deque<CompletedTask>>;
-
-void extract_remaining_future_tasks(FutureCompletedTasks& futures, std::deque<CompletedTask>& result)
+auto extract_remaining_tasks(CompletedTaskBuffer& buffer)
 {
-    const auto itr = std::remove_if(std::begin(futures), std::end(futures), [] (const auto& f) { return !f.valid(); });
-    std::transform(std::begin(futures), itr, std::back_inserter(result), [] (auto& fut) { return fut.get(); });
-    futures.clear();
-    futures.shrink_to_fit();
-}
-
-void extract_buffered_tasks(CompletedTaskMap& buffered_tasks, std::deque<CompletedTask>& result)
-{
-    for (auto& p : buffered_tasks) {
-        std::transform(std::make_move_iterator(std::begin(p.second)), std::make_move_iterator(std::end(p.second)),
-                       std::back_inserter(result), [] (auto&& p) { return std::move(p.second); });
-        p.second.clear();
+    std::deque<CompletedTask> result {};
+    if (buffer.holdback) {
+        result.push_back(std::move(*buffer.holdback));
+        buffer.holdback = boost::none;
     }
-    buffered_tasks.clear();
-}
-
-void sort_ignoring_contig_name(std::deque<CompletedTask>& tasks)
-{
-    std::sort(std::begin(tasks), std::end(tasks),
-              [] (const auto& lhs, const auto& rhs) { return contig_region(lhs) < contig_region(rhs); });
-}
-
-RemainingTaskMap make_map(std::deque<CompletedTask>& tasks)
-{
-    sort_ignoring_contig_name(tasks);
-    RemainingTaskMap result {};
-    for (auto&& task : tasks) {
-        result[contig_name(task.region)].push_back(std::move(task));
+    for (auto& p : buffer.pending) {
+        result.push_back(std::move(p.second));
     }
+    buffer.pending.clear();
     return result;
 }
 
-RemainingTaskMap extract_remaining_tasks(FutureCompletedTasks& futures, CompletedTaskMap& buffered_tasks)
-{
-    std::deque<CompletedTask> tasks {};
-    extract_remaining_future_tasks(futures, tasks);
-    extract_buffered_tasks(buffered_tasks, tasks);
-    return make_map(tasks);
-}
-
-void resolve_connecting_calls(RemainingTaskMap& remaining_tasks,
-                              const ContigCallingComponentFactoryMap& calling_components)
-{
-    for (auto& p : remaining_tasks) {
-        resolve_connecting_calls(p.second, calling_components.at(p.first));
-    }
-}
-
-void write(RemainingTaskMap&& remaining_tasks, TempVcfWriterMap& temp_vcfs)
-{
-    for (auto& p : remaining_tasks) {
-        write(std::move(p.second), temp_vcfs.at(p.first));
-    }
-}
-
-void write_remaining_tasks(FutureCompletedTasks& futures, CompletedTaskMap& buffered_tasks, TempVcfWriterMap& temp_vcfs,
-                           const ContigCallingComponentFactoryMap& calling_components)
+void close(const ContigName& contig, CompletedTaskBuffer& buffer, OrderedTaskWriter& writer,
+           const ContigCallingComponentFactory& calling_components)
 {
     static auto debug_log = get_debug_log();
-    if (debug_log) stream(*debug_log) << "Waiting for " << futures.size() << " running tasks to finish";
-    auto remaining_tasks = extract_remaining_tasks(futures, buffered_tasks);
+    if (debug_log) stream(*debug_log) << "Finished all tasks on contig " << contig;
+    auto remaining_tasks = extract_remaining_tasks(buffer);
     resolve_connecting_calls(remaining_tasks, calling_components);
-    write(std::move(remaining_tasks), temp_vcfs);
+    writer.write(std::move(remaining_tasks));
+    writer.close(contig);
+    buffer.closed = true;
 }
 
-auto extract_writers(TempVcfWriterMap&& vcfs)
+// A contig can be closed once all of its tasks have been made and completed
+void close_if_finished(const ContigName& contig, CompletedTaskBuffer& buffer, OrderedTaskWriter& writer,
+                       const ContigCallingComponentFactory& calling_components)
 {
-    std::vector<VcfWriter> result {};
-    result.reserve(vcfs.size());
-    for (auto&& p : vcfs) {
-        result.push_back(std::move(p.second));
+    if (!buffer.closed && buffer.num_tasks && buffer.next_index == *buffer.num_tasks) {
+        assert(buffer.pending.empty());
+        close(contig, buffer, writer, calling_components);
     }
-    vcfs.clear();
-    return result;
 }
 
-auto extract_as_readers(TempVcfWriterMap&& vcfs)
+void close_remaining_contigs(CompletedTaskBufferMap& buffers, OrderedTaskWriter& writer,
+                             const ContigCallingComponentFactoryMap& calling_components)
 {
-    return writers_to_readers(extract_writers(std::move(vcfs)), false);
-}
-
-void merge(TempVcfWriterMap&& temp_vcf_writers, GenomeCallingComponents& components)
-{
-    static auto debug_log = get_debug_log();
-    if (debug_log) stream(*debug_log) << "Merging " << temp_vcf_writers.size() << " temporary VCF files";
-    auto temp_readers = extract_as_readers(std::move(temp_vcf_writers));
-    merge(temp_readers, components.output(), components.contigs());
+    for (auto& p : buffers) {
+        if (!p.second.closed) {
+            close(p.first, p.second, writer, calling_components.at(p.first));
+        }
+    }
 }
 
-void run_octopus_multi_threaded(GenomeCallingComponents& components)
+void run_octopus_multi_threaded(GenomeCallingComponents& components, FusedCallFilter filter)
 {
-    using namespace std::chrono_literals;
     static auto debug_log = get_debug_log();
     
-    const auto num_task_threads = calculate_num_task_threads(components);
-    
-    TaskMap pending_tasks {components.contigs()};
-    TaskMakerSyncPacket task_maker_sync {};
-    task_maker_sync.batch_size_hint = 2 * num_task_threads;
-    std::unique_lock<std::mutex> pending_task_lock {task_maker_sync.mutex, std::defer_lock};
-    auto task_maker_thread = make_task_maker_thread(pending_tasks, components, num_task_threads, task_maker_sync);
-    if (!task_maker_thread.joinable()) {
-        logging::FatalLogger fatal_log {};
-        fatal_log << "Unable to make task maker thread";
-        return;
-    }
-    task_maker_thread.detach();
-    
-    FutureCompletedTasks futures(num_task_threads);
-    TaskMap running_tasks {ContigOrder {components.contigs()}};
-    CompletedTaskMap buffered_tasks {};
-    std::map<ContigName, HoldbackTask> holdbacks {};
-    // Populate all the maps first so we can make unchecked accesses
+    CompletedTaskBufferMap buffered_tasks {};
+    // Populate the map first so we can make unchecked accesses
     for (const auto& contig : components.contigs()) {
-        running_tasks.emplace(contig, TaskMap::mapped_type {});
-        buffered_tasks.emplace(contig, CompletedTaskMap::mapped_type {});
-        holdbacks.emplace(contig, boost::none);
+        buffered_tasks.emplace(contig, CompletedTaskBuffer {});
     }
-    
-    CallerSyncPacket caller_sync {};
     const auto calling_components = make_contig_calling_component_factory_map(components);
-    unsigned num_idle_futures {0};
     
-    auto temp_writers = make_temp_vcf_writers(components);
     TaskWriterSyncPacket task_writer_sync {};
-    auto task_writer_thread = make_task_writer_thread(temp_writers, task_writer_sync);
+    OrderedTaskWriter ordered_writer {components.contigs(), task_writer_sync, make_spill_file_factory(components)};
+    auto task_writer_thread = make_task_writer_thread(components.output(), task_writer_sync, filter);
     if (!task_writer_thread.joinable()) {
         logging::FatalLogger fatal_log {};
         fatal_log << "Unable to make task writer thread";
@@ -1178,77 +1203,32 @@ void run_octopus_multi_threaded(GenomeCallingComponents& components)
     }
     task_writer_thread.detach();
     
-    // Wait for the first task to be made
-    const auto tasks_available = [&] () noexcept { return task_maker_sync.num_tasks > 0; };
-    while(task_maker_sync.num_tasks == 0) {
-        pending_task_lock.lock();
-        task_maker_sync.cv.wait(pending_task_lock, tasks_available);
-        pending_task_lock.unlock();
-    }
-    task_maker_sync.batch_size_hint = num_task_threads / 2;
-    
     components.progress_meter().start();
-    
-    while (!task_maker_sync.all_done || task_maker_sync.num_tasks > 0) {
-        pending_task_lock.lock();
-        assert(count_tasks(pending_tasks) == task_maker_sync.num_tasks);
-        if (!task_maker_sync.all_done && task_maker_sync.num_tasks == 0) {
-            task_maker_sync.batch_size_hint = std::max(num_idle_futures, num_task_threads / 2);
-            if (num_idle_futures < futures.size()) {
-                // If there are running futures then it's good periodically check to see if
-                // any have finished and process them while we wait for the task maker.
-                while (task_maker_sync.num_tasks == 0 && caller_sync.num_finished == 0) {
-                    auto now = std::chrono::system_clock::now();
-                    task_maker_sync.cv.wait_until(pending_task_lock, now + 5s, tasks_available);
-                }
+    {
+        CallingTaskScheduler scheduler {components, calculate_num_task_threads(components)};
+        start_task_maker(scheduler, components);
+        while (auto outcome = scheduler.pop()) {
+            if (outcome->error) std::rethrow_exception(outcome->error);
+            boost::optional<ContigName> contig {};
+            if (outcome->task) {
+                contig = contig_name(*outcome->task);
+                write_or_buffer(std::move(*outcome->task), buffered_tasks.at(*contig),
+                                ordered_writer, calling_components.at(*contig));
             } else {
-                task_maker_sync.cv.wait(pending_task_lock, tasks_available);
+                assert(outcome->made_contig);
+                contig = outcome->made_contig->contig;
+                buffered_tasks.at(*contig).num_tasks = outcome->made_contig->num_tasks;
             }
-        }
-        pending_task_lock.unlock();
-        num_idle_futures = 0;
-        for (auto& future : futures) {
-            if (is_ready(future)) {
-                auto completed_task = future.get();
-                const auto& contig = contig_name(completed_task.region);
-                write_or_buffer(std::move(completed_task), buffered_tasks.at(contig),
-                                running_tasks.at(contig), holdbacks.at(contig),
-                                task_writer_sync, calling_components.at(contig));
-                --caller_sync.num_finished;
-            }
-            if (!future.valid()) {
-                pending_task_lock.lock();
-                if (task_maker_sync.num_tasks > 0) {
-                    pending_task_lock.unlock(); // As pop will need to lock the mutex too == deadlock
-                    auto task = pop(pending_tasks, task_maker_sync);
-                    future = run(task, calling_components.at(contig_name(task))(), caller_sync);
-                    running_tasks.at(contig_name(task)).push(std::move(task));
-                } else {
-                    pending_task_lock.unlock();
-                    ++num_idle_futures;
-                }
-            }
-        }
-        // If there are no idle futures then all threads are busy and we must wait for one to finish,
-        // otherwise we must have run out of tasks, so we should wait for new ones.
-        if (num_idle_futures == 0 && caller_sync.num_finished == 0) {
-            task_maker_sync.waiting = false;
-            std::unique_lock<std::mutex> lock {caller_sync.mutex};
-            caller_sync.cv.wait(lock, [&] () { return caller_sync.num_finished > 0; });
-            task_maker_sync.waiting = true;
-        } else {
-            if (debug_log) stream(*debug_log) << "There are " << num_idle_futures << " idle futures";
+            close_if_finished(*contig, buffered_tasks.at(*contig), ordered_writer, calling_components.at(*contig));
         }
     }
-    assert(task_maker_sync.num_tasks == 0);
-    assert(pending_tasks.empty());
-    running_tasks.clear();
-    holdbacks.clear(); // holdbacks are just references to buffered tasks
-    if (debug_log) *debug_log << "Finished making new tasks. Waiting for task writer to complete existing jobs";
+    if (debug_log) {
+        log_executor_metrics(*debug_log);
+        *debug_log << "Finished calling all tasks. Waiting for task writer to complete existing jobs";
+    }
+    close_remaining_contigs(buffered_tasks, ordered_writer, calling_components);
     wait_until_finished(task_writer_sync);
-    write_remaining_tasks(futures, buffered_tasks, temp_writers, calling_components);
     components.progress_meter().stop();
-    merge(std::move(temp_writers), components);
 }
 
 } // namespace
@@ -1258,16 +1238,16 @@ bool is_multithreaded(const GenomeCallingComponents& components)
     return !components.num_threads() || *components.num_threads() > 1;
 }
 
-void run_calling(GenomeCallingComponents& components)
+void run_calling(GenomeCallingComponents& components, FusedCallFilter filter)
 {
     if (is_multithreaded(components)) {
         if (DEBUG_MODE) {
             logging::WarningLogger warn_log {};
             warn_log << "Running in parallel mode can make debug log difficult to interpret";
         }
-        run_octopus_multi_threaded(components);
+        run_octopus_multi_threaded(components, filter);
     } else {
-        run_octopus_single_threaded(components);
+        run_octopus_single_threaded(components, filter);
     }
 }
 
@@ -1322,13 +1302,20 @@ bool use_unfiltered_call_region_hints_for_filtering(const GenomeCallingComponent
     return true;
 }
 
+BufferedReadPipe make_filter_buffered_read_pipe(const GenomeCallingComponents& components)
+{
+    BufferedReadPipe::Config buffer_config {components.read_buffer_size()};
+    buffer_config.fetch_expansion = 100;
+    buffer_config.max_hint_gap = 5'000;
+    return BufferedReadPipe {components.filter_read_pipe(), buffer_config};
+}
+
 void run_csr(GenomeCallingComponents& components)
 {
     if (apply_csr(components)) {
         log_filtering_info(components);
         ProgressMeter progress {components.search_regions()};
         const auto& filter_factory = components.call_filter_factory();
-        const auto& filter_read_pipe = components.filter_read_pipe();
         boost::optional<boost::filesystem::path> input_path {};
         if (components.filter_request()) {
             input_path = components.filter_request();
@@ -1336,10 +1323,7 @@ void run_csr(GenomeCallingComponents& components)
             input_path = components.output().path();
         }
         assert(input_path); // cannot be stdout
-        BufferedReadPipe::Config buffer_config {components.read_buffer_size()};
-        buffer_config.fetch_expansion = 100;
-        buffer_config.max_hint_gap = 5'000;
-        BufferedReadPipe buffered_rp {filter_read_pipe, buffer_config};
+        auto buffered_rp = make_filter_buffered_read_pipe(components);
         if (use_unfiltered_call_region_hints_for_filtering(components)) {
             buffered_rp.hint(extract_call_regions(*input_path));
         } else {
@@ -1356,6 +1340,34 @@ void run_csr(GenomeCallingComponents& components)
     }
 }
 
+// Single-pass filters can filter calls as they are made, which avoids reading the unfiltered calls,
+// and the reads around them, a second time. Reads are still fetched for each block of calls, but
+// only once the calls are made, on the thread writing the output.
+std::unique_ptr<VariantCallFilter> make_fused_call_filter(const GenomeCallingComponents& components, const VcfHeader& calls_header)
+{
+    if (!apply_csr(components) || components.filter_request()) return nullptr;
+    auto result = components.call_filter_factory().make(components.reference(), make_filter_buffered_read_pipe(components),
+                                                        calls_header, components.ploidies(), components.pedigree(),
+                                                        boost::none, components.num_threads());
+    if (!result || !result->can_stream()) return nullptr;
+    return result;
+}
+
+void log_fused_filtering_info(const GenomeCallingComponents& components)
+{
+    logging::InfoLogger log {};
+    log << "Call Set Refinement (CSR) filtering will be applied as calls are made";
+}
+
+FusedCallFilter get_fused_call_filter(boost::optional<VariantCallFilter::CallStream>& stream)
+{
+    if (stream) {
+        return FusedCallFilter {*stream};
+    } else {
+        return boost::none;
+    }
+}
+
 void log_run_start(const GenomeCallingComponents& components, const std::string& command)
 {
     static auto debug_log = get_debug_log();
@@ -1392,11 +1404,18 @@ void run_variant_calling(GenomeCallingComponents& components, std::string comman
 {
     static auto debug_log = get_debug_log();
     log_run_start(components, command);
-    write_caller_output_header(components, command);
+    const auto calls_header = write_caller_output_header(components, command);
     const auto start = std::chrono::system_clock::now();
+    std::unique_ptr<VariantCallFilter> fused_filter {};
+    boost::optional<VariantCallFilter::CallStream> fused_filter_stream {};
     try {
         if (!components.filter_request()) {
-            run_calling(components);
+            fused_filter = make_fused_call_filter(components, calls_header);
+            if (fused_filter) {
+                log_fused_filtering_info(components);
+                fused_filter_stream.emplace(*fused_filter, calls_header, *components.filtered_output());
+            }
+            run_calling(components, get_fused_call_filter(fused_filter_stream));
         }
     } catch (const ProgramError& e) {
         try {
@@ -1419,7 +1438,12 @@ void run_variant_calling(GenomeCallingComponents& components, std::string comman
     }
     components.output().close();
     try {
-        run_csr(components);
+        if (fused_filter_stream) {
+            fused_filter_stream->close();
+            components.filtered_output()->close();
+        } else {
+            run_csr(components);
+        }
     } catch (...) {
         try {
             if (debug_log) *debug_log << "Encountered an error whilst filtering, attempting to cleanup";
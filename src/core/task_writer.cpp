@@ -0,0 +1,223 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "task_writer.hpp"
+
+#include <utility>
+#include <iterator>
+#include <exception>
+#include <cassert>
+
+#include <boost/filesystem/operations.hpp>
+
+#include "io/variant/vcf_reader.hpp"
+#include "utils/append.hpp"
+#include "logging/logging.hpp"
+#include "logging/error_handler.hpp"
+#include "exceptions/error.hpp"
+
+namespace octopus {
+
+using logging::get_debug_log;
+
+void write_calls(std::deque<VcfRecord>&& calls, VcfWriter& out, FusedCallFilter filter)
+{
+    if (calls.empty()) return;
+    static auto debug_log = get_debug_log();
+    if (debug_log) stream(*debug_log) << "Writing " << calls.size() << " calls to output";
+    const bool was_closed {!out.is_open()};
+    if (was_closed) out.open();
+    write(calls, out);
+    if (was_closed) out.close();
+    if (filter) {
+        filter->filter({std::make_move_iterator(std::begin(calls)), std::make_move_iterator(std::end(calls))});
+    }
+    calls.clear();
+    calls.shrink_to_fit();
+}
+
+namespace {
+
+void write_spilled_calls(VcfWriter& spilled, VcfWriter& out, FusedCallFilter filter)
+{
+    static auto debug_log = get_debug_log();
+    const auto path = spilled.path();
+    assert(path);
+    spilled.close();
+    if (debug_log) stream(*debug_log) << "Writing calls spilled to " << *path;
+    {
+        // Spilled calls are read back in chunks so they are never all in memory
+        static constexpr std::size_t maxChunkSize {10'000};
+        const VcfReader spilled_calls {*path};
+        std::deque<VcfRecord> chunk {};
+        for (auto p = spilled_calls.iterate(); p.first != p.second; ++p.first) {
+            chunk.push_back(*p.first);
+            if (chunk.size() == maxChunkSize) write_calls(std::move(chunk), out, filter);
+        }
+        write_calls(std::move(chunk), out, filter);
+    }
+    // Removing the file first stops the writer indexing it when destroyed
+    boost::filesystem::remove(*path);
+}
+
+void write(std::deque<OutputJob>& jobs, VcfWriter& out, FusedCallFilter filter)
+{
+    static auto debug_log = get_debug_log();
+    for (auto& job : jobs) {
+        if (job.spilled) {
+            write_spilled_calls(*job.spilled, out, filter);
+        }
+        if (job.task) {
+            if (debug_log) {
+                stream(*debug_log) << "Writing completed task " << *job.task << " that finished in " << duration(*job.task);
+            }
+            write_calls(std::move(job.task->calls), out, filter);
+        }
+    }
+    jobs.clear();
+}
+
+void write_final_output_helper(VcfWriter& out, TaskWriterSyncPacket& sync, FusedCallFilter filter)
+{
+    try {
+        std::unique_lock<std::mutex> lock {sync.mutex, std::defer_lock};
+        std::deque<OutputJob> buffer {};
+        while (true) {
+            lock.lock();
+            sync.cv.wait(lock, [&] () { return !sync.jobs.empty() || sync.done; });
+            if (sync.jobs.empty()) break;
+            assert(buffer.empty());
+            std::swap(sync.jobs, buffer);
+            lock.unlock();
+            write(buffer, out, filter);
+        }
+        sync.finished = true;
+        lock.unlock();
+        sync.cv.notify_all();
+        logging::DebugLogger debug_log {};
+        debug_log << "Task writer finished";
+    } catch (const Error& e) {
+        log_error(e);
+        logging::FatalLogger fatal_log {};
+        fatal_log << "Encountered error in task writer thread. Calling terminate";
+        std::terminate();
+    } catch (const std::exception& e) {
+        log_error(e);
+        logging::FatalLogger fatal_log {};
+        fatal_log << "Encountered error in task writer thread. Calling terminate";
+        std::terminate();
+    } catch (...) {
+        logging::FatalLogger fatal_log {};
+        fatal_log << "Encountered error in task writer thread. Calling terminate";
+        std::terminate();
+    }
+}
+
+} // namespace
+
+std::thread make_task_writer_thread(VcfWriter& out, TaskWriterSyncPacket& writer_sync, FusedCallFilter filter)
+{
+    return std::thread {write_final_output_helper, std::ref(out), std::ref(writer_sync), filter};
+}
+
+void submit(std::deque<OutputJob>&& jobs, TaskWriterSyncPacket& sync)
+{
+    if (jobs.empty()) return;
+    std::unique_lock<std::mutex> lock {sync.mutex};
+    utils::append(std::move(jobs), sync.jobs);
+    lock.unlock();
+    sync.cv.notify_all();
+}
+
+void wait_until_finished(TaskWriterSyncPacket& sync)
+{
+    std::unique_lock<std::mutex> lock {sync.mutex};
+    sync.done = true;
+    sync.cv.notify_all();
+    sync.cv.wait(lock, [&] () { return sync.finished; });
+}
+
+// OrderedTaskWriter
+
+constexpr std::size_t OrderedTaskWriter::defaultMaxBufferedCalls;
+
+OrderedTaskWriter::OrderedTaskWriter(std::vector<ContigName> contigs, TaskWriterSyncPacket& sync,
+                                     SpillFileFactory make_spill_file, const std::size_t max_buffered_calls)
+: sync_ {sync}
+, make_spill_file_ {std::move(make_spill_file)}
+, order_ {contigs}
+, buffers_ {}
+, current_ {0}
+, num_buffered_calls_ {0}
+, max_buffered_calls_ {max_buffered_calls}
+{
+    buffers_.reserve(contigs.size());
+    for (auto& contig : contigs) {
+        buffers_.push_back(ContigBuffer {std::move(contig)});
+    }
+}
+
+void OrderedTaskWriter::write(std::deque<CompletedTask>&& tasks)
+{
+    if (tasks.empty()) return;
+    const auto rank = order_.rank(contig_name(tasks.front()));
+    assert(rank >= current_ && !buffers_[rank].closed);
+    if (rank == current_) {
+        std::deque<OutputJob> jobs {};
+        for (auto& task : tasks) jobs.push_back({std::move(task)});
+        submit(std::move(jobs), sync_);
+    } else {
+        auto& buffer = buffers_[rank];
+        for (auto& task : tasks) {
+            buffer.num_calls += task.calls.size();
+            num_buffered_calls_ += task.calls.size();
+            buffer.tasks.push_back(std::move(task));
+        }
+        if (num_buffered_calls_ > max_buffered_calls_) spill();
+    }
+    tasks.clear();
+}
+
+void OrderedTaskWriter::close(const ContigName& contig)
+{
+    buffers_[order_.rank(contig)].closed = true;
+    while (current_ < buffers_.size() && buffers_[current_].closed) {
+        ++current_;
+        if (current_ < buffers_.size()) flush(buffers_[current_]);
+    }
+}
+
+void OrderedTaskWriter::flush(ContigBuffer& buffer)
+{
+    std::deque<OutputJob> jobs {};
+    if (buffer.spilled) {
+        jobs.push_back({boost::none, std::move(buffer.spilled)});
+    }
+    for (auto& task : buffer.tasks) jobs.push_back({std::move(task)});
+    buffer.tasks.clear();
+    num_buffered_calls_ -= buffer.num_calls;
+    buffer.num_calls = 0;
+    submit(std::move(jobs), sync_);
+}
+
+void OrderedTaskWriter::spill()
+{
+    static auto debug_log = get_debug_log();
+    if (!make_spill_file_) return;
+    for (auto rank = buffers_.size() - 1; rank > current_ && num_buffered_calls_ > max_buffered_calls_; --rank) {
+        auto& buffer = buffers_[rank];
+        if (buffer.tasks.empty()) continue;
+        if (debug_log) stream(*debug_log) << "Spilling " << buffer.num_calls << " buffered calls on contig " << buffer.contig;
+        if (!buffer.spilled) {
+            buffer.spilled = std::make_unique<VcfWriter>(make_spill_file_(buffer.contig));
+        }
+        for (auto& task : buffer.tasks) {
+            write_calls(std::move(task.calls), *buffer.spilled);
+        }
+        buffer.tasks.clear();
+        num_buffered_calls_ -= buffer.num_calls;
+        buffer.num_calls = 0;
+    }
+}
+
+} // namespace octopus
@@ -0,0 +1,108 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef task_writer_hpp
+#define task_writer_hpp
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <condition_variable>
+#include <mutex>
+#include <cstddef>
+
+#include <boost/optional.hpp>
+
+#include "config/common.hpp"
+#include "io/variant/vcf_record.hpp"
+#include "io/variant/vcf_writer.hpp"
+#include "core/csr/filters/variant_call_filter.hpp"
+#include "calling_task.hpp"
+
+namespace octopus {
+
+// Filters calls as they are written, when CSR filtering is fused with calling
+using FusedCallFilter = boost::optional<VariantCallFilter::CallStream&>;
+
+void write_calls(std::deque<VcfRecord>&& calls, VcfWriter& out, FusedCallFilter filter = boost::none);
+
+// Calls that are ready to be written to the final output. The calls are either in memory, or
+// have been spilled to a temporary file.
+struct OutputJob
+{
+    boost::optional<CompletedTask> task = boost::none;
+    std::unique_ptr<VcfWriter> spilled = nullptr;
+};
+
+struct TaskWriterSyncPacket
+{
+    std::condition_variable cv;
+    std::mutex mutex;
+    std::deque<OutputJob> jobs = {};
+    bool done = false, finished = false;
+};
+
+// The task writer thread writes submitted jobs to out, in submission order, until wait_until_finished is called
+std::thread make_task_writer_thread(VcfWriter& out, TaskWriterSyncPacket& writer_sync, FusedCallFilter filter);
+
+void submit(std::deque<OutputJob>&& jobs, TaskWriterSyncPacket& sync);
+
+// Blocks until the task writer has written all submitted jobs
+void wait_until_finished(TaskWriterSyncPacket& sync);
+
+// A reorder buffer that commits completed tasks to the final output in contig order. Tasks on the
+// contig currently being written go straight to the task writer, while tasks on later contigs are
+// buffered until all preceding contigs are closed. If more than max_buffered_calls calls are
+// buffered, the buffered calls furthest from being written are spilled to temporary files, which
+// are copied to the output when their contig is reached.
+class OrderedTaskWriter
+{
+public:
+    // Makes an empty temporary file for spilling calls on the contig. Calls are never spilled without one.
+    using SpillFileFactory = std::function<VcfWriter(const ContigName&)>;
+
+    static constexpr std::size_t defaultMaxBufferedCalls {500'000};
+
+    OrderedTaskWriter() = delete;
+
+    OrderedTaskWriter(std::vector<ContigName> contigs, TaskWriterSyncPacket& sync,
+                      SpillFileFactory make_spill_file = nullptr,
+                      std::size_t max_buffered_calls = defaultMaxBufferedCalls);
+
+    OrderedTaskWriter(const OrderedTaskWriter&)            = delete;
+    OrderedTaskWriter& operator=(const OrderedTaskWriter&) = delete;
+    OrderedTaskWriter(OrderedTaskWriter&&)                 = delete;
+    OrderedTaskWriter& operator=(OrderedTaskWriter&&)      = delete;
+
+    ~OrderedTaskWriter() = default;
+
+    // The tasks must be on the same contig, and follow any tasks previously written on the contig
+    void write(std::deque<CompletedTask>&& tasks);
+    // No more tasks may be written on a closed contig
+    void close(const ContigName& contig);
+
+private:
+    struct ContigBuffer
+    {
+        ContigName contig;
+        std::deque<CompletedTask> tasks = {};
+        std::size_t num_calls = 0;
+        std::unique_ptr<VcfWriter> spilled = nullptr;
+        bool closed = false;
+    };
+
+    TaskWriterSyncPacket& sync_;
+    SpillFileFactory make_spill_file_;
+    ContigOrder order_;
+    std::vector<ContigBuffer> buffers_;
+    std::size_t current_, num_buffered_calls_, max_buffered_calls_;
+
+    void flush(ContigBuffer& buffer);
+    void spill();
+};
+
+} // namespace octopus
+
+#endif
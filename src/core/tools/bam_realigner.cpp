@@ -14,6 +14,7 @@
 #include "basics/cigar_string.hpp"
 #include "io/variant/vcf_record.hpp"
 #include "io/variant/vcf_header.hpp"
+#include "io/variant/vcf_spec.hpp"
 #include "io/read/buffered_read_writer.hpp"
 #include "io/read/annotated_aligned_read.hpp"
 #include "utils/genotype_reader.hpp"
@@ -232,6 +233,14 @@ auto move_merge(Container&& src, std::vector<T>& dst)
     std::inplace_merge(std::begin(dst), itr, std::end(dst));
 }
 
+// Only genotypes and phase sets are needed to find blocks and extract the called haplotypes
+VcfReader::UnpackMask get_genotype_unpack_mask()
+{
+    auto result = VcfReader::UnpackMask::site_fields_only();
+    result.add_format(vcfspec::format::genotype).add_format(vcfspec::format::phaseSet);
+    return result;
+}
+
 } // namespace
 
 BAMRealigner::Report
@@ -244,7 +253,7 @@ BAMRealigner::realign(ReadReader& src, VcfReader& variants, ReadWriter& dst,
     Report report {};
     BatchList batch {};
     boost::optional<GenomicRegion> batch_region {};
-    for (auto p = variants.iterate(); p.first != p.second;) {
+    for (auto p = variants.iterate(get_genotype_unpack_mask()); p.first != p.second;) {
         std::tie(batch, batch_region) = read_next_batch(p.first, p.second, src, reference, samples, batch_region);
         for (auto& sample : batch) {
             std::vector<AlignedRead> genotype_reads {};
@@ -340,7 +349,7 @@ BAMRealigner::realign(ReadReader& src, VcfReader& variants, std::vector<ReadWrit
     Report report {};
     BatchList batch {};
     boost::optional<GenomicRegion> batch_region {};
-    for (auto p = variants.iterate(); p.first != p.second; ) {
+    for (auto p = variants.iterate(get_genotype_unpack_mask()); p.first != p.second; ) {
         std::tie(batch, batch_region) = read_next_batch(p.first, p.second, src, reference, samples, batch_region);
         for (auto& sample : batch) {
             std::vector<AlignedRead> genotype_reads {}, unassigned_realigned_reads {};
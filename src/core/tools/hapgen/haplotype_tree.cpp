@@ -3,139 +3,74 @@
 
 #include "haplotype_tree.hpp"
 
-#include <deque>
-#include <stack>
 #include <stdexcept>
 #include <cassert>
 #include <iostream>
-
-#include <boost/property_map/property_map.hpp>
-#include <boost/graph/breadth_first_search.hpp>
-#include <boost/graph/depth_first_search.hpp>
-#include <boost/graph/visitors.hpp>
-#include <boost/graph/copy.hpp>
-#include <boost/graph/graphviz.hpp>
+#include <fstream>
 
 #include "io/reference/reference_genome.hpp"
 #include "utils/mappable_algorithms.hpp"
 
 namespace octopus { namespace coretools {
 
+constexpr HaplotypeTree::Vertex HaplotypeTree::nullVertex;
+
 HaplotypeTree::HaplotypeTree(const GenomicRegion::ContigName& contig, const ReferenceGenome& reference)
 : reference_ {reference}
-, tree_ {}
-, root_ {boost::add_vertex(tree_)}
-, haplotype_leafs_ {root_}
 , contig_ {contig}
+, alleles_ {}
+, parents_ {}
+, first_children_ {}
+, last_children_ {}
+, next_siblings_ {}
+, previous_siblings_ {}
+, num_children_ {}
+, next_leafs_ {}
+, previous_leafs_ {}
+, free_vertices_ {}
+, num_vertices_ {0}
+, root_ {}
+, first_leaf_ {nullVertex}
+, last_leaf_ {nullVertex}
+, num_leafs_ {0}
 , haplotype_leaf_cache_ {}
 , tree_region_ {}
+, branch_buffer_ {}
 {
     if (!reference.has_contig(contig)) {
         throw std::invalid_argument {"HaplotypeTree: constructed with contig "
             + contig + " which is not in the reference " + reference.name()};
     }
-}
-
-namespace debug {
-
-template <typename G, typename V, typename Container>
-bool is_tree(const G& graph, const V& root, const Container& leafs);
-
-} // namespace debug
-
-namespace {
-
-template <typename Graph>
-bool is_empty(const Graph& g)
-{
-    return boost::num_vertices(g) == 0 && boost::num_edges(g) == 0;
-}
-
-template <typename Graph>
-auto copy_graph(const Graph& src, Graph& dst)
-{
-    assert(is_empty(dst));
-    using Vertex = typename boost::graph_traits<Graph>::vertex_descriptor;
-    std::unordered_map<Vertex, std::size_t> index_map {};
-    index_map.reserve(boost::num_vertices(src));
-    const auto p = boost::vertices(src);
-    std::size_t i {0};
-    std::for_each(p.first, p.second, [&i, &index_map] (const Vertex& v) { index_map.emplace(v, i++); });
-    std::unordered_map<Vertex, Vertex> vertex_copy_map {};
-    vertex_copy_map.reserve(boost::num_vertices(src));
-    boost::copy_graph(src, dst,
-                      boost::vertex_index_map(boost::make_assoc_property_map(index_map))
-                      .orig_to_copy(boost::make_assoc_property_map(vertex_copy_map)));
-    assert(vertex_copy_map.size() == boost::num_vertices(src));
-    return vertex_copy_map;
-}
-
-template <typename Container, typename Map>
-void copy_leafs(const Container& src, Container& dst, const Map& vertex_copy_map)
-{
-    assert(dst.empty());
-    std::transform(std::cbegin(src), std::cend(src), std::back_inserter(dst),
-                   [&vertex_copy_map] (const auto& v) { return vertex_copy_map.at(v); });
-}
-
-} // namespace
-
-HaplotypeTree::HaplotypeTree(const HaplotypeTree& other)
-: reference_ {other.reference_}
-, tree_ {}
-, root_ {}
-, haplotype_leafs_ {}
-, contig_ {other.contig_}
-, haplotype_leaf_cache_ {}
-{
-    const auto vertex_copy_map = copy_graph(other.tree_, tree_);
-    root_ = vertex_copy_map.at(other.root_);
-    copy_leafs(other.haplotype_leafs_, haplotype_leafs_, vertex_copy_map);
-}
-
-HaplotypeTree& HaplotypeTree::operator=(const HaplotypeTree& other)
-{
-    if (&other == this) return *this;
-    tree_.clear();
-    haplotype_leafs_.clear();
-    haplotype_leaf_cache_.clear();
-    reference_ = other.reference_;
-    contig_    = other.contig_;
-    const auto vertex_copy_map = copy_graph(other.tree_, tree_);
-    root_ = vertex_copy_map.at(other.root_);
-    copy_leafs(other.haplotype_leafs_, haplotype_leafs_, vertex_copy_map);
-    assert(debug::is_tree(tree_, root_, haplotype_leafs_));
-    return *this;
+    root_ = add_vertex(ContigAllele {});
+    push_back_leaf(root_);
 }
 
 bool HaplotypeTree::is_empty() const noexcept
 {
-    return haplotype_leafs_.front() == root_;
+    return first_leaf_ == root_;
 }
 
 std::size_t HaplotypeTree::num_haplotypes() const noexcept
 {
-    return (is_empty()) ? 0 : haplotype_leafs_.size();
+    return (is_empty()) ? 0 : num_leafs_;
 }
 
 bool HaplotypeTree::contains(const Haplotype& haplotype) const
 {
     if (haplotype_leaf_cache_.count(haplotype) > 0) return true;
-    
-    return std::any_of(std::cbegin(haplotype_leafs_), std::cend(haplotype_leafs_),
-                       [this, &haplotype] (const Vertex leaf) {
-                           return is_branch_equal_haplotype(leaf, haplotype);
-                       });
+    for (auto leaf = first_leaf_; leaf != nullVertex; leaf = next_leafs_[leaf]) {
+        if (is_branch_equal_haplotype(leaf, haplotype)) return true;
+    }
+    return false;
 }
     
 bool HaplotypeTree::includes(const Haplotype& haplotype) const
 {
     if (haplotype_leaf_cache_.count(haplotype) > 0) return true;
-    
-    return std::any_of(std::cbegin(haplotype_leafs_), std::cend(haplotype_leafs_),
-                       [this, &haplotype] (const Vertex leaf) {
-                           return is_branch_exact_haplotype(leaf, haplotype);
-                       });
+    for (auto leaf = first_leaf_; leaf != nullVertex; leaf = next_leafs_[leaf]) {
+        if (is_branch_exact_haplotype(leaf, haplotype)) return true;
+    }
+    return false;
 }
 
 bool HaplotypeTree::is_unique(const Haplotype& haplotype) const
@@ -144,7 +79,7 @@ bool HaplotypeTree::is_unique(const Haplotype& haplotype) const
         return haplotype_leaf_cache_.count(haplotype) == 1;
     }
     bool haplotype_seen {false};
-    for (const Vertex& leaf : haplotype_leafs_) {
+    for (auto leaf = first_leaf_; leaf != nullVertex; leaf = next_leafs_[leaf]) {
         if (is_branch_equal_haplotype(leaf, haplotype)) {
             if (haplotype_seen) {
                 return false;
@@ -158,7 +93,7 @@ bool HaplotypeTree::is_unique(const Haplotype& haplotype) const
 
 HaplotypeTree& HaplotypeTree::extend(const ContigAllele& allele)
 {
-    for (auto leaf_itr = std::cbegin(haplotype_leafs_); leaf_itr != std::cend(haplotype_leafs_); ++leaf_itr) {
+    for (auto leaf_itr = first_leaf_; leaf_itr != nullVertex; leaf_itr = next_leafs_[leaf_itr]) {
         leaf_itr = extend_haplotype(leaf_itr, allele);
     }
     haplotype_leaf_cache_.clear();
@@ -174,54 +109,7 @@ HaplotypeTree& HaplotypeTree::extend(const Allele& allele)
     return extend(demote(allele));
 }
 
-template <typename Container, typename V>
-struct Splicer : public boost::default_dfs_visitor
-{
-    Splicer(const ContigAllele& allele, std::stack<V>& candidate_splice_sites, Container& splice_sites,
-            V root)
-    : allele_ {allele}
-    , candidate_splice_sites_ {candidate_splice_sites}
-    , splice_sites_ {splice_sites}
-    , root_ {root}
-    {}
-    
-    template <typename G>
-    void finish_vertex(const V v, const G& tree)
-    {
-        if (!candidate_splice_sites_.empty() && v == candidate_splice_sites_.top()) {
-            candidate_splice_sites_.pop();
-            if (v == root_ || is_after(allele_.get(), tree[v])) {
-                splice_sites_.push_back(v);
-            } else {
-                const auto u = *boost::inv_adjacent_vertices(v, tree).first;
-                if (candidate_splice_sites_.empty() || candidate_splice_sites_.top() != u) {
-                    candidate_splice_sites_.push(u);
-                }
-            }
-        }
-    }
-private:
-    std::reference_wrapper<const ContigAllele> allele_;
-    std::stack<V>& candidate_splice_sites_;
-    Container& splice_sites_;
-    V root_;
-};
-
-template <typename Container, typename V>
-auto make_splicer(const ContigAllele& allele, std::stack<V>& candidate_splice_sites,
-                  Container& splice_sites, V root)
-{
-    return Splicer<Container, V> {allele, candidate_splice_sites, splice_sites, root};
-}
-
-template <typename V, typename G>
-bool is_possible_splice_site(const ContigAllele& allele, const V& v, const G& tree)
-{
-    // Can allele go before v in the tree?
-    return begins_before(allele, tree[v])
-           || (boost::out_degree(v, tree) == 0 && overlaps(allele, tree[v]))
-           || (begins_equal(allele, tree[v]) && (!is_empty_region(tree[v]) || (is_insertion(tree[v]) && is_deletion(allele))));
-}
+namespace {
 
 bool is_deletion_and_insertion(const ContigAllele& new_allele, const ContigAllele& leaf)
 {
@@ -233,40 +121,65 @@ bool can_add_to_branch(const ContigAllele& new_allele, const ContigAllele& leaf)
     return !are_adjacent(leaf, new_allele) || !is_deletion_and_insertion(new_allele, leaf);
 }
 
+} // namespace
+
 void HaplotypeTree::splice(const ContigAllele& allele)
 {
     if (is_empty()) {
         extend(allele);
         return;
     }
-    std::unordered_map<Vertex, boost::default_color_type> colours {};
-    colours.reserve(boost::num_vertices(tree_));
-    std::deque<Vertex> splice_sites {};
-    std::stack<Vertex> candidate_splice_sites {};
-    boost::depth_first_visit(tree_, root_,
-                             make_splicer(allele, candidate_splice_sites, splice_sites, root_),
-                             boost::make_assoc_property_map(colours),
-                             [&] (const Vertex v, const Tree& tree) -> bool {
-                                 if (v != root_) {
-                                     if (is_possible_splice_site(allele, v, tree_)) {
-                                         const auto p = boost::inv_adjacent_vertices(v, tree);
-                                         if (p.first != p.second) {
-                                             const auto u = *p.first;
-                                             if (candidate_splice_sites.empty() || candidate_splice_sites.top() != u) {
-                                                 candidate_splice_sites.push(u);
-                                             }
-                                         }
-                                         return true;
-                                     }
-                                 }
-                                 return false;
-                             });
+    // Can allele go before v in the tree? If so, v's subtree is not searched.
+    const auto is_possible_splice_site = [&] (const Vertex v) {
+        const auto& v_allele = alleles_[v];
+        return begins_before(allele, v_allele)
+               || (num_children_[v] == 0 && overlaps(allele, v_allele))
+               || (begins_equal(allele, v_allele) && (!is_empty_region(v_allele) || (is_insertion(v_allele) && is_deletion(allele))));
+    };
+    // Depth first search from the root. Each possible splice site nominates its parent, and a
+    // nominated vertex is a splice site once its subtree is finished if allele can follow it;
+    // otherwise it nominates its own parent.
+    std::vector<Vertex> splice_sites {}, candidate_splice_sites {};
+    const auto nominate = [&] (const Vertex v) {
+        if (candidate_splice_sites.empty() || candidate_splice_sites.back() != v) {
+            candidate_splice_sites.push_back(v);
+        }
+    };
+    const auto finish = [&] (const Vertex v) {
+        if (!candidate_splice_sites.empty() && v == candidate_splice_sites.back()) {
+            candidate_splice_sites.pop_back();
+            if (v == root_ || is_after(allele, alleles_[v])) {
+                splice_sites.push_back(v);
+            } else {
+                nominate(parents_[v]);
+            }
+        }
+    };
+    std::vector<std::pair<Vertex, Vertex>> stack {}; // vertex, next child to visit
+    stack.emplace_back(root_, first_children_[root_]);
+    while (!stack.empty()) {
+        auto& top = stack.back();
+        if (top.second != nullVertex) {
+            const auto v = top.second;
+            top.second = next_siblings_[v];
+            if (is_possible_splice_site(v)) {
+                nominate(parents_[v]);
+                finish(v);
+            } else {
+                stack.emplace_back(v, first_children_[v]);
+            }
+        } else {
+            const auto v = top.first;
+            stack.pop_back();
+            finish(v);
+        }
+    }
     assert(candidate_splice_sites.empty());
     for (const auto v : splice_sites) {
-        if (can_add_to_branch(allele, tree_[v])) {
-            const auto spliced = boost::add_vertex(allele, tree_);
-            boost::add_edge(v, spliced, tree_);
-            haplotype_leafs_.push_back(spliced);
+        if (v == root_ || can_add_to_branch(allele, alleles_[v])) {
+            const auto spliced = add_vertex(allele);
+            add_edge(v, spliced);
+            push_back_leaf(spliced);
         }
     }
     tree_region_ = boost::none;
@@ -280,48 +193,21 @@ void HaplotypeTree::splice(const Allele& allele)
     return splice(demote(allele));
 }
 
-namespace {
-
-template <typename InputIterator, typename Compare>
-decltype(auto) min_value(InputIterator first, InputIterator last, Compare comp)
-{
-    auto result = *first;
-    ++first;
-    for (; first != last; ++first) {
-        if (comp(*first, result)) {
-            result = *first;
-        }
-    }
-    return result;
-}
-
-template <typename InputIterator, typename Compare>
-decltype(auto) max_value(InputIterator first, InputIterator last, Compare comp)
-{
-    auto result = *first;
-    ++first;
-    for (; first != last; ++first) {
-        if (comp(result, *first)) {
-            result = *first;
-        }
-    }
-    return result;
-}
-
-} // namespace
-
 GenomicRegion HaplotypeTree::encompassing_region() const
 {
     if (tree_region_) return *tree_region_;
     if (is_empty()) {
         throw std::runtime_error {"HaplotypeTree::encompassing_region called on empty tree"};
     }
-    const auto p = boost::adjacent_vertices(root_, tree_);
-    const auto leftmost = min_value(p.first, p.second, [this] (const auto& lhs, const auto& rhs) {
-                                    return begins_before(tree_[lhs], tree_[rhs]); });
-    const auto rightmost = max_value(std::cbegin(haplotype_leafs_), std::cend(haplotype_leafs_),
-                                    [this] (const auto& lhs, const auto& rhs) { return ends_before(tree_[lhs], tree_[rhs]); });
-    tree_region_ = GenomicRegion {contig_, octopus::encompassing_region(tree_[leftmost], tree_[rightmost])};
+    auto leftmost = first_children_[root_];
+    for (auto v = next_siblings_[leftmost]; v != nullVertex; v = next_siblings_[v]) {
+        if (begins_before(alleles_[v], alleles_[leftmost])) leftmost = v;
+    }
+    auto rightmost = first_leaf_;
+    for (auto leaf = next_leafs_[rightmost]; leaf != nullVertex; leaf = next_leafs_[leaf]) {
+        if (ends_before(alleles_[rightmost], alleles_[leaf])) rightmost = leaf;
+    }
+    tree_region_ = GenomicRegion {contig_, octopus::encompassing_region(alleles_[leftmost], alleles_[rightmost])};
     return *tree_region_;
 }
 
@@ -341,7 +227,7 @@ std::vector<Haplotype> HaplotypeTree::extract_haplotypes(const GenomicRegion& re
     std::vector<Haplotype> result {};
     if (is_empty() || !overlaps(region, encompassing_region())) return result;
     result.reserve(num_haplotypes());
-    for (const auto leaf : haplotype_leafs_) {
+    for (auto leaf = first_leaf_; leaf != nullVertex; leaf = next_leafs_[leaf]) {
         auto haplotype = extract_haplotype(leaf, region);
         // recently retreived haplotypes are added to the cache as it is likely these
         // are the haplotypes that will be pruned next
@@ -363,15 +249,16 @@ std::vector<HaplotypeTree::HaplotypeLength> HaplotypeTree::extract_haplotype_len
 std::vector<HaplotypeTree::HaplotypeLength> HaplotypeTree::extract_haplotype_lengths(const GenomicRegion& region) const
 {
     if (is_empty() || !overlaps(region, encompassing_region())) return {};
-    std::vector<HaplotypeLength> result(num_haplotypes());
-    std::transform(std::cbegin(haplotype_leafs_), std::cend(haplotype_leafs_), std::begin(result),
-                   [this, &region] (const Vertex leaf) { return extract_haplotype_length(leaf, region); });
+    std::vector<HaplotypeLength> result {};
+    result.reserve(num_haplotypes());
+    for (auto leaf = first_leaf_; leaf != nullVertex; leaf = next_leafs_[leaf]) {
+        result.push_back(extract_haplotype_length(leaf, region));
+    }
     return result;
 }
 
 void HaplotypeTree::prune_all(const Haplotype& haplotype)
 {
-    using std::cbegin; using std::cend; using std::for_each; using std::find;
     if (is_empty() || contig_name(haplotype) != contig_) return;
     // If any of the haplotypes in cache match the query haplotype then the cache must contain
     // all possible leaves corrosponding to that haplotype. So we don't need to look through
@@ -379,25 +266,23 @@ void HaplotypeTree::prune_all(const Haplotype& haplotype)
     tree_region_ = boost::none;
     if (haplotype_leaf_cache_.count(haplotype) > 0) {
         const auto possible_leafs = haplotype_leaf_cache_.equal_range(haplotype);
-        for_each(possible_leafs.first, possible_leafs.second,
-                 [this, &haplotype] (const HaplotypeVertexMultiMap::value_type& leaf_pair) {
-                     const auto p = clear(leaf_pair.second, contig_region(haplotype));
-                     auto leaf_itr = find(cbegin(haplotype_leafs_), cend(haplotype_leafs_), leaf_pair.second);
-                     leaf_itr = haplotype_leafs_.erase(leaf_itr);
-                     if (p.second) {
-                         haplotype_leafs_.insert(leaf_itr, p.first);
-                     }
-                 });
+        std::for_each(possible_leafs.first, possible_leafs.second,
+                      [this, &haplotype] (const HaplotypeVertexMultiMap::value_type& leaf_pair) {
+                          const auto next_leaf = erase_leaf(leaf_pair.second);
+                          const auto p = clear(leaf_pair.second, contig_region(haplotype));
+                          if (p.second) insert_leaf(next_leaf, p.first);
+                      });
         haplotype_leaf_cache_.erase(haplotype);
     } else {
-        auto leaf_itr = cbegin(haplotype_leafs_);
+        auto leaf_itr = first_leaf_;
         while (true) {
-            leaf_itr = find_equal_haplotype_leaf(leaf_itr, cend(haplotype_leafs_), haplotype);
-            if (leaf_itr == cend(haplotype_leafs_)) return;
-            const auto p = clear(*leaf_itr, contig_region(haplotype));
-            leaf_itr = haplotype_leafs_.erase(leaf_itr);
+            leaf_itr = find_equal_haplotype_leaf(leaf_itr, haplotype);
+            if (leaf_itr == nullVertex) return;
+            const auto leaf = leaf_itr;
+            leaf_itr = erase_leaf(leaf);
+            const auto p = clear(leaf, contig_region(haplotype));
             if (p.second) {
-                leaf_itr = haplotype_leafs_.insert(leaf_itr, p.first);
+                leaf_itr = insert_leaf(leaf_itr, p.first);
             }
         }
     }
@@ -405,7 +290,6 @@ void HaplotypeTree::prune_all(const Haplotype& haplotype)
 
 void HaplotypeTree::prune_unique(const Haplotype& haplotype)
 {
-    using std::cbegin; using std::cend; using std::for_each;
     if (is_empty()) return;
     tree_region_ = boost::none;
     if (haplotype_leaf_cache_.count(haplotype) > 0) {
@@ -417,33 +301,33 @@ void HaplotypeTree::prune_unique(const Haplotype& haplotype)
         if (match_itr == possible_leafs.second) {
             throw std::runtime_error {"HaplotypeTree::prune_unique called with matching Haplotype not in tree"};
         }
-        const auto leaf_to_keep_itr = match_itr->second;
+        const auto leaf_to_keep = match_itr->second;
         std::for_each(possible_leafs.first, possible_leafs.second,
-                      [this, &haplotype, leaf_to_keep_itr] (HaplotypeVertexMultiMap::value_type& leaf_pair) {
-                          if (leaf_pair.second != leaf_to_keep_itr) {
+                      [this, &haplotype, leaf_to_keep] (HaplotypeVertexMultiMap::value_type& leaf_pair) {
+                          if (leaf_pair.second != leaf_to_keep) {
+                              const auto next_leaf = erase_leaf(leaf_pair.second);
                               const auto p = clear(leaf_pair.second, contig_region(haplotype));
-                              auto leaf_itr = std::find(cbegin(haplotype_leafs_), cend(haplotype_leafs_), leaf_pair.second);
-                              leaf_itr = haplotype_leafs_.erase(leaf_itr);
-                              if (p.second) haplotype_leafs_.insert(leaf_itr, p.first);
+                              if (p.second) insert_leaf(next_leaf, p.first);
                           }
                       });
         haplotype_leaf_cache_.erase(haplotype);
-        haplotype_leaf_cache_.emplace(haplotype, leaf_to_keep_itr);
+        haplotype_leaf_cache_.emplace(haplotype, leaf_to_keep);
     } else {
-        auto leaf_itr = cbegin(haplotype_leafs_);
-        const auto leaf_to_keep_itr = find_exact_haplotype_leaf(leaf_itr, cend(haplotype_leafs_), haplotype);
+        auto leaf_itr = first_leaf_;
+        const auto leaf_to_keep = find_exact_haplotype_leaf(leaf_itr, haplotype);
         while (true) {
-            leaf_itr = find_equal_haplotype_leaf(leaf_itr, cend(haplotype_leafs_), haplotype);
-            if (leaf_itr == cend(haplotype_leafs_)) {
+            leaf_itr = find_equal_haplotype_leaf(leaf_itr, haplotype);
+            if (leaf_itr == nullVertex) {
                 return;
             }
-            if (leaf_itr == leaf_to_keep_itr) {
-                std::advance(leaf_itr, 1);
+            if (leaf_itr == leaf_to_keep) {
+                leaf_itr = next_leafs_[leaf_itr];
                 continue;
             }
-            const auto p = clear(*leaf_itr, contig_region(haplotype));
-            leaf_itr = haplotype_leafs_.erase(leaf_itr);
-            if (p.second) leaf_itr = haplotype_leafs_.insert(leaf_itr, p.first);
+            const auto leaf = leaf_itr;
+            leaf_itr = erase_leaf(leaf);
+            const auto p = clear(leaf, contig_region(haplotype));
+            if (p.second) leaf_itr = insert_leaf(leaf_itr, p.first);
         }
     }
 }
@@ -461,18 +345,39 @@ void HaplotypeTree::clear(const GenomicRegion& region)
 
 void HaplotypeTree::clear() noexcept
 {
+    // The arrays keep their capacity for the next extension
     haplotype_leaf_cache_.clear();
-    haplotype_leafs_.clear();
-    tree_.clear();
-    root_ = boost::add_vertex(tree_);
-    haplotype_leafs_.push_back(root_);
+    alleles_.clear();
+    parents_.clear();
+    first_children_.clear();
+    last_children_.clear();
+    next_siblings_.clear();
+    previous_siblings_.clear();
+    num_children_.clear();
+    next_leafs_.clear();
+    previous_leafs_.clear();
+    free_vertices_.clear();
+    num_vertices_ = 0;
+    first_leaf_ = last_leaf_ = nullVertex;
+    num_leafs_ = 0;
+    root_ = add_vertex(ContigAllele {});
+    push_back_leaf(root_);
     tree_region_ = boost::none;
 }
 
 void HaplotypeTree::write_dot(std::ostream& out) const
 {
-    const auto vertex_writer = [this] (std::ostream& out, const Vertex v) {
-        const Allele allele {GenomicRegion {contig_, tree_[v].mapped_region()}, tree_[v].sequence()};
+    const auto is_free = [this] () {
+        std::vector<bool> result(alleles_.size(), false);
+        for (const auto v : free_vertices_) result[v] = true;
+        return result;
+    }();
+    out << "digraph G {" << std::endl;
+    out << "rankdir=LR" << std::endl;
+    for (Vertex v {0}; v < alleles_.size(); ++v) {
+        if (is_free[v]) continue;
+        out << v;
+        const Allele allele {GenomicRegion {contig_, alleles_[v].mapped_region()}, alleles_[v].sequence()};
         if (v == root_) {
             out << " [shape=circle,color=black]" << std::endl;
         } else {
@@ -493,68 +398,174 @@ void HaplotypeTree::write_dot(std::ostream& out) const
             }
             out << " [label=\"" << allele << "\"]" << std::endl;
         }
-    };
-    const auto edge_writer = [] (std::ostream& out, const Edge e) {
-        out << "[color=black]" << std::endl;
-    };
-    const auto graph_writer = [] (std::ostream& out) {
-        out << "rankdir=LR" << std::endl;
-    };
-    std::unordered_map<Vertex, std::size_t> vertex_ids {};
-    vertex_ids.reserve(boost::num_vertices(tree_));
-    const auto p = boost::vertices(tree_); std::size_t idx {0};
-    std::for_each(p.first, p.second, [&] (Vertex v) { vertex_ids.emplace(v, idx++); });
-    boost::write_graphviz(out, tree_, vertex_writer, edge_writer, graph_writer, boost::make_assoc_property_map(vertex_ids));
+        out << ";" << std::endl;
+    }
+    for (Vertex u {0}; u < alleles_.size(); ++u) {
+        if (is_free[u]) continue;
+        for (auto v = first_children_[u]; v != nullVertex; v = next_siblings_[v]) {
+            out << u << "->" << v << " [color=black]" << std::endl << ";" << std::endl;
+        }
+    }
+    out << "}" << std::endl;
 }
 
 // Private methods
 
+HaplotypeTree::Vertex HaplotypeTree::add_vertex(const ContigAllele& allele)
+{
+    Vertex result;
+    if (free_vertices_.empty()) {
+        result = static_cast<Vertex>(alleles_.size());
+        alleles_.push_back(allele);
+        parents_.push_back(nullVertex);
+        first_children_.push_back(nullVertex);
+        last_children_.push_back(nullVertex);
+        next_siblings_.push_back(nullVertex);
+        previous_siblings_.push_back(nullVertex);
+        num_children_.push_back(0);
+        next_leafs_.push_back(nullVertex);
+        previous_leafs_.push_back(nullVertex);
+    } else {
+        result = free_vertices_.back();
+        free_vertices_.pop_back();
+        alleles_[result] = allele; // reuses the old allele's sequence buffer
+    }
+    ++num_vertices_;
+    return result;
+}
+
+void HaplotypeTree::remove_vertex(const Vertex v)
+{
+    assert(parents_[v] == nullVertex && num_children_[v] == 0 && !is_linked_leaf(v));
+    free_vertices_.push_back(v);
+    --num_vertices_;
+}
+
+void HaplotypeTree::add_edge(const Vertex u, const Vertex v)
+{
+    assert(parents_[v] == nullVertex);
+    parents_[v] = u;
+    previous_siblings_[v] = last_children_[u];
+    next_siblings_[v] = nullVertex;
+    if (last_children_[u] == nullVertex) {
+        first_children_[u] = v;
+    } else {
+        next_siblings_[last_children_[u]] = v;
+    }
+    last_children_[u] = v;
+    ++num_children_[u];
+}
+
+void HaplotypeTree::remove_edge(const Vertex u, const Vertex v)
+{
+    assert(parents_[v] == u);
+    if (previous_siblings_[v] == nullVertex) {
+        first_children_[u] = next_siblings_[v];
+    } else {
+        next_siblings_[previous_siblings_[v]] = next_siblings_[v];
+    }
+    if (next_siblings_[v] == nullVertex) {
+        last_children_[u] = previous_siblings_[v];
+    } else {
+        previous_siblings_[next_siblings_[v]] = previous_siblings_[v];
+    }
+    parents_[v] = previous_siblings_[v] = next_siblings_[v] = nullVertex;
+    --num_children_[u];
+}
+
+void HaplotypeTree::push_back_leaf(const Vertex leaf)
+{
+    insert_leaf(nullVertex, leaf);
+}
+
+HaplotypeTree::LeafIterator HaplotypeTree::insert_leaf(const LeafIterator position, const Vertex leaf)
+{
+    assert(!is_linked_leaf(leaf));
+    next_leafs_[leaf] = position;
+    previous_leafs_[leaf] = position == nullVertex ? last_leaf_ : previous_leafs_[position];
+    if (previous_leafs_[leaf] == nullVertex) {
+        first_leaf_ = leaf;
+    } else {
+        next_leafs_[previous_leafs_[leaf]] = leaf;
+    }
+    if (position == nullVertex) {
+        last_leaf_ = leaf;
+    } else {
+        previous_leafs_[position] = leaf;
+    }
+    ++num_leafs_;
+    return leaf;
+}
+
+HaplotypeTree::LeafIterator HaplotypeTree::erase_leaf(const LeafIterator leaf)
+{
+    const auto result = next_leafs_[leaf];
+    if (previous_leafs_[leaf] == nullVertex) {
+        first_leaf_ = result;
+    } else {
+        next_leafs_[previous_leafs_[leaf]] = result;
+    }
+    if (result == nullVertex) {
+        last_leaf_ = previous_leafs_[leaf];
+    } else {
+        previous_leafs_[result] = previous_leafs_[leaf];
+    }
+    next_leafs_[leaf] = previous_leafs_[leaf] = nullVertex;
+    --num_leafs_;
+    return result;
+}
+
+bool HaplotypeTree::is_linked_leaf(const Vertex v) const noexcept
+{
+    return first_leaf_ == v || previous_leafs_[v] != nullVertex;
+}
+
 HaplotypeTree::Vertex HaplotypeTree::get_previous_allele(const Vertex allele) const
 {
     assert(allele != root_);
-    const auto p = boost::inv_adjacent_vertices(allele, tree_);
-    assert(std::distance(p.first, p.second) == 1);
-    return *p.first;
+    assert(parents_[allele] != nullVertex);
+    return parents_[allele];
 }
 
 bool HaplotypeTree::is_leaf(const Vertex v) const
 {
-    return boost::out_degree(v, tree_) == 0;
+    return num_children_[v] == 0;
 }
 
 bool HaplotypeTree::is_bifurcating(const Vertex v) const
 {
-    return boost::out_degree(v, tree_) > 1;
+    return num_children_[v] > 1;
 }
 
 HaplotypeTree::Vertex HaplotypeTree::remove_forward(const Vertex u)
 {
-    const auto p = boost::adjacent_vertices(u, tree_);
-    assert(std::distance(p.first, p.second) == 1);
-    const auto v = *p.first;
-    boost::remove_edge(u, v, tree_);
-    boost::remove_vertex(u, tree_);
+    assert(num_children_[u] == 1);
+    const auto v = first_children_[u];
+    remove_edge(u, v);
+    remove_vertex(u);
     return v;
 }
 
 HaplotypeTree::Vertex HaplotypeTree::remove_backward(const Vertex v)
 {
     const auto u = get_previous_allele(v);
-    boost::remove_edge(u, v, tree_);
-    boost::remove_vertex(v, tree_);
+    remove_edge(u, v);
+    remove_vertex(v);
     return u;
 }
 
 bool HaplotypeTree::allele_exists(const Vertex leaf, const ContigAllele& allele) const
 {
-    const auto p = boost::adjacent_vertices(leaf, tree_);
-    return std::any_of(p.first, p.second, [this, &allele] (const Vertex v) { return tree_[v] == allele; });
+    for (auto v = first_children_[leaf]; v != nullVertex; v = next_siblings_[v]) {
+        if (alleles_[v] == allele) return true;
+    }
+    return false;
 }
 
 HaplotypeTree::Vertex HaplotypeTree::find_allele_before(Vertex v, const ContigAllele& allele) const
 {
-    while (v != root_ && overlaps(allele, tree_[v])) {
-        if (is_same_region(allele, tree_[v])) { // for insertions
+    while (v != root_ && overlaps(allele, alleles_[v])) {
+        if (is_same_region(allele, alleles_[v])) { // for insertions
             v = get_previous_allele(v);
             break;
         }
@@ -566,26 +577,26 @@ HaplotypeTree::Vertex HaplotypeTree::find_allele_before(Vertex v, const ContigAl
 HaplotypeTree::LeafIterator
 HaplotypeTree::extend_haplotype(LeafIterator leaf_itr, const ContigAllele& new_allele)
 {
-    if (*leaf_itr == root_) {
-        const auto new_leaf = boost::add_vertex(new_allele, tree_);
-        boost::add_edge(*leaf_itr, new_leaf, tree_);
-        leaf_itr = haplotype_leafs_.erase(leaf_itr);
-        leaf_itr = haplotype_leafs_.insert(leaf_itr, new_leaf);
+    if (leaf_itr == root_) {
+        const auto new_leaf = add_vertex(new_allele);
+        add_edge(leaf_itr, new_leaf);
+        leaf_itr = erase_leaf(leaf_itr);
+        leaf_itr = insert_leaf(leaf_itr, new_leaf);
     } else {
-        const auto& leaf_allele = tree_[*leaf_itr];
+        const auto& leaf_allele = alleles_[leaf_itr];
         if (can_add_to_branch(new_allele, leaf_allele)) {
             if (is_after(new_allele, leaf_allele)) {
-                const auto new_leaf = boost::add_vertex(new_allele, tree_);
-                boost::add_edge(*leaf_itr, new_leaf, tree_);
-                leaf_itr = haplotype_leafs_.erase(leaf_itr);
-                leaf_itr = haplotype_leafs_.insert(leaf_itr, new_leaf);
+                const auto new_leaf = add_vertex(new_allele);
+                add_edge(leaf_itr, new_leaf);
+                leaf_itr = erase_leaf(leaf_itr);
+                leaf_itr = insert_leaf(leaf_itr, new_leaf);
             } else if (overlaps(new_allele, leaf_allele)) {
-                const auto branch_point = find_allele_before(*leaf_itr, new_allele);
-                if ((branch_point == root_ || can_add_to_branch(new_allele, tree_[branch_point]))
+                const auto branch_point = find_allele_before(leaf_itr, new_allele);
+                if ((branch_point == root_ || can_add_to_branch(new_allele, alleles_[branch_point]))
                     && !allele_exists(branch_point, new_allele)) {
-                    const auto new_leaf = boost::add_vertex(new_allele, tree_);
-                    boost::add_edge(branch_point, new_leaf, tree_);
-                    haplotype_leafs_.insert(leaf_itr, new_leaf);
+                    const auto new_leaf = add_vertex(new_allele);
+                    add_edge(branch_point, new_leaf);
+                    insert_leaf(leaf_itr, new_leaf);
                 }
             }
         }
@@ -597,14 +608,16 @@ Haplotype HaplotypeTree::extract_haplotype(Vertex leaf, const GenomicRegion& reg
 {
     const auto& contig_region = region.contig_region();
     using octopus::contains;
-    while (leaf != root_ && !contains(contig_region, tree_[leaf])) {
+    while (leaf != root_ && !contains(contig_region, alleles_[leaf])) {
         leaf = get_previous_allele(leaf);
     }
-    Haplotype::Builder result {region, reference_};
-    while (leaf != root_ && contains(contig_region, tree_[leaf])) {
-        result.push_front(tree_[leaf]);
+    branch_buffer_.clear();
+    while (leaf != root_ && contains(contig_region, alleles_[leaf])) {
+        branch_buffer_.push_back(leaf);
         leaf = get_previous_allele(leaf);
     }
+    Haplotype::Builder result {region, reference_};
+    std::for_each(std::crbegin(branch_buffer_), std::crend(branch_buffer_), [&] (const Vertex v) { result.push_back(alleles_[v]); });
     return result.build();
 }
 
@@ -612,25 +625,25 @@ HaplotypeTree::HaplotypeLength HaplotypeTree::extract_haplotype_length(Vertex le
 {
     const auto& contig_region = region.contig_region();
     using octopus::contains;
-    while (leaf != root_ && !contains(contig_region, tree_[leaf])) {
+    while (leaf != root_ && !contains(contig_region, alleles_[leaf])) {
         leaf = get_previous_allele(leaf);
     }
     if (leaf == root_) {
         return size(contig_region);
     }
-    HaplotypeLength result {right_overhang_size(contig_region, tree_[leaf])};
+    HaplotypeLength result {right_overhang_size(contig_region, alleles_[leaf])};
     auto prev_node = leaf;
     while (true) {
-        result += sequence_size(tree_[leaf]);
+        result += sequence_size(alleles_[leaf]);
         prev_node = leaf;
         leaf = get_previous_allele(leaf);
-        if (leaf != root_ && contains(contig_region, tree_[leaf])) {
-            result += inner_distance(tree_[leaf], tree_[prev_node]);
+        if (leaf != root_ && contains(contig_region, alleles_[leaf])) {
+            result += inner_distance(alleles_[leaf], alleles_[prev_node]);
         } else {
             break;
         }
     }
-    result += left_overhang_size(contig_region, tree_[prev_node]);
+    result += left_overhang_size(contig_region, alleles_[prev_node]);
     return result;
 }
 
@@ -640,7 +653,7 @@ bool HaplotypeTree::define_same_haplotype(Vertex leaf1, Vertex leaf2) const
         return true;
     }
     while (leaf1 != root_) {
-        if (leaf2 == root_ || tree_[leaf1] != tree_[leaf2]) return false;
+        if (leaf2 == root_ || alleles_[leaf1] != alleles_[leaf2]) return false;
         leaf1 = get_previous_allele(leaf1);
         leaf2 = get_previous_allele(leaf2);
     }
@@ -649,11 +662,11 @@ bool HaplotypeTree::define_same_haplotype(Vertex leaf1, Vertex leaf2) const
 
 bool HaplotypeTree::is_branch_exact_haplotype(Vertex leaf, const Haplotype& haplotype) const
 {
-    if (leaf == root_ || !overlaps(tree_[leaf], contig_region(haplotype))) {
+    if (leaf == root_ || !overlaps(alleles_[leaf], contig_region(haplotype))) {
         return false;
     }
     while (leaf != root_) {
-        if (!haplotype.includes(tree_[leaf])) {
+        if (!haplotype.includes(alleles_[leaf])) {
             return false;
         }
         leaf = get_previous_allele(leaf);
@@ -664,48 +677,47 @@ bool HaplotypeTree::is_branch_exact_haplotype(Vertex leaf, const Haplotype& hapl
 bool HaplotypeTree::is_branch_equal_haplotype(const Vertex leaf, const Haplotype& haplotype) const
 {
     // TODO: check if this is quicker than calling Haplotype::contains for each ContigAllele
-    return leaf != root_ && overlaps(contig_region(haplotype), tree_[leaf])
+    return leaf != root_ && overlaps(contig_region(haplotype), alleles_[leaf])
             && extract_haplotype(leaf, haplotype.mapped_region()) == haplotype;
 }
 
 HaplotypeTree::LeafIterator
-HaplotypeTree::find_exact_haplotype_leaf(const LeafIterator first, const LeafIterator last,
-                                         const Haplotype& haplotype) const
+HaplotypeTree::find_exact_haplotype_leaf(LeafIterator first, const Haplotype& haplotype) const
 {
-    return std::find_if(first, last,
-                        [this, &haplotype] (Vertex leaf) {
-                            return is_branch_exact_haplotype(leaf, haplotype);
-                        });
+    while (first != nullVertex && !is_branch_exact_haplotype(first, haplotype)) first = next_leafs_[first];
+    return first;
 }
 
 HaplotypeTree::LeafIterator
-HaplotypeTree::find_equal_haplotype_leaf(const LeafIterator first, const LeafIterator last,
-                                         const Haplotype& haplotype) const
+HaplotypeTree::find_equal_haplotype_leaf(LeafIterator first, const Haplotype& haplotype) const
 {
-    return std::find_if(first, last,
-                        [this, &haplotype] (Vertex leaf) {
-                            return is_branch_equal_haplotype(leaf, haplotype);
-                        });
+    while (first != nullVertex && !is_branch_equal_haplotype(first, haplotype)) first = next_leafs_[first];
+    return first;
 }
 
 void HaplotypeTree::clear_overlapped(const ContigRegion& region)
 {
     haplotype_leaf_cache_.clear();
-    std::list<Vertex> new_leafs {};
-    for (const Vertex leaf : haplotype_leafs_) {
+    std::vector<Vertex> new_leafs {};
+    new_leafs.reserve(num_leafs_);
+    for (auto leaf = first_leaf_; leaf != nullVertex; ) {
+        const auto next_leaf = erase_leaf(leaf);
         const auto p = clear(leaf, region);
         if (p.second) new_leafs.push_back(p.first);
+        leaf = next_leaf;
     }
+    assert(num_leafs_ == 0);
     // As the tree is cleared, a  branch stub could be appended to a previous new leaf node
-    new_leafs.erase(std::remove_if(std::begin(new_leafs), std::end(new_leafs), [this] (Vertex v) { return !is_leaf(v); }), std::end(new_leafs));
-    haplotype_leafs_ = std::move(new_leafs);
+    for (const auto leaf : new_leafs) {
+        if (is_leaf(leaf) && !is_linked_leaf(leaf)) push_back_leaf(leaf);
+    }
     tree_region_ = boost::none;
 }
 
 std::pair<HaplotypeTree::Vertex, bool>
 HaplotypeTree::clear(const Vertex leaf, const ContigRegion& region)
 {
-    if (overlaps(region, tree_[leaf])) {
+    if (overlaps(region, alleles_[leaf])) {
         return clear_external(leaf, region);
     } else {
         return clear_internal(leaf, region);
@@ -717,16 +729,16 @@ HaplotypeTree::clear_external(Vertex leaf, const ContigRegion& region)
 {
     assert(is_leaf(leaf));
     while (leaf != root_) {
-        if (boost::out_degree(leaf, tree_) > 0) {
+        if (num_children_[leaf] > 0) {
             return std::make_pair(leaf, false);
-        } else if (begins_before(tree_[leaf], region)) {
+        } else if (begins_before(alleles_[leaf], region)) {
             return std::make_pair(leaf, true);
         } else {
             leaf = remove_backward(leaf);
         }
     }
     // the root should only be indicated as a leaf node if there are no other nodes in the tree
-    return std::make_pair(leaf, boost::num_vertices(tree_) == 1);
+    return std::make_pair(leaf, num_vertices_ == 1);
 }
 
 std::pair<HaplotypeTree::Vertex, bool>
@@ -734,72 +746,66 @@ HaplotypeTree::clear_internal(const Vertex leaf, const ContigRegion& region)
 {
     assert(is_leaf(leaf));
     // TODO: we can optimise this for cases where region overlaps the leftmost alleles in the tree
-    if (leaf == root_ || is_after(region, tree_[leaf])) {
+    if (leaf == root_ || is_after(region, alleles_[leaf])) {
         return std::make_pair(leaf, true);
     }
     Vertex current_allele {leaf}, allele_to_move {leaf};
-    std::deque<Vertex> alleles_to_copy {};
+    std::vector<Vertex> alleles_to_copy {}; // in reverse order
     bool is_bifurcating_branch {false};
     while (true) {
         current_allele = get_previous_allele(current_allele);
-        if (current_allele == root_ || overlaps(tree_[current_allele], region)) {
+        if (current_allele == root_ || overlaps(alleles_[current_allele], region)) {
             break;
         }
         is_bifurcating_branch = is_bifurcating_branch || is_bifurcating(current_allele);
         if (!is_bifurcating_branch) {
             allele_to_move = current_allele;
         } else {
-            alleles_to_copy.push_front(current_allele);
+            alleles_to_copy.push_back(current_allele);
         }
     }
     if (alleles_to_copy.empty()) {
-        boost::remove_edge(current_allele, allele_to_move, tree_);
+        remove_edge(current_allele, allele_to_move);
     } else {
-        assert(alleles_to_copy.back() != allele_to_move);
-        boost::remove_edge(alleles_to_copy.back(), allele_to_move, tree_);
+        assert(alleles_to_copy.front() != allele_to_move);
+        remove_edge(alleles_to_copy.front(), allele_to_move);
     }
-    while (current_allele != root_ && overlaps(region, tree_[current_allele])) {
+    while (current_allele != root_ && overlaps(region, alleles_[current_allele])) {
         const auto previous_allele = get_previous_allele(current_allele);
-        is_bifurcating_branch = is_bifurcating_branch || boost::out_degree(current_allele, tree_) > 0;
+        is_bifurcating_branch = is_bifurcating_branch || num_children_[current_allele] > 0;
         if (!is_bifurcating_branch) {
-            assert(boost::out_degree(current_allele, tree_) <= 1);
-            boost::remove_edge(previous_allele, current_allele, tree_);
-            boost::remove_vertex(current_allele, tree_);
+            assert(num_children_[current_allele] <= 1);
+            remove_edge(previous_allele, current_allele);
+            remove_vertex(current_allele);
         }
         current_allele = previous_allele;
     }
     // Simpler to prepend onto the movable branch and then call that moveable than treat each separately
-    std::for_each(std::crbegin(alleles_to_copy), std::crend(alleles_to_copy),
-                  [this, &allele_to_move] (const Vertex allele) {
-                      const auto v = boost::add_vertex(tree_[allele], tree_);
-                      boost::add_edge(v, allele_to_move, tree_);
-                      allele_to_move = v;
-                  });
-    alleles_to_copy.clear();
-    alleles_to_copy.shrink_to_fit();
+    for (const auto allele : alleles_to_copy) {
+        const auto v = add_vertex(alleles_[allele]);
+        add_edge(v, allele_to_move);
+        allele_to_move = v;
+    }
     auto allele_to_move_to = current_allele;
     // Now avoid duplicate branches
     while (true) {
-        const auto vertex_range = boost::adjacent_vertices(allele_to_move_to, tree_);
-        const auto it = std::find_if(vertex_range.first, vertex_range.second,
-                                     [this, allele_to_move] (const Vertex allele) {
-                                         return tree_[allele] == tree_[allele_to_move];
-                                     });
-        if (it == vertex_range.second) break;
-        allele_to_move_to = *it; // i.e. move forward
+        auto it = first_children_[allele_to_move_to];
+        while (it != nullVertex && alleles_[it] != alleles_[allele_to_move]) it = next_siblings_[it];
+        if (it == nullVertex) break;
+        allele_to_move_to = it; // i.e. move forward
         if (is_leaf(allele_to_move)) break;
         // Safe to remove forward as we made this branch earlier via copies
         allele_to_move = remove_forward(allele_to_move);
     }
-    if (allele_to_move_to == root_ || tree_[allele_to_move_to] != tree_[allele_to_move]) {
-        boost::add_edge(allele_to_move_to, allele_to_move, tree_);
+    if (allele_to_move_to == root_ || alleles_[allele_to_move_to] != alleles_[allele_to_move]) {
+        add_edge(allele_to_move_to, allele_to_move);
         return std::make_pair(leaf, true);
     } else {
         // Ditch the entire copied branch as it's already in the tree
-        while (boost::out_degree(allele_to_move, tree_) > 0) {
+        while (num_children_[allele_to_move] > 0) {
             allele_to_move = remove_forward(allele_to_move);
         }
-        boost::remove_vertex(allele_to_move, tree_);
+        remove_vertex(allele_to_move);
         return std::make_pair(allele_to_move_to, false);
     }
 }
@@ -878,41 +884,6 @@ void write_dot(const HaplotypeTree& tree, const boost::filesystem::path& dest)
     tree.write_dot(file);
 }
 
-template <typename G, typename V, typename Container>
-bool is_tree(const G& graph, const V& root, const Container& leafs)
-{
-    if (boost::num_vertices(graph) == 1) {
-        return *boost::vertices(graph).first == root;
-    }
-    std::unordered_set<V> visited_vertices {};
-    visited_vertices.reserve(boost::num_vertices(graph));
-    auto vis = boost::make_bfs_visitor(boost::write_property(boost::typed_identity_property_map<V>(),
-                                                             std::inserter(visited_vertices,
-                                                                           std::begin(visited_vertices)),
-                                                             boost::on_discover_vertex()));
-    std::unordered_map<V, std::size_t> index_map {};
-    index_map.reserve(boost::num_vertices(graph));
-    const auto p = boost::vertices(graph);
-    std::size_t i {0};
-    std::for_each(p.first, p.second, [&i, &index_map] (const auto& v) { index_map.emplace(v, i++); });
-    boost::breadth_first_search(graph, root,
-                                boost::visitor(vis)
-                                .vertex_index_map(boost::make_assoc_property_map(index_map)));
-    if (visited_vertices.size() != boost::num_vertices(graph) || visited_vertices.count(root) == 0) {
-        return false;
-    }
-    return std::all_of(std::cbegin(leafs), std::cend(leafs),
-                       [&graph, &root] (auto v) {
-                           if (boost::out_degree(v, graph) != 0) return false;
-                           while (v != root) {
-                               const auto p = boost::inv_adjacent_vertices(v, graph);
-                               if (std::distance(p.first, p.second) != 1) return false;
-                               v = *p.first;
-                           }
-                           return true;
-                       });
-}
-
 } // namespace debug
 
 } // namespace coretools
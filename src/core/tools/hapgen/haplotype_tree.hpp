@@ -5,18 +5,17 @@
 #define haplotype_tree_hpp
 
 #include <vector>
-#include <list>
 #include <unordered_map>
-#include <unordered_set>
 #include <utility>
 #include <functional>
 #include <iterator>
 #include <algorithm>
 #include <type_traits>
+#include <limits>
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
 
-#include <boost/graph/adjacency_list.hpp>
 #include <boost/optional.hpp>
 #include <boost/filesystem.hpp>
 
@@ -31,6 +30,15 @@ class ReferenceGenome;
 
 namespace coretools {
 
+/*
+    HaplotypeTree is a prefix tree of the alleles of all haplotypes being considered; each
+    root-to-leaf path is a haplotype.
+ 
+    Nodes are stored in flat arrays and linked by index. Each node's children, and the leafs, are
+    kept in insertion order with intrusive linked lists, so iteration order is deterministic.
+    Removed nodes go on a free list and are reused by later extensions, so clearing a region and
+    then extending again usually allocates nothing.
+ */
 class HaplotypeTree
 {
 public:
@@ -40,8 +48,8 @@ public:
     
     HaplotypeTree(const GenomicRegion::ContigName& contig, const ReferenceGenome& reference);
     
-    HaplotypeTree(const HaplotypeTree&);
-    HaplotypeTree& operator=(const HaplotypeTree&);
+    HaplotypeTree(const HaplotypeTree&)            = default;
+    HaplotypeTree& operator=(const HaplotypeTree&) = default;
     HaplotypeTree(HaplotypeTree&&)            = default;
     HaplotypeTree& operator=(HaplotypeTree&&) = default;
     
@@ -89,26 +97,41 @@ public:
     void write_dot(std::ostream& out) const;
     
 private:
-    using Tree = boost::adjacency_list<
-        boost::listS, boost::listS, boost::bidirectionalS, ContigAllele, boost::no_property
-    >;
+    using Vertex = std::uint32_t;
     
-    using Vertex = boost::graph_traits<Tree>::vertex_descriptor;
-    using Edge   = boost::graph_traits<Tree>::edge_descriptor;
+    static constexpr Vertex nullVertex {std::numeric_limits<Vertex>::max()};
     
     using HaplotypeVertexMultiMap = std::unordered_multimap<Haplotype, Vertex>;
     
     std::reference_wrapper<const ReferenceGenome> reference_;
-    Tree tree_;
-    Vertex root_;
-    std::list<Vertex> haplotype_leafs_;
     GenomicRegion::ContigName contig_;
     
+    // Node arrays, indexed by Vertex
+    std::vector<ContigAllele> alleles_;
+    std::vector<Vertex> parents_, first_children_, last_children_, next_siblings_, previous_siblings_;
+    std::vector<std::uint32_t> num_children_;
+    std::vector<Vertex> next_leafs_, previous_leafs_;
+    std::vector<Vertex> free_vertices_;
+    std::size_t num_vertices_;
+    
+    Vertex root_;
+    Vertex first_leaf_, last_leaf_;
+    std::size_t num_leafs_;
+    
     mutable HaplotypeVertexMultiMap haplotype_leaf_cache_;
     mutable boost::optional<GenomicRegion> tree_region_;
+    mutable std::vector<Vertex> branch_buffer_;
+    
+    using LeafIterator = Vertex; // nullVertex is the end
     
-    using LeafIterator  = decltype(haplotype_leafs_)::const_iterator;
-    using CacheIterator = decltype(haplotype_leaf_cache_)::iterator;
+    Vertex add_vertex(const ContigAllele& allele);
+    void remove_vertex(Vertex v);
+    void add_edge(Vertex u, Vertex v);
+    void remove_edge(Vertex u, Vertex v);
+    void push_back_leaf(Vertex leaf);
+    LeafIterator insert_leaf(LeafIterator position, Vertex leaf);
+    LeafIterator erase_leaf(LeafIterator leaf);
+    bool is_linked_leaf(Vertex v) const noexcept;
     
     bool is_leaf(Vertex v) const;
     bool is_bifurcating(Vertex v) const;
@@ -123,10 +146,8 @@ private:
     bool define_same_haplotype(Vertex leaf1, Vertex leaf2) const;
     bool is_branch_exact_haplotype(Vertex branch_vertex, const Haplotype& haplotype) const;
     bool is_branch_equal_haplotype(Vertex branch_vertex, const Haplotype& haplotype) const;
-    LeafIterator find_exact_haplotype_leaf(LeafIterator first, LeafIterator last,
-                                           const Haplotype& haplotype) const;
-    LeafIterator find_equal_haplotype_leaf(LeafIterator first, LeafIterator last,
-                                           const Haplotype& haplotype) const;
+    LeafIterator find_exact_haplotype_leaf(LeafIterator first, const Haplotype& haplotype) const;
+    LeafIterator find_equal_haplotype_leaf(LeafIterator first, const Haplotype& haplotype) const;
     void clear_overlapped(const ContigRegion& region);
     std::pair<Vertex, bool> clear(Vertex leaf, const ContigRegion& region);
     std::pair<Vertex, bool> clear_external(Vertex leaf, const ContigRegion& region);
@@ -7,8 +7,6 @@
 #include <iterator>
 #include <deque>
 #include <stdexcept>
-#include <thread>
-#include <future>
 #include <cassert>
 
 #include "tandem/tandem.hpp"
@@ -22,6 +20,7 @@
 #include "utils/append.hpp"
 #include "utils/global_aligner.hpp"
 #include "utils/read_stats.hpp"
+#include "utils/executor.hpp"
 #include "io/reference/reference_genome.hpp"
 #include "logging/logging.hpp"
 
@@ -93,7 +92,7 @@ const GenomicRegion& LocalReassembler::Bin::mapped_region() const noexcept
     return region;
 }
 
-void LocalReassembler::Bin::add(const AlignedRead& read)
+void LocalReassembler::Bin::add(const AlignedRead& read, const Assembler::PackedSequence& sequence)
 {
     if (read_region) {
         read_region = encompassing_region(*read_region, contig_region(read));
@@ -101,23 +100,9 @@ void LocalReassembler::Bin::add(const AlignedRead& read)
         read_region = contig_region(read);
     }
     if (is_forward_strand(read)) {
-        forward_read_sequences.emplace_back(read.sequence());
+        forward_read_sequences.emplace_back(sequence);
     } else {
-        reverse_read_sequences.emplace_back(read.sequence());
-    }
-}
-
-void LocalReassembler::Bin::add(const AlignedRead& read, const NucleotideSequence& masked_sequence)
-{
-    if (read_region) {
-        read_region = encompassing_region(*read_region, contig_region(read));
-    } else {
-        read_region = contig_region(read);
-    }
-    if (is_forward_strand(read)) {
-        forward_read_sequences.emplace_back(masked_sequence);
-    } else {
-        reverse_read_sequences.emplace_back(masked_sequence);
+        reverse_read_sequences.emplace_back(sequence);
     }
 }
 
@@ -323,7 +308,8 @@ void remove_larger_than(std::deque<Variant>& variants, const Variant::MappingDom
 std::vector<Variant> LocalReassembler::do_generate(const RegionSet& regions) const
 {
     BinList bins {};
-    SequenceBuffer masked_sequence_buffer {};
+    // Each read is packed once and shared by all the bins and kmer sizes it is assembled with
+    SequenceBuffer read_sequence_buffer {};
     for (const auto& region : regions) {
         prepare_bins(region, bins);
         for (const auto& p : read_buffer_) {
@@ -333,13 +319,14 @@ std::vector<Variant> LocalReassembler::do_generate(const RegionSet& regions) con
                 if (requires_masking(read, mask_threshold_)) {
                     auto masked_sequence = mask(read, mask_threshold_, reference_);
                     if (masked_sequence) {
-                        masked_sequence_buffer.emplace_back(std::move(*masked_sequence));
+                        read_sequence_buffer.emplace_back(*masked_sequence);
                         for (auto& bin : active_bins) {
-                            bin.add(read, std::cref(masked_sequence_buffer.back()));
+                            bin.add(read, read_sequence_buffer.back());
                         }
                     }
                 } else {
-                    for (auto& bin : active_bins) bin.add(read);
+                    read_sequence_buffer.emplace_back(read.get().sequence());
+                    for (auto& bin : active_bins) bin.add(read, read_sequence_buffer.back());
                 }
             }
         }
@@ -359,28 +346,27 @@ std::vector<Variant> LocalReassembler::do_generate(const RegionSet& regions) con
             bin.clear();
         }
     } else {
-        const std::size_t num_threads {4};
-        std::vector<std::future<std::deque<Variant>>> bin_futures(std::min(bins.size(), num_threads));
-        for (auto first_bin = std::begin(bins), last_bin = std::end(bins); first_bin != last_bin; ) {
-            const auto batch_size = std::min(num_threads, static_cast<std::size_t>(std::distance(first_bin, last_bin)));
-            const auto next_bin = std::next(first_bin, batch_size);
-            auto last_future = std::transform(first_bin, next_bin, std::begin(bin_futures), [&] (Bin& bin) {
-                if (debug_log_) {
-                    stream(*debug_log_) << "Assembling " << bin.size() << " reads in bin " << mapped_region(bin);
-                }
-                return std::async([&] () {
-                    std::deque<Variant> result {};
-                    const auto num_default_failures = try_assemble_with_defaults(bin, result);
-                    if (num_default_failures == default_kmer_sizes_.size()) {
-                        try_assemble_with_fallbacks(bin, result);
-                    }
-                    bin.clear();
-                    return result;
-                });
-            });
-            std::for_each(std::begin(bin_futures), last_future, [&] (auto& f) { utils::append(f.get(), candidates); });
-            first_bin = next_bin;
+        const auto executor = get_executor();
+        if (debug_log_) {
+            for (const auto& bin : bins) {
+                stream(*debug_log_) << "Assembling " << bin.size() << " reads in bin " << mapped_region(bin);
+            }
+        }
+        std::vector<std::deque<Variant>> bin_candidates(bins.size());
+        const auto assemble = [&] (const std::size_t i) {
+            auto& bin = bins[i];
+            const auto num_default_failures = try_assemble_with_defaults(bin, bin_candidates[i]);
+            if (num_default_failures == default_kmer_sizes_.size()) {
+                try_assemble_with_fallbacks(bin, bin_candidates[i]);
+            }
+            bin.clear();
+        };
+        if (executor) {
+            executor->parallel_for("LocalReassembler::assemble", bins.size(), assemble);
+        } else {
+            for (std::size_t i {0}; i < bins.size(); ++i) assemble(i);
         }
+        for (auto& variants : bin_candidates) utils::append(std::move(variants), candidates);
     }
     remove_duplicates(candidates);
     remove_larger_than(candidates, max_variant_size_);
@@ -79,21 +79,20 @@ private:
     std::string name() const override;
     
     using NucleotideSequence = AlignedRead::NucleotideSequence;
-    using SequenceBuffer     = std::deque<NucleotideSequence>;
+    using SequenceBuffer     = std::deque<Assembler::PackedSequence>;
     using ReadReference      = MappableReferenceWrapper<const AlignedRead>;
     using ReadBuffer         = MappableFlatMultiSet<ReadReference>;
     using ReadBufferMap      = std::map<SampleName, ReadBuffer>;
     
     struct Bin : public Mappable<Bin>
     {
-        using ReadReferenceStash = std::deque<std::reference_wrapper<const NucleotideSequence>>;
+        using ReadReferenceStash = std::deque<std::reference_wrapper<const Assembler::PackedSequence>>;
         
         Bin(GenomicRegion region);
         
         const GenomicRegion& mapped_region() const noexcept;
         
-        void add(const AlignedRead& read);
-        void add(const AlignedRead& read, const NucleotideSequence& masked_sequence);
+        void add(const AlignedRead& read, const Assembler::PackedSequence& sequence);
         
         void clear() noexcept;
         std::size_t size() const noexcept;
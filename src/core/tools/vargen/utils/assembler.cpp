@@ -12,7 +12,6 @@
 #include <cassert>
 #include <iostream>
 
-#include <boost/functional/hash.hpp>
 #include <boost/property_map/property_map.hpp>
 #include <boost/graph/depth_first_search.hpp>
 #include <boost/graph/breadth_first_search.hpp>
@@ -31,8 +30,6 @@
 #include "utils/append.hpp"
 #include "utils/maths.hpp"
 
-#define _unused(x) ((void)(x))
-
 namespace octopus { namespace coretools {
 
 namespace {
@@ -49,6 +46,15 @@ std::size_t count_kmers(const T& sequence, const unsigned kmer_size) noexcept
     return sequence.size() >= kmer_size ? sequence.size() - kmer_size + 1 : 0;
 }
 
+constexpr std::array<char, 4> packedBases {'A', 'C', 'G', 'T'};
+
+template <typename Word>
+char unpack_base(const Word* packed, const std::size_t pos) noexcept
+{
+    constexpr unsigned basesPerWord {4 * sizeof(Word)};
+    return packedBases[(packed[pos / basesPerWord] >> (2 * (pos % basesPerWord))) & 3];
+}
+
 } // namespace
 
 // public methods
@@ -65,15 +71,15 @@ const char* Assembler::NonCanonicalReferenceSequence::what() const noexcept
 
 Assembler::Assembler(const Parameters params)
 : params_ {params}
-, reference_kmers_ {}
 , reference_head_position_ {0}
+, kmers_ {params.kmer_size}
 , reference_vertices_ {}
 {}
 
 Assembler::Assembler(const Parameters params, const NucleotideSequence& reference)
 : params_ {params}
-, reference_kmers_ {}
 , reference_head_position_ {0}
+, kmers_ {params.kmer_size}
 , reference_vertices_ {}
 {
     insert_reference_into_empty_graph(reference);
@@ -94,7 +100,7 @@ void Assembler::insert_reference(const NucleotideSequence& sequence)
     if (sequence.size() >= kmer_size()) {
         if (is_empty()) {
             insert_reference_into_empty_graph(sequence);
-        } else if (reference_kmers_.empty()) {
+        } else if (reference_vertices_.empty()) {
             insert_reference_into_populated_graph(sequence);
         } else {
             throw std::runtime_error {"Assembler: only one reference sequence can be inserted into the graph"};
@@ -107,112 +113,98 @@ void Assembler::insert_reference(const NucleotideSequence& sequence)
 void Assembler::insert_read(const NucleotideSequence& sequence, const Direction strand)
 {
     if (sequence.size() >= kmer_size()) {
-        const bool is_forward_strand {strand == Direction::forward};
-        auto kmer_begin = std::cbegin(sequence);
-        auto kmer_end   = std::next(kmer_begin, kmer_size());
-        Kmer prev_kmer {kmer_begin, kmer_end};
-        bool prev_kmer_good {true};
-        auto vertex_itr = vertex_cache_.find(prev_kmer);
-        auto ref_kmer_itr = std::cbegin(reference_kmers_);
-        if (vertex_itr == std::cend(vertex_cache_)) {
-            const auto u = add_vertex(prev_kmer);
-            if (!u) prev_kmer_good = false;
-        } else if (is_reference(vertex_itr->second)) {
-            ref_kmer_itr = std::find(std::cbegin(reference_kmers_), std::cend(reference_kmers_), prev_kmer);
-            assert(ref_kmer_itr != std::cend(reference_kmers_));
-            auto next_kmer_begin = std::next(kmer_begin);
-            auto next_kmer_end   = std::next(kmer_end);
-            const auto ref_offset = std::distance(std::cbegin(reference_kmers_), ref_kmer_itr);
-            auto ref_vertex_itr = std::next(std::cbegin(reference_vertices_), ref_offset);
-            auto ref_edge_itr = std::next(std::cbegin(reference_edges_), ref_offset);
-            ++ref_kmer_itr;
-            for (; next_kmer_end <= std::cend(sequence) && ref_kmer_itr < std::cend(reference_kmers_);
-                   ++next_kmer_begin, ++next_kmer_end, ++ref_kmer_itr, ++ref_vertex_itr, ++ref_edge_itr) {
-                if (std::equal(next_kmer_begin, next_kmer_end, std::cbegin(*ref_kmer_itr))) {
-                    assert(ref_edge_itr != std::cend(reference_edges_));
-                    increment_weight(*ref_edge_itr, is_forward_strand);
-                } else {
-                    break;
-                }
-            }
-            if (next_kmer_end > std::cend(sequence)) {
-                return;
+        insert_read(PackedSequence {sequence}, strand);
+    }
+}
+
+void Assembler::insert_read(const PackedSequence& sequence, const Direction strand)
+{
+    if (sequence.size() < kmer_size()) return;
+    const bool is_forward_strand {strand == Direction::forward};
+    const auto num_read_kmers = sequence.size() - kmer_size() + 1;
+    std::vector<KmerWord> kmer(kmers_.num_words());
+    const auto load_kmer = [&] (const std::size_t offset) {
+        if (!sequence.is_canonical(offset, kmer_size())) return false;
+        sequence.copy(offset, kmer_size(), kmer.data());
+        return true;
+    };
+    std::size_t ref_offset {0};
+    // The read kmer at offset is the reference kmer at ref_offset. Returns the offset of the first
+    // read kmer that leaves the reference, leaving ref_offset on the matching reference kmer.
+    const auto follow_reference = [&] (std::size_t offset) {
+        auto ref_edge_offset = ref_offset;
+        for (++offset, ++ref_offset; offset < num_read_kmers && ref_offset < reference_vertices_.size();
+             ++offset, ++ref_offset, ++ref_edge_offset) {
+            if (load_kmer(offset) && is_kmer_of(reference_vertices_[ref_offset], kmer.data())) {
+                assert(ref_edge_offset < reference_edges_.size());
+                increment_weight(reference_edges_[ref_edge_offset], is_forward_strand);
+            } else {
+                break;
             }
-            kmer_begin = std::prev(next_kmer_begin);
-            kmer_end   = std::prev(next_kmer_end);
-            assert(kmer_end <= std::cend(sequence));
-            prev_kmer = Kmer {kmer_begin, kmer_end};
         }
-        ++kmer_begin;
-        ++kmer_end;
-        for (; kmer_end <= std::cend(sequence); ++kmer_begin, ++kmer_end) {
-            Kmer kmer {kmer_begin, kmer_end};
-            const auto kmer_itr = vertex_cache_.find(kmer);
-            if (kmer_itr == std::cend(vertex_cache_)) {
-                const auto v = add_vertex(kmer);
-                if (v) {
-                    if (prev_kmer_good) {
-                        const auto u = vertex_cache_.at(prev_kmer);
-                        add_edge(u, *v, 1, is_forward_strand);
-                    }
-                    prev_kmer_good = true;
+        return offset;
+    };
+    std::size_t offset {0};
+    auto prev_vertex = null_vertex(); // null if the previous read kmer is not canonical
+    if (load_kmer(offset)) {
+        prev_vertex = find_vertex(kmer.data());
+        if (prev_vertex == null_vertex()) {
+            prev_vertex = add_vertex(kmer.data());
+        } else if (is_reference(prev_vertex)) {
+            const auto ref_itr = std::find(std::cbegin(reference_vertices_), std::cend(reference_vertices_), prev_vertex);
+            assert(ref_itr != std::cend(reference_vertices_));
+            ref_offset = std::distance(std::cbegin(reference_vertices_), ref_itr);
+            offset = follow_reference(offset);
+            if (offset == num_read_kmers) return;
+            --offset;
+            prev_vertex = reference_vertices_[ref_offset - 1];
+        }
+    }
+    for (++offset; offset < num_read_kmers; ++offset) {
+        if (!load_kmer(offset)) {
+            prev_vertex = null_vertex();
+            continue;
+        }
+        auto v = find_vertex(kmer.data());
+        if (v == null_vertex()) {
+            v = add_vertex(kmer.data());
+            if (prev_vertex != null_vertex()) {
+                add_edge(prev_vertex, v, 1, is_forward_strand);
+            }
+        } else {
+            if (prev_vertex != null_vertex()) {
+                Edge e; bool e_in_graph;
+                std::tie(e, e_in_graph) = boost::edge(prev_vertex, v, graph_);
+                if (e_in_graph) {
+                    increment_weight(e, is_forward_strand);
                 } else {
-                    prev_kmer_good = false;
+                    add_edge(prev_vertex, v, 1, is_forward_strand);
                 }
-            } else {
-                if (prev_kmer_good) {
-                    const auto u = vertex_cache_.at(prev_kmer);
-                    const auto v = kmer_itr->second;
-                    Edge e; bool e_in_graph;
-                    std::tie(e, e_in_graph) = boost::edge(u, v, graph_);
-                    if (e_in_graph) {
-                        increment_weight(e, is_forward_strand);
-                    } else {
-                        add_edge(u, v, 1, is_forward_strand);
-                    }
-                }
-                if (is_reference(kmer_itr->second)) {
-                    ref_kmer_itr = std::find(ref_kmer_itr, std::cend(reference_kmers_), kmer);
-                    if (ref_kmer_itr != std::cend(reference_kmers_)) {
-                        auto next_kmer_begin = std::next(kmer_begin);
-                        auto next_kmer_end   = std::next(kmer_end);
-                        const auto ref_offset = std::distance(std::cbegin(reference_kmers_), ref_kmer_itr);
-                        auto ref_vertex_itr = std::next(std::cbegin(reference_vertices_), ref_offset);
-                        auto ref_edge_itr = std::next(std::cbegin(reference_edges_), ref_offset);
-                        ++ref_kmer_itr;
-                        for (; next_kmer_end <= std::cend(sequence) && ref_kmer_itr < std::cend(reference_kmers_);
-                               ++next_kmer_begin, ++next_kmer_end, ++ref_kmer_itr, ++ref_vertex_itr, ++ref_edge_itr) {
-                            if (std::equal(next_kmer_begin, next_kmer_end, std::cbegin(*ref_kmer_itr))) {
-                                assert(ref_edge_itr != std::cend(reference_edges_));
-                                increment_weight(*ref_edge_itr, is_forward_strand);
-                            } else {
-                                break;
-                            }
-                        }
-                        if (next_kmer_end > std::cend(sequence)) {
-                            return;
-                        }
-                        kmer_begin = std::prev(next_kmer_begin);
-                        kmer_end   = std::prev(next_kmer_end);
-                        assert(kmer_end <= std::cend(sequence));
-                        kmer = Kmer {kmer_begin, kmer_end};
-                    }
+            }
+            if (is_reference(v)) {
+                const auto ref_itr = std::find(std::next(std::cbegin(reference_vertices_), ref_offset),
+                                               std::cend(reference_vertices_), v);
+                ref_offset = std::distance(std::cbegin(reference_vertices_), ref_itr);
+                if (ref_itr != std::cend(reference_vertices_)) {
+                    offset = follow_reference(offset);
+                    if (offset == num_read_kmers) return;
+                    --offset;
+                    v = reference_vertices_[ref_offset - 1];
                 }
-                prev_kmer_good = true;
             }
-            prev_kmer = kmer;
         }
+        prev_vertex = v;
     }
 }
 
 std::size_t Assembler::num_kmers() const noexcept
 {
-    return vertex_cache_.size();
+    return kmers_.size();
 }
 
 bool Assembler::is_empty() const noexcept
 {
-    return vertex_cache_.empty();
+    return kmers_.empty();
 }
 
 bool Assembler::is_acyclic() const
@@ -312,9 +304,7 @@ void Assembler::cleanup()
 void Assembler::clear()
 {
     graph_.clear();
-    vertex_cache_.clear();
-    reference_kmers_.clear();
-    reference_kmers_.shrink_to_fit();
+    kmers_.clear();
     reference_vertices_.clear();
     reference_vertices_.shrink_to_fit();
     reference_edges_.clear();
@@ -351,7 +341,7 @@ void Assembler::write_dot(std::ostream& out) const
         } else {
             out << " [shape=box,color=red]" << std::endl;
         }
-        out << " [label=\"" << kmer_of(v) << "\"]" << std::endl;
+        out << " [label=\"" << kmer_sequence_of(v) << "\"]" << std::endl;
     };
     const auto edge_writer = [this] (std::ostream& out, Edge e) {
         if (is_reference(e)) {
@@ -369,97 +359,229 @@ void Assembler::write_dot(std::ostream& out) const
     boost::write_graphviz(out, graph_, vertex_writer, edge_writer, graph_writer);
 }
 
-// Kmer
-Assembler::Kmer::Kmer(SequenceIterator first, SequenceIterator last) noexcept
-: first_ {first}
-, last_ {last}
-, hash_ {boost::hash_range(first_, last_)}
+// PackedSequence
+
+Assembler::PackedSequence::PackedSequence(const NucleotideSequence& sequence)
+: words_(sequence.size() / basesPerWord + 2) // padded so copy can always read the word after the last base
+, noncanonical_positions_ {}
+, size_ {sequence.size()}
+{
+    for (std::size_t i {0}; i < sequence.size(); ++i) {
+        Word code {0};
+        switch (sequence[i]) {
+            case 'A': break;
+            case 'C': code = 1; break;
+            case 'G': code = 2; break;
+            case 'T': code = 3; break;
+            default: noncanonical_positions_.push_back(i);
+        }
+        words_[i / basesPerWord] |= code << (2 * (i % basesPerWord));
+    }
+}
+
+std::size_t Assembler::PackedSequence::size() const noexcept
+{
+    return size_;
+}
+
+bool Assembler::PackedSequence::is_canonical(const std::size_t pos, const unsigned length) const noexcept
+{
+    const auto itr = std::lower_bound(std::cbegin(noncanonical_positions_), std::cend(noncanonical_positions_), pos);
+    return itr == std::cend(noncanonical_positions_) || *itr >= pos + length;
+}
+
+void Assembler::PackedSequence::copy(const std::size_t pos, const unsigned length, Word* result) const noexcept
+{
+    assert(pos + length <= size_);
+    const auto num_words = (length + basesPerWord - 1) / basesPerWord;
+    const auto shift = 2 * (pos % basesPerWord);
+    auto first = std::next(std::cbegin(words_), pos / basesPerWord);
+    for (unsigned i {0}; i < num_words; ++i, ++first) {
+        result[i] = shift == 0 ? *first : (*first >> shift) | (*std::next(first) << (64 - shift));
+    }
+    if (length % basesPerWord > 0) {
+        result[num_words - 1] &= (Word {1} << (2 * (length % basesPerWord))) - 1;
+    }
+}
+
+// KmerTable
+
+constexpr Assembler::KmerId Assembler::KmerTable::nullKmer;
+constexpr Assembler::KmerId Assembler::KmerTable::emptySlot;
+constexpr Assembler::KmerId Assembler::KmerTable::erasedSlot;
+
+Assembler::KmerTable::KmerTable(const unsigned kmer_size)
+: num_words_ {(kmer_size + PackedSequence::basesPerWord - 1) / PackedSequence::basesPerWord}
 {}
 
-char Assembler::Kmer::front() const noexcept
+unsigned Assembler::KmerTable::num_words() const noexcept
+{
+    return num_words_;
+}
+
+std::size_t Assembler::KmerTable::size() const noexcept
+{
+    return size_;
+}
+
+bool Assembler::KmerTable::empty() const noexcept
+{
+    return size_ == 0;
+}
+
+namespace {
+
+std::size_t next_power_of_two(std::size_t n) noexcept
+{
+    std::size_t result {16};
+    while (result < n) result *= 2;
+    return result;
+}
+
+} // namespace
+
+void Assembler::KmerTable::reserve(const std::size_t n)
+{
+    if (slots_.size() < 2 * n) rehash(next_power_of_two(2 * n));
+    words_.reserve(n * num_words_);
+    vertices_.reserve(n);
+}
+
+Assembler::KmerId Assembler::KmerTable::find(const KmerWord* kmer) const noexcept
+{
+    if (slots_.empty()) return nullKmer;
+    const auto kmer_hash = hash(kmer);
+    const auto mask = slots_.size() - 1;
+    for (auto i = kmer_hash & mask;; i = (i + 1) & mask) {
+        const auto& slot = slots_[i];
+        if (slot.kmer == emptySlot) return nullKmer;
+        if (slot.kmer != erasedSlot && slot.hash == kmer_hash && equal(slot.kmer, kmer)) {
+            return slot.kmer;
+        }
+    }
+}
+
+Assembler::KmerId Assembler::KmerTable::insert(const KmerWord* kmer, const Vertex v)
 {
-    return *first_;
+    if (4 * (size_ + num_erased_slots_ + 1) > 3 * slots_.size()) {
+        rehash(next_power_of_two(2 * (size_ + 1)));
+    }
+    KmerId result;
+    if (free_kmers_.empty()) {
+        result = static_cast<KmerId>(vertices_.size());
+        vertices_.push_back(v);
+        words_.insert(std::cend(words_), kmer, kmer + num_words_);
+    } else {
+        result = free_kmers_.back();
+        free_kmers_.pop_back();
+        vertices_[result] = v;
+        std::copy(kmer, kmer + num_words_, std::next(std::begin(words_), result * num_words_));
+    }
+    const auto kmer_hash = hash(kmer);
+    const auto mask = slots_.size() - 1;
+    auto i = kmer_hash & mask;
+    for (; slots_[i].kmer != emptySlot && slots_[i].kmer != erasedSlot; i = (i + 1) & mask);
+    if (slots_[i].kmer == erasedSlot) --num_erased_slots_;
+    slots_[i] = {kmer_hash, result};
+    ++size_;
+    return result;
 }
 
-char Assembler::Kmer::back() const noexcept
+void Assembler::KmerTable::erase(const KmerId kmer) noexcept
 {
-    return *std::prev(last_);
+    const auto mask = slots_.size() - 1;
+    auto i = hash(this->kmer(kmer)) & mask;
+    for (; slots_[i].kmer != kmer; i = (i + 1) & mask);
+    slots_[i].kmer = erasedSlot;
+    ++num_erased_slots_;
+    --size_;
+    free_kmers_.push_back(kmer);
 }
 
-Assembler::Kmer::SequenceIterator Assembler::Kmer::begin() const noexcept
+const Assembler::KmerWord* Assembler::KmerTable::kmer(const KmerId kmer) const noexcept
 {
-    return first_;
+    return words_.data() + static_cast<std::size_t>(kmer) * num_words_;
 }
 
-Assembler::Kmer::SequenceIterator Assembler::Kmer::end() const noexcept
+Assembler::Vertex Assembler::KmerTable::vertex(const KmerId kmer) const noexcept
 {
-    return last_;
+    return vertices_[kmer];
 }
 
-Assembler::Kmer::operator NucleotideSequence() const
+void Assembler::KmerTable::clear() noexcept
 {
-    return NucleotideSequence {first_, last_};
+    words_.clear();
+    vertices_.clear();
+    free_kmers_.clear();
+    slots_.clear();
+    size_ = 0;
+    num_erased_slots_ = 0;
 }
 
-std::size_t Assembler::Kmer::hash() const noexcept
+std::uint32_t Assembler::KmerTable::hash(const KmerWord* kmer) const noexcept
 {
-    return hash_;
+    std::uint64_t result {0x9e3779b97f4a7c15};
+    std::for_each(kmer, kmer + num_words_, [&result] (const KmerWord word) {
+        result ^= word;
+        result *= 0xff51afd7ed558ccd;
+        result ^= result >> 33;
+    });
+    result *= 0xc4ceb9fe1a85ec53;
+    result ^= result >> 33;
+    return static_cast<std::uint32_t>(result);
 }
 
-bool operator==(const Assembler::Kmer& lhs, const Assembler::Kmer& rhs) noexcept
+bool Assembler::KmerTable::equal(const KmerId kmer, const KmerWord* other) const noexcept
 {
-    return std::equal(lhs.first_, lhs.last_, rhs.first_);
+    return std::equal(other, other + num_words_, this->kmer(kmer));
 }
 
-bool operator<(const Assembler::Kmer& lhs, const Assembler::Kmer& rhs) noexcept
+void Assembler::KmerTable::rehash(const std::size_t num_slots)
 {
-    return std::lexicographical_compare(lhs.first_, lhs.last_, rhs.first_, rhs.last_);
+    std::vector<Slot> slots(num_slots, Slot {0, emptySlot});
+    const auto mask = num_slots - 1;
+    for (const auto& slot : slots_) {
+        if (slot.kmer != emptySlot && slot.kmer != erasedSlot) {
+            auto i = slot.hash & mask;
+            for (; slots[i].kmer != emptySlot; i = (i + 1) & mask);
+            slots[i] = slot;
+        }
+    }
+    slots_ = std::move(slots);
+    num_erased_slots_ = 0;
 }
+
 //
 // Assembler private methods
 //
 void Assembler::insert_reference_into_empty_graph(const NucleotideSequence& sequence)
 {
     assert(sequence.size() >= kmer_size());
-    vertex_cache_.reserve(sequence.size() + std::pow(4, 5));
-    auto kmer_begin = std::cbegin(sequence);
-    auto kmer_end   = std::next(kmer_begin, kmer_size());
-    reference_kmers_.emplace_back(kmer_begin, kmer_end);
-    if (!contains_kmer(reference_kmers_.back())) {
-        const auto u = add_vertex(reference_kmers_.back(), true);
-        if (!u) {
-            throw NonCanonicalReferenceSequence {sequence};
-        }
-        reference_vertices_.push_back(*u);
-    } else {
-        reference_vertices_.push_back(vertex_cache_.at(reference_kmers_.back()));
-    }
-    ++kmer_begin;
-    ++kmer_end;
-    for (; kmer_end <= std::cend(sequence); ++kmer_begin, ++kmer_end) {
-        reference_kmers_.emplace_back(kmer_begin, kmer_end);
-        const auto& kmer = reference_kmers_.back();
-        if (!contains_kmer(kmer)) {
-            const auto v = add_vertex(kmer, true);
-            if (v) {
-                reference_vertices_.push_back(*v);
-                const auto u = vertex_cache_.at(std::crbegin(reference_kmers_)[1]);
-                const auto e = add_reference_edge(u, *v);
-                reference_edges_.push_back(e);
-            } else {
-                throw NonCanonicalReferenceSequence {sequence};
-            }
-        } else {
-            const auto u = vertex_cache_.at(std::crbegin(reference_kmers_)[1]);
-            const auto v = vertex_cache_.at(kmer);
-            reference_vertices_.push_back(v);
-            const auto e = add_reference_edge(u, v);
-            reference_edges_.push_back(e);
+    if (!utils::is_canonical_dna(sequence)) {
+        throw NonCanonicalReferenceSequence {sequence};
+    }
+    kmers_.reserve(sequence.size() + std::pow(4, 5));
+    const PackedSequence packed_sequence {sequence};
+    const auto num_reference_kmers = count_kmers(sequence, kmer_size());
+    std::vector<KmerWord> kmer(kmers_.num_words());
+    packed_sequence.copy(0, kmer_size(), kmer.data());
+    auto u = find_vertex(kmer.data());
+    if (u == null_vertex()) {
+        u = add_vertex(kmer.data(), true);
+    }
+    reference_vertices_.push_back(u);
+    for (std::size_t offset {1}; offset < num_reference_kmers; ++offset) {
+        packed_sequence.copy(offset, kmer_size(), kmer.data());
+        auto v = find_vertex(kmer.data());
+        if (v == null_vertex()) {
+            v = add_vertex(kmer.data(), true);
         }
+        reference_vertices_.push_back(v);
+        const auto e = add_reference_edge(u, v);
+        reference_edges_.push_back(e);
+        u = v;
     }
-    assert(reference_vertices_.size() == reference_kmers_.size());
     assert(reference_edges_.size() == reference_vertices_.size() - 1);
-    reference_kmers_.shrink_to_fit();
     reference_vertices_.shrink_to_fit();
     reference_edges_.shrink_to_fit();
 }
@@ -467,39 +589,29 @@ void Assembler::insert_reference_into_empty_graph(const NucleotideSequence& sequ
 void Assembler::insert_reference_into_populated_graph(const NucleotideSequence& sequence)
 {
     assert(sequence.size() >= kmer_size());
-    assert(reference_kmers_.empty());
-    vertex_cache_.reserve(vertex_cache_.size() + sequence.size() + std::pow(4, 5));
-    auto kmer_begin = std::cbegin(sequence);
-    auto kmer_end   = std::next(kmer_begin, kmer_size());
-    reference_kmers_.emplace_back(kmer_begin, kmer_end);
-    if (!contains_kmer(reference_kmers_.back())) {
-        const auto u = add_vertex(reference_kmers_.back(), true);
-        if (!u) {
-            throw NonCanonicalReferenceSequence {sequence};
-        }
-        reference_vertices_.push_back(*u);
+    assert(reference_vertices_.empty());
+    if (!utils::is_canonical_dna(sequence)) {
+        throw NonCanonicalReferenceSequence {sequence};
+    }
+    kmers_.reserve(kmers_.size() + sequence.size() + std::pow(4, 5));
+    const PackedSequence packed_sequence {sequence};
+    const auto num_reference_kmers = count_kmers(sequence, kmer_size());
+    std::vector<KmerWord> kmer(kmers_.num_words());
+    packed_sequence.copy(0, kmer_size(), kmer.data());
+    auto u = find_vertex(kmer.data());
+    if (u == null_vertex()) {
+        u = add_vertex(kmer.data(), true);
     } else {
-        set_vertex_reference(reference_kmers_.back());
-        reference_vertices_.push_back(vertex_cache_.at(reference_kmers_.back()));
-    }
-    ++kmer_begin;
-    ++kmer_end;
-    for (; kmer_end <= std::cend(sequence); ++kmer_begin, ++kmer_end) {
-        reference_kmers_.emplace_back(kmer_begin, kmer_end);
-        if (!contains_kmer(reference_kmers_.back())) {
-            const auto v = add_vertex(reference_kmers_.back(), true);
-            if (v) {
-                reference_vertices_.push_back(*v);
-                const auto u = vertex_cache_.at(std::crbegin(reference_kmers_)[1]);
-                const auto e = add_reference_edge(u, *v);
-                reference_edges_.push_back(e);
-            } else {
-                throw NonCanonicalReferenceSequence {sequence};
-            }
+        set_vertex_reference(u);
+    }
+    reference_vertices_.push_back(u);
+    for (std::size_t offset {1}; offset < num_reference_kmers; ++offset) {
+        packed_sequence.copy(offset, kmer_size(), kmer.data());
+        auto v = find_vertex(kmer.data());
+        if (v == null_vertex()) {
+            v = add_vertex(kmer.data(), true);
+            reference_edges_.push_back(add_reference_edge(u, v));
         } else {
-            const auto u = vertex_cache_.at(std::crbegin(reference_kmers_)[1]);
-            const auto v = vertex_cache_.at(reference_kmers_.back());
-            reference_vertices_.push_back(v);
             set_vertex_reference(v);
             Edge e; bool e_in_graph;
             std::tie(e, e_in_graph) = boost::edge(u, v, graph_);
@@ -510,28 +622,34 @@ void Assembler::insert_reference_into_populated_graph(const NucleotideSequence&
             }
             reference_edges_.push_back(e);
         }
+        reference_vertices_.push_back(v);
+        u = v;
     }
-    vertex_cache_.rehash(vertex_cache_.size());
-    reference_kmers_.shrink_to_fit();
     reference_vertices_.shrink_to_fit();
     reference_edges_.shrink_to_fit();
     regenerate_vertex_indices();
     reference_head_position_ = 0;
 }
 
-bool Assembler::contains_kmer(const Kmer& kmer) const noexcept
+bool Assembler::contains_kmer(const KmerWord* kmer) const noexcept
 {
-    return vertex_cache_.count(kmer) == 1;
+    return kmers_.find(kmer) != KmerTable::nullKmer;
 }
 
-std::size_t Assembler::count_kmer(const Kmer& kmer) const noexcept
+Assembler::Vertex Assembler::find_vertex(const KmerWord* kmer) const noexcept
 {
-    return vertex_cache_.count(kmer);
+    const auto id = kmers_.find(kmer);
+    return id != KmerTable::nullKmer ? kmers_.vertex(id) : null_vertex();
+}
+
+bool Assembler::is_kmer_of(const Vertex v, const KmerWord* kmer) const noexcept
+{
+    return std::equal(kmer, kmer + kmers_.num_words(), kmer_of(v));
 }
 
 std::size_t Assembler::reference_size() const noexcept
 {
-    return sequence_length(reference_kmers_.size(), kmer_size());
+    return sequence_length(reference_vertices_.size(), kmer_size());
 }
 
 void Assembler::regenerate_vertex_indices()
@@ -568,27 +686,23 @@ Assembler::Vertex Assembler::null_vertex() const
     return boost::graph_traits<KmerGraph>::null_vertex();
 }
 
-boost::optional<Assembler::Vertex> Assembler::add_vertex(const Kmer& kmer, const bool is_reference)
+Assembler::Vertex Assembler::add_vertex(const KmerWord* kmer, const bool is_reference)
 {
-    if (!utils::is_canonical_dna(kmer)) return boost::none;
-    const auto u = boost::add_vertex({boost::num_vertices(graph_), kmer, is_reference}, graph_);
-    vertex_cache_.emplace(kmer, u);
+    assert(!contains_kmer(kmer));
+    const auto u = boost::add_vertex({boost::num_vertices(graph_), KmerTable::nullKmer, is_reference}, graph_);
+    graph_[u].kmer = kmers_.insert(kmer, u);
     return u;
 }
 
 void Assembler::remove_vertex(const Vertex v)
 {
-    const auto c = vertex_cache_.erase(kmer_of(v));
-    assert(c == 1);
-    _unused(c); // make production build happy
+    kmers_.erase(graph_[v].kmer);
     boost::remove_vertex(v, graph_);
 }
 
 void Assembler::clear_and_remove_vertex(const Vertex v)
 {
-    const auto c = vertex_cache_.erase(kmer_of(v));
-    assert(c == 1);
-    _unused(c); // make production build happy
+    kmers_.erase(graph_[v].kmer);
     boost::clear_vertex(v, graph_);
     boost::remove_vertex(v, graph_);
 }
@@ -634,39 +748,34 @@ void Assembler::set_vertex_reference(const Vertex v)
     graph_[v].is_reference = true;
 }
 
-void Assembler::set_vertex_reference(const Kmer& kmer)
-{
-    set_vertex_reference(vertex_cache_.at(kmer));
-}
-
 void Assembler::set_edge_reference(const Edge e)
 {
     graph_[e].is_reference = true;
 }
 
-const Assembler::Kmer& Assembler::kmer_of(const Vertex v) const
+const Assembler::KmerWord* Assembler::kmer_of(const Vertex v) const
 {
-    return graph_[v].kmer;
+    return kmers_.kmer(graph_[v].kmer);
 }
 
-char Assembler::front_base_of(const Vertex v) const
+Assembler::NucleotideSequence Assembler::kmer_sequence_of(const Vertex v) const
 {
-    return kmer_of(v).front();
-}
-
-char Assembler::back_base_of(const Vertex v) const
-{
-    return kmer_of(v).back();
+    NucleotideSequence result(kmer_size(), 'N');
+    const auto kmer = kmer_of(v);
+    for (unsigned i {0}; i < kmer_size(); ++i) {
+        result[i] = unpack_base(kmer, i);
+    }
+    return result;
 }
 
-const Assembler::Kmer& Assembler::source_kmer_of(const Edge e) const
+char Assembler::front_base_of(const Vertex v) const
 {
-    return kmer_of(boost::source(e, graph_));
+    return unpack_base(kmer_of(v), 0);
 }
 
-const Assembler::Kmer& Assembler::target_kmer_of(const Edge e) const
+char Assembler::back_base_of(const Vertex v) const
 {
-    return kmer_of(boost::target(e, graph_));
+    return unpack_base(kmer_of(v), kmer_size() - 1);
 }
 
 bool Assembler::is_reference(const Vertex v) const
@@ -738,16 +847,23 @@ bool Assembler::is_dangling_branch(const Vertex v) const
 
 boost::optional<Assembler::Vertex> Assembler::find_joining_kmer(const Vertex v) const
 {
-    const auto& kmer = kmer_of(v);
-    NucleotideSequence adjacent_kmer {std::next(std::cbegin(kmer)), std::cend(kmer)};
-    adjacent_kmer.resize(kmer_size());
-    constexpr std::array<NucleotideSequence::value_type, 4> bases {'A', 'C', 'G', 'T'};
-    for (const auto base : bases) {
-        adjacent_kmer.back() = base;
-        const Kmer k {std::cbegin(adjacent_kmer), std::cend(adjacent_kmer)};
-        const auto itr = vertex_cache_.find(k);
-        if (itr != std::cend(vertex_cache_)) {
-            return itr->second;
+    const auto kmer = kmer_of(v);
+    const auto num_words = kmers_.num_words();
+    // Drop the first base, leaving the last base A
+    std::vector<KmerWord> adjacent_kmer(num_words);
+    for (unsigned i {0}; i < num_words; ++i) {
+        adjacent_kmer[i] = kmer[i] >> 2;
+        if (i + 1 < num_words) adjacent_kmer[i] |= kmer[i + 1] << 62;
+    }
+    const auto last_base = kmer_size() - 1;
+    auto& last_word = adjacent_kmer[last_base / PackedSequence::basesPerWord];
+    const auto last_shift = 2 * (last_base % PackedSequence::basesPerWord);
+    for (KmerWord base {0}; base < packedBases.size(); ++base) {
+        last_word &= ~(KmerWord {3} << last_shift);
+        last_word |= base << last_shift;
+        const auto u = find_vertex(adjacent_kmer.data());
+        if (u != null_vertex()) {
+            return u;
         }
     }
     return boost::none;
@@ -757,7 +873,7 @@ Assembler::NucleotideSequence Assembler::make_sequence(const Path& path) const
 {
     assert(!path.empty());
     NucleotideSequence result(kmer_size() + path.size() - 1, 'N');
-    const auto& first_kmer = kmer_of(path.front());
+    const auto first_kmer = kmer_sequence_of(path.front());
     auto itr = std::copy(std::cbegin(first_kmer), std::cend(first_kmer), std::begin(result));
     std::transform(std::next(std::cbegin(path)), std::cend(path), itr,
                   [this] (const Vertex v) { return back_base_of(v); });
@@ -775,13 +891,12 @@ Assembler::NucleotideSequence Assembler::make_reference(Vertex from, const Verte
     auto last = to;
     if (last == null) {
         if (from == reference_tail()) {
-            return static_cast<NucleotideSequence>(kmer_of(from));
+            return kmer_sequence_of(from);
         }
         last = reference_tail();
     }
+    result = kmer_sequence_of(from);
     result.reserve(2 * kmer_size());
-    const auto& first_kmer = kmer_of(from);
-    result.assign(std::cbegin(first_kmer), std::cend(first_kmer));
     from = next_reference(from);
     while (from != last) {
         result.push_back(back_base_of(from));
@@ -1362,7 +1477,6 @@ bool Assembler::can_prune_reference_flanks() const
 
 void Assembler::pop_reference_head()
 {
-    reference_kmers_.pop_front();
     reference_vertices_.pop_front();
     if (!reference_edges_.empty()) {
         reference_edges_.pop_front();
@@ -1372,7 +1486,6 @@ void Assembler::pop_reference_head()
 
 void Assembler::pop_reference_tail()
 {
-    reference_kmers_.pop_back();
     reference_vertices_.pop_back();
     if (!reference_edges_.empty()) {
         reference_edges_.pop_back();
@@ -1983,20 +2096,14 @@ std::deque<Assembler::Variant> Assembler::extract_bubble_paths_with_ksp(const un
 
 // debug
 
-std::ostream& operator<<(std::ostream& os, const Assembler::Kmer& kmer)
-{
-    std::copy(std::cbegin(kmer), std::cend(kmer), std::ostreambuf_iterator<char> {os});
-    return os;
-}
-
 void Assembler::print_reference_head() const
 {
-    std::cout << "reference head is " << kmer_of(reference_head()) << std::endl;
+    std::cout << "reference head is " << kmer_sequence_of(reference_head()) << std::endl;
 }
 
 void Assembler::print_reference_tail() const
 {
-    std::cout << "reference tail is " << kmer_of(reference_tail()) << std::endl;
+    std::cout << "reference tail is " << kmer_sequence_of(reference_tail()) << std::endl;
 }
 
 void Assembler::print_reference_path() const
@@ -2006,15 +2113,15 @@ void Assembler::print_reference_path() const
 
 void Assembler::print(const Edge e) const
 {
-    std::cout << kmer_of(boost::source(e, graph_)) << "->" << kmer_of(boost::target(e, graph_));
+    std::cout << kmer_sequence_of(boost::source(e, graph_)) << "->" << kmer_sequence_of(boost::target(e, graph_));
 }
 
 void Assembler::print(const Path& path) const
 {
     assert(!path.empty());
-    std::transform(std::cbegin(path), std::prev(std::cend(path)), std::ostream_iterator<Kmer> {std::cout, "->"},
-                   [this] (const Vertex v) { return kmer_of(v); });
-    std::cout << kmer_of(path.back());
+    std::transform(std::cbegin(path), std::prev(std::cend(path)), std::ostream_iterator<std::string> {std::cout, "->"},
+                   [this] (const Vertex v) { return kmer_sequence_of(v); });
+    std::cout << kmer_sequence_of(path.back());
 }
 
 void Assembler::print_weighted(const Path& path) const
@@ -2026,16 +2133,16 @@ void Assembler::print_weighted(const Path& path) const
                        Edge e; bool good;
                        std::tie(e, good) = boost::edge(u, v, graph_);
                        assert(good);
-                       return static_cast<std::string>(this->kmer_of(v)) + "(" + std::to_string(graph_[e].weight) + ")";
+                       return this->kmer_sequence_of(v) + "(" + std::to_string(graph_[e].weight) + ")";
                    });
-    std::cout << kmer_of(path.back());
+    std::cout << kmer_sequence_of(path.back());
 }
 
 void Assembler::print_dominator_tree() const
 {
     const auto dom_tree = build_dominator_tree(reference_head());
     for (const auto& p : dom_tree) {
-        std::cout << kmer_of(p.first) << " dominated by " << kmer_of(p.second) << std::endl;
+        std::cout << kmer_sequence_of(p.first) << " dominated by " << kmer_sequence_of(p.second) << std::endl;
     }
 }
 
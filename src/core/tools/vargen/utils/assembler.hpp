@@ -12,6 +12,8 @@
 #include <cstddef>
 #include <utility>
 #include <tuple>
+#include <limits>
+#include <cstdint>
 #include <stdexcept>
 #include <iosfwd>
 
@@ -19,7 +21,6 @@
 #include <boost/optional.hpp>
 
 #include "concepts/equitable.hpp"
-#include "concepts/comparable.hpp"
 
 namespace octopus { namespace coretools { class Assembler; }}
 
@@ -39,6 +40,7 @@ public:
     enum class Direction { forward, reverse };
     
     struct Variant;
+    class PackedSequence;
     class NonCanonicalReferenceSequence;
     class NonUniqueReferenceSequence {};
     
@@ -69,6 +71,8 @@ public:
     
     // Threads the given read sequence into the graph
     void insert_read(const NucleotideSequence& sequence, Direction strand);
+    // Reads can be packed once and threaded into graphs of any kmer size
+    void insert_read(const PackedSequence& sequence, Direction strand);
     
     // Returns the current number of unique kmers in the graph
     std::size_t num_kmers() const noexcept;
@@ -96,46 +100,8 @@ public:
     void write_dot(std::ostream& out) const;
     
 private:
-    class Kmer : public Comparable<Kmer>
-    {
-    public:
-        using NucleotideSequence = Assembler::NucleotideSequence;
-        using SequenceIterator   = NucleotideSequence::const_iterator;
-        
-        Kmer() = delete;
-        Kmer(SequenceIterator first, SequenceIterator last) noexcept;
-        
-        Kmer(const Kmer&)            = default;
-        Kmer& operator=(const Kmer&) = default;
-        Kmer(Kmer&&)                 = default;
-        Kmer& operator=(Kmer&&)      = default;
-        
-        ~Kmer() = default;
-        
-        char front() const noexcept;
-        char back() const noexcept;
-        
-        SequenceIterator begin() const noexcept;
-        SequenceIterator end() const noexcept;
-        
-        explicit operator NucleotideSequence() const;
-        
-        std::size_t hash() const noexcept;
-        
-        friend bool operator==(const Kmer& lhs, const Kmer& rhs) noexcept;
-        friend bool operator<(const Kmer& lhs, const Kmer& rhs) noexcept;
-    private:
-        SequenceIterator first_, last_;
-        std::size_t hash_;
-    };
-    
-    friend bool operator==(const Kmer& lhs, const Kmer& rhs) noexcept;
-    friend bool operator<(const Kmer& lhs, const Kmer& rhs) noexcept;
-    
-    struct KmerHash
-    {
-        std::size_t operator()(const Kmer& k) const noexcept { return k.hash(); }
-    };
+    using KmerWord = std::uint64_t;
+    using KmerId   = std::uint32_t;
     
     struct GraphEdge
     {
@@ -148,7 +114,7 @@ private:
     struct GraphNode
     {
         std::size_t index;
-        Kmer kmer;
+        KmerId kmer;
         bool is_reference = false;
     };
     
@@ -172,14 +138,55 @@ private:
         std::size_t reference_offset;
     };
     
+    // Open addressing hash table from the kmers in the graph to their vertices. Kmers are packed
+    // into a shared word arena, and their ids are reused once they are erased.
+    class KmerTable
+    {
+    public:
+        static constexpr KmerId nullKmer {std::numeric_limits<KmerId>::max()};
+        
+        KmerTable() = default;
+        KmerTable(unsigned kmer_size);
+        
+        unsigned num_words() const noexcept;
+        std::size_t size() const noexcept;
+        bool empty() const noexcept;
+        void reserve(std::size_t n);
+        KmerId find(const KmerWord* kmer) const noexcept;
+        KmerId insert(const KmerWord* kmer, Vertex v); // kmer must not be in the table
+        void erase(KmerId kmer) noexcept;
+        const KmerWord* kmer(KmerId kmer) const noexcept;
+        Vertex vertex(KmerId kmer) const noexcept;
+        void clear() noexcept;
+        
+    private:
+        struct Slot
+        {
+            std::uint32_t hash;
+            KmerId kmer;
+        };
+        
+        static constexpr KmerId emptySlot {nullKmer}, erasedSlot {nullKmer - 1};
+        
+        unsigned num_words_ = 0;
+        std::vector<KmerWord> words_ = {};
+        std::vector<Vertex> vertices_ = {};
+        std::vector<KmerId> free_kmers_ = {};
+        std::vector<Slot> slots_ = {};
+        std::size_t size_ = 0, num_erased_slots_ = 0;
+        
+        std::uint32_t hash(const KmerWord* kmer) const noexcept;
+        bool equal(KmerId kmer, const KmerWord* other) const noexcept;
+        void rehash(std::size_t num_slots);
+    };
+    
     Parameters params_;
     
-    std::deque<Kmer> reference_kmers_;
     std::size_t reference_head_position_;
     
     KmerGraph graph_;
     
-    std::unordered_map<Kmer, Vertex, KmerHash> vertex_cache_;
+    KmerTable kmers_;
     Path reference_vertices_;
     std::deque<Edge> reference_edges_;
     
@@ -187,13 +194,14 @@ private:
     
     void insert_reference_into_empty_graph(const NucleotideSequence& reference);
     void insert_reference_into_populated_graph(const NucleotideSequence& reference);
-    bool contains_kmer(const Kmer& kmer) const noexcept;
-    std::size_t count_kmer(const Kmer& kmer) const noexcept;
+    bool contains_kmer(const KmerWord* kmer) const noexcept;
+    Vertex find_vertex(const KmerWord* kmer) const noexcept;
+    bool is_kmer_of(Vertex v, const KmerWord* kmer) const noexcept;
     std::size_t reference_size() const noexcept;
     void regenerate_vertex_indices();
     bool is_reference_unique_path() const;
     Vertex null_vertex() const;
-    boost::optional<Vertex> add_vertex(const Kmer& kmer, bool is_reference = false);
+    Vertex add_vertex(const KmerWord* kmer, bool is_reference = false);
     void remove_vertex(Vertex v);
     void clear_and_remove_vertex(Vertex v);
     void clear_and_remove_all(const std::unordered_set<Vertex>& vertices);
@@ -204,13 +212,11 @@ private:
     void remove_edge(Edge e);
     void increment_weight(Edge e, bool is_forward);
     void set_vertex_reference(Vertex v);
-    void set_vertex_reference(const Kmer& kmer);
     void set_edge_reference(Edge e);
-    const Kmer& kmer_of(Vertex v) const;
+    const KmerWord* kmer_of(Vertex v) const;
+    NucleotideSequence kmer_sequence_of(Vertex v) const;
     char front_base_of(Vertex v) const;
     char back_base_of(Vertex v) const;
-    const Kmer& source_kmer_of(Edge e) const;
-    const Kmer& target_kmer_of(Edge e) const;
     bool is_reference(Vertex v) const;
     bool is_source_reference(Edge e) const;
     bool is_target_reference(Edge e) const;
@@ -293,7 +299,6 @@ private:
     
     // for debug
     
-    friend std::ostream& operator<<(std::ostream& os, const Kmer& kmer);
     void print_reference_head() const;
     void print_reference_tail() const;
     void print_reference_path() const;
@@ -318,6 +323,39 @@ struct Assembler::Variant : public Equitable<Variant>
     std::size_t begin_pos;
 };
 
+// A nucleotide sequence packed two bits per base. Kmers overlapping any base other than A, C, G, or T
+// are never threaded into the graph.
+class Assembler::PackedSequence
+{
+public:
+    using Word = KmerWord;
+    
+    static constexpr unsigned basesPerWord {32};
+    
+    PackedSequence() = default;
+    
+    explicit PackedSequence(const NucleotideSequence& sequence);
+    
+    PackedSequence(const PackedSequence&)            = default;
+    PackedSequence& operator=(const PackedSequence&) = default;
+    PackedSequence(PackedSequence&&)                 = default;
+    PackedSequence& operator=(PackedSequence&&)      = default;
+    
+    ~PackedSequence() = default;
+    
+    std::size_t size() const noexcept;
+    
+    bool is_canonical(std::size_t pos, unsigned length) const noexcept;
+    
+    // Copies the length bases starting at pos into the first (length + 31) / 32 words of result
+    void copy(std::size_t pos, unsigned length, Word* result) const noexcept;
+    
+private:
+    std::vector<Word> words_;
+    std::vector<std::size_t> noncanonical_positions_;
+    std::size_t size_ = 0;
+};
+
 class Assembler::NonCanonicalReferenceSequence : public std::invalid_argument
 {
 public:
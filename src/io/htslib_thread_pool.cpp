@@ -0,0 +1,60 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "htslib_thread_pool.hpp"
+
+#include <mutex>
+#include <algorithm>
+#include <stdexcept>
+
+#include "htslib/thread_pool.h"
+
+namespace octopus { namespace io {
+
+HtslibThreadPool::HtslibThreadPool(const unsigned num_threads)
+: pool_ {nullptr, 0}
+, num_threads_ {std::max(num_threads, 1u)}
+{
+    pool_.pool = hts_tpool_init(static_cast<int>(num_threads_));
+    if (pool_.pool == nullptr) {
+        throw std::runtime_error {"HtslibThreadPool: could not create htslib thread pool"};
+    }
+}
+
+HtslibThreadPool::~HtslibThreadPool() noexcept
+{
+    hts_tpool_destroy(pool_.pool);
+}
+
+unsigned HtslibThreadPool::num_threads() const noexcept
+{
+    return num_threads_;
+}
+
+void HtslibThreadPool::attach(htsFile* file) noexcept
+{
+    // Files that are not compressed ignore the pool
+    if (file != nullptr) hts_set_thread_pool(file, &pool_);
+}
+
+namespace {
+
+std::mutex installed_pool_mutex;
+std::weak_ptr<HtslibThreadPool> installed_pool {};
+
+} // namespace
+
+void install_htslib_thread_pool(const std::shared_ptr<HtslibThreadPool>& pool) noexcept
+{
+    std::lock_guard<std::mutex> lock {installed_pool_mutex};
+    installed_pool = pool;
+}
+
+std::shared_ptr<HtslibThreadPool> get_htslib_thread_pool() noexcept
+{
+    std::lock_guard<std::mutex> lock {installed_pool_mutex};
+    return installed_pool.lock();
+}
+
+} // namespace io
+} // namespace octopus
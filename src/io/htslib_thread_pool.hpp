@@ -0,0 +1,50 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef htslib_thread_pool_hpp
+#define htslib_thread_pool_hpp
+
+#include <memory>
+
+#include "htslib/hts.h"
+
+namespace octopus { namespace io {
+
+// A pool of htslib worker threads used for BGZF and CRAM (de)compression. A single pool is shared
+// by every htslib file so that the number of compression threads does not scale with the number of
+// open files. Files must be closed before the pool they are attached to is destroyed.
+class HtslibThreadPool
+{
+public:
+    HtslibThreadPool() = delete;
+    
+    explicit HtslibThreadPool(unsigned num_threads);
+    
+    HtslibThreadPool(const HtslibThreadPool&)            = delete;
+    HtslibThreadPool& operator=(const HtslibThreadPool&) = delete;
+    HtslibThreadPool(HtslibThreadPool&&)                 = delete;
+    HtslibThreadPool& operator=(HtslibThreadPool&&)      = delete;
+    
+    ~HtslibThreadPool() noexcept;
+    
+    unsigned num_threads() const noexcept;
+    
+    void attach(htsFile* file) noexcept;
+    
+private:
+    htsThreadPool pool_;
+    unsigned num_threads_;
+};
+
+// Installs the pool that htslib files opened from now on should share. Only a weak reference is
+// kept, so files opened after the pool is destroyed are not attached to any pool.
+void install_htslib_thread_pool(const std::shared_ptr<HtslibThreadPool>& pool) noexcept;
+
+// Returns the installed pool, or nullptr if there is none. Owners of htslib files should keep the
+// returned pointer until the file is closed.
+std::shared_ptr<HtslibThreadPool> get_htslib_thread_pool() noexcept;
+
+} // namespace io
+} // namespace octopus
+
+#endif
@@ -0,0 +1,81 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "bam_sequence_unpacking.hpp"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
+
+namespace octopus { namespace io {
+
+namespace {
+
+constexpr const char* symbolTable {"=ACMGRSVTWYHKDBN"};
+
+// Each packed byte holds two bases; the first base is in the high nibble
+void unpack_scalar(const std::uint8_t* packed, const std::size_t length, char* result) noexcept
+{
+    const auto num_full_bytes = length / 2;
+    for (std::size_t i {0}; i < num_full_bytes; ++i) {
+        result[2 * i]     = symbolTable[packed[i] >> 4];
+        result[2 * i + 1] = symbolTable[packed[i] & 0xf];
+    }
+    if (length % 2 == 1) {
+        result[length - 1] = symbolTable[packed[num_full_bytes] >> 4];
+    }
+}
+
+} // namespace
+
+#if defined(__AVX2__)
+
+void unpack_bam_sequence(const std::uint8_t* packed, const std::size_t length, char* result) noexcept
+{
+    const auto lut = _mm256_setr_epi8('=','A','C','M','G','R','S','V','T','W','Y','H','K','D','B','N',
+                                      '=','A','C','M','G','R','S','V','T','W','Y','H','K','D','B','N');
+    const auto low_mask = _mm256_set1_epi8(0xf);
+    std::size_t num_unpacked {0};
+    for (; num_unpacked + 64 <= length; num_unpacked += 64, packed += 32, result += 64) {
+        const auto bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(packed));
+        const auto firsts  = _mm256_shuffle_epi8(lut, _mm256_and_si256(_mm256_srli_epi16(bytes, 4), low_mask));
+        const auto seconds = _mm256_shuffle_epi8(lut, _mm256_and_si256(bytes, low_mask));
+        // unpack interleaves within each 128-bit lane, so the lanes need reordering
+        const auto lo = _mm256_unpacklo_epi8(firsts, seconds);
+        const auto hi = _mm256_unpackhi_epi8(firsts, seconds);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(result), _mm256_permute2x128_si256(lo, hi, 0x20));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(result + 32), _mm256_permute2x128_si256(lo, hi, 0x31));
+    }
+    unpack_scalar(packed, length - num_unpacked, result);
+}
+
+#elif defined(__SSSE3__)
+
+void unpack_bam_sequence(const std::uint8_t* packed, const std::size_t length, char* result) noexcept
+{
+    const auto lut = _mm_setr_epi8('=','A','C','M','G','R','S','V','T','W','Y','H','K','D','B','N');
+    const auto low_mask = _mm_set1_epi8(0xf);
+    std::size_t num_unpacked {0};
+    for (; num_unpacked + 32 <= length; num_unpacked += 32, packed += 16, result += 32) {
+        const auto bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(packed));
+        const auto firsts  = _mm_shuffle_epi8(lut, _mm_and_si128(_mm_srli_epi16(bytes, 4), low_mask));
+        const auto seconds = _mm_shuffle_epi8(lut, _mm_and_si128(bytes, low_mask));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(result), _mm_unpacklo_epi8(firsts, seconds));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(result + 16), _mm_unpackhi_epi8(firsts, seconds));
+    }
+    unpack_scalar(packed, length - num_unpacked, result);
+}
+
+#else
+
+void unpack_bam_sequence(const std::uint8_t* packed, const std::size_t length, char* result) noexcept
+{
+    unpack_scalar(packed, length, result);
+}
+
+#endif
+
+} // namespace io
+} // namespace octopus
@@ -0,0 +1,19 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef bam_sequence_unpacking_hpp
+#define bam_sequence_unpacking_hpp
+
+#include <cstddef>
+#include <cstdint>
+
+namespace octopus { namespace io {
+
+// Unpacks a BAM 4-bit encoded sequence of length bases into result, which must have space for
+// at least length characters. Uses SSSE3 or AVX2 shuffles when available.
+void unpack_bam_sequence(const std::uint8_t* packed, std::size_t length, char* result) noexcept;
+
+} // namespace io
+} // namespace octopus
+
+#endif
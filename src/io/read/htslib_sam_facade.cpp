@@ -22,6 +22,7 @@
 #include "exceptions/malformed_file_error.hpp"
 #include "exceptions/unwritable_file_error.hpp"
 #include "annotated_aligned_read.hpp"
+#include "bam_sequence_unpacking.hpp"
 
 namespace octopus { namespace io {
 
@@ -156,10 +157,13 @@ private:
 
 namespace {
 
-auto open_hts_file(const boost::filesystem::path& file)
+auto open_hts_file(const boost::filesystem::path& file, HtslibThreadPool* thread_pool)
 {
     hts_verbose = 0; // disable hts error reporting
-    return sam_open(file.c_str(), "r");
+    auto result = sam_open(file.c_str(), "r");
+    // The pool must be attached before anything is read
+    if (result && thread_pool) thread_pool->attach(result);
+    return result;
 }
 
 bool is_cram(const boost::filesystem::path& file)
@@ -171,12 +175,14 @@ bool is_cram(const boost::filesystem::path& file)
 
 HtslibSamFacade::HtslibSamFacade(Path file_path)
 : file_path_ {std::move(file_path)}
-, hts_file_ {open_hts_file(file_path_), HtsFileDeleter {}}
+, thread_pool_ {get_htslib_thread_pool()}
+, hts_file_ {open_hts_file(file_path_, thread_pool_.get()), HtsFileDeleter {}}
 , hts_header_ {(hts_file_) ? sam_hdr_read(hts_file_.get()) : nullptr, HtsHeaderDeleter {}}
 , hts_index_ {(hts_file_) ? sam_index_load(hts_file_.get(), file_path_.c_str()) : nullptr, HtsIndexDeleter {}}
 , hts_targets_ {}
 , contig_names_ {}
 , sample_names_ {}
+, read_groups_ {}
 , samples_ {}
 {
     namespace fs = boost::filesystem;
@@ -235,6 +241,7 @@ HtslibSamFacade::HtslibSamFacade(Path sam_out, Path sam_template)
     if (!hts_file_) {
         throw UnwritableBAM {std::move(file_path_)};
     }
+    if (thread_pool_) thread_pool_->attach(hts_file_.get());
     hts_index_ = nullptr;
     if (sam_hdr_write(hts_file_.get(), hts_header_.get()) < 0) {
         throw UnwritableBAM {std::move(file_path_)};
@@ -259,7 +266,7 @@ bool HtslibSamFacade::is_open() const noexcept
 
 void HtslibSamFacade::open()
 {
-    hts_file_.reset(sam_open(file_path_.string().c_str(), "r"));
+    hts_file_.reset(open_hts_file(file_path_, thread_pool_.get()));
     if (hts_file_) {
         hts_header_.reset(sam_hdr_read(hts_file_.get()));
         hts_index_.reset(sam_index_load(hts_file_.get(), file_path_.c_str()));
@@ -376,7 +383,7 @@ bool HtslibSamFacade::has_reads(const SampleName& sample, const GenomicRegion& r
 {
     if (samples_.size() == 1 && samples_.front() == sample) return has_reads(region);
     HtslibIterator it {*this, region};
-    while (++it) if (sample_names_.at(it.read_group()) == sample) return true;
+    while (++it) if (it.sample() == sample) return true;
     return false;
 }
 
@@ -389,7 +396,7 @@ bool HtslibSamFacade::has_reads(const std::vector<SampleName>& samples, const Ge
     HtslibIterator it {*this, region};
     while (++it) {
         if (std::binary_search(std::cbegin(readable_samples), std::cend(readable_samples),
-                               sample_names_.at(it.read_group()))) {
+                               it.sample())) {
             return true;
         }
     }
@@ -411,7 +418,7 @@ std::size_t HtslibSamFacade::count_reads(const SampleName& sample, const Genomic
     if (samples_.size() == 1 && samples_.front() == sample) return count_reads(region);
     HtslibIterator it {*this, region};
     std::size_t result {0};
-    while (++it && sample_names_.at(it.read_group()) == sample) ++result;
+    while (++it && it.sample() == sample) ++result;
     return result;
 }
 
@@ -424,7 +431,7 @@ std::size_t HtslibSamFacade::count_reads(const std::vector<SampleName>& samples,
     HtslibIterator it {*this, region};
     std::size_t result {0};
     while (++it && std::binary_search(std::cbegin(readable_samples), std::cend(readable_samples),
-                                      sample_names_.at(it.read_group()))) {
+                                      it.sample())) {
         ++result;
     }
     return result;
@@ -460,7 +467,7 @@ HtslibSamFacade::extract_read_positions(const SampleName& sample, const GenomicR
     result.reserve(max_coverage);
     HtslibIterator it {*this, region};
     while (max_coverage > 0 && ++it) {
-        if (sample == sample_names_.at(it.read_group())) {
+        if (sample == it.sample()) {
             result.push_back(it.begin());
             --max_coverage;
         }
@@ -479,7 +486,7 @@ HtslibSamFacade::extract_read_positions(const std::vector<SampleName>& samples,
     result.reserve(max_coverage);
     HtslibIterator it {*this, region};
     while (max_coverage > 0 && ++it) {
-        if (contains(samples, sample_names_.at(it.read_group()))) {
+        if (contains(samples, it.sample())) {
             result.push_back(it.begin());
             --max_coverage;
         }
@@ -520,7 +527,7 @@ HtslibSamFacade::SampleReadMap HtslibSamFacade::fetch_reads(const GenomicRegion&
     }
     while (++it) {
         try {
-            result.at(sample_names_.at(it.read_group())).emplace_back(*it);
+            result.at(it.sample()).emplace_back(*it);
         } catch (InvalidBamRecord& e) {
             // TODO: Just ignore? Could log or something.
             //std::clog << "Warning: " << e.what() << std::endl;
@@ -539,7 +546,7 @@ HtslibSamFacade::ReadContainer HtslibSamFacade::fetch_reads(const SampleName& sa
     ReadContainer result {};
     try_reserve(result, defaultReserve_, defaultReserve_ / 10);
     while (++it) {
-        if (sample_names_.at(it.read_group()) == sample) {
+        if (it.sample() == sample) {
             try {
                 result.emplace_back(*it);
             } catch (InvalidBamRecord& e) {
@@ -571,10 +578,42 @@ HtslibSamFacade::SampleReadMap HtslibSamFacade::fetch_reads(const std::vector<Sa
     }
     if (result.empty()) return result; // no matching samples
     while (++it) {
-        const auto& sample = sample_names_.at(it.read_group());
+        const auto& sample = it.sample();
         if (result.count(sample) == 1) {
             try {
-                result.at(sample_names_.at(it.read_group())).emplace_back(*it);
+                result.at(sample).emplace_back(*it);
+            } catch (InvalidBamRecord& e) {
+                // TODO
+            } catch (...) {
+                throw;
+            }
+        }
+    }
+    return result;
+}
+
+HtslibSamFacade::SampleReadMap HtslibSamFacade::fetch_reads(const std::vector<SampleName>& samples,
+                                                            const GenomicRegion& region,
+                                                            const ReadFilter& filter) const
+{
+    SampleReadMap result {samples.size()};
+    for (const auto& sample : samples) {
+        if (contains(samples_, sample)) {
+            auto p = result.emplace(std::piecewise_construct,
+                                    std::forward_as_tuple(sample),
+                                    std::forward_as_tuple());
+            try_reserve(p.first->second, defaultReserve_, defaultReserve_ / 10);
+        }
+    }
+    if (result.empty()) return result; // no matching samples
+    HtslibIterator it {*this, region};
+    while (++it) {
+        // Read groups are not checked for single sample files, as in fetch_all_reads
+        const auto& sample = samples_.size() == 1 ? samples_.front() : it.sample();
+        const auto sample_itr = result.find(sample);
+        if (sample_itr != std::end(result) && filter(sample, it.core())) {
+            try {
+                sample_itr->second.emplace_back(*it);
             } catch (InvalidBamRecord& e) {
                 // TODO
             } catch (...) {
@@ -685,7 +724,7 @@ void HtslibSamFacade::init_maps()
     
     for (HtsTid target {0}; target < hts_header_->n_targets; ++target) {
         hts_targets_.emplace(hts_header_->target_name[target], target);
-        contig_names_.emplace(target, hts_header_->target_name[target]);
+        contig_names_.emplace_back(hts_header_->target_name[target]);
     }
     
     const std::string header_text(hts_header_->text, hts_header_->l_text);
@@ -707,8 +746,9 @@ void HtslibSamFacade::init_maps()
                 e.set_reason("a sample tag (SM) in @RG lines is required but was not found");
                 throw e;
             }
-            sample_names_.emplace(extract_tag_value(line, readGroupIdTag),
-                                  extract_tag_value(line, sampleIdTag));
+            const auto p = sample_names_.emplace(extract_tag_value(line, readGroupIdTag),
+                                                 extract_tag_value(line, sampleIdTag));
+            if (p.second) read_groups_.push_back({p.first->first, p.first->second});
             ++num_read_groups;
         }
     }
@@ -727,7 +767,7 @@ HtslibSamFacade::HtsTid HtslibSamFacade::get_htslib_target(const GenomicRegion::
 
 const std::string& HtslibSamFacade::get_contig_name(HtsTid target) const
 {
-    return contig_names_.at(target);
+    return contig_names_.at(static_cast<std::size_t>(target));
 }
 
 // HtslibIterator
@@ -744,6 +784,7 @@ HtslibSamFacade::HtslibIterator::HtslibIterator(const HtslibSamFacade& hts_facad
         ? make_hts_iterator(hts_facade_.hts_index_.get(), hts_facade_.hts_header_.get(), region)
     : nullptr, HtsIteratorDeleter {}}
 , hts_bam1_ {bam_init1(), HtsBam1Deleter {}}
+, read_group_hint_ {0}
 {
     if (hts_iterator_ == nullptr) {
         throw std::runtime_error {"HtslibIterator: could not load iterator for " + hts_facade.file_path_.string()};
@@ -758,6 +799,7 @@ HtslibSamFacade::HtslibIterator::HtslibIterator(const HtslibSamFacade& hts_facad
 , hts_iterator_ {hts_facade.is_open() ? sam_itr_querys(hts_facade_.hts_index_.get(), hts_facade_.hts_header_.get(),
                                                      contig.c_str()) : nullptr, HtsIteratorDeleter {}}
 , hts_bam1_ {bam_init1(), HtsBam1Deleter {}}
+, read_group_hint_ {0}
 {
     if (hts_iterator_ == nullptr) {
         throw std::runtime_error {"HtslibIterator: could not load iterator for " + hts_facade.file_path_.string()};
@@ -787,20 +829,12 @@ auto extract_sequence_length(const bam1_t* b) noexcept
     return b->core.l_qseq;
 }
 
-char extract_base(const std::uint8_t* hts_sequence, const std::uint32_t index) noexcept
-{
-    static constexpr const char* symbolTable {"=ACMGRSVTWYHKDBN"};
-    return symbolTable[bam_seqi(hts_sequence, index)];
-}
-
 AlignedRead::NucleotideSequence extract_sequence(const bam1_t* b)
 {
     using NucleotideSequence = AlignedRead::NucleotideSequence;
-    const auto sequence_length  = static_cast<NucleotideSequence::size_type>(extract_sequence_length(b));
-    const auto hts_sequence     = bam_get_seq(b);
+    const auto sequence_length = static_cast<NucleotideSequence::size_type>(extract_sequence_length(b));
     NucleotideSequence result(sequence_length, 'N');
-    std::uint32_t i {0};
-    std::generate_n(std::begin(result), sequence_length, [&] () { return extract_base(hts_sequence, i++); });
+    unpack_bam_sequence(bam_get_seq(b), sequence_length, &result[0]);
     return result;
 }
 
@@ -877,10 +911,11 @@ auto extract_next_segment_flags(const bam1_core_t& c) noexcept
 AlignedRead HtslibSamFacade::HtslibIterator::operator*() const
 {
     using std::begin; using std::end; using std::next; using std::move;
-    auto qualities = extract_qualities(hts_bam1_.get());
-    if (qualities.empty() || qualities[0] == 0xff) {
+    // Check before anything is allocated
+    if (extract_sequence_length(hts_bam1_.get()) == 0 || bam_get_qual(hts_bam1_.get())[0] == 0xff) {
         throw InvalidBamRecord {hts_facade_.file_path_, extract_read_name(hts_bam1_.get()), "corrupt sequence data"};
     }
+    auto qualities = extract_qualities(hts_bam1_.get());
     auto cigar = extract_cigar_string(hts_bam1_.get());
     const auto& info = hts_bam1_->core;
     auto read_begin_tmp = clipped_begin(cigar, info.pos);
@@ -930,13 +965,63 @@ AlignedRead HtslibSamFacade::HtslibIterator::operator*() const
     }
 }
 
-HtslibSamFacade::ReadGroupIdType HtslibSamFacade::HtslibIterator::read_group() const
+auto extract_left_overhang_size(const bam1_t* b) noexcept
+{
+    // The number of soft clipped bases that would map before the start of the contig
+    if (get_cigar_length(b) > 0) {
+        const auto first_op = bam_get_cigar(b)[0];
+        if (bam_cigar_op(first_op) == BAM_CSOFT_CLIP && bam_cigar_oplen(first_op) > static_cast<std::uint32_t>(b->core.pos)) {
+            return static_cast<std::uint32_t>(bam_cigar_oplen(first_op) - b->core.pos);
+        }
+    }
+    return std::uint32_t {0};
+}
+
+AlignedReadCore HtslibSamFacade::HtslibIterator::core() const noexcept
+{
+    const auto& info = hts_bam1_->core;
+    AlignedReadCore result {};
+    result.flags = extract_flags(info);
+    result.mapping_quality = mapping_quality(info);
+    const auto sequence_length = static_cast<std::uint32_t>(extract_sequence_length(hts_bam1_.get()));
+    result.sequence_size = sequence_length - std::min(sequence_length, extract_left_overhang_size(hts_bam1_.get()));
+    result.has_other_segment = has_multiple_segments(info);
+    if (result.has_other_segment) {
+        result.next_segment_flags = extract_next_segment_flags(info);
+        result.next_segment_on_same_contig = info.mtid == info.tid;
+    }
+    return result;
+}
+
+const HtslibSamFacade::ReadGroupIdType& HtslibSamFacade::HtslibIterator::read_group() const
+{
+    return interned_read_group().id;
+}
+
+const HtslibSamFacade::SampleName& HtslibSamFacade::HtslibIterator::sample() const
+{
+    return interned_read_group().sample;
+}
+
+const HtslibSamFacade::ReadGroup& HtslibSamFacade::HtslibIterator::interned_read_group() const
 {
     const auto ptr = bam_aux_get(hts_bam1_.get(), readGroupTag.c_str());
-    if (ptr == nullptr) {
+    const char* id {ptr != nullptr ? bam_aux2Z(ptr) : nullptr};
+    if (id == nullptr) {
         throw InvalidBamRecord {hts_facade_.file_path_, extract_read_name(hts_bam1_.get()), "no read group"};
     }
-    return HtslibSamFacade::ReadGroupIdType {bam_aux2Z(ptr)};
+    const auto& read_groups = hts_facade_.read_groups_;
+    // Consecutive records usually share a read group
+    if (read_group_hint_ < read_groups.size() && read_groups[read_group_hint_].id == id) {
+        return read_groups[read_group_hint_];
+    }
+    for (std::size_t i {0}; i < read_groups.size(); ++i) {
+        if (read_groups[i].id == id) {
+            read_group_hint_ = i;
+            return read_groups[i];
+        }
+    }
+    throw std::out_of_range {"HtslibSamFacade: read group " + std::string {id} + " is not in the header"};
 }
 
 bool HtslibSamFacade::HtslibIterator::is_good() const noexcept
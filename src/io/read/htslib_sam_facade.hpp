@@ -19,6 +19,7 @@
 #include "htslib/sam.h"
 
 #include "basics/aligned_read.hpp"
+#include "io/htslib_thread_pool.hpp"
 #include "read_reader_impl.hpp"
 
 namespace octopus {
@@ -38,6 +39,7 @@ public:
     using IReadReaderImpl::ReadContainer;
     using IReadReaderImpl::SampleReadMap;
     using IReadReaderImpl::PositionList;
+    using IReadReaderImpl::ReadFilter;
     
     using NucleotideSequence = AlignedRead::NucleotideSequence;
     
@@ -88,6 +90,9 @@ public:
                               const GenomicRegion& region) const override;
     SampleReadMap fetch_reads(const std::vector<SampleName>& samples,
                               const GenomicRegion& region) const override;
+    SampleReadMap fetch_reads(const std::vector<SampleName>& samples,
+                              const GenomicRegion& region,
+                              const ReadFilter& filter) const override;
     
     GenomicRegion::Size reference_size(const GenomicRegion::ContigName& contig) const override;
     std::vector<GenomicRegion::ContigName> reference_contigs() const override;
@@ -118,6 +123,14 @@ private:
         void operator()(bam1_t* b) const { bam_destroy1(b); }
     };
     
+    // Read groups are interned from the header so that records can be mapped to their read group
+    // and sample without constructing a string for every record
+    struct ReadGroup
+    {
+        ReadGroupIdType id;
+        SampleName sample;
+    };
+    
     class HtslibIterator
     {
     public:
@@ -133,8 +146,10 @@ private:
         
         bool operator++();
         AlignedRead operator*() const;
+        AlignedReadCore core() const noexcept;
         
-        HtslibSamFacade::ReadGroupIdType read_group() const;
+        const HtslibSamFacade::ReadGroupIdType& read_group() const;
+        const HtslibSamFacade::SampleName& sample() const;
         
         bool is_good() const noexcept;
         std::size_t begin() const noexcept;
@@ -153,17 +168,22 @@ private:
         
         std::unique_ptr<hts_itr_t, HtsIteratorDeleter> hts_iterator_;
         std::unique_ptr<bam1_t, HtsBam1Deleter> hts_bam1_;
+        mutable std::size_t read_group_hint_;
+        
+        const ReadGroup& interned_read_group() const;
     };
     
     Path file_path_;
     
+    std::shared_ptr<HtslibThreadPool> thread_pool_; // must outlive hts_file_
     std::unique_ptr<htsFile, HtsFileDeleter> hts_file_;
     std::unique_ptr<bam_hdr_t, HtsHeaderDeleter> hts_header_;
     std::unique_ptr<hts_idx_t, HtsIndexDeleter> hts_index_;
     
     std::unordered_map<GenomicRegion::ContigName, HtsTid> hts_targets_;
-    std::unordered_map<HtsTid, GenomicRegion::ContigName> contig_names_;
+    std::vector<GenomicRegion::ContigName> contig_names_; // indexed by HtsTid
     std::unordered_map<ReadGroupIdType, SampleName> sample_names_;
+    std::vector<ReadGroup> read_groups_;
     
     std::vector<SampleName> samples_;
     
@@ -8,6 +8,7 @@
 #include <utility>
 #include <deque>
 #include <numeric>
+#include <atomic>
 #include <cassert>
 
 #include <boost/filesystem/operations.hpp>
@@ -15,6 +16,7 @@
 #include "basics/aligned_read.hpp"
 #include "utils/append.hpp"
 #include "utils/coverage_tracker.hpp"
+#include "utils/executor.hpp"
 
 namespace octopus { namespace io {
 
@@ -49,6 +51,7 @@ ReadManager::ReadManager(ReadManager&& other)
     using std::move;
     max_open_files_                 = move(other.max_open_files_);
     num_files_                      = move(other.num_files_);
+    max_fetch_threads_              = move(other.max_fetch_threads_);
     closed_readers_                 = move(other.closed_readers_);
     open_readers_                   = move(other.open_readers_);
     reader_paths_containing_sample_ = move(other.reader_paths_containing_sample_);
@@ -64,6 +67,7 @@ ReadManager& ReadManager::operator=(ReadManager&& other)
         using std::move;
         max_open_files_                 = move(other.max_open_files_);
         num_files_                      = move(other.num_files_);
+        max_fetch_threads_              = move(other.max_fetch_threads_);
         closed_readers_                 = move(other.closed_readers_);
         open_readers_                   = move(other.open_readers_);
         reader_paths_containing_sample_ = move(other.reader_paths_containing_sample_);
@@ -81,6 +85,7 @@ void swap(ReadManager& lhs, ReadManager& rhs) noexcept
     using std::swap;
     swap(lhs.max_open_files_,                 rhs.max_open_files_);
     swap(lhs.num_files_,                      rhs.num_files_);
+    swap(lhs.max_fetch_threads_,              rhs.max_fetch_threads_);
     swap(lhs.closed_readers_,                 rhs.closed_readers_);
     swap(lhs.open_readers_,                   rhs.open_readers_);
     swap(lhs.reader_paths_containing_sample_, rhs.reader_paths_containing_sample_);
@@ -363,70 +368,171 @@ GenomicRegion ReadManager::find_covered_subregion(const GenomicRegion& region, c
     return find_covered_subregion(samples(), region, max_reads);
 }
 
+void ReadManager::set_max_fetch_threads(const unsigned n) noexcept
+{
+    max_fetch_threads_ = std::max(n, 1u);
+}
+
+unsigned ReadManager::max_fetch_threads() const noexcept
+{
+    return max_fetch_threads_;
+}
+
 namespace {
 
-template <typename Container>
-void merge_insert(Container&& src, Container& dst)
+// Applies fetch to each reader on the installed Executor, using up to max_threads threads (including
+// the calling thread). Each thread takes the next unfetched reader, so one large file does not hold up
+// the others. Readers are fetched sequentially if there is no executor.
+template <typename Result, typename Fetcher>
+std::vector<Result>
+fetch_each(const std::vector<const ReadReader*>& readers, Fetcher fetch, const unsigned max_threads)
+{
+    std::vector<Result> result(readers.size());
+    const auto num_threads = std::min(max_threads, static_cast<unsigned>(readers.size()));
+    const auto executor = num_threads > 1 ? get_executor() : nullptr;
+    if (!executor) {
+        std::transform(std::cbegin(readers), std::cend(readers), std::begin(result),
+                       [&] (const ReadReader* reader) { return fetch(*reader); });
+        return result;
+    }
+    std::atomic<std::size_t> next_reader {0};
+    executor->parallel_for("ReadManager::fetch_reads", num_threads, [&] (std::size_t) {
+        try {
+            for (auto idx = next_reader++; idx < readers.size(); idx = next_reader++) {
+                result[idx] = fetch(*readers[idx]);
+            }
+        } catch (...) {
+            next_reader = readers.size();
+            throw;
+        }
+    });
+    return result;
+}
+
+// k-way merge of sorted containers. Equivalent reads are ordered by source, as if each
+// source had been merged in turn.
+ReadManager::ReadContainer merge_sorted(std::vector<ReadManager::ReadContainer>& sources)
 {
-    auto itr = octopus::utils::append(std::move(src), dst);
-    std::inplace_merge(std::begin(dst), itr, std::end(dst));
+    using ReadContainer = ReadManager::ReadContainer;
+    sources.erase(std::remove_if(std::begin(sources), std::end(sources),
+                                 [] (const ReadContainer& reads) { return reads.empty(); }),
+                  std::end(sources));
+    if (sources.empty()) return {};
+    if (sources.size() == 1) return std::move(sources.front());
+    ReadContainer result {};
+    result.reserve(std::accumulate(std::cbegin(sources), std::cend(sources), std::size_t {0},
+                                   [] (auto curr, const ReadContainer& reads) { return curr + reads.size(); }));
+    using std::begin; using std::end; using std::make_move_iterator;
+    if (sources.size() == 2) {
+        std::merge(make_move_iterator(begin(sources[0])), make_move_iterator(end(sources[0])),
+                   make_move_iterator(begin(sources[1])), make_move_iterator(end(sources[1])),
+                   std::back_inserter(result));
+    } else {
+        using Cursor = std::pair<ReadContainer::iterator, std::size_t>; // next read, source index
+        // std heap functions build a max heap, so this orders the smallest read at the top
+        const auto cursor_greater = [] (const Cursor& lhs, const Cursor& rhs) {
+            if (*rhs.first < *lhs.first) return true;
+            if (*lhs.first < *rhs.first) return false;
+            return rhs.second < lhs.second;
+        };
+        std::vector<Cursor> heap {};
+        heap.reserve(sources.size());
+        for (std::size_t i {0}; i < sources.size(); ++i) {
+            heap.emplace_back(begin(sources[i]), i);
+        }
+        std::make_heap(begin(heap), end(heap), cursor_greater);
+        while (!heap.empty()) {
+            std::pop_heap(begin(heap), end(heap), cursor_greater);
+            auto& cursor = heap.back();
+            result.push_back(std::move(*cursor.first));
+            if (++cursor.first != end(sources[cursor.second])) {
+                std::push_heap(begin(heap), end(heap), cursor_greater);
+            } else {
+                heap.pop_back();
+            }
+        }
+    }
+    sources.clear();
+    sources.shrink_to_fit();
+    return result;
+}
+
+void merge_sorted(std::vector<ReadManager::SampleReadMap>& sources, ReadManager::SampleReadMap& result)
+{
+    std::vector<ReadManager::ReadContainer> sample_sources {};
+    for (auto& p : result) {
+        sample_sources.reserve(sources.size());
+        if (!p.second.empty()) sample_sources.push_back(std::move(p.second));
+        for (auto& source : sources) {
+            auto itr = source.find(p.first);
+            if (itr != std::end(source)) {
+                sample_sources.push_back(std::move(itr->second));
+                source.erase(itr);
+            }
+        }
+        p.second = merge_sorted(sample_sources);
+    }
+    sources.clear();
 }
 
 } // namespace
 
 ReadManager::ReadContainer ReadManager::fetch_reads(const SampleName& sample, const GenomicRegion& region) const
 {
-    ReadContainer result {};
+    const auto fetch = [&] (const ReadReader& reader) { return reader.fetch_reads(sample, region); };
+    std::vector<ReadContainer> reads {};
     if (all_readers_are_open()) {
-        for (const auto& p : open_readers_) {
-            merge_insert(p.second.fetch_reads(sample, region), result);
-        }
+        reads = fetch_each<ReadContainer>(get_possible_open_readers({sample}, region), fetch, max_fetch_threads_);
     } else {
         std::lock_guard<std::mutex> lock {mutex_};
         auto reader_paths = get_possible_reader_paths({sample}, region);
         auto reader_itr = partition_open(reader_paths);
         while (!reader_paths.empty()) {
-            using std::begin; using std::end; using std::make_move_iterator; using std::for_each;
-            for_each(reader_itr, end(reader_paths), [&] (const auto& reader_path) {
-                merge_insert(open_readers_.at(reader_path).fetch_reads(sample, region), result);
+            using std::begin; using std::end;
+            std::vector<const ReadReader*> readers {};
+            readers.reserve(std::distance(reader_itr, end(reader_paths)));
+            std::for_each(reader_itr, end(reader_paths), [&] (const auto& reader_path) {
+                readers.push_back(&open_readers_.at(reader_path));
             });
+            utils::append(fetch_each<ReadContainer>(readers, fetch, max_fetch_threads_), reads);
             reader_paths.erase(reader_itr, end(reader_paths));
             reader_itr = open_readers(begin(reader_paths), end(reader_paths));
         }
     }
-    return result;
+    return merge_sorted(reads);
 }
 
 ReadManager::SampleReadMap ReadManager::fetch_reads(const std::vector<SampleName>& samples, const GenomicRegion& region) const
+{
+    return fetch_reads(samples, region, ReadFilter {});
+}
+
+ReadManager::SampleReadMap ReadManager::fetch_reads(const std::vector<SampleName>& samples, const GenomicRegion& region,
+                                                    const ReadFilter& filter) const
 {
     SampleReadMap result {samples.size()};
     // Populate here so we can make unchecked access
     for (const auto& sample : samples) {
         result.emplace(std::piecewise_construct, std::forward_as_tuple(sample), std::forward_as_tuple());
     }
+    const auto fetch = [&] (const ReadReader& reader) { return reader.fetch_reads(samples, region, filter); };
     if (all_readers_are_open()) {
-        for (const auto& p : open_readers_) {
-            auto reads = p.second.fetch_reads(samples, region);
-            for (auto&& r : reads) {
-                merge_insert(std::move(r.second), result.at(r.first));
-                r.second.clear();
-                r.second.shrink_to_fit();
-            }
-        }
+        auto reads = fetch_each<SampleReadMap>(get_possible_open_readers(samples, region), fetch, max_fetch_threads_);
+        merge_sorted(reads, result);
     } else {
         std::lock_guard<std::mutex> lock {mutex_};
         auto reader_paths = get_possible_reader_paths(samples, region);
         auto reader_itr = partition_open(reader_paths);
         while (!reader_paths.empty()) {
-            using std::begin; using std::end; using std::make_move_iterator; using std::for_each;
-            for_each(reader_itr, end(reader_paths), [&] (const auto& reader_path) {
-                auto reads = open_readers_.at(reader_path).fetch_reads(samples, region);
-                for (auto&& r : reads) {
-                    merge_insert(std::move(r.second), result.at(r.first));
-                    r.second.clear();
-                    r.second.shrink_to_fit();
-                }
+            using std::begin; using std::end;
+            std::vector<const ReadReader*> readers {};
+            readers.reserve(std::distance(reader_itr, end(reader_paths)));
+            std::for_each(reader_itr, end(reader_paths), [&] (const auto& reader_path) {
+                readers.push_back(&open_readers_.at(reader_path));
             });
+            auto reads = fetch_each<SampleReadMap>(readers, fetch, max_fetch_threads_);
+            // Merge each batch before opening more files to bound the number of reads held
+            merge_sorted(reads, result);
             reader_paths.erase(reader_itr, end(reader_paths));
             reader_itr = open_readers(begin(reader_paths), end(reader_paths));
         }
@@ -644,5 +750,21 @@ ReadManager::get_possible_reader_paths(const std::vector<SampleName>& samples, c
     return result;
 }
 
+std::vector<const ReadReader*>
+ReadManager::get_possible_open_readers(const std::vector<SampleName>& samples, const GenomicRegion& region) const
+{
+    const auto reader_paths = get_reader_paths_containing_samples(samples);
+    const std::unordered_set<Path, PathHash> candidate_paths {std::cbegin(reader_paths), std::cend(reader_paths)};
+    std::vector<const ReadReader*> result {};
+    result.reserve(candidate_paths.size());
+    // Keep the open reader order so equivalent reads are always merged in the same order
+    for (const auto& p : open_readers_) {
+        if (candidate_paths.count(p.first) == 1 && could_reader_contain_region(p.first, region)) {
+            result.push_back(&p.second);
+        }
+    }
+    return result;
+}
+
 } // namespace io
 } // namespace octopus
@@ -35,6 +35,7 @@ public:
     using SampleName    = IReadReaderImpl::SampleName;
     using ReadContainer = IReadReaderImpl::ReadContainer;
     using SampleReadMap = IReadReaderImpl::SampleReadMap;
+    using ReadFilter    = IReadReaderImpl::ReadFilter;
     
     ReadManager() = default;
     
@@ -72,8 +73,15 @@ public:
                                          std::size_t max_reads) const;
     GenomicRegion find_covered_subregion(const GenomicRegion& region, std::size_t max_reads) const;
     
+    // Reads from up to max_fetch_threads files are fetched concurrently on the installed Executor
+    void set_max_fetch_threads(unsigned n) noexcept;
+    unsigned max_fetch_threads() const noexcept;
+    
     ReadContainer fetch_reads(const SampleName& sample,  const GenomicRegion& region) const;
     SampleReadMap fetch_reads(const std::vector<SampleName>& samples, const GenomicRegion& region) const;
+    // filter may be called concurrently if max_fetch_threads > 1
+    SampleReadMap fetch_reads(const std::vector<SampleName>& samples, const GenomicRegion& region,
+                              const ReadFilter& filter) const;
     SampleReadMap fetch_reads(const GenomicRegion& region) const;
     
 private:
@@ -92,6 +100,7 @@ private:
     
     unsigned max_open_files_ = 200;
     unsigned num_files_;
+    unsigned max_fetch_threads_ = 1;
     
     mutable ClosedReaderSet closed_readers_;
     mutable OpenReaderMap open_readers_;
@@ -127,6 +136,8 @@ private:
     std::vector<Path> get_possible_reader_paths(const GenomicRegion& region) const;
     std::vector<Path> get_possible_reader_paths(const std::vector<SampleName>& samples,
                                                 const GenomicRegion& region) const;
+    std::vector<const ReadReader*> get_possible_open_readers(const std::vector<SampleName>& samples,
+                                                             const GenomicRegion& region) const;
 };
 
 } // namespace io
@@ -237,6 +237,15 @@ ReadReader::SampleReadMap ReadReader::fetch_reads(const std::vector<SampleName>&
     return impl_->fetch_reads(samples, region);
 }
 
+ReadReader::SampleReadMap ReadReader::fetch_reads(const std::vector<SampleName>& samples,
+                                                  const GenomicRegion& region,
+                                                  const ReadFilter& filter) const
+{
+    std::lock_guard<std::mutex> lock {mutex_};
+    if (!filter) return impl_->fetch_reads(samples, region);
+    return impl_->fetch_reads(samples, region, filter);
+}
+
 bool operator==(const ReadReader& lhs, const ReadReader& rhs)
 {
     return lhs.path() == rhs.path();
@@ -36,6 +36,7 @@ public:
     using ReadContainer   = IReadReaderImpl::ReadContainer;
     using SampleReadMap   = IReadReaderImpl::SampleReadMap;
     using PositionList    = IReadReaderImpl::PositionList;
+    using ReadFilter      = IReadReaderImpl::ReadFilter;
     
     ReadReader() = default;
     
@@ -91,6 +92,9 @@ public:
                               const GenomicRegion& region) const;
     SampleReadMap fetch_reads(const std::vector<SampleName>& samples,
                               const GenomicRegion& region) const;
+    SampleReadMap fetch_reads(const std::vector<SampleName>& samples,
+                              const GenomicRegion& region,
+                              const ReadFilter& filter) const;
     
 private:
     Path file_path_;
@@ -8,12 +8,14 @@
 #include <vector>
 #include <cstddef>
 #include <unordered_map>
+#include <functional>
 #include <utility>
 
 #include <boost/optional.hpp>
 
 #include "basics/genomic_region.hpp"
 #include "basics/aligned_read.hpp"
+#include "basics/aligned_read_core.hpp"
 
 namespace octopus { namespace io {
 
@@ -24,6 +26,7 @@ public:
     using ReadContainer   = std::vector<AlignedRead>;
     using SampleReadMap   = std::unordered_map<SampleName, ReadContainer>;
     using PositionList    = std::vector<GenomicRegion::Position>;
+    using ReadFilter      = std::function<bool(const SampleName&, const AlignedReadCore&)>;
     
     virtual ~IReadReaderImpl() noexcept = default;
     
@@ -60,6 +63,10 @@ public:
                                       const GenomicRegion& region) const = 0;
     virtual SampleReadMap fetch_reads(const std::vector<SampleName>& samples,
                                       const GenomicRegion& region) const = 0;
+    // Reads that do not pass the filter are discarded before they are decoded
+    virtual SampleReadMap fetch_reads(const std::vector<SampleName>& samples,
+                                      const GenomicRegion& region,
+                                      const ReadFilter& filter) const = 0;
     
     virtual std::vector<GenomicRegion::ContigName> reference_contigs() const = 0;
     virtual GenomicRegion::Size reference_size(const GenomicRegion::ContigName& contig) const = 0;
@@ -0,0 +1,469 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "packed_fasta.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <cctype>
+#include <ctime>
+#include <array>
+#include <unordered_map>
+#include <algorithm>
+#include <iterator>
+#include <fstream>
+#include <sstream>
+#include <functional>
+#include <utility>
+#include <stdexcept>
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#include "basics/genomic_region.hpp"
+#include "utils/sequence_utils.hpp"
+#include "exceptions/malformed_file_error.hpp"
+#include "exceptions/unwritable_file_error.hpp"
+
+namespace octopus { namespace io {
+
+namespace {
+
+// All sections of the packed file are arrays of 64 bit words, so every section is 8 byte aligned
+
+using Word = std::uint64_t;
+
+static constexpr std::size_t basesPerWord {32};
+static constexpr std::array<char, 4> packedBases {'A', 'C', 'G', 'T'};
+static constexpr std::array<char, 8> packedMagic {'O', 'C', 'T', 'P', 'A', 'C', 'K', 'F'};
+static constexpr std::uint32_t packedVersion {1};
+static constexpr std::uint32_t packedByteOrder {0x01020304};
+
+struct Header
+{
+    std::array<char, 8> magic;
+    std::uint32_t version, byte_order;
+    Word num_contigs, fasta_size;
+    std::int64_t fasta_write_time;
+    Word directory_offset, names_offset, names_size;
+};
+
+struct DirectoryEntry
+{
+    Word name_offset, name_size, length;
+    Word words_offset;
+    Word n_runs_offset, num_n_runs;
+    Word lower_runs_offset, num_lower_runs;
+    Word symbols_offset, num_symbols;
+};
+
+// Half open interval of positions in a contig
+struct Run
+{
+    Word begin, end;
+};
+
+// An uppercase symbol other than ACGTN
+struct Symbol
+{
+    Word position, base;
+};
+
+static_assert(sizeof(Header) == 8 * sizeof(Word), "");
+static_assert(sizeof(DirectoryEntry) == 10 * sizeof(Word), "");
+
+class MalformedPackedFasta : public MalformedFileError
+{
+    std::string do_where() const override
+    {
+        return "PackedFasta";
+    }
+public:
+    MalformedPackedFasta(PackedFasta::Path file) : MalformedFileError {std::move(file), "packed reference"} {}
+};
+
+class UnwritablePackedFasta : public UnwritableFileError
+{
+    std::string do_where() const override
+    {
+        return "PackedFasta";
+    }
+public:
+    UnwritablePackedFasta(PackedFasta::Path file) : UnwritableFileError {std::move(file), "packed reference"} {}
+};
+
+struct FastaStamp
+{
+    Word size;
+    std::int64_t write_time;
+};
+
+bool get_stamp(const PackedFasta::Path& fasta_path, FastaStamp& result) noexcept
+{
+    boost::system::error_code size_error {}, time_error {};
+    result.size = boost::filesystem::file_size(fasta_path, size_error);
+    result.write_time = boost::filesystem::last_write_time(fasta_path, time_error);
+    return !size_error && !time_error;
+}
+
+Word num_words(const Word num_bases) noexcept
+{
+    return (num_bases + basesPerWord - 1) / basesPerWord;
+}
+
+void extend(std::vector<Run>& runs, const Word position)
+{
+    if (!runs.empty() && runs.back().end == position) {
+        ++runs.back().end;
+    } else {
+        runs.push_back({position, position + 1});
+    }
+}
+
+template <typename T>
+Word write(std::ofstream& file, const std::vector<T>& values)
+{
+    const auto result = static_cast<Word>(file.tellp());
+    file.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+    return result;
+}
+
+void pack(const PackedFasta::Path& fasta_path, const PackedFasta::Path& packed_path)
+{
+    using namespace boost::filesystem;
+    Header header {};
+    header.magic = packedMagic;
+    header.version = packedVersion;
+    header.byte_order = packedByteOrder;
+    FastaStamp stamp {};
+    if (!get_stamp(fasta_path, stamp)) {
+        Fasta {fasta_path}; // throws the appropriate error
+    }
+    header.fasta_size = stamp.size;
+    header.fasta_write_time = stamp.write_time;
+    const Fasta fasta {fasta_path}; // keep original case and symbols
+    const auto contigs = fasta.fetch_contig_names();
+    header.num_contigs = contigs.size();
+    // Write to a temporary file and rename so concurrent runs never see a partial file
+    const auto temp_path = packed_path.parent_path() / unique_path(packed_path.filename().string() + ".%%%%-%%%%-%%%%");
+    std::ofstream file {temp_path.string(), std::ios::binary};
+    if (!file) {
+        throw UnwritablePackedFasta {packed_path};
+    }
+    try {
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        std::vector<DirectoryEntry> directory {};
+        directory.reserve(contigs.size());
+        std::string names {};
+        std::vector<Word> words {};
+        std::vector<Run> n_runs {}, lower_runs {};
+        std::vector<Symbol> symbols {};
+        static constexpr Word chunkSize {1u << 22};
+        for (const auto& contig : contigs) {
+            DirectoryEntry entry {};
+            entry.name_offset = names.size();
+            entry.name_size = contig.size();
+            names += contig;
+            entry.length = fasta.fetch_contig_size(contig);
+            words.assign(num_words(entry.length), 0);
+            n_runs.clear(); lower_runs.clear(); symbols.clear();
+            for (Word begin {0}; begin < entry.length; begin += chunkSize) {
+                const auto end = std::min(begin + chunkSize, entry.length);
+                const GenomicRegion region {contig, static_cast<GenomicRegion::Position>(begin),
+                                            static_cast<GenomicRegion::Position>(end)};
+                const auto sequence = fasta.fetch_sequence(region);
+                if (sequence.size() != end - begin) {
+                    throw MalformedPackedFasta {fasta_path};
+                }
+                for (std::size_t i {0}; i < sequence.size(); ++i) {
+                    const Word position {begin + i};
+                    const auto c = sequence[i];
+                    if (std::islower(static_cast<unsigned char>(c))) extend(lower_runs, position);
+                    Word code {0};
+                    switch (std::toupper(static_cast<unsigned char>(c))) {
+                        case 'A': break;
+                        case 'C': code = 1; break;
+                        case 'G': code = 2; break;
+                        case 'T': code = 3; break;
+                        case 'N': extend(n_runs, position); break;
+                        default: symbols.push_back({position, static_cast<Word>(std::toupper(static_cast<unsigned char>(c)))});
+                    }
+                    words[position / basesPerWord] |= code << (2 * (position % basesPerWord));
+                }
+            }
+            entry.words_offset = write(file, words);
+            entry.n_runs_offset = write(file, n_runs);
+            entry.num_n_runs = n_runs.size();
+            entry.lower_runs_offset = write(file, lower_runs);
+            entry.num_lower_runs = lower_runs.size();
+            entry.symbols_offset = write(file, symbols);
+            entry.num_symbols = symbols.size();
+            directory.push_back(entry);
+        }
+        header.directory_offset = write(file, directory);
+        header.names_offset = static_cast<Word>(file.tellp());
+        header.names_size = names.size();
+        file.write(names.data(), names.size());
+        file.seekp(0);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.close();
+        if (!file) {
+            throw UnwritablePackedFasta {packed_path};
+        }
+        rename(temp_path, packed_path);
+    } catch (...) {
+        boost::system::error_code ec {};
+        remove(temp_path, ec);
+        throw;
+    }
+}
+
+} // namespace
+
+class PackedFasta::Store
+{
+public:
+    // Returns nullptr if the packed file does not exist, is malformed, or is out of date
+    static std::shared_ptr<const Store> open(const Path& packed_path, const Path& fasta_path);
+
+    std::vector<ContigName> contig_names() const;
+    GenomicSize contig_size(const ContigName& contig) const;
+    GeneticSequence fetch(const GenomicRegion& region, bool capitalise) const;
+
+private:
+    struct Contig
+    {
+        ContigName name;
+        Word length;
+        const Word* words;
+        const Run* n_runs;
+        std::size_t num_n_runs;
+        const Run* lower_runs;
+        std::size_t num_lower_runs;
+        const Symbol* symbols;
+        std::size_t num_symbols;
+    };
+
+    boost::iostreams::mapped_file_source file_;
+    std::vector<Contig> contigs_;
+    std::unordered_map<ContigName, std::size_t> contig_indices_;
+};
+
+std::shared_ptr<const PackedFasta::Store> PackedFasta::Store::open(const Path& packed_path, const Path& fasta_path)
+{
+    FastaStamp stamp {};
+    if (!boost::filesystem::exists(packed_path) || !get_stamp(fasta_path, stamp)) return nullptr;
+    auto result = std::make_shared<Store>();
+    try {
+        result->file_.open(packed_path.string());
+    } catch (const std::ios::failure&) {
+        return nullptr;
+    }
+    const auto data = result->file_.data();
+    const Word file_size {result->file_.size()};
+    const auto in_file = [=] (const Word offset, const Word size) { return offset <= file_size && size <= file_size - offset; };
+    if (!in_file(0, sizeof(Header))) return nullptr;
+    Header header;
+    std::memcpy(&header, data, sizeof(header));
+    if (header.magic != packedMagic || header.version != packedVersion || header.byte_order != packedByteOrder
+        || header.fasta_size != stamp.size || header.fasta_write_time != stamp.write_time
+        || header.directory_offset % sizeof(Word) != 0
+        || header.num_contigs > file_size / sizeof(DirectoryEntry)
+        || !in_file(header.directory_offset, header.num_contigs * sizeof(DirectoryEntry))
+        || !in_file(header.names_offset, header.names_size)) {
+        return nullptr;
+    }
+    const auto directory = reinterpret_cast<const DirectoryEntry*>(data + header.directory_offset);
+    const auto names = data + header.names_offset;
+    const auto in_section = [&] (const Word offset, const Word count, const std::size_t element_size) {
+        return offset % sizeof(Word) == 0 && count <= file_size / element_size && in_file(offset, count * element_size);
+    };
+    result->contigs_.reserve(header.num_contigs);
+    result->contig_indices_.reserve(header.num_contigs);
+    for (std::size_t i {0}; i < header.num_contigs; ++i) {
+        const auto& entry = directory[i];
+        if (entry.name_offset > header.names_size || entry.name_size > header.names_size - entry.name_offset
+            || !in_section(entry.words_offset, num_words(entry.length), sizeof(Word))
+            || !in_section(entry.n_runs_offset, entry.num_n_runs, sizeof(Run))
+            || !in_section(entry.lower_runs_offset, entry.num_lower_runs, sizeof(Run))
+            || !in_section(entry.symbols_offset, entry.num_symbols, sizeof(Symbol))) {
+            return nullptr;
+        }
+        Contig contig {};
+        contig.name.assign(names + entry.name_offset, entry.name_size);
+        contig.length = entry.length;
+        contig.words = reinterpret_cast<const Word*>(data + entry.words_offset);
+        contig.n_runs = reinterpret_cast<const Run*>(data + entry.n_runs_offset);
+        contig.num_n_runs = entry.num_n_runs;
+        contig.lower_runs = reinterpret_cast<const Run*>(data + entry.lower_runs_offset);
+        contig.num_lower_runs = entry.num_lower_runs;
+        contig.symbols = reinterpret_cast<const Symbol*>(data + entry.symbols_offset);
+        contig.num_symbols = entry.num_symbols;
+        result->contig_indices_.emplace(contig.name, i);
+        result->contigs_.push_back(std::move(contig));
+    }
+    return result;
+}
+
+std::vector<PackedFasta::ContigName> PackedFasta::Store::contig_names() const
+{
+    std::vector<ContigName> result {};
+    result.reserve(contigs_.size());
+    for (const auto& contig : contigs_) result.push_back(contig.name);
+    return result;
+}
+
+PackedFasta::GenomicSize PackedFasta::Store::contig_size(const ContigName& contig) const
+{
+    return static_cast<GenomicSize>(contigs_[contig_indices_.at(contig)].length);
+}
+
+namespace {
+
+// Calls f(begin, end) for the overlap of each run with [begin, end)
+template <typename F>
+void for_each_overlap(const Run* first, const Run* last, const Word begin, const Word end, F f)
+{
+    first = std::partition_point(first, last, [=] (const Run& run) { return run.end <= begin; });
+    for (; first != last && first->begin < end; ++first) {
+        f(std::max(first->begin, begin), std::min(first->end, end));
+    }
+}
+
+} // namespace
+
+PackedFasta::GeneticSequence PackedFasta::Store::fetch(const GenomicRegion& region, const bool capitalise) const
+{
+    const auto& contig = contigs_[contig_indices_.at(contig_name(region))];
+    const Word begin {std::min(static_cast<Word>(mapped_begin(region)), contig.length)};
+    const Word end {std::min(static_cast<Word>(mapped_end(region)), contig.length)};
+    GeneticSequence result(end - begin, 'N');
+    if (begin == end) return result;
+    auto out = std::begin(result);
+    auto word = contig.words[begin / basesPerWord] >> (2 * (begin % basesPerWord));
+    for (auto position = begin; position < end; ++position, ++out) {
+        if (position % basesPerWord == 0) word = contig.words[position / basesPerWord];
+        *out = packedBases[word & 3];
+        word >>= 2;
+    }
+    const auto at = [&] (const Word position) { return std::next(std::begin(result), position - begin); };
+    for_each_overlap(contig.n_runs, contig.n_runs + contig.num_n_runs, begin, end, [&] (Word first, Word last) {
+        std::fill(at(first), at(last), 'N');
+    });
+    const auto symbols_end = contig.symbols + contig.num_symbols;
+    auto symbol = std::partition_point(contig.symbols, symbols_end, [=] (const Symbol& s) { return s.position < begin; });
+    for (; symbol != symbols_end && symbol->position < end; ++symbol) {
+        *at(symbol->position) = static_cast<char>(symbol->base);
+    }
+    if (!capitalise) {
+        for_each_overlap(contig.lower_runs, contig.lower_runs + contig.num_lower_runs, begin, end, [&] (Word first, Word last) {
+            std::transform(at(first), at(last), at(first),
+                           [] (char c) { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); });
+        });
+    }
+    return result;
+}
+
+PackedFasta::PackedFasta(Path fasta_path)
+: PackedFasta {fasta_path, Options {}}
+{}
+
+PackedFasta::PackedFasta(Path fasta_path, Options options)
+: fasta_path_ {std::move(fasta_path)}
+, store_ {}
+, options_ {options}
+{
+    try {
+        store_ = open_or_make_store(default_packed_path(fasta_path_));
+    } catch (const UnwritablePackedFasta&) {
+        // Shared references are often in read-only directories
+        store_ = open_or_make_store(fallback_packed_path(fasta_path_));
+    }
+}
+
+PackedFasta::PackedFasta(Path fasta_path, Path packed_path, Options options)
+: fasta_path_ {std::move(fasta_path)}
+, store_ {}
+, options_ {options}
+{
+    store_ = open_or_make_store(packed_path);
+}
+
+PackedFasta::Path PackedFasta::default_packed_path(const Path& fasta_path)
+{
+    return fasta_path.string() + ".packed";
+}
+
+PackedFasta::Path PackedFasta::fallback_packed_path(const Path& fasta_path)
+{
+    // The absolute FASTA path is hashed so references with the same file name do not share a packed file
+    const auto absolute_fasta_path = boost::filesystem::absolute(fasta_path).string();
+    std::ostringstream packed_name {};
+    packed_name << fasta_path.filename().string() << '.' << std::hex
+                << std::hash<std::string> {}(absolute_fasta_path) << ".packed";
+    return boost::filesystem::temp_directory_path() / packed_name.str();
+}
+
+// private methods
+
+std::shared_ptr<const PackedFasta::Store> PackedFasta::open_or_make_store(const Path& packed_path) const
+{
+    auto result = Store::open(packed_path, fasta_path_);
+    if (!result) {
+        pack(fasta_path_, packed_path);
+        result = Store::open(packed_path, fasta_path_);
+        if (!result) {
+            throw MalformedPackedFasta {packed_path};
+        }
+    }
+    return result;
+}
+
+// virtual private methods
+
+std::unique_ptr<ReferenceReader> PackedFasta::do_clone() const
+{
+    return std::make_unique<PackedFasta>(*this);
+}
+
+bool PackedFasta::do_is_open() const noexcept
+{
+    return store_ != nullptr;
+}
+
+std::string PackedFasta::do_fetch_reference_name() const
+{
+    return fasta_path_.stem().string();
+}
+
+std::vector<PackedFasta::ContigName> PackedFasta::do_fetch_contig_names() const
+{
+    return store_->contig_names();
+}
+
+PackedFasta::GenomicSize PackedFasta::do_fetch_contig_size(const ContigName& contig) const
+{
+    return store_->contig_size(contig);
+}
+
+PackedFasta::GeneticSequence PackedFasta::do_fetch_sequence(const GenomicRegion& region) const
+{
+    const bool capitalise {options_.base_transform_policy == Options::CapitalisationPolicy::capitalise};
+    auto result = store_->fetch(region, capitalise);
+    if (options_.iupac_ambiguity_symbol_policy == Options::IUPACAmbiguitySymbolPolicy::disambiguate) {
+        utils::disambiguate_iupac_bases(result, true);
+    }
+    if (result.size() < size(region)) {
+        if (options_.base_fill_policy == Options::BaseFillPolicy::throw_exception) {
+            throw std::out_of_range {"PackedFasta: requested bad reference region " + to_string(region)};
+        }
+        if (options_.base_fill_policy == Options::BaseFillPolicy::fill_with_ns) {
+            result.resize(size(region), 'N');
+        }
+    }
+    return result;
+}
+
+} // namespace io
+} // namespace octopus
@@ -0,0 +1,76 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef packed_fasta_hpp
+#define packed_fasta_hpp
+
+#include <string>
+#include <vector>
+#include <memory>
+
+#include <boost/filesystem/path.hpp>
+
+#include "reference_reader.hpp"
+#include "fasta.hpp"
+
+namespace octopus {
+
+class GenomicRegion;
+
+namespace io {
+
+/*
+    PackedFasta serves reference sequence from a memory-mapped copy of a FASTA file, with bases
+    packed two bits each and N, lowercase, and other IUPAC symbols kept in sorted tables. The packed
+    file is made next to the FASTA the first time it is needed, or in the system temp directory if
+    the FASTA directory cannot be written, and remade if the FASTA changes.
+
+    The mapping is read-only and shared between clones, so any number of threads can fetch sequence
+    at once without locking.
+ */
+class PackedFasta : public ReferenceReader
+{
+public:
+    using Path    = Fasta::Path;
+    using Options = Fasta::Options;
+
+    using ContigName      = ReferenceReader::ContigName;
+    using GenomicSize     = ReferenceReader::GenomicSize;
+    using GeneticSequence = ReferenceReader::GeneticSequence;
+
+    PackedFasta() = delete;
+
+    PackedFasta(Path fasta_path);
+    PackedFasta(Path fasta_path, Options options);
+    PackedFasta(Path fasta_path, Path packed_path, Options options);
+
+    PackedFasta(const PackedFasta&)            = default;
+    PackedFasta& operator=(const PackedFasta&) = default;
+    PackedFasta(PackedFasta&&)                 = default;
+    PackedFasta& operator=(PackedFasta&&)      = default;
+
+    ~PackedFasta() override = default;
+
+    static Path default_packed_path(const Path& fasta_path);
+    static Path fallback_packed_path(const Path& fasta_path);
+
+private:
+    class Store;
+
+    Path fasta_path_;
+    std::shared_ptr<const Store> store_;
+    Options options_;
+
+    std::shared_ptr<const Store> open_or_make_store(const Path& packed_path) const;
+    std::unique_ptr<ReferenceReader> do_clone() const override;
+    bool do_is_open() const noexcept override;
+    std::string do_fetch_reference_name() const override;
+    std::vector<ContigName> do_fetch_contig_names() const override;
+    GenomicSize do_fetch_contig_size(const ContigName& contig) const override;
+    GeneticSequence do_fetch_sequence(const GenomicRegion& region) const override;
+};
+
+} // namespace io
+} // namespace octopus
+
+#endif
@@ -11,6 +11,7 @@
 #include "fasta.hpp"
 #include "threadsafe_fasta.hpp"
 #include "caching_fasta.hpp"
+#include "packed_fasta.hpp"
 
 namespace octopus {
 
@@ -98,7 +99,9 @@ ReferenceGenome make_reference(boost::filesystem::path reference_path,
                                const MemoryFootprint max_cache_size,
                                const bool is_threaded,
                                const bool capitalise_bases,
-                               const bool disambiguate_iupac_ambiguity_symbols)
+                               const bool disambiguate_iupac_ambiguity_symbols,
+                               const bool use_packed_store,
+                               boost::optional<boost::filesystem::path> packed_store_path)
 {
     using namespace io;
     std::unique_ptr<ReferenceReader> impl_ {};
@@ -110,6 +113,13 @@ ReferenceGenome make_reference(boost::filesystem::path reference_path,
         options.iupac_ambiguity_symbol_policy = Fasta::Options::IUPACAmbiguitySymbolPolicy::disambiguate;
     }
     options.base_fill_policy = Fasta::Options::BaseFillPolicy::fill_with_ns;
+    if (use_packed_store) {
+        // Fetches are lock-free and served from the page cache, so there is nothing for a cache to save
+        if (packed_store_path) {
+            return ReferenceGenome {std::make_unique<PackedFasta>(std::move(reference_path), std::move(*packed_store_path), options)};
+        }
+        return ReferenceGenome {std::make_unique<PackedFasta>(std::move(reference_path), options)};
+    }
     if (is_threaded) {
         impl_ = std::make_unique<ThreadsafeFasta>(std::make_unique<Fasta>(reference_path, options));
     } else {
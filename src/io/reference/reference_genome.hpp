@@ -11,6 +11,7 @@
 #include <memory>
 
 #include <boost/filesystem/path.hpp>
+#include <boost/optional.hpp>
 
 #include "basics/genomic_region.hpp"
 #include "utils/memory_footprint.hpp"
@@ -59,7 +60,9 @@ ReferenceGenome make_reference(boost::filesystem::path reference_path,
                                MemoryFootprint max_cache_size = 0,
                                bool is_threaded = false,
                                bool capitalise_bases = true,
-                               bool disambiguate_iupac_ambiguity_symbols = true);
+                               bool disambiguate_iupac_ambiguity_symbols = true,
+                               bool use_packed_store = false,
+                               boost::optional<boost::filesystem::path> packed_store_path = boost::none);
 
 std::vector<GenomicRegion> get_all_contig_regions(const ReferenceGenome& reference);
 
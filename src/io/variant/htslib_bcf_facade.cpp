@@ -24,6 +24,7 @@
 #include "vcf_spec.hpp"
 #include "vcf_header.hpp"
 #include "vcf_record.hpp"
+#include "typed_vcf_record.hpp"
 
 #include <iostream> // TEST
 
@@ -83,9 +84,22 @@ std::string get_hts_mode(const HtslibBcfFacade::Path& file_path, const HtslibBcf
     return result;
 }
 
+namespace {
+
+htsFile* open_hts_file(const char* path, const char* mode, io::HtslibThreadPool* thread_pool)
+{
+    auto result = bcf_open(path, mode);
+    // The pool must be attached before anything is read or written
+    if (result && thread_pool) thread_pool->attach(result);
+    return result;
+}
+
+} // namespace
+
 HtslibBcfFacade::HtslibBcfFacade()
 : file_path_ {}
-, file_ {bcf_open("-", "[w]"), HtsFileDeleter {}}
+, thread_pool_ {io::get_htslib_thread_pool()}
+, file_ {open_hts_file("-", "[w]", thread_pool_.get()), HtsFileDeleter {}}
 , header_ {bcf_hdr_init("w"), HtsHeaderDeleter {}}
 , samples_ {}
 {
@@ -99,6 +113,7 @@ HtslibBcfFacade::HtslibBcfFacade()
 
 HtslibBcfFacade::HtslibBcfFacade(Path file_path, Mode mode)
 : file_path_ {std::move(file_path)}
+, thread_pool_ {io::get_htslib_thread_pool()}
 , file_ {nullptr, HtsFileDeleter {}}
 , header_ {nullptr, HtsHeaderDeleter {}}
 , samples_ {}
@@ -106,7 +121,7 @@ HtslibBcfFacade::HtslibBcfFacade(Path file_path, Mode mode)
     const auto hts_mode = get_hts_mode(file_path_, mode);
     if (mode == Mode::read) {
         if (boost::filesystem::exists(file_path_)) {
-            file_.reset(bcf_open(file_path_.c_str(), hts_mode.c_str()));
+            file_.reset(open_hts_file(file_path_.c_str(), hts_mode.c_str(), thread_pool_.get()));
             if (!file_) {
                 throw FileOpenError {file_path_};
             }
@@ -119,20 +134,20 @@ HtslibBcfFacade::HtslibBcfFacade(Path file_path, Mode mode)
             throw std::runtime_error {"HtslibBcfFacade: " + file_path_.string() + " does not exist"};
         }
     } else if (mode == Mode::write) {
-        file_.reset(bcf_open(file_path_.c_str(), hts_mode.c_str()));
+        file_.reset(open_hts_file(file_path_.c_str(), hts_mode.c_str(), thread_pool_.get()));
         if (!file_) {
             throw FileOpenError {file_path_};
         }
         header_.reset(bcf_hdr_init(hts_mode.c_str()));
     } else {
         const auto hts_read_mode = get_hts_mode(file_path_, Mode::read);
-        file_.reset(bcf_open(file_path_.c_str(), hts_read_mode.c_str()));
+        file_.reset(open_hts_file(file_path_.c_str(), hts_read_mode.c_str(), thread_pool_.get()));
         if (!file_) {
             throw FileOpenError {file_path_};
         }
         header_.reset(bcf_hdr_read(file_.get()));
         file_.reset();
-        file_.reset(bcf_open(file_path_.c_str(), hts_mode.c_str()));
+        file_.reset(open_hts_file(file_path_.c_str(), hts_mode.c_str(), thread_pool_.get()));
         if (!file_) {
             throw FileOpenError {file_path_};
         }
@@ -213,7 +228,7 @@ std::size_t HtslibBcfFacade::count_records(const GenomicRegion& region) const
     return count_records(sr);
 }
 
-HtslibBcfFacade::RecordIteratorPtrPair HtslibBcfFacade::iterate(const UnpackPolicy level) const
+HtslibBcfFacade::RecordIteratorPtrPair HtslibBcfFacade::iterate(const UnpackMask& level) const
 {
     HtsBcfSrPtr sr {bcf_sr_init(), HtsSrsDeleter {}};
     if (bcf_sr_add_reader(sr.get(), file_path_.c_str()) != 1) {
@@ -230,7 +245,7 @@ HtslibBcfFacade::RecordIteratorPtrPair HtslibBcfFacade::iterate(const UnpackPoli
 }
 
 HtslibBcfFacade::RecordIteratorPtrPair
-HtslibBcfFacade::iterate(const std::string& contig, const UnpackPolicy level) const
+HtslibBcfFacade::iterate(const std::string& contig, const UnpackMask& level) const
 {
     HtsBcfSrPtr sr {bcf_sr_init(), HtsSrsDeleter {}};
     if (bcf_sr_set_regions(sr.get(), contig.c_str(), 0) != 0) {
@@ -250,7 +265,7 @@ HtslibBcfFacade::iterate(const std::string& contig, const UnpackPolicy level) co
 }
 
 HtslibBcfFacade::RecordIteratorPtrPair
-HtslibBcfFacade::iterate(const GenomicRegion& region, const UnpackPolicy level) const
+HtslibBcfFacade::iterate(const GenomicRegion& region, const UnpackMask& level) const
 {
     HtsBcfSrPtr sr {bcf_sr_init(), HtsSrsDeleter {}};
     const auto region_str = to_string(region);
@@ -271,7 +286,7 @@ HtslibBcfFacade::iterate(const GenomicRegion& region, const UnpackPolicy level)
 }
 
 HtslibBcfFacade::RecordContainer
-HtslibBcfFacade::fetch_records(const UnpackPolicy level) const
+HtslibBcfFacade::fetch_records(const UnpackMask& level) const
 {
     const auto n_records = count_records();
     if (n_records == 0) return {};
@@ -284,7 +299,7 @@ HtslibBcfFacade::fetch_records(const UnpackPolicy level) const
 }
 
 HtslibBcfFacade::RecordContainer
-HtslibBcfFacade::fetch_records(const std::string& contig, const UnpackPolicy level) const
+HtslibBcfFacade::fetch_records(const std::string& contig, const UnpackMask& level) const
 {
     const auto n_records = count_records(contig);
     if (n_records == 0) return {};
@@ -300,7 +315,7 @@ HtslibBcfFacade::fetch_records(const std::string& contig, const UnpackPolicy lev
 }
 
 HtslibBcfFacade::RecordContainer
-HtslibBcfFacade::fetch_records(const GenomicRegion& region, const UnpackPolicy level) const
+HtslibBcfFacade::fetch_records(const GenomicRegion& region, const UnpackMask& level) const
 {
     const auto n_records = count_records(region);
     if (n_records == 0) return {};
@@ -316,6 +331,52 @@ HtslibBcfFacade::fetch_records(const GenomicRegion& region, const UnpackPolicy l
     return fetch_records(sr.get(), level, n_records);
 }
 
+HtslibBcfFacade::TypedRecordContainer
+HtslibBcfFacade::fetch_typed_records(const SchemaPtr& schema) const
+{
+    const auto n_records = count_records();
+    if (n_records == 0) return {};
+    HtsBcfSrPtr sr {bcf_sr_init(), HtsSrsDeleter {}};
+    if (bcf_sr_add_reader(sr.get(), file_path_.c_str()) != 1) {
+        sr.release();
+        throw std::runtime_error {"failed to open file " + file_path_.string()};
+    }
+    return fetch_typed_records(sr.get(), schema, n_records);
+}
+
+HtslibBcfFacade::TypedRecordContainer
+HtslibBcfFacade::fetch_typed_records(const std::string& contig, const SchemaPtr& schema) const
+{
+    const auto n_records = count_records(contig);
+    if (n_records == 0) return {};
+    HtsBcfSrPtr sr {bcf_sr_init(), HtsSrsDeleter {}};
+    if (bcf_sr_set_regions(sr.get(), contig.c_str(), 0) != 0) { // must go before bcf_sr_add_reader
+        throw std::runtime_error {"failed load contig " + contig};
+    }
+    if (bcf_sr_add_reader(sr.get(), file_path_.c_str()) != 1) {
+        sr.release();
+        throw std::runtime_error {"failed to open file " + file_path_.string()};
+    }
+    return fetch_typed_records(sr.get(), schema, n_records);
+}
+
+HtslibBcfFacade::TypedRecordContainer
+HtslibBcfFacade::fetch_typed_records(const GenomicRegion& region, const SchemaPtr& schema) const
+{
+    const auto n_records = count_records(region);
+    if (n_records == 0) return {};
+    HtsBcfSrPtr sr {bcf_sr_init(), HtsSrsDeleter {}};
+    const auto region_str = to_string(region);
+    if (bcf_sr_set_regions(sr.get(), region_str.c_str(), 0) != 0) { // must go before bcf_sr_add_reader
+        throw std::runtime_error {"failed load region " + region_str};
+    }
+    if (bcf_sr_add_reader(sr.get(), file_path_.c_str()) != 1) {
+        sr.release();
+        throw std::runtime_error {"failed to open file " + file_path_.string()};
+    }
+    return fetch_typed_records(sr.get(), schema, n_records);
+}
+
 auto hts_tag_type(const std::string& tag)
 {
     using namespace vcfspec::header::meta::tag;
@@ -437,6 +498,44 @@ void HtslibBcfFacade::write(const VcfRecord& record)
     bcf_destroy(hts_record);
 }
 
+void set_typed_info(const bcf_hdr_t* header, bcf1_t* dest, const TypedVcfRecord& source);
+void set_typed_samples(const bcf_hdr_t* header, bcf1_t* dest, const TypedVcfRecord& source,
+                       const std::vector<std::string>& samples);
+
+void HtslibBcfFacade::write(const TypedVcfRecord& record)
+{
+    if (file_ == nullptr) {
+        throw std::runtime_error {"HtslibBcfFacade: trying to write record to closed file"};
+    }
+    if (header_ == nullptr) {
+        throw std::runtime_error {"HtslibBcfFacade: trying to write record without a header"};
+    }
+    
+    const auto& contig = record.chrom();
+    
+    if (!contains_contig(header_.get(), contig)) {
+        throw std::runtime_error {"HtslibBcfFacade: required contig header line missing for contig \"" + contig + "\""};
+    }
+    
+    auto hts_record = bcf_init();
+    set_chrom(header_.get(), hts_record, contig);
+    set_pos(hts_record, record.pos() - 1);
+    set_id(hts_record, record.id());
+    set_alleles(header_.get(), hts_record, record.ref(), record.alt());
+    if (record.qual()) {
+        set_qual(hts_record, *record.qual());
+    }
+    set_filter(header_.get(), hts_record, record.filter());
+    set_typed_info(header_.get(), hts_record, record);
+    if (record.num_samples() > 0) {
+        set_typed_samples(header_.get(), hts_record, record, samples_);
+    }
+    if (bcf_write(file_.get(), header_.get(), hts_record) < 0) {
+        throw std::runtime_error {"HtslibBcfFacade: record write failed"};
+    }
+    bcf_destroy(hts_record);
+}
+
 // HtslibBcfFacade::RecordIterator
 
 HtslibBcfFacade::RecordIterator::RecordIterator(const HtslibBcfFacade& facade)
@@ -448,7 +547,7 @@ HtslibBcfFacade::RecordIterator::RecordIterator(const HtslibBcfFacade& facade)
 
 HtslibBcfFacade::RecordIterator::RecordIterator(const HtslibBcfFacade& facade,
                                                 HtsBcfSrPtr hts_iterator,
-                                                UnpackPolicy level)
+                                                const UnpackMask& level)
 : facade_ {facade}
 , hts_iterator_ {std::move(hts_iterator)}
 , level_ {level}
@@ -595,7 +694,8 @@ void set_filter(const bcf_hdr_t* header, bcf1_t* record, const std::vector<std::
     }
 }
 
-void extract_info(const bcf_hdr_t* header, bcf1_t* record, VcfRecord::Builder& builder)
+void extract_info(const bcf_hdr_t* header, bcf1_t* record, const IVcfReaderImpl::UnpackMask& mask,
+                  VcfRecord::Builder& builder)
 {
     int* intinfo {nullptr};
     float* floatinfo {nullptr};
@@ -609,6 +709,7 @@ void extract_info(const bcf_hdr_t* header, bcf1_t* record, VcfRecord::Builder& b
             throw std::runtime_error {"HtslibBcfFacade: found INFO key not present in header file"};
         }
         const char* key {header->id[BCF_DT_ID][key_id].key};
+        if (!mask.unpacks_info(key)) continue;
         std::vector<std::string> values {};
         switch (bcf_hdr_id2type(header, BCF_HL_INFO, key_id)) {
             case BCF_HT_INT: {
@@ -706,7 +807,7 @@ bool has_samples(const bcf_hdr_t* header)
     return bcf_hdr_nsamples(header) > 0;
 }
 
-auto extract_format(const bcf_hdr_t* header, const bcf1_t* record)
+auto extract_format(const bcf_hdr_t* header, const bcf1_t* record, const IVcfReaderImpl::UnpackMask& mask)
 {
     std::vector<VcfRecord::KeyType> result {};
     result.reserve(record->n_fmt);
@@ -715,14 +816,17 @@ auto extract_format(const bcf_hdr_t* header, const bcf1_t* record)
         if (key_id >= header->n[BCF_DT_ID]) {
             throw std::runtime_error {"HtslibBcfFacade: found FORMAT key not present in header file"};
         }
-        result.emplace_back(header->id[BCF_DT_ID][key_id].key);
+        const char* key {header->id[BCF_DT_ID][key_id].key};
+        if (mask.unpacks_format(key)) result.emplace_back(key);
     }
     return result;
 }
 
-void extract_samples(const bcf_hdr_t* header, bcf1_t* record, VcfRecord::Builder& builder)
+void extract_samples(const bcf_hdr_t* header, bcf1_t* record, const IVcfReaderImpl::UnpackMask& mask,
+                     VcfRecord::Builder& builder)
 {
-    auto format = extract_format(header, record);
+    auto format = extract_format(header, record, mask);
+    if (format.empty()) return;
     const auto num_samples = record->n_sample;
     builder.reserve_samples(num_samples);
     auto first_format = std::cbegin(format);
@@ -953,6 +1057,249 @@ void set_samples(const bcf_hdr_t* header, bcf1_t* dest, const VcfRecord& source,
     });
 }
 
+// TypedVcfRecord values use the htslib sentinels so can be copied without translation
+static_assert(TypedVcfRecord::missingInt == bcf_int32_missing, "");
+static_assert(TypedVcfRecord::intVectorEnd == bcf_int32_vector_end, "");
+
+// Reusable htslib decode buffers, so a batch of records only pays for allocation once
+struct HtsValueBuffers
+{
+    HtsValueBuffers() = default;
+    HtsValueBuffers(const HtsValueBuffers&)            = delete;
+    HtsValueBuffers& operator=(const HtsValueBuffers&) = delete;
+    
+    ~HtsValueBuffers()
+    {
+        if (ints != nullptr) std::free(ints);
+        if (floats != nullptr) std::free(floats);
+        if (chars != nullptr) std::free(chars);
+        if (strings != nullptr) {
+            // bcf_get_format_string allocates two arrays
+            std::free(strings[0]);
+            std::free(strings);
+        }
+    }
+    
+    int* ints = nullptr;
+    float* floats = nullptr;
+    char* chars = nullptr;
+    char** strings = nullptr;
+    int nints = 0, nfloats = 0, nchars = 0, nstrings = 0;
+};
+
+void extract_typed_info(const bcf_hdr_t* header, bcf1_t* record, TypedVcfRecord& result, HtsValueBuffers& buffers)
+{
+    const auto& schema = result.schema();
+    for (unsigned i {0}; i < record->n_info; ++i) {
+        const auto key_id = record->d.info[i].key;
+        if (key_id >= header->n[BCF_DT_ID]) {
+            throw std::runtime_error {"HtslibBcfFacade: found INFO key not present in header file"};
+        }
+        const char* key {header->id[BCF_DT_ID][key_id].key};
+        const auto field = schema.info_index(key);
+        if (!field) {
+            throw std::runtime_error {"HtslibBcfFacade: found INFO key not present in record schema"};
+        }
+        switch (bcf_hdr_id2type(header, BCF_HL_INFO, key_id)) {
+            case BCF_HT_INT: {
+                const auto n = bcf_get_info_int32(header, record, key, &buffers.ints, &buffers.nints);
+                result.set_info(*field, buffers.ints, n > 0 ? n : 0);
+                break;
+            }
+            case BCF_HT_REAL: {
+                const auto n = bcf_get_info_float(header, record, key, &buffers.floats, &buffers.nfloats);
+                result.set_info(*field, buffers.floats, n > 0 ? n : 0);
+                break;
+            }
+            case BCF_HT_STR: {
+                const auto nchars = bcf_get_info_string(header, record, key, &buffers.chars, &buffers.nchars);
+                if (nchars > 0) {
+                    result.set_info(*field, utils::split(std::string(buffers.chars, nchars), vcfspec::info::valueSeperator));
+                } else {
+                    result.set_info(*field, std::vector<std::string> {});
+                }
+                break;
+            }
+            case BCF_HT_FLAG: {
+                result.set_info_flag(*field, bcf_get_info_flag(header, record, key, nullptr, nullptr) == 1);
+                break;
+            }
+        }
+    }
+}
+
+void extract_typed_genotypes(const bcf_hdr_t* header, bcf1_t* record, TypedVcfRecord& result, HtsValueBuffers& buffers)
+{
+    const auto num_samples = static_cast<unsigned>(record->n_sample);
+    const auto n = bcf_get_genotypes(header, record, &buffers.ints, &buffers.nints);
+    if (n <= 0 || num_samples == 0) return;
+    const auto max_ploidy = static_cast<unsigned>(n) / num_samples;
+    std::vector<std::int32_t> genotypes(n);
+    std::vector<bool> phasing(num_samples);
+    for (unsigned sample {0}, i {0}; sample < num_samples; ++sample) {
+        for (unsigned p {0}; p < max_ploidy; ++p, ++i) {
+            const auto g = buffers.ints[i];
+            if (g == bcf_int32_vector_end) {
+                genotypes[i] = TypedVcfRecord::intVectorEnd;
+            } else if (bcf_gt_is_missing(g)) {
+                genotypes[i] = TypedVcfRecord::missingInt;
+            } else {
+                const auto idx = bcf_gt_allele(g);
+                genotypes[i] = idx >= 0 && idx < record->n_allele ? idx : TypedVcfRecord::missingInt;
+            }
+            if (p > 0 && g != bcf_int32_vector_end) phasing[sample] = bcf_gt_is_phased(g);
+        }
+    }
+    result.set_genotypes(std::move(genotypes), max_ploidy, std::move(phasing));
+}
+
+void extract_typed_samples(const bcf_hdr_t* header, bcf1_t* record, TypedVcfRecord& result, HtsValueBuffers& buffers)
+{
+    const auto& schema = result.schema();
+    const auto num_samples = static_cast<unsigned>(record->n_sample);
+    if (num_samples != schema.num_samples()) {
+        throw std::runtime_error {"HtslibBcfFacade: record schema samples do not match header samples"};
+    }
+    for (unsigned i {0}; i < record->n_fmt; ++i) {
+        const auto key_id = record->d.fmt[i].id;
+        if (key_id >= header->n[BCF_DT_ID]) {
+            throw std::runtime_error {"HtslibBcfFacade: found FORMAT key not present in header file"};
+        }
+        const char* key {header->id[BCF_DT_ID][key_id].key};
+        if (std::strcmp(key, vcfspec::format::genotype) == 0) {
+            extract_typed_genotypes(header, record, result, buffers);
+            continue;
+        }
+        const auto field = schema.format_index(key);
+        if (!field) {
+            throw std::runtime_error {"HtslibBcfFacade: found FORMAT key not present in record schema"};
+        }
+        switch (bcf_hdr_id2type(header, BCF_HL_FMT, key_id)) {
+            case BCF_HT_INT: {
+                const auto n = bcf_get_format_int32(header, record, key, &buffers.ints, &buffers.nints);
+                if (n > 0) result.set_format(*field, buffers.ints, static_cast<unsigned>(n) / num_samples);
+                break;
+            }
+            case BCF_HT_REAL: {
+                const auto n = bcf_get_format_float(header, record, key, &buffers.floats, &buffers.nfloats);
+                if (n > 0) result.set_format(*field, buffers.floats, static_cast<unsigned>(n) / num_samples);
+                break;
+            }
+            case BCF_HT_STR: {
+                if (bcf_get_format_string(header, record, key, &buffers.strings, &buffers.nstrings) > 0) {
+                    result.set_format(*field, std::vector<std::string> {buffers.strings, buffers.strings + num_samples});
+                }
+                break;
+            }
+        }
+    }
+}
+
+TypedVcfRecord extract_typed_record(const bcf_hdr_t* header, bcf1_t* record, const HtslibBcfFacade::SchemaPtr& schema,
+                                    HtsValueBuffers& buffers)
+{
+    std::vector<TypedVcfRecord::NucleotideSequence> alt {};
+    alt.reserve(record->n_allele - 1);
+    for (unsigned i {1}; i < record->n_allele; ++i) {
+        alt.emplace_back(record->d.allele[i]);
+    }
+    std::vector<TypedVcfRecord::KeyType> filter {};
+    filter.reserve(record->d.n_flt);
+    for (decltype(record->d.n_flt) i {0}; i < record->d.n_flt; ++i) {
+        filter.emplace_back(bcf_hdr_int2id(header, BCF_DT_ID, record->d.flt[i]));
+    }
+    boost::optional<TypedVcfRecord::QualityType> qual {};
+    if (!std::isnan(record->qual)) qual = record->qual;
+    TypedVcfRecord result {schema, bcf_hdr_id2name(header, record->rid), static_cast<GenomicRegion::Position>(record->pos + 1),
+                           record->d.id, record->d.allele[0], std::move(alt), qual, std::move(filter)};
+    extract_typed_info(header, record, result, buffers);
+    if (has_samples(header)) {
+        extract_typed_samples(header, record, result, buffers);
+    }
+    return result;
+}
+
+void set_typed_info(const bcf_hdr_t* header, bcf1_t* dest, const TypedVcfRecord& source)
+{
+    const auto& schema = source.schema();
+    for (const auto field : source.info_fields()) {
+        const auto& info = schema.info_field(field);
+        const auto key = info.key.c_str();
+        switch (info.type) {
+            case VcfRecordSchema::ValueType::integer: {
+                const auto values = source.info_ints(field);
+                bcf_update_info_int32(header, dest, key, values.begin(), static_cast<int>(values.size()));
+                break;
+            }
+            case VcfRecordSchema::ValueType::floating: {
+                const auto values = source.info_floats(field);
+                bcf_update_info_float(header, dest, key, values.begin(), static_cast<int>(values.size()));
+                break;
+            }
+            case VcfRecordSchema::ValueType::flag:
+                bcf_update_info_flag(header, dest, key, "", source.info_flag(field));
+                break;
+            case VcfRecordSchema::ValueType::string: {
+                const auto values = source.info_strings(field);
+                const auto vals = utils::join(std::vector<std::string> {values.begin(), values.end()}, vcfspec::info::valueSeperator);
+                bcf_update_info_string(header, dest, key, vals.c_str());
+                break;
+            }
+        }
+    }
+}
+
+void set_typed_samples(const bcf_hdr_t* header, bcf1_t* dest, const TypedVcfRecord& source,
+                       const std::vector<std::string>& samples)
+{
+    const auto& schema = source.schema();
+    if (schema.samples() != samples) {
+        throw std::runtime_error {"HtslibBcfFacade: record schema samples do not match header samples"};
+    }
+    const auto num_samples = static_cast<int>(samples.size());
+    if (source.has_genotypes()) {
+        const auto& alleles = source.genotypes_data();
+        const auto max_ploidy = source.max_ploidy();
+        bc::small_vector<int, 1'000> genotypes(alleles.size());
+        for (unsigned sample {0}, i {0}; sample < samples.size(); ++sample) {
+            const bool is_phased {source.is_sample_phased(sample)};
+            for (unsigned p {0}; p < max_ploidy; ++p, ++i) {
+                const auto allele = alleles[i];
+                if (TypedVcfRecord::is_vector_end(allele)) {
+                    genotypes[i] = bcf_int32_vector_end;
+                } else if (TypedVcfRecord::is_missing(allele)) {
+                    genotypes[i] = is_phased ? bcf_gt_missing + 1 : bcf_gt_missing;
+                } else {
+                    genotypes[i] = is_phased ? bcf_gt_phased(allele) : bcf_gt_unphased(allele);
+                }
+            }
+        }
+        bcf_update_genotypes(header, dest, genotypes.data(), static_cast<int>(genotypes.size()));
+    }
+    std::vector<const char*> strings {};
+    for (const auto field : source.format_fields()) {
+        const auto& format = schema.format_field(field);
+        const auto key = format.key.c_str();
+        const auto num_values = static_cast<int>(source.format_stride(field)) * num_samples;
+        switch (format.type) {
+            case VcfRecordSchema::ValueType::integer:
+                bcf_update_format_int32(header, dest, key, source.format_ints_data(field), num_values);
+                break;
+            case VcfRecordSchema::ValueType::floating:
+                bcf_update_format_float(header, dest, key, source.format_floats_data(field), num_values);
+                break;
+            case VcfRecordSchema::ValueType::flag:
+            case VcfRecordSchema::ValueType::string:
+                strings.resize(samples.size());
+                for (unsigned sample {0}; sample < samples.size(); ++sample) {
+                    strings[sample] = source.format_string(field, sample).c_str();
+                }
+                bcf_update_format_string(header, dest, key, strings.data(), num_samples);
+                break;
+        }
+    }
+}
+
 bool HtslibBcfFacade::is_bcf() const noexcept
 {
     assert(file_);
@@ -966,10 +1313,14 @@ std::size_t HtslibBcfFacade::count_records(HtsBcfSrPtr& sr) const
     return result;
 }
 
-VcfRecord HtslibBcfFacade::fetch_record(const bcf_srs_t* sr, UnpackPolicy level) const
+VcfRecord HtslibBcfFacade::fetch_record(const bcf_srs_t* sr, const UnpackMask& level) const
 {
     auto hts_record = bcf_sr_get_line(sr, 0);
-    bcf_unpack(hts_record, level == UnpackPolicy::all ? BCF_UN_ALL : BCF_UN_SHR);
+    const bool unpack_samples {level.unpacks_samples() && has_samples(header_.get())};
+    int which {BCF_UN_STR | BCF_UN_FLT};
+    if (level.unpacks_info()) which |= BCF_UN_INFO;
+    if (unpack_samples) which |= BCF_UN_FMT; // only the FORMAT keys in level are converted below
+    bcf_unpack(hts_record, which);
     VcfRecord::Builder record_builder {};
     extract_chrom(header_.get(), hts_record, record_builder);
     extract_pos(hts_record, record_builder);
@@ -978,15 +1329,17 @@ VcfRecord HtslibBcfFacade::fetch_record(const bcf_srs_t* sr, UnpackPolicy level)
     extract_alt(hts_record, record_builder);
     extract_qual(hts_record, record_builder);
     extract_filter(header_.get(), hts_record, record_builder);
-    extract_info(header_.get(), hts_record, record_builder);
-    if (level == UnpackPolicy::all && has_samples(header_.get())) {
-        extract_samples(header_.get(), hts_record, record_builder);
+    if (level.unpacks_info()) {
+        extract_info(header_.get(), hts_record, level, record_builder);
+    }
+    if (unpack_samples) {
+        extract_samples(header_.get(), hts_record, level, record_builder);
     }
     return record_builder.build_once();
 }
 
 HtslibBcfFacade::RecordContainer
-HtslibBcfFacade::fetch_records(bcf_srs_t* sr, const UnpackPolicy level, const std::size_t num_records) const
+HtslibBcfFacade::fetch_records(bcf_srs_t* sr, const UnpackMask& level, const std::size_t num_records) const
 {
     RecordContainer result {};
     result.reserve(num_records);
@@ -996,4 +1349,18 @@ HtslibBcfFacade::fetch_records(bcf_srs_t* sr, const UnpackPolicy level, const st
     return result;
 }
 
+HtslibBcfFacade::TypedRecordContainer
+HtslibBcfFacade::fetch_typed_records(bcf_srs_t* sr, const SchemaPtr& schema, const std::size_t num_records) const
+{
+    TypedRecordContainer result {};
+    result.reserve(num_records);
+    HtsValueBuffers buffers {};
+    while (bcf_sr_next_line(sr)) {
+        auto hts_record = bcf_sr_get_line(sr, 0);
+        bcf_unpack(hts_record, BCF_UN_ALL);
+        result.push_back(extract_typed_record(header_.get(), hts_record, schema, buffers));
+    }
+    return result;
+}
+
 } // namespace octopus
@@ -16,8 +16,10 @@
 #include "htslib/vcf.h"
 #include "htslib/synced_bcf_reader.h"
 
+#include "io/htslib_thread_pool.hpp"
 #include "vcf_reader_impl.hpp"
 #include "vcf_record.hpp"
+#include "typed_vcf_record.hpp"
 
 namespace octopus {
 
@@ -29,7 +31,10 @@ class HtslibBcfFacade : public IVcfReaderImpl
 public:
     using Path = boost::filesystem::path;
     using IVcfReaderImpl::UnpackPolicy;
+    using IVcfReaderImpl::UnpackMask;
     using IVcfReaderImpl::RecordContainer;
+    using IVcfReaderImpl::TypedRecordContainer;
+    using IVcfReaderImpl::SchemaPtr;
     using IVcfReaderImpl::RecordIteratorPtrPair;
     class RecordIterator;
     
@@ -53,16 +58,21 @@ public:
     std::size_t count_records(const std::string& contig) const override;
     std::size_t count_records(const GenomicRegion& region) const override;
     
-    RecordIteratorPtrPair iterate(UnpackPolicy level) const override;
-    RecordIteratorPtrPair iterate(const std::string& contig, UnpackPolicy level) const override;
-    RecordIteratorPtrPair iterate(const GenomicRegion& region, UnpackPolicy level) const override;
+    RecordIteratorPtrPair iterate(const UnpackMask& level) const override;
+    RecordIteratorPtrPair iterate(const std::string& contig, const UnpackMask& level) const override;
+    RecordIteratorPtrPair iterate(const GenomicRegion& region, const UnpackMask& level) const override;
     
-    RecordContainer fetch_records(UnpackPolicy level) const override;
-    RecordContainer fetch_records(const std::string& contig, UnpackPolicy level) const override;
-    RecordContainer fetch_records(const GenomicRegion& region, UnpackPolicy level) const override;
+    RecordContainer fetch_records(const UnpackMask& level) const override;
+    RecordContainer fetch_records(const std::string& contig, const UnpackMask& level) const override;
+    RecordContainer fetch_records(const GenomicRegion& region, const UnpackMask& level) const override;
+    
+    TypedRecordContainer fetch_typed_records(const SchemaPtr& schema) const override;
+    TypedRecordContainer fetch_typed_records(const std::string& contig, const SchemaPtr& schema) const override;
+    TypedRecordContainer fetch_typed_records(const GenomicRegion& region, const SchemaPtr& schema) const override;
     
     void write(const VcfHeader& header);
     void write(const VcfRecord& record);
+    void write(const TypedVcfRecord& record);
     
 private:
     struct HtsFileDeleter
@@ -86,14 +96,16 @@ private:
     using HtsBcf1Ptr  = std::unique_ptr<bcf1_t, HtsBcf1Deleter>;
     
     Path file_path_;
+    std::shared_ptr<io::HtslibThreadPool> thread_pool_; // must outlive file_
     std::unique_ptr<htsFile, HtsFileDeleter> file_;
     std::unique_ptr<bcf_hdr_t, HtsHeaderDeleter> header_;
     std::vector<std::string> samples_;
     
     bool is_bcf() const noexcept;
     std::size_t count_records(HtsBcfSrPtr& sr) const;
-    VcfRecord fetch_record(const bcf_srs_t* sr, UnpackPolicy level) const;
-    RecordContainer fetch_records(bcf_srs_t*, UnpackPolicy level, size_t num_records) const;
+    VcfRecord fetch_record(const bcf_srs_t* sr, const UnpackMask& level) const;
+    RecordContainer fetch_records(bcf_srs_t*, const UnpackMask& level, size_t num_records) const;
+    TypedRecordContainer fetch_typed_records(bcf_srs_t*, const SchemaPtr& schema, size_t num_records) const;
     
     friend RecordIterator;
 };
@@ -108,7 +120,7 @@ public:
     using reference         = const VcfRecord&;
     
     RecordIterator(const HtslibBcfFacade& facade);
-    RecordIterator(const HtslibBcfFacade& facade, HtsBcfSrPtr hts_iterator, UnpackPolicy level);
+    RecordIterator(const HtslibBcfFacade& facade, HtsBcfSrPtr hts_iterator, const UnpackMask& level);
     
     RecordIterator(const RecordIterator&)            = default;
     RecordIterator& operator=(const RecordIterator&) = default;
@@ -136,7 +148,7 @@ private:
     std::reference_wrapper<const HtslibBcfFacade> facade_;
     
     HtsBcfSrSharedPtr hts_iterator_;
-    UnpackPolicy level_;
+    UnpackMask level_;
     
     std::shared_ptr<VcfRecord> record_;
 };
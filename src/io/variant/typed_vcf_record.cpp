@@ -0,0 +1,740 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "typed_vcf_record.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+#include <stdexcept>
+#include <cstring>
+#include <cassert>
+#include <utility>
+
+#include "utils/string_utils.hpp"
+#include "vcf_spec.hpp"
+#include "vcf_header.hpp"
+
+namespace octopus {
+
+// VcfRecordSchema
+
+namespace {
+
+auto to_value_type(const std::string& type)
+{
+    using namespace vcfspec::header::meta;
+    using ValueType = VcfRecordSchema::ValueType;
+    if (type == type::integer) return ValueType::integer;
+    if (type == type::floating) return ValueType::floating;
+    if (type == type::flag) return ValueType::flag;
+    return ValueType::string;
+}
+
+boost::optional<unsigned> to_fixed_number(const std::string& number)
+{
+    if (!number.empty() && std::all_of(std::cbegin(number), std::cend(number), [] (char c) { return std::isdigit(c); })) {
+        return static_cast<unsigned>(std::stoul(number));
+    }
+    return boost::none;
+}
+
+template <typename Fields, typename IndexMap>
+void index_fields(const VcfHeader& header, const VcfHeader::Tag& tag, Fields& fields, IndexMap& indices)
+{
+    using namespace vcfspec::header::meta;
+    for (const auto& field : header.structured_fields(tag)) {
+        const auto id_itr = field.find(struc::id);
+        if (id_itr == std::cend(field)) continue;
+        const auto type_itr = field.find(struc::type);
+        const auto number_itr = field.find(struc::number);
+        VcfRecordSchema::Field typed_field {
+            id_itr->second,
+            type_itr != std::cend(field) ? to_value_type(type_itr->second) : VcfRecordSchema::ValueType::string,
+            number_itr != std::cend(field) ? to_fixed_number(number_itr->second) : boost::none
+        };
+        if (indices.emplace(typed_field.key, static_cast<VcfRecordSchema::FieldIndex>(fields.size())).second) {
+            fields.push_back(std::move(typed_field));
+        }
+    }
+}
+
+} // namespace
+
+VcfRecordSchema::VcfRecordSchema(const VcfHeader& header)
+: samples_ {header.samples()}
+, info_ {}
+, format_ {}
+, info_indices_ {}
+, format_indices_ {}
+{
+    using namespace vcfspec::header::meta;
+    index_fields(header, tag::info, info_, info_indices_);
+    index_fields(header, tag::format, format_, format_indices_);
+}
+
+const std::vector<std::string>& VcfRecordSchema::samples() const noexcept
+{
+    return samples_;
+}
+
+unsigned VcfRecordSchema::num_samples() const noexcept
+{
+    return static_cast<unsigned>(samples_.size());
+}
+
+boost::optional<unsigned> VcfRecordSchema::sample_index(const std::string& sample) const noexcept
+{
+    const auto itr = std::find(std::cbegin(samples_), std::cend(samples_), sample);
+    if (itr != std::cend(samples_)) {
+        return static_cast<unsigned>(std::distance(std::cbegin(samples_), itr));
+    }
+    return boost::none;
+}
+
+std::size_t VcfRecordSchema::num_info_fields() const noexcept
+{
+    return info_.size();
+}
+
+boost::optional<VcfRecordSchema::FieldIndex> VcfRecordSchema::info_index(const std::string& key) const noexcept
+{
+    const auto itr = info_indices_.find(key);
+    if (itr != std::cend(info_indices_)) return itr->second;
+    return boost::none;
+}
+
+const VcfRecordSchema::Field& VcfRecordSchema::info_field(const FieldIndex index) const noexcept
+{
+    assert(index < info_.size());
+    return info_[index];
+}
+
+std::size_t VcfRecordSchema::num_format_fields() const noexcept
+{
+    return format_.size();
+}
+
+boost::optional<VcfRecordSchema::FieldIndex> VcfRecordSchema::format_index(const std::string& key) const noexcept
+{
+    const auto itr = format_indices_.find(key);
+    if (itr != std::cend(format_indices_)) return itr->second;
+    return boost::none;
+}
+
+const VcfRecordSchema::Field& VcfRecordSchema::format_field(const FieldIndex index) const noexcept
+{
+    assert(index < format_.size());
+    return format_[index];
+}
+
+// TypedVcfRecord
+
+constexpr std::int32_t TypedVcfRecord::missingInt;
+constexpr std::int32_t TypedVcfRecord::intVectorEnd;
+
+namespace {
+
+// Same bit patterns htslib uses for bcf_float_missing and bcf_float_vector_end
+constexpr std::uint32_t floatMissingBits   {0x7F800001};
+constexpr std::uint32_t floatVectorEndBits {0x7F800002};
+
+float make_float(const std::uint32_t bits) noexcept
+{
+    float result;
+    std::memcpy(&result, &bits, sizeof(float));
+    return result;
+}
+
+std::uint32_t get_bits(const float value) noexcept
+{
+    std::uint32_t result;
+    std::memcpy(&result, &value, sizeof(float));
+    return result;
+}
+
+} // namespace
+
+float TypedVcfRecord::missing_float() noexcept
+{
+    return make_float(floatMissingBits);
+}
+
+float TypedVcfRecord::float_vector_end() noexcept
+{
+    return make_float(floatVectorEndBits);
+}
+
+bool TypedVcfRecord::is_missing(const float value) noexcept
+{
+    return get_bits(value) == floatMissingBits;
+}
+
+bool TypedVcfRecord::is_vector_end(const float value) noexcept
+{
+    return get_bits(value) == floatVectorEndBits;
+}
+
+TypedVcfRecord::TypedVcfRecord(SchemaPtr schema, GenomicRegion::ContigName chrom, GenomicRegion::Position pos,
+                               std::string id, NucleotideSequence ref, std::vector<NucleotideSequence> alt,
+                               boost::optional<QualityType> qual, std::vector<KeyType> filter)
+: schema_ {std::move(schema)}
+, region_ {std::move(chrom), pos - 1, pos + static_cast<GenomicRegion::Position>(ref.size()) - 1}
+, id_ {std::move(id)}
+, ref_ {std::move(ref)}
+, alt_ {std::move(alt)}
+, qual_ {qual}
+, filter_ {std::move(filter)}
+{}
+
+const VcfRecordSchema& TypedVcfRecord::schema() const noexcept
+{
+    assert(schema_);
+    return *schema_;
+}
+
+const TypedVcfRecord::SchemaPtr& TypedVcfRecord::schema_ptr() const noexcept
+{
+    return schema_;
+}
+
+const GenomicRegion& TypedVcfRecord::mapped_region() const noexcept
+{
+    return region_;
+}
+
+const GenomicRegion::ContigName& TypedVcfRecord::chrom() const noexcept
+{
+    return region_.contig_name();
+}
+
+GenomicRegion::Position TypedVcfRecord::pos() const noexcept
+{
+    return region_.begin() + 1;
+}
+
+const std::string& TypedVcfRecord::id() const noexcept
+{
+    return id_;
+}
+
+const TypedVcfRecord::NucleotideSequence& TypedVcfRecord::ref() const noexcept
+{
+    return ref_;
+}
+
+const std::vector<TypedVcfRecord::NucleotideSequence>& TypedVcfRecord::alt() const noexcept
+{
+    return alt_;
+}
+
+boost::optional<TypedVcfRecord::QualityType> TypedVcfRecord::qual() const noexcept
+{
+    return qual_;
+}
+
+const std::vector<TypedVcfRecord::KeyType>& TypedVcfRecord::filter() const noexcept
+{
+    return filter_;
+}
+
+std::vector<TypedVcfRecord::FieldIndex> TypedVcfRecord::info_fields() const
+{
+    std::vector<FieldIndex> result(info_.size());
+    std::transform(std::cbegin(info_), std::cend(info_), std::begin(result), [] (const Slot& slot) { return slot.field; });
+    return result;
+}
+
+bool TypedVcfRecord::has_info(const FieldIndex field) const noexcept
+{
+    return find(info_, field) != nullptr;
+}
+
+bool TypedVcfRecord::has_info(const KeyType& key) const noexcept
+{
+    const auto field = schema().info_index(key);
+    return field && has_info(*field);
+}
+
+TypedVcfRecord::ValueRange<std::int32_t> TypedVcfRecord::info_ints(const FieldIndex field) const noexcept
+{
+    const auto slot = find(info_, field);
+    if (slot == nullptr) return {};
+    assert(schema().info_field(field).type == ValueType::integer);
+    const auto first = ints_.data() + slot->offset;
+    return {first, first + slot->count};
+}
+
+TypedVcfRecord::ValueRange<float> TypedVcfRecord::info_floats(const FieldIndex field) const noexcept
+{
+    const auto slot = find(info_, field);
+    if (slot == nullptr) return {};
+    assert(schema().info_field(field).type == ValueType::floating);
+    const auto first = floats_.data() + slot->offset;
+    return {first, first + slot->count};
+}
+
+TypedVcfRecord::ValueRange<std::string> TypedVcfRecord::info_strings(const FieldIndex field) const noexcept
+{
+    const auto slot = find(info_, field);
+    if (slot == nullptr) return {};
+    assert(schema().info_field(field).type == ValueType::string);
+    const auto first = strings_.data() + slot->offset;
+    return {first, first + slot->count};
+}
+
+bool TypedVcfRecord::info_flag(const FieldIndex field) const noexcept
+{
+    const auto slot = find(info_, field);
+    return slot != nullptr && ints_[slot->offset] != 0;
+}
+
+void TypedVcfRecord::set_info(const FieldIndex field, const std::int32_t* values, const std::size_t n)
+{
+    auto& slot = assign(info_, field);
+    slot.offset = static_cast<std::uint32_t>(ints_.size());
+    slot.count  = static_cast<std::uint32_t>(n);
+    ints_.insert(std::cend(ints_), values, values + n);
+}
+
+void TypedVcfRecord::set_info(const FieldIndex field, const float* values, const std::size_t n)
+{
+    auto& slot = assign(info_, field);
+    slot.offset = static_cast<std::uint32_t>(floats_.size());
+    slot.count  = static_cast<std::uint32_t>(n);
+    floats_.insert(std::cend(floats_), values, values + n);
+}
+
+void TypedVcfRecord::set_info(const FieldIndex field, std::vector<std::string> values)
+{
+    auto& slot = assign(info_, field);
+    slot.offset = static_cast<std::uint32_t>(strings_.size());
+    slot.count  = static_cast<std::uint32_t>(values.size());
+    strings_.insert(std::cend(strings_), std::make_move_iterator(std::begin(values)), std::make_move_iterator(std::end(values)));
+}
+
+void TypedVcfRecord::set_info_flag(const FieldIndex field, const bool value)
+{
+    const std::int32_t flag {value};
+    set_info(field, &flag, 1);
+}
+
+unsigned TypedVcfRecord::num_samples() const noexcept
+{
+    return schema_ ? schema_->num_samples() : 0;
+}
+
+std::vector<TypedVcfRecord::FieldIndex> TypedVcfRecord::format_fields() const
+{
+    std::vector<FieldIndex> result(format_.size());
+    std::transform(std::cbegin(format_), std::cend(format_), std::begin(result), [] (const Slot& slot) { return slot.field; });
+    return result;
+}
+
+bool TypedVcfRecord::has_format(const FieldIndex field) const noexcept
+{
+    return find(format_, field) != nullptr;
+}
+
+bool TypedVcfRecord::has_format(const KeyType& key) const noexcept
+{
+    if (key == vcfspec::format::genotype) return has_genotypes();
+    const auto field = schema().format_index(key);
+    return field && has_format(*field);
+}
+
+unsigned TypedVcfRecord::format_stride(const FieldIndex field) const noexcept
+{
+    const auto slot = find(format_, field);
+    return slot != nullptr ? slot->count : 0;
+}
+
+TypedVcfRecord::ValueRange<std::int32_t> TypedVcfRecord::format_ints(const FieldIndex field, const unsigned sample) const noexcept
+{
+    const auto slot = find(format_, field);
+    if (slot == nullptr) return {};
+    assert(schema().format_field(field).type == ValueType::integer);
+    const auto first = ints_.data() + slot->offset + sample * slot->count;
+    return {first, std::find(first, first + slot->count, intVectorEnd)};
+}
+
+TypedVcfRecord::ValueRange<float> TypedVcfRecord::format_floats(const FieldIndex field, const unsigned sample) const noexcept
+{
+    const auto slot = find(format_, field);
+    if (slot == nullptr) return {};
+    assert(schema().format_field(field).type == ValueType::floating);
+    const auto first = floats_.data() + slot->offset + sample * slot->count;
+    return {first, std::find_if(first, first + slot->count, [] (float v) { return is_vector_end(v); })};
+}
+
+const std::string& TypedVcfRecord::format_string(const FieldIndex field, const unsigned sample) const noexcept
+{
+    static const std::string missing {vcfspec::missingValue};
+    const auto slot = find(format_, field);
+    if (slot == nullptr) return missing;
+    assert(schema().format_field(field).type == ValueType::string);
+    return strings_[slot->offset + sample];
+}
+
+void TypedVcfRecord::set_format(const FieldIndex field, const std::int32_t* values, const unsigned stride)
+{
+    auto& slot = assign(format_, field);
+    slot.offset = static_cast<std::uint32_t>(ints_.size());
+    slot.count  = stride;
+    ints_.insert(std::cend(ints_), values, values + num_samples() * stride);
+}
+
+void TypedVcfRecord::set_format(const FieldIndex field, const float* values, const unsigned stride)
+{
+    auto& slot = assign(format_, field);
+    slot.offset = static_cast<std::uint32_t>(floats_.size());
+    slot.count  = stride;
+    floats_.insert(std::cend(floats_), values, values + num_samples() * stride);
+}
+
+void TypedVcfRecord::set_format(const FieldIndex field, std::vector<std::string> values)
+{
+    assert(values.size() == num_samples());
+    auto& slot = assign(format_, field);
+    slot.offset = static_cast<std::uint32_t>(strings_.size());
+    slot.count  = 1;
+    strings_.insert(std::cend(strings_), std::make_move_iterator(std::begin(values)), std::make_move_iterator(std::end(values)));
+}
+
+bool TypedVcfRecord::has_genotypes() const noexcept
+{
+    return max_ploidy_ > 0;
+}
+
+unsigned TypedVcfRecord::max_ploidy() const noexcept
+{
+    return max_ploidy_;
+}
+
+unsigned TypedVcfRecord::ploidy(const unsigned sample) const noexcept
+{
+    return static_cast<unsigned>(genotype(sample).size());
+}
+
+TypedVcfRecord::ValueRange<std::int32_t> TypedVcfRecord::genotype(const unsigned sample) const noexcept
+{
+    if (!has_genotypes()) return {};
+    const auto first = genotypes_.data() + sample * max_ploidy_;
+    return {first, std::find(first, first + max_ploidy_, intVectorEnd)};
+}
+
+bool TypedVcfRecord::is_sample_phased(const unsigned sample) const noexcept
+{
+    return sample < phasing_.size() && phasing_[sample];
+}
+
+void TypedVcfRecord::set_genotypes(std::vector<std::int32_t> alleles, const unsigned max_ploidy, std::vector<bool> phasing)
+{
+    assert(alleles.size() == num_samples() * max_ploidy);
+    genotypes_  = std::move(alleles);
+    max_ploidy_ = max_ploidy;
+    phasing_    = std::move(phasing);
+}
+
+const std::int32_t* TypedVcfRecord::format_ints_data(const FieldIndex field) const noexcept
+{
+    const auto slot = find(format_, field);
+    return slot != nullptr ? ints_.data() + slot->offset : nullptr;
+}
+
+const float* TypedVcfRecord::format_floats_data(const FieldIndex field) const noexcept
+{
+    const auto slot = find(format_, field);
+    return slot != nullptr ? floats_.data() + slot->offset : nullptr;
+}
+
+const std::vector<std::int32_t>& TypedVcfRecord::genotypes_data() const noexcept
+{
+    return genotypes_;
+}
+
+// private methods
+
+const TypedVcfRecord::Slot* TypedVcfRecord::find(const SlotList& slots, const FieldIndex field) const noexcept
+{
+    // Records rarely carry more than a dozen fields so a linear scan beats anything fancier
+    const auto itr = std::find_if(std::cbegin(slots), std::cend(slots), [field] (const Slot& slot) { return slot.field == field; });
+    return itr != std::cend(slots) ? &(*itr) : nullptr;
+}
+
+TypedVcfRecord::Slot& TypedVcfRecord::assign(SlotList& slots, const FieldIndex field)
+{
+    const auto itr = std::find_if(std::begin(slots), std::end(slots), [field] (const Slot& slot) { return slot.field == field; });
+    if (itr != std::end(slots)) return *itr; // previous values are left unreferenced in the pool
+    slots.push_back({field, 0, 0});
+    return slots.back();
+}
+
+// non-member methods
+
+namespace {
+
+bool is_missing_value(const std::string& value) noexcept
+{
+    return value == vcfspec::missingValue;
+}
+
+std::int32_t parse_int(const std::string& value)
+{
+    return !is_missing_value(value) ? std::stoi(value) : TypedVcfRecord::missingInt;
+}
+
+float parse_float(const std::string& value)
+{
+    return !is_missing_value(value) ? std::stof(value) : TypedVcfRecord::missing_float();
+}
+
+std::string to_string(const std::int32_t value)
+{
+    return !TypedVcfRecord::is_missing(value) ? std::to_string(value) : vcfspec::missingValue;
+}
+
+std::string to_string(const float value)
+{
+    return !TypedVcfRecord::is_missing(value) ? std::to_string(value) : vcfspec::missingValue;
+}
+
+std::size_t max_format_cardinality(const VcfRecord& record, const VcfRecord::KeyType& key,
+                                   const std::vector<std::string>& samples)
+{
+    std::size_t result {0};
+    for (const auto& sample : samples) {
+        result = std::max(result, record.get_sample_value(sample, key).size());
+    }
+    return result;
+}
+
+void set_typed_info(const VcfRecord& source, TypedVcfRecord& dest)
+{
+    const auto& schema = dest.schema();
+    std::vector<std::int32_t> ints {};
+    std::vector<float> floats {};
+    for (const auto& key : source.info_keys()) {
+        const auto field = schema.info_index(key);
+        if (!field) {
+            throw std::runtime_error {"make_typed: INFO key \"" + key + "\" is not declared in the header"};
+        }
+        const auto& values = source.info_value(key);
+        switch (schema.info_field(*field).type) {
+            case VcfRecordSchema::ValueType::integer:
+                ints.resize(values.size());
+                std::transform(std::cbegin(values), std::cend(values), std::begin(ints), parse_int);
+                dest.set_info(*field, ints.data(), ints.size());
+                break;
+            case VcfRecordSchema::ValueType::floating:
+                floats.resize(values.size());
+                std::transform(std::cbegin(values), std::cend(values), std::begin(floats), parse_float);
+                dest.set_info(*field, floats.data(), floats.size());
+                break;
+            case VcfRecordSchema::ValueType::flag:
+                dest.set_info_flag(*field, values.empty() || values.front() == "1");
+                break;
+            case VcfRecordSchema::ValueType::string:
+                dest.set_info(*field, values);
+                break;
+        }
+    }
+}
+
+void set_typed_genotypes(const VcfRecord& source, TypedVcfRecord& dest)
+{
+    const auto& samples = dest.schema().samples();
+    std::vector<VcfRecord::NucleotideSequence> alleles {};
+    alleles.reserve(source.alt().size() + 1);
+    alleles.push_back(source.ref());
+    alleles.insert(std::cend(alleles), std::cbegin(source.alt()), std::cend(source.alt()));
+    unsigned max_ploidy {0};
+    for (const auto& sample : samples) {
+        max_ploidy = std::max(max_ploidy, source.ploidy(sample));
+    }
+    std::vector<std::int32_t> genotypes(samples.size() * max_ploidy, TypedVcfRecord::intVectorEnd);
+    std::vector<bool> phasing(samples.size());
+    auto genotype_itr = std::begin(genotypes);
+    for (std::size_t s {0}; s < samples.size(); ++s, genotype_itr += max_ploidy) {
+        const auto& genotype = source.get_sample_value(samples[s], vcfspec::format::genotype);
+        std::transform(std::cbegin(genotype), std::cend(genotype), genotype_itr,
+                       [&alleles] (const auto& allele) -> std::int32_t {
+                           if (is_missing_value(allele)) return TypedVcfRecord::missingInt;
+                           const auto itr = std::find(std::cbegin(alleles), std::cend(alleles), allele);
+                           if (itr == std::cend(alleles)) return TypedVcfRecord::missingInt;
+                           return static_cast<std::int32_t>(std::distance(std::cbegin(alleles), itr));
+                       });
+        phasing[s] = source.is_sample_phased(samples[s]);
+    }
+    dest.set_genotypes(std::move(genotypes), max_ploidy, std::move(phasing));
+}
+
+void set_typed_samples(const VcfRecord& source, TypedVcfRecord& dest)
+{
+    const auto& schema = dest.schema();
+    const auto& samples = schema.samples();
+    std::vector<std::int32_t> ints {};
+    std::vector<float> floats {};
+    std::vector<std::string> strings {};
+    for (const auto& key : source.format()) {
+        if (key == vcfspec::format::genotype) {
+            set_typed_genotypes(source, dest);
+            continue;
+        }
+        const auto field = schema.format_index(key);
+        if (!field) {
+            throw std::runtime_error {"make_typed: FORMAT key \"" + key + "\" is not declared in the header"};
+        }
+        const auto stride = max_format_cardinality(source, key, samples);
+        switch (schema.format_field(*field).type) {
+            case VcfRecordSchema::ValueType::integer:
+            {
+                ints.assign(samples.size() * stride, TypedVcfRecord::intVectorEnd);
+                auto value_itr = std::begin(ints);
+                for (const auto& sample : samples) {
+                    const auto& values = source.get_sample_value(sample, key);
+                    std::transform(std::cbegin(values), std::cend(values), value_itr, parse_int);
+                    value_itr += stride;
+                }
+                dest.set_format(*field, ints.data(), static_cast<unsigned>(stride));
+                break;
+            }
+            case VcfRecordSchema::ValueType::floating:
+            {
+                floats.assign(samples.size() * stride, TypedVcfRecord::float_vector_end());
+                auto value_itr = std::begin(floats);
+                for (const auto& sample : samples) {
+                    const auto& values = source.get_sample_value(sample, key);
+                    std::transform(std::cbegin(values), std::cend(values), value_itr, parse_float);
+                    value_itr += stride;
+                }
+                dest.set_format(*field, floats.data(), static_cast<unsigned>(stride));
+                break;
+            }
+            case VcfRecordSchema::ValueType::flag:
+            case VcfRecordSchema::ValueType::string:
+            {
+                strings.clear();
+                strings.reserve(samples.size());
+                for (const auto& sample : samples) {
+                    strings.push_back(utils::join(source.get_sample_value(sample, key), vcfspec::format::valueSeperator));
+                }
+                dest.set_format(*field, strings);
+                break;
+            }
+        }
+    }
+}
+
+template <typename T>
+std::vector<std::string> to_strings(const TypedVcfRecord::ValueRange<T>& values)
+{
+    std::vector<std::string> result(values.size());
+    std::transform(std::cbegin(values), std::cend(values), std::begin(result), [] (T value) { return to_string(value); });
+    return result;
+}
+
+void set_string_info(const TypedVcfRecord& source, VcfRecord::Builder& dest)
+{
+    const auto& schema = source.schema();
+    dest.reserve_info(source.info_fields().size());
+    for (const auto field : source.info_fields()) {
+        const auto& info = schema.info_field(field);
+        switch (info.type) {
+            case VcfRecordSchema::ValueType::integer:
+                dest.set_info(info.key, to_strings(source.info_ints(field)));
+                break;
+            case VcfRecordSchema::ValueType::floating:
+                dest.set_info(info.key, to_strings(source.info_floats(field)));
+                break;
+            case VcfRecordSchema::ValueType::flag:
+                if (source.info_flag(field)) {
+                    dest.set_info_flag(info.key);
+                } else {
+                    dest.set_info(info.key, std::string {"0"});
+                }
+                break;
+            case VcfRecordSchema::ValueType::string:
+            {
+                const auto values = source.info_strings(field);
+                dest.set_info(info.key, std::vector<std::string> {std::cbegin(values), std::cend(values)});
+                break;
+            }
+        }
+    }
+}
+
+void set_string_samples(const TypedVcfRecord& source, VcfRecord::Builder& dest)
+{
+    const auto& schema = source.schema();
+    const auto& samples = schema.samples();
+    const auto fields = source.format_fields();
+    std::vector<VcfRecord::KeyType> format {};
+    format.reserve(fields.size() + 1);
+    if (source.has_genotypes()) {
+        format.emplace_back(vcfspec::format::genotype);
+        std::vector<boost::optional<unsigned>> alleles {};
+        for (unsigned s {0}; s < samples.size(); ++s) {
+            const auto genotype = source.genotype(s);
+            alleles.resize(genotype.size());
+            std::transform(std::cbegin(genotype), std::cend(genotype), std::begin(alleles),
+                           [] (std::int32_t allele) -> boost::optional<unsigned> {
+                               if (TypedVcfRecord::is_missing(allele)) return boost::none;
+                               return static_cast<unsigned>(allele);
+                           });
+            using Phasing = VcfRecord::Builder::Phasing;
+            dest.set_genotype(samples[s], alleles, source.is_sample_phased(s) ? Phasing::phased : Phasing::unphased);
+        }
+    }
+    for (const auto field : fields) {
+        const auto& info = schema.format_field(field);
+        format.push_back(info.key);
+        for (unsigned s {0}; s < samples.size(); ++s) {
+            switch (info.type) {
+                case VcfRecordSchema::ValueType::integer:
+                    dest.set_format(samples[s], info.key, to_strings(source.format_ints(field, s)));
+                    break;
+                case VcfRecordSchema::ValueType::floating:
+                    dest.set_format(samples[s], info.key, to_strings(source.format_floats(field, s)));
+                    break;
+                case VcfRecordSchema::ValueType::flag:
+                case VcfRecordSchema::ValueType::string:
+                    dest.set_format(samples[s], info.key, std::vector<std::string> {source.format_string(field, s)});
+                    break;
+            }
+        }
+    }
+    dest.set_format(std::move(format));
+}
+
+} // namespace
+
+TypedVcfRecord make_typed(const VcfRecord& record, TypedVcfRecord::SchemaPtr schema)
+{
+    TypedVcfRecord result {std::move(schema), record.chrom(), record.pos(), record.id(), record.ref(), record.alt(),
+                           record.qual(), record.filter()};
+    set_typed_info(record, result);
+    if (record.num_samples() > 0 && result.num_samples() > 0) {
+        set_typed_samples(record, result);
+    }
+    return result;
+}
+
+VcfRecord make_vcf_record(const TypedVcfRecord& record)
+{
+    VcfRecord::Builder result {};
+    result.set_chrom(record.chrom());
+    result.set_pos(record.pos());
+    result.set_id(record.id());
+    result.set_ref(record.ref());
+    result.set_alt(record.alt());
+    if (record.qual()) result.set_qual(*record.qual());
+    result.set_filter(record.filter());
+    set_string_info(record, result);
+    if (record.num_samples() > 0 && (record.has_genotypes() || !record.format_fields().empty())) {
+        set_string_samples(record, result);
+    }
+    return result.build_once();
+}
+
+} // namespace octopus
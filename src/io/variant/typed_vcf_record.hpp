@@ -0,0 +1,233 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef typed_vcf_record_hpp
+#define typed_vcf_record_hpp
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include <limits>
+
+#include <boost/optional.hpp>
+
+#include "concepts/mappable.hpp"
+#include "basics/genomic_region.hpp"
+#include "vcf_record.hpp"
+
+namespace octopus {
+
+class VcfHeader;
+
+/**
+ VcfRecordSchema assigns a dense index to every INFO and FORMAT key declared in a VcfHeader,
+ together with the declared value type, so that TypedVcfRecord can refer to fields by index
+ rather than by name. A schema is built once per header and shared by all records.
+ */
+class VcfRecordSchema
+{
+public:
+    using FieldIndex = std::uint32_t;
+
+    enum class ValueType { integer, floating, flag, string };
+
+    struct Field
+    {
+        std::string key;
+        ValueType type;
+        boost::optional<unsigned> number; // none if not a fixed count (i.e. A, R, G, or .)
+    };
+
+    VcfRecordSchema() = default;
+
+    VcfRecordSchema(const VcfHeader& header);
+
+    VcfRecordSchema(const VcfRecordSchema&)            = default;
+    VcfRecordSchema& operator=(const VcfRecordSchema&) = default;
+    VcfRecordSchema(VcfRecordSchema&&)                 = default;
+    VcfRecordSchema& operator=(VcfRecordSchema&&)      = default;
+
+    ~VcfRecordSchema() = default;
+
+    const std::vector<std::string>& samples() const noexcept;
+    unsigned num_samples() const noexcept;
+    boost::optional<unsigned> sample_index(const std::string& sample) const noexcept;
+
+    std::size_t num_info_fields() const noexcept;
+    boost::optional<FieldIndex> info_index(const std::string& key) const noexcept;
+    const Field& info_field(FieldIndex index) const noexcept;
+
+    std::size_t num_format_fields() const noexcept;
+    boost::optional<FieldIndex> format_index(const std::string& key) const noexcept;
+    const Field& format_field(FieldIndex index) const noexcept;
+
+private:
+    using IndexMap = std::unordered_map<std::string, FieldIndex>;
+
+    std::vector<std::string> samples_;
+    std::vector<Field> info_, format_;
+    IndexMap info_indices_, format_indices_;
+};
+
+/**
+ TypedVcfRecord is a columnar alternative to VcfRecord. INFO and FORMAT values are kept in
+ their header declared types in a few contiguous pools rather than as per-key string vectors,
+ and FORMAT values are laid out sample-major with a fixed per-field stride, matching BCF.
+ Text conversion only happens when a record is converted to or from a VcfRecord.
+
+ Missing and padding values use the same sentinels as htslib so values can be copied to and
+ from bcf1_t buffers without translation.
+ */
+class TypedVcfRecord : public Mappable<TypedVcfRecord>
+{
+public:
+    using NucleotideSequence = VcfRecord::NucleotideSequence;
+    using QualityType        = VcfRecord::QualityType;
+    using KeyType            = VcfRecord::KeyType;
+    using SchemaPtr          = std::shared_ptr<const VcfRecordSchema>;
+    using FieldIndex         = VcfRecordSchema::FieldIndex;
+    using ValueType          = VcfRecordSchema::ValueType;
+
+    template <typename T> class ValueRange;
+
+    static constexpr std::int32_t missingInt   {std::numeric_limits<std::int32_t>::min()};
+    static constexpr std::int32_t intVectorEnd {std::numeric_limits<std::int32_t>::min() + 1};
+
+    static float missing_float() noexcept;
+    static float float_vector_end() noexcept;
+    static bool is_missing(float value) noexcept;
+    static bool is_vector_end(float value) noexcept;
+    static bool is_missing(std::int32_t value) noexcept { return value == missingInt; }
+    static bool is_vector_end(std::int32_t value) noexcept { return value == intVectorEnd; }
+
+    TypedVcfRecord() = default;
+
+    TypedVcfRecord(SchemaPtr schema, GenomicRegion::ContigName chrom, GenomicRegion::Position pos, std::string id,
+                   NucleotideSequence ref, std::vector<NucleotideSequence> alt, boost::optional<QualityType> qual,
+                   std::vector<KeyType> filter);
+
+    TypedVcfRecord(const TypedVcfRecord&)            = default;
+    TypedVcfRecord& operator=(const TypedVcfRecord&) = default;
+    TypedVcfRecord(TypedVcfRecord&&)                 = default;
+    TypedVcfRecord& operator=(TypedVcfRecord&&)      = default;
+
+    ~TypedVcfRecord() = default;
+
+    const VcfRecordSchema& schema() const noexcept;
+    const SchemaPtr& schema_ptr() const noexcept;
+
+    const GenomicRegion& mapped_region() const noexcept;
+
+    const GenomicRegion::ContigName& chrom() const noexcept;
+    GenomicRegion::Position pos() const noexcept; // One based!
+    const std::string& id() const noexcept;
+    const NucleotideSequence& ref() const noexcept;
+    const std::vector<NucleotideSequence>& alt() const noexcept;
+    boost::optional<QualityType> qual() const noexcept;
+    const std::vector<KeyType>& filter() const noexcept;
+
+    // INFO
+    std::vector<FieldIndex> info_fields() const;
+    bool has_info(FieldIndex field) const noexcept;
+    bool has_info(const KeyType& key) const noexcept;
+    ValueRange<std::int32_t> info_ints(FieldIndex field) const noexcept;
+    ValueRange<float> info_floats(FieldIndex field) const noexcept;
+    ValueRange<std::string> info_strings(FieldIndex field) const noexcept;
+    bool info_flag(FieldIndex field) const noexcept;
+
+    void set_info(FieldIndex field, const std::int32_t* values, std::size_t n);
+    void set_info(FieldIndex field, const float* values, std::size_t n);
+    void set_info(FieldIndex field, std::vector<std::string> values);
+    void set_info_flag(FieldIndex field, bool value = true);
+
+    // FORMAT
+    unsigned num_samples() const noexcept;
+    std::vector<FieldIndex> format_fields() const; // excludes GT
+    bool has_format(FieldIndex field) const noexcept;
+    bool has_format(const KeyType& key) const noexcept;
+    unsigned format_stride(FieldIndex field) const noexcept;
+    ValueRange<std::int32_t> format_ints(FieldIndex field, unsigned sample) const noexcept;
+    ValueRange<float> format_floats(FieldIndex field, unsigned sample) const noexcept;
+    const std::string& format_string(FieldIndex field, unsigned sample) const noexcept;
+
+    // values must be sample-major, stride values per sample, padded with the vector end sentinel
+    void set_format(FieldIndex field, const std::int32_t* values, unsigned stride);
+    void set_format(FieldIndex field, const float* values, unsigned stride);
+    void set_format(FieldIndex field, std::vector<std::string> values); // one value per sample
+
+    // Genotypes are stored as allele indices (missingInt for '.'), padded with intVectorEnd
+    bool has_genotypes() const noexcept;
+    unsigned max_ploidy() const noexcept;
+    unsigned ploidy(unsigned sample) const noexcept;
+    ValueRange<std::int32_t> genotype(unsigned sample) const noexcept;
+    bool is_sample_phased(unsigned sample) const noexcept;
+
+    void set_genotypes(std::vector<std::int32_t> alleles, unsigned max_ploidy, std::vector<bool> phasing);
+
+    // Raw sample-major buffers, for handing directly to htslib
+    const std::int32_t* format_ints_data(FieldIndex field) const noexcept;
+    const float* format_floats_data(FieldIndex field) const noexcept;
+    const std::vector<std::int32_t>& genotypes_data() const noexcept;
+
+private:
+    struct Slot
+    {
+        FieldIndex field;
+        std::uint32_t offset, count;
+    };
+    using SlotList = std::vector<Slot>;
+
+    SchemaPtr schema_;
+
+    GenomicRegion region_;
+    std::string id_;
+    NucleotideSequence ref_;
+    std::vector<NucleotideSequence> alt_;
+    boost::optional<QualityType> qual_;
+    std::vector<KeyType> filter_;
+
+    // INFO & FORMAT value pools. FORMAT slot counts are the per-sample stride.
+    SlotList info_, format_;
+    std::vector<std::int32_t> ints_;
+    std::vector<float> floats_;
+    std::vector<std::string> strings_;
+
+    std::vector<std::int32_t> genotypes_;
+    unsigned max_ploidy_ = 0;
+    std::vector<bool> phasing_;
+
+    const Slot* find(const SlotList& slots, FieldIndex field) const noexcept;
+    Slot& assign(SlotList& slots, FieldIndex field);
+};
+
+template <typename T>
+class TypedVcfRecord::ValueRange
+{
+public:
+    using value_type     = T;
+    using const_iterator = const T*;
+
+    ValueRange() = default;
+    ValueRange(const T* first, const T* last) noexcept : first_ {first}, last_ {last} {}
+
+    const_iterator begin() const noexcept { return first_; }
+    const_iterator end() const noexcept { return last_; }
+    std::size_t size() const noexcept { return static_cast<std::size_t>(last_ - first_); }
+    bool empty() const noexcept { return first_ == last_; }
+    const T& operator[](std::size_t n) const noexcept { return first_[n]; }
+    const T& front() const noexcept { return *first_; }
+
+private:
+    const T* first_ = nullptr;
+    const T* last_ = nullptr;
+};
+
+TypedVcfRecord make_typed(const VcfRecord& record, TypedVcfRecord::SchemaPtr schema);
+VcfRecord make_vcf_record(const TypedVcfRecord& record);
+
+} // namespace octopus
+
+#endif
@@ -7,6 +7,7 @@
 #include "io/variant/vcf_type.hpp"
 #include "io/variant/vcf_header.hpp"
 #include "io/variant/vcf_record.hpp"
+#include "io/variant/typed_vcf_record.hpp"
 #include "io/variant/vcf_reader.hpp"
 #include "io/variant/vcf_writer.hpp"
 #include "io/variant/vcf_utils.hpp"
@@ -11,6 +11,7 @@
 
 #include "basics/genomic_region.hpp"
 #include "exceptions/file_open_error.hpp"
+#include "typed_vcf_record.hpp"
 
 namespace octopus {
 
@@ -83,32 +84,32 @@ std::size_t VcfParser::count_records(const GenomicRegion& region) const
     return result;
 }
 
-VcfParser::RecordIteratorPtrPair VcfParser::iterate(UnpackPolicy level) const
+VcfParser::RecordIteratorPtrPair VcfParser::iterate(const UnpackMask& level) const
 {
     reset_vcf();
     return std::make_pair(std::make_unique<RecordIterator>(*this, level),
                           std::make_unique<RecordIterator>());
 }
 
-VcfParser::RecordIteratorPtrPair VcfParser::iterate(const std::string& contig, UnpackPolicy level) const
+VcfParser::RecordIteratorPtrPair VcfParser::iterate(const std::string& contig, const UnpackMask& level) const
 {
     reset_vcf();
     return std::make_pair(std::make_unique<RecordIterator>(*this, level, contig),
                           std::make_unique<RecordIterator>());
 }
 
-VcfParser::RecordIteratorPtrPair VcfParser::iterate(const GenomicRegion& region, const UnpackPolicy level) const
+VcfParser::RecordIteratorPtrPair VcfParser::iterate(const GenomicRegion& region, const UnpackMask& level) const
 {
     reset_vcf();
     return std::make_pair(std::make_unique<RecordIterator>(*this, level, region),
                           std::make_unique<RecordIterator>());
 }
 
-VcfParser::RecordContainer VcfParser::fetch_records(const UnpackPolicy level) const
+VcfParser::RecordContainer VcfParser::fetch_records(const UnpackMask& level) const
 {
     RecordContainer result {};
     result.reserve(count_records());
-    bool unpack_all {level == UnpackPolicy::all};
+    bool unpack_all {level.unpacks_samples()};
     std::transform(std::istream_iterator<Line>(file_), std::istream_iterator<Line>(),
                    std::back_inserter(result), [this, unpack_all] (const auto& line) {
                        return (unpack_all) ? parse_record(line, samples_) : parse_record(line);
@@ -117,11 +118,11 @@ VcfParser::RecordContainer VcfParser::fetch_records(const UnpackPolicy level) co
     return result;
 }
 
-VcfParser::RecordContainer VcfParser::fetch_records(const std::string& contig, const UnpackPolicy level) const
+VcfParser::RecordContainer VcfParser::fetch_records(const std::string& contig, const UnpackMask& level) const
 {
     RecordContainer result {};
     result.reserve(count_records(contig));
-    bool unpack_all {level == UnpackPolicy::all};
+    bool unpack_all {level.unpacks_samples()};
     std::for_each(std::istream_iterator<Line>(file_), std::istream_iterator<Line>(),
                   [this, &result, &contig, unpack_all] (const auto& line) {
                       if (is_same_contig(line, contig)) {
@@ -132,11 +133,11 @@ VcfParser::RecordContainer VcfParser::fetch_records(const std::string& contig, c
     return result;
 }
 
-VcfParser::RecordContainer VcfParser::fetch_records(const GenomicRegion& region, const UnpackPolicy level) const
+VcfParser::RecordContainer VcfParser::fetch_records(const GenomicRegion& region, const UnpackMask& level) const
 {
     RecordContainer result {};
     result.reserve(count_records(region));
-    bool unpack_all {level == UnpackPolicy::all};
+    bool unpack_all {level.unpacks_samples()};
     std::for_each(std::istream_iterator<Line>(file_), std::istream_iterator<Line>(),
                   [this, &result, &region, unpack_all] (const std::string& line) {
                       if (overlaps(line, region)) {
@@ -147,6 +148,36 @@ VcfParser::RecordContainer VcfParser::fetch_records(const GenomicRegion& region,
     return result;
 }
 
+namespace {
+
+auto make_typed_records(VcfParser::RecordContainer&& records, const VcfParser::SchemaPtr& schema)
+{
+    // Text VCFs are parsed to strings anyway, so just convert at the boundary
+    VcfParser::TypedRecordContainer result {};
+    result.reserve(records.size());
+    for (const auto& record : records) {
+        result.push_back(make_typed(record, schema));
+    }
+    return result;
+}
+
+} // namespace
+
+VcfParser::TypedRecordContainer VcfParser::fetch_typed_records(const SchemaPtr& schema) const
+{
+    return make_typed_records(fetch_records(UnpackPolicy::all), schema);
+}
+
+VcfParser::TypedRecordContainer VcfParser::fetch_typed_records(const std::string& contig, const SchemaPtr& schema) const
+{
+    return make_typed_records(fetch_records(contig, UnpackPolicy::all), schema);
+}
+
+VcfParser::TypedRecordContainer VcfParser::fetch_typed_records(const GenomicRegion& region, const SchemaPtr& schema) const
+{
+    return make_typed_records(fetch_records(region, UnpackPolicy::all), schema);
+}
+
 // private methods
 
 void VcfParser::reset_vcf() const
@@ -424,16 +455,16 @@ VcfRecord parse_record(const std::string& line, const std::vector<VcfRecord::Sam
 
 // VcfParser::RecordIterator
 
-VcfParser::RecordIterator::RecordIterator(const VcfParser& vcf, UnpackPolicy unpack)
+VcfParser::RecordIterator::RecordIterator(const VcfParser& vcf, UnpackMask unpack)
 : parent_vcf_ {&vcf}
-, unpack_ {unpack}
+, unpack_ {std::move(unpack)}
 , local_ {vcf.file_path_.string()}
 , contig_ {}
 , region_ {}
 {
     local_.seekg(parent_vcf_->file_.tellg());
     if (std::getline(local_, line_)) {
-        if (unpack_ == UnpackPolicy::all) {
+        if (unpack_.unpacks_samples()) {
             record_ = std::make_shared<VcfRecord>(parse_record(line_, vcf.samples_));
         } else {
             record_ = std::make_shared<VcfRecord>(parse_record(line_));
@@ -443,8 +474,8 @@ VcfParser::RecordIterator::RecordIterator(const VcfParser& vcf, UnpackPolicy unp
     }
 }
 
-VcfParser::RecordIterator::RecordIterator(const VcfParser& vcf, UnpackPolicy unpack, std::string contig)
-: RecordIterator {vcf, unpack}
+VcfParser::RecordIterator::RecordIterator(const VcfParser& vcf, UnpackMask unpack, std::string contig)
+: RecordIterator {vcf, std::move(unpack)}
 {
     contig_ = std::move(contig);
     if (record_ && record_->chrom() != *contig_) {
@@ -452,8 +483,8 @@ VcfParser::RecordIterator::RecordIterator(const VcfParser& vcf, UnpackPolicy unp
     }
 }
 
-VcfParser::RecordIterator::RecordIterator(const VcfParser& vcf, UnpackPolicy unpack, GenomicRegion region)
-: RecordIterator {vcf, unpack}
+VcfParser::RecordIterator::RecordIterator(const VcfParser& vcf, UnpackMask unpack, GenomicRegion region)
+: RecordIterator {vcf, std::move(unpack)}
 {
     region_ = std::move(region);
     if (record_ && !overlaps(*record_, *region_)) {
@@ -468,7 +499,7 @@ VcfParser::RecordIterator::RecordIterator(const RecordIterator& other)
 {
     local_.seekg(parent_vcf_->file_.tellg());
     if (std::getline(local_, line_)) {
-        if (unpack_ == UnpackPolicy::all) {
+        if (unpack_.unpacks_samples()) {
             record_ = std::make_shared<VcfRecord>(parse_record(line_, parent_vcf_->samples_));
         } else {
             record_ = std::make_shared<VcfRecord>(parse_record(line_));
@@ -500,7 +531,7 @@ VcfParser::RecordIterator::pointer VcfParser::RecordIterator::operator->() const
 void VcfParser::RecordIterator::next()
 {
     while (std::getline(local_, line_) && !line_.empty()) {
-        if (unpack_ == UnpackPolicy::all) {
+        if (unpack_.unpacks_samples()) {
             *record_ = parse_record(line_, parent_vcf_->samples_);
         } else {
             *record_ = parse_record(line_);
@@ -28,6 +28,8 @@ class VcfParser : public IVcfReaderImpl
 {
 public:
     using IVcfReaderImpl::RecordContainer;
+    using IVcfReaderImpl::TypedRecordContainer;
+    using IVcfReaderImpl::SchemaPtr;
     
     class RecordIterator;
     
@@ -52,13 +54,17 @@ public:
     std::size_t count_records(const std::string& contig) const override;
     std::size_t count_records(const GenomicRegion& region) const override;
     
-    RecordIteratorPtrPair iterate(UnpackPolicy level) const override;
-    RecordIteratorPtrPair iterate(const std::string& contig, UnpackPolicy level) const override;
-    RecordIteratorPtrPair iterate(const GenomicRegion& region, UnpackPolicy level) const override;
+    RecordIteratorPtrPair iterate(const UnpackMask& level) const override;
+    RecordIteratorPtrPair iterate(const std::string& contig, const UnpackMask& level) const override;
+    RecordIteratorPtrPair iterate(const GenomicRegion& region, const UnpackMask& level) const override;
     
-    RecordContainer fetch_records(UnpackPolicy level) const override;
-    RecordContainer fetch_records(const std::string& contig, UnpackPolicy level) const override;
-    RecordContainer fetch_records(const GenomicRegion& region, UnpackPolicy level) const override;
+    RecordContainer fetch_records(const UnpackMask& level) const override;
+    RecordContainer fetch_records(const std::string& contig, const UnpackMask& level) const override;
+    RecordContainer fetch_records(const GenomicRegion& region, const UnpackMask& level) const override;
+    
+    TypedRecordContainer fetch_typed_records(const SchemaPtr& schema) const override;
+    TypedRecordContainer fetch_typed_records(const std::string& contig, const SchemaPtr& schema) const override;
+    TypedRecordContainer fetch_typed_records(const GenomicRegion& region, const SchemaPtr& schema) const override;
     
     friend RecordIterator;
     friend bool operator==(const RecordIterator& lhs, const RecordIterator& rhs);
@@ -87,9 +93,9 @@ public:
     
     RecordIterator() = default;
     
-    RecordIterator(const VcfParser& vcf, UnpackPolicy unpack);
-    RecordIterator(const VcfParser& vcf, UnpackPolicy unpack, std::string contig);
-    RecordIterator(const VcfParser& vcf, UnpackPolicy unpack, GenomicRegion region);
+    RecordIterator(const VcfParser& vcf, UnpackMask unpack);
+    RecordIterator(const VcfParser& vcf, UnpackMask unpack, std::string contig);
+    RecordIterator(const VcfParser& vcf, UnpackMask unpack, GenomicRegion region);
     
     RecordIterator(const RecordIterator&);
     RecordIterator& operator=(RecordIterator);
@@ -113,7 +119,7 @@ public:
 private:
     std::shared_ptr<VcfRecord> record_;
     const VcfParser* parent_vcf_;
-    UnpackPolicy unpack_;
+    UnpackMask unpack_;
     mutable std::ifstream local_;
     mutable std::string line_;
     boost::optional<std::string> contig_;
@@ -15,6 +15,7 @@
 
 #include "vcf_header.hpp"
 #include "vcf_record.hpp"
+#include "typed_vcf_record.hpp"
 #include "htslib_bcf_facade.hpp"
 #include "vcf_parser.hpp"
 
@@ -165,6 +166,11 @@ VcfHeader VcfReader::fetch_header() const
     return reader_->fetch_header();
 }
 
+VcfReader::SchemaPtr VcfReader::fetch_schema() const
+{
+    return std::make_shared<const VcfRecordSchema>(fetch_header());
+}
+
 std::size_t VcfReader::count_records() const
 {
     std::lock_guard<std::mutex> lock {mutex_};
@@ -183,39 +189,57 @@ std::size_t VcfReader::count_records(const GenomicRegion& region) const
     return reader_->count_records(region);
 }
 
-VcfReader::RecordContainer VcfReader::fetch_records(const UnpackPolicy level) const
+VcfReader::RecordContainer VcfReader::fetch_records(const UnpackMask& level) const
 {
     std::lock_guard<std::mutex> lock {mutex_};
     return reader_->fetch_records(level);
 }
 
-VcfReader::RecordContainer VcfReader::fetch_records(const std::string& contig, const UnpackPolicy level) const
+VcfReader::RecordContainer VcfReader::fetch_records(const std::string& contig, const UnpackMask& level) const
 {
     std::lock_guard<std::mutex> lock {mutex_};
     return reader_->fetch_records(contig, level);
 }
 
-VcfReader::RecordContainer VcfReader::fetch_records(const GenomicRegion& region, const UnpackPolicy level) const
+VcfReader::RecordContainer VcfReader::fetch_records(const GenomicRegion& region, const UnpackMask& level) const
 {
     std::lock_guard<std::mutex> lock {mutex_};
     return reader_->fetch_records(region, level);
 }
 
-VcfReader::RecordIteratorPair VcfReader::iterate(const UnpackPolicy level) const
+VcfReader::TypedRecordContainer VcfReader::fetch_typed_records(const SchemaPtr& schema) const
+{
+    std::lock_guard<std::mutex> lock {mutex_};
+    return reader_->fetch_typed_records(schema);
+}
+
+VcfReader::TypedRecordContainer VcfReader::fetch_typed_records(const std::string& contig, const SchemaPtr& schema) const
+{
+    std::lock_guard<std::mutex> lock {mutex_};
+    return reader_->fetch_typed_records(contig, schema);
+}
+
+VcfReader::TypedRecordContainer VcfReader::fetch_typed_records(const GenomicRegion& region, const SchemaPtr& schema) const
+{
+    std::lock_guard<std::mutex> lock {mutex_};
+    return reader_->fetch_typed_records(region, schema);
+}
+
+VcfReader::RecordIteratorPair VcfReader::iterate(const UnpackMask& level) const
 {
     std::lock_guard<std::mutex> lock {mutex_};
     auto p = reader_->iterate(level);
     return std::make_pair(std::move(p.first), std::move(p.second));
 }
 
-VcfReader::RecordIteratorPair VcfReader::iterate(const std::string& contig, const UnpackPolicy level) const
+VcfReader::RecordIteratorPair VcfReader::iterate(const std::string& contig, const UnpackMask& level) const
 {
     std::lock_guard<std::mutex> lock {mutex_};
     auto p = reader_->iterate(contig, level);
     return std::make_pair(std::move(p.first), std::move(p.second));
 }
 
-VcfReader::RecordIteratorPair VcfReader::iterate(const GenomicRegion& region, const UnpackPolicy level) const
+VcfReader::RecordIteratorPair VcfReader::iterate(const GenomicRegion& region, const UnpackMask& level) const
 {
     std::lock_guard<std::mutex> lock {mutex_};
     auto p = reader_->iterate(region, level);
@@ -29,7 +29,10 @@ class VcfReader
 public:
     using Path = boost::filesystem::path;
     using UnpackPolicy = IVcfReaderImpl::UnpackPolicy;
+    using UnpackMask   = IVcfReaderImpl::UnpackMask;
     using RecordContainer = IVcfReaderImpl::RecordContainer;
+    using TypedRecordContainer = IVcfReaderImpl::TypedRecordContainer;
+    using SchemaPtr = IVcfReaderImpl::SchemaPtr;
     
     class RecordIterator;
     using RecordIteratorPair = std::pair<RecordIterator, RecordIterator>;
@@ -54,18 +57,23 @@ public:
     const Path& path() const noexcept;
     
     VcfHeader fetch_header() const;
+    SchemaPtr fetch_schema() const;
     
     std::size_t count_records() const;
     std::size_t count_records(const std::string& contig) const;
     std::size_t count_records(const GenomicRegion& region) const;
     
-    RecordContainer fetch_records(UnpackPolicy level = UnpackPolicy::all) const;
-    RecordContainer fetch_records(const std::string& contig, UnpackPolicy level = UnpackPolicy::all) const;
-    RecordContainer fetch_records(const GenomicRegion& region, UnpackPolicy level = UnpackPolicy::all) const;
+    RecordContainer fetch_records(const UnpackMask& level = UnpackPolicy::all) const;
+    RecordContainer fetch_records(const std::string& contig, const UnpackMask& level = UnpackPolicy::all) const;
+    RecordContainer fetch_records(const GenomicRegion& region, const UnpackMask& level = UnpackPolicy::all) const;
     
-    RecordIteratorPair iterate(UnpackPolicy level = UnpackPolicy::all) const;
-    RecordIteratorPair iterate(const std::string& contig, UnpackPolicy level = UnpackPolicy::all) const;
-    RecordIteratorPair iterate(const GenomicRegion& region, UnpackPolicy level = UnpackPolicy::all) const;
+    TypedRecordContainer fetch_typed_records(const SchemaPtr& schema) const;
+    TypedRecordContainer fetch_typed_records(const std::string& contig, const SchemaPtr& schema) const;
+    TypedRecordContainer fetch_typed_records(const GenomicRegion& region, const SchemaPtr& schema) const;
+    
+    RecordIteratorPair iterate(const UnpackMask& level = UnpackPolicy::all) const;
+    RecordIteratorPair iterate(const std::string& contig, const UnpackMask& level = UnpackPolicy::all) const;
+    RecordIteratorPair iterate(const GenomicRegion& region, const UnpackMask& level = UnpackPolicy::all) const;
     
 private:
     Path file_path_;
@@ -9,19 +9,77 @@
 #include <cstddef>
 #include <memory>
 #include <utility>
+#include <algorithm>
+#include <iterator>
 
 namespace octopus {
 
 class GenomicRegion;
 class VcfHeader;
 class VcfRecord;
+class TypedVcfRecord;
+class VcfRecordSchema;
 
 class IVcfReaderImpl
 {
 public:
     enum class UnpackPolicy { all, sites };
     
-    using RecordContainer = std::vector<VcfRecord>;
+    /**
+     An UnpackMask restricts which parts of a record are decoded. The site fields (CHROM to FILTER) are
+     always decoded, but INFO and FORMAT can each be skipped or limited to a set of keys. Readers may
+     decode more than the mask asks for, but never less, so callers must only rely on the masked fields.
+     An UnpackPolicy converts to the equivalent mask.
+     */
+    class UnpackMask
+    {
+    public:
+        using KeyType = std::string;
+        
+        UnpackMask(UnpackPolicy policy = UnpackPolicy::all) noexcept
+        : info_ {Extent::all}
+        , format_ {policy == UnpackPolicy::all ? Extent::all : Extent::none}
+        {}
+        
+        static UnpackMask site_fields_only() noexcept
+        {
+            UnpackMask result {UnpackPolicy::sites};
+            result.info_ = Extent::none;
+            return result;
+        }
+        
+        UnpackMask& add_info(KeyType key) { add(std::move(key), info_, info_keys_); return *this; }
+        UnpackMask& add_format(KeyType key) { add(std::move(key), format_, format_keys_); return *this; }
+        UnpackMask& add_all_info() noexcept { info_ = Extent::all; info_keys_.clear(); return *this; }
+        UnpackMask& add_all_format() noexcept { format_ = Extent::all; format_keys_.clear(); return *this; }
+        
+        bool unpacks_info() const noexcept { return info_ != Extent::none; }
+        bool unpacks_info(const KeyType& key) const noexcept { return contains(key, info_, info_keys_); }
+        bool unpacks_samples() const noexcept { return format_ != Extent::none; }
+        bool unpacks_format(const KeyType& key) const noexcept { return contains(key, format_, format_keys_); }
+        
+    private:
+        enum class Extent { none, some, all };
+        
+        Extent info_, format_;
+        std::vector<KeyType> info_keys_, format_keys_; // sorted, only used if Extent::some
+        
+        static void add(KeyType key, Extent& extent, std::vector<KeyType>& keys)
+        {
+            if (extent == Extent::all) return;
+            extent = Extent::some;
+            const auto itr = std::lower_bound(std::cbegin(keys), std::cend(keys), key);
+            if (itr == std::cend(keys) || *itr != key) keys.insert(itr, std::move(key));
+        }
+        static bool contains(const KeyType& key, const Extent extent, const std::vector<KeyType>& keys) noexcept
+        {
+            return extent == Extent::all || (extent == Extent::some && std::binary_search(std::cbegin(keys), std::cend(keys), key));
+        }
+    };
+    
+    using RecordContainer      = std::vector<VcfRecord>;
+    using TypedRecordContainer = std::vector<TypedVcfRecord>;
+    using SchemaPtr            = std::shared_ptr<const VcfRecordSchema>;
     
     class RecordIterator
     {
@@ -53,13 +111,17 @@ public:
     virtual std::size_t count_records(const std::string& contig) const = 0;
     virtual std::size_t count_records(const GenomicRegion& region) const = 0;
     
-    virtual RecordContainer fetch_records(UnpackPolicy level) const = 0; // fetches all records
-    virtual RecordContainer fetch_records(const std::string& contig, UnpackPolicy level) const = 0;
-    virtual RecordContainer fetch_records(const GenomicRegion& region, UnpackPolicy level) const = 0;
+    virtual RecordContainer fetch_records(const UnpackMask& level) const = 0; // fetches all records
+    virtual RecordContainer fetch_records(const std::string& contig, const UnpackMask& level) const = 0;
+    virtual RecordContainer fetch_records(const GenomicRegion& region, const UnpackMask& level) const = 0;
+    
+    virtual TypedRecordContainer fetch_typed_records(const SchemaPtr& schema) const = 0;
+    virtual TypedRecordContainer fetch_typed_records(const std::string& contig, const SchemaPtr& schema) const = 0;
+    virtual TypedRecordContainer fetch_typed_records(const GenomicRegion& region, const SchemaPtr& schema) const = 0;
     
-    virtual RecordIteratorPtrPair iterate(UnpackPolicy level) const = 0;
-    virtual RecordIteratorPtrPair iterate(const std::string& contig, UnpackPolicy level) const  = 0;
-    virtual RecordIteratorPtrPair iterate(const GenomicRegion& region, UnpackPolicy level) const = 0;
+    virtual RecordIteratorPtrPair iterate(const UnpackMask& level) const = 0;
+    virtual RecordIteratorPtrPair iterate(const std::string& contig, const UnpackMask& level) const  = 0;
+    virtual RecordIteratorPtrPair iterate(const GenomicRegion& region, const UnpackMask& level) const = 0;
     
     virtual ~IVcfReaderImpl() noexcept = default;
 };
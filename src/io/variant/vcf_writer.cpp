@@ -175,6 +175,16 @@ void VcfWriter::write(const VcfRecord& record)
     }
 }
 
+void VcfWriter::write(const TypedVcfRecord& record)
+{
+    std::lock_guard<std::mutex> lock {mutex_};
+    if (is_header_written_) {
+        writer_->write(record);
+    } else {
+        throw std::runtime_error {"VcfWriter::write: cannot write record as header has not been written"};
+    }
+}
+
 bool VcfWriter::can_write_index() const noexcept
 {
     return file_path_ && is_header_written_
@@ -195,6 +205,12 @@ VcfWriter& operator<<(VcfWriter& dst, const VcfRecord& record)
     return dst;
 }
 
+VcfWriter& operator<<(VcfWriter& dst, const TypedVcfRecord& record)
+{
+    dst.write(record);
+    return dst;
+}
+
 bool operator==(const VcfWriter& lhs, const VcfWriter& rhs)
 {
     return lhs.path() == rhs.path();
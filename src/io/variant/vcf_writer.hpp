@@ -19,6 +19,7 @@ namespace octopus {
 
 class VcfHeader;
 class VcfRecord;
+class TypedVcfRecord;
 class GenomicRegion;
 
 class VcfWriter
@@ -51,6 +52,7 @@ public:
     
     void write(const VcfHeader& header);
     void write(const VcfRecord& record);
+    void write(const TypedVcfRecord& record);
     
 private:
     boost::optional<Path> file_path_;
@@ -63,11 +65,13 @@ private:
 
 VcfWriter& operator<<(VcfWriter& dst, const VcfHeader& header);
 VcfWriter& operator<<(VcfWriter& dst, const VcfRecord& record);
+VcfWriter& operator<<(VcfWriter& dst, const TypedVcfRecord& record);
 
 template <typename Container>
 void write(const Container& records, VcfWriter& dst)
 {
-    static_assert(std::is_same<typename Container::value_type, VcfRecord>::value, "");
+    static_assert(std::is_same<typename Container::value_type, VcfRecord>::value
+                  || std::is_same<typename Container::value_type, TypedVcfRecord>::value, "");
     for (const auto& record : records) {
         dst << record;
     }
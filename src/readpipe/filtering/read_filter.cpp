@@ -25,39 +25,39 @@ bool HasValidBaseQualities::passes(const AlignedRead& read) const noexcept
 }
 
 IsNotSecondaryAlignment::IsNotSecondaryAlignment()
-: BasicReadFilter {"IsNotSecondaryAlignment"} {}
+: CoreReadFilter {"IsNotSecondaryAlignment"} {}
 
 IsNotSecondaryAlignment::IsNotSecondaryAlignment(std::string name)
-: BasicReadFilter {std::move(name)} {}
+: CoreReadFilter {std::move(name)} {}
 
-bool IsNotSecondaryAlignment::passes(const AlignedRead& read) const noexcept
+bool IsNotSecondaryAlignment::passes(const AlignedReadCore& read) const noexcept
 {
-    return !read.is_marked_secondary_alignment();
+    return !read.flags.secondary_alignment;
 }
 
 IsNotSupplementaryAlignment::IsNotSupplementaryAlignment()
-: BasicReadFilter {"IsNotSupplementaryAlignment"} {}
+: CoreReadFilter {"IsNotSupplementaryAlignment"} {}
 
 IsNotSupplementaryAlignment::IsNotSupplementaryAlignment(std::string name)
-: BasicReadFilter {std::move(name)} {}
+: CoreReadFilter {std::move(name)} {}
 
-bool IsNotSupplementaryAlignment::passes(const AlignedRead& read) const noexcept
+bool IsNotSupplementaryAlignment::passes(const AlignedReadCore& read) const noexcept
 {
-    return !read.is_marked_supplementary_alignment();
+    return !read.flags.supplementary_alignment;
 }
 
 IsGoodMappingQuality::IsGoodMappingQuality(MappingQuality good_mapping_quality)
 :
-BasicReadFilter {"IsGoodMappingQuality"}
+CoreReadFilter {"IsGoodMappingQuality"}
 , good_mapping_quality_ {good_mapping_quality} {}
 
 IsGoodMappingQuality::IsGoodMappingQuality(std::string name, MappingQuality good_mapping_quality)
-: BasicReadFilter {std::move(name)}
+: CoreReadFilter {std::move(name)}
 , good_mapping_quality_ {good_mapping_quality} {}
 
-bool IsGoodMappingQuality::passes(const AlignedRead& read) const noexcept
+bool IsGoodMappingQuality::passes(const AlignedReadCore& read) const noexcept
 {
-    return read.mapping_quality() >= good_mapping_quality_;
+    return read.mapping_quality >= good_mapping_quality_;
 }
 
 HasSufficientGoodBaseFraction::HasSufficientGoodBaseFraction(BaseQuality good_base_quality,
@@ -106,62 +106,62 @@ bool HasSufficientGoodQualityBases::passes(const AlignedRead& read) const noexce
                          }) >= min_good_bases_;
 }
 
-IsMapped::IsMapped() : BasicReadFilter {"IsMapped"} {}
-IsMapped::IsMapped(std::string name) :  BasicReadFilter {std::move(name)} {}
+IsMapped::IsMapped() : CoreReadFilter {"IsMapped"} {}
+IsMapped::IsMapped(std::string name) :  CoreReadFilter {std::move(name)} {}
 
-bool IsMapped::passes(const AlignedRead& read) const noexcept
+bool IsMapped::passes(const AlignedReadCore& read) const noexcept
 {
-    return !read.is_marked_unmapped();
+    return !read.flags.unmapped;
 }
 
-IsNotChimeric::IsNotChimeric() : BasicReadFilter {"IsNotChimeric"} {}
-IsNotChimeric::IsNotChimeric(std::string name) :  BasicReadFilter {std::move(name)} {}
+IsNotChimeric::IsNotChimeric() : CoreReadFilter {"IsNotChimeric"} {}
+IsNotChimeric::IsNotChimeric(std::string name) :  CoreReadFilter {std::move(name)} {}
 
-bool IsNotChimeric::passes(const AlignedRead& read) const noexcept
+bool IsNotChimeric::passes(const AlignedReadCore& read) const noexcept
 {
-    return !read.has_other_segment();
+    return !read.has_other_segment;
 }
 
-IsNextSegmentMapped::IsNextSegmentMapped() : BasicReadFilter {"IsNextSegmentMapped"} {}
-IsNextSegmentMapped::IsNextSegmentMapped(std::string name) :  BasicReadFilter {std::move(name)} {}
+IsNextSegmentMapped::IsNextSegmentMapped() : CoreReadFilter {"IsNextSegmentMapped"} {}
+IsNextSegmentMapped::IsNextSegmentMapped(std::string name) :  CoreReadFilter {std::move(name)} {}
 
-bool IsNextSegmentMapped::passes(const AlignedRead& read) const noexcept
+bool IsNextSegmentMapped::passes(const AlignedReadCore& read) const noexcept
 {
-    return !read.has_other_segment() || !read.next_segment().is_marked_unmapped();
+    return !read.has_other_segment || !read.next_segment_flags.unmapped;
 }
 
-IsNotMarkedDuplicate::IsNotMarkedDuplicate() : BasicReadFilter {"IsNotMarkedDuplicate"} {}
-IsNotMarkedDuplicate::IsNotMarkedDuplicate(std::string name) :  BasicReadFilter {std::move(name)} {}
+IsNotMarkedDuplicate::IsNotMarkedDuplicate() : CoreReadFilter {"IsNotMarkedDuplicate"} {}
+IsNotMarkedDuplicate::IsNotMarkedDuplicate(std::string name) :  CoreReadFilter {std::move(name)} {}
 
-bool IsNotMarkedDuplicate::passes(const AlignedRead& read) const noexcept
+bool IsNotMarkedDuplicate::passes(const AlignedReadCore& read) const noexcept
 {
-    return !read.is_marked_duplicate();
+    return !read.flags.duplicate;
 }
 
 IsShort::IsShort(Length max_length)
-: BasicReadFilter {"IsShort"}
+: CoreReadFilter {"IsShort"}
 , max_length_ {max_length} {}
 
 IsShort::IsShort(std::string name, Length max_length)
-: BasicReadFilter {std::move(name)}
+: CoreReadFilter {std::move(name)}
 , max_length_ {max_length} {}
 
-bool IsShort::passes(const AlignedRead& read) const noexcept
+bool IsShort::passes(const AlignedReadCore& read) const noexcept
 {
-    return sequence_size(read) <= max_length_;
+    return read.sequence_size <= max_length_;
 }
 
 IsLong::IsLong(Length min_length)
-: BasicReadFilter {"IsLong"}
+: CoreReadFilter {"IsLong"}
 , min_length_ {min_length} {}
 
 IsLong::IsLong(std::string name, Length min_length)
-: BasicReadFilter {std::move(name)}
+: CoreReadFilter {std::move(name)}
 , min_length_ {min_length} {}
 
-bool IsLong::passes(const AlignedRead& read) const noexcept
+bool IsLong::passes(const AlignedReadCore& read) const noexcept
 {
-    return sequence_size(read) >= min_length_;
+    return read.sequence_size >= min_length_;
 }
 
 IsNotContaminated::IsNotContaminated() : BasicReadFilter {"IsNotContaminated"} {}
@@ -176,28 +176,28 @@ bool IsNotContaminated::passes(const AlignedRead& read) const noexcept
     return template_length > region_size(read);
 }
 
-IsNotMarkedQcFail::IsNotMarkedQcFail() : BasicReadFilter {"IsNotMarkedQcFail"} {}
-IsNotMarkedQcFail::IsNotMarkedQcFail(std::string name) :  BasicReadFilter {std::move(name)} {}
+IsNotMarkedQcFail::IsNotMarkedQcFail() : CoreReadFilter {"IsNotMarkedQcFail"} {}
+IsNotMarkedQcFail::IsNotMarkedQcFail(std::string name) :  CoreReadFilter {std::move(name)} {}
 
-bool IsNotMarkedQcFail::passes(const AlignedRead& read) const noexcept
+bool IsNotMarkedQcFail::passes(const AlignedReadCore& read) const noexcept
 {
-    return !read.is_marked_qc_fail();
+    return !read.flags.qc_fail;
 }
 
-IsProperTemplate::IsProperTemplate() : BasicReadFilter {"IsProperTemplate"} {}
-IsProperTemplate::IsProperTemplate(std::string name) :  BasicReadFilter {std::move(name)} {}
+IsProperTemplate::IsProperTemplate() : CoreReadFilter {"IsProperTemplate"} {}
+IsProperTemplate::IsProperTemplate(std::string name) :  CoreReadFilter {std::move(name)} {}
 
-bool IsProperTemplate::passes(const AlignedRead& read) const noexcept
+bool IsProperTemplate::passes(const AlignedReadCore& read) const noexcept
 {
-    return !read.has_other_segment() || read.is_marked_all_segments_in_read_aligned();
+    return !read.has_other_segment || read.flags.all_segments_in_read_aligned;
 }
 
-IsLocalTemplate::IsLocalTemplate() : BasicReadFilter {"IsLocalTemplate"} {}
-IsLocalTemplate::IsLocalTemplate(std::string name) :  BasicReadFilter {std::move(name)} {}
+IsLocalTemplate::IsLocalTemplate() : CoreReadFilter {"IsLocalTemplate"} {}
+IsLocalTemplate::IsLocalTemplate(std::string name) :  CoreReadFilter {std::move(name)} {}
 
-bool IsLocalTemplate::passes(const AlignedRead& read) const noexcept
+bool IsLocalTemplate::passes(const AlignedReadCore& read) const noexcept
 {
-    return !read.has_other_segment() || read.next_segment().contig_name() == contig_name(read);
+    return !read.has_other_segment || read.next_segment_on_same_contig;
 }
 
 } // namespace readpipe
@@ -13,6 +13,7 @@
 
 #include "basics/cigar_string.hpp"
 #include "basics/aligned_read.hpp"
+#include "basics/aligned_read_core.hpp"
 #include "basics/mappable_reference_wrapper.hpp"
 #include "utils/read_duplicates.hpp"
 
@@ -56,6 +57,35 @@ private:
     virtual bool passes(const AlignedRead&) const noexcept = 0;
 };
 
+// Core filters only inspect the fields in AlignedReadCore, so can also be applied to alignment
+// records before they are decoded
+
+class CoreReadFilter : public BasicReadFilter
+{
+public:
+    CoreReadFilter() = delete;
+    
+    virtual ~CoreReadFilter() = default;
+    
+    using BasicReadFilter::operator();
+    
+    bool operator()(const AlignedReadCore& read) const noexcept
+    {
+        return passes(read);
+    }
+    
+protected:
+    CoreReadFilter(std::string name) : BasicReadFilter {std::move(name)} {};
+    
+private:
+    bool passes(const AlignedRead& read) const noexcept override
+    {
+        return passes(extract_core(read));
+    }
+    
+    virtual bool passes(const AlignedReadCore&) const noexcept = 0;
+};
+
 struct HasWellFormedCigar : BasicReadFilter
 {
     HasWellFormedCigar();
@@ -72,23 +102,23 @@ struct HasValidBaseQualities : BasicReadFilter
     bool passes(const AlignedRead& read) const noexcept override;
 };
 
-struct IsNotSecondaryAlignment : BasicReadFilter
+struct IsNotSecondaryAlignment : CoreReadFilter
 {
     IsNotSecondaryAlignment();
     IsNotSecondaryAlignment(std::string name);
     
-    bool passes(const AlignedRead& read) const noexcept override;
+    bool passes(const AlignedReadCore& read) const noexcept override;
 };
 
-struct IsNotSupplementaryAlignment : BasicReadFilter
+struct IsNotSupplementaryAlignment : CoreReadFilter
 {
     IsNotSupplementaryAlignment();
     IsNotSupplementaryAlignment(std::string name);
     
-    bool passes(const AlignedRead& read) const noexcept override;
+    bool passes(const AlignedReadCore& read) const noexcept override;
 };
 
-struct IsGoodMappingQuality : BasicReadFilter
+struct IsGoodMappingQuality : CoreReadFilter
 {
     using MappingQuality = AlignedRead::MappingQuality;
     
@@ -98,7 +128,7 @@ struct IsGoodMappingQuality : BasicReadFilter
     
     IsGoodMappingQuality(std::string name, MappingQuality good_mapping_quality);
     
-    bool passes(const AlignedRead& read) const noexcept override;
+    bool passes(const AlignedReadCore& read) const noexcept override;
     
 private:
     MappingQuality good_mapping_quality_;
@@ -138,39 +168,39 @@ private:
     unsigned min_good_bases_;
 };
 
-struct IsMapped : BasicReadFilter
+struct IsMapped : CoreReadFilter
 {
     IsMapped();
     IsMapped(std::string name);
     
-    bool passes(const AlignedRead& read) const noexcept override;
+    bool passes(const AlignedReadCore& read) const noexcept override;
 };
 
-struct IsNotChimeric : BasicReadFilter
+struct IsNotChimeric : CoreReadFilter
 {
     IsNotChimeric();
     IsNotChimeric(std::string name);
     
-    bool passes(const AlignedRead& read) const noexcept override;
+    bool passes(const AlignedReadCore& read) const noexcept override;
 };
 
-struct IsNextSegmentMapped : BasicReadFilter
+struct IsNextSegmentMapped : CoreReadFilter
 {
     IsNextSegmentMapped();
     IsNextSegmentMapped(std::string name);
     
-    bool passes(const AlignedRead& read) const noexcept override;
+    bool passes(const AlignedReadCore& read) const noexcept override;
 };
 
-struct IsNotMarkedDuplicate : BasicReadFilter
+struct IsNotMarkedDuplicate : CoreReadFilter
 {
     IsNotMarkedDuplicate();
     IsNotMarkedDuplicate(std::string name);
     
-    bool passes(const AlignedRead& read) const noexcept override;
+    bool passes(const AlignedReadCore& read) const noexcept override;
 };
 
-struct IsShort : BasicReadFilter
+struct IsShort : CoreReadFilter
 {
     using Length = AlignedRead::NucleotideSequence::size_type;
     
@@ -178,13 +208,13 @@ struct IsShort : BasicReadFilter
     explicit IsShort(Length max_length);
     IsShort(std::string name, Length max_length);
     
-    bool passes(const AlignedRead& read) const noexcept override;
+    bool passes(const AlignedReadCore& read) const noexcept override;
 
 private:
     Length max_length_;
 };
 
-struct IsLong : BasicReadFilter
+struct IsLong : CoreReadFilter
 {
     using Length = AlignedRead::AlignedRead::NucleotideSequence::size_type;
     
@@ -192,7 +222,7 @@ struct IsLong : BasicReadFilter
     explicit IsLong(Length min_length);
     IsLong(std::string name, Length min_length);
     
-    bool passes(const AlignedRead& read) const noexcept override;
+    bool passes(const AlignedReadCore& read) const noexcept override;
     
 private:
     Length min_length_;
@@ -206,28 +236,28 @@ struct IsNotContaminated : BasicReadFilter
     bool passes(const AlignedRead& read) const noexcept override;
 };
 
-struct IsNotMarkedQcFail : BasicReadFilter
+struct IsNotMarkedQcFail : CoreReadFilter
 {
     IsNotMarkedQcFail();
     IsNotMarkedQcFail(std::string name);
     
-    bool passes(const AlignedRead& read) const noexcept override;
+    bool passes(const AlignedReadCore& read) const noexcept override;
 };
 
-struct IsProperTemplate : BasicReadFilter
+struct IsProperTemplate : CoreReadFilter
 {
     IsProperTemplate();
     IsProperTemplate(std::string name);
     
-    bool passes(const AlignedRead& read) const noexcept override;
+    bool passes(const AlignedReadCore& read) const noexcept override;
 };
     
-struct IsLocalTemplate : BasicReadFilter
+struct IsLocalTemplate : CoreReadFilter
 {
     IsLocalTemplate();
     IsLocalTemplate(std::string name);
     
-    bool passes(const AlignedRead& read) const noexcept override;
+    bool passes(const AlignedReadCore& read) const noexcept override;
 };
 
 // Context filters
@@ -50,6 +50,11 @@ public:
     
     unsigned num_filters() const noexcept;
     
+    // Core filters can also be applied to reads before they are decoded
+    unsigned num_core_filters() const noexcept;
+    // Returns the first core filter the read fails, or nullptr if the read passes all core filters
+    const CoreReadFilter* find_failing_core_filter(const AlignedReadCore& read) const noexcept;
+    
     void shrink_to_fit() noexcept; // Just removes extra capcity for filters
     
     // Like std::remove
@@ -63,6 +68,7 @@ public:
 private:
     std::vector<BasicFilterPtr> basic_filters_;
     std::vector<ContextFilterPtr> context_filters_;
+    std::vector<const CoreReadFilter*> core_filters_; // owned by basic_filters_
     
     bool passes_all_basic_filters(const AlignedRead& read) const noexcept;
     auto find_failing_basic_filter(const AlignedRead& read) const noexcept;
@@ -71,6 +77,9 @@ private:
 template <typename BidirIt>
 void ReadFilterer<BidirIt>::add(BasicFilterPtr filter)
 {
+    if (const auto core_filter = dynamic_cast<const CoreReadFilter*>(filter.get())) {
+        core_filters_.push_back(core_filter);
+    }
     basic_filters_.emplace_back(std::move(filter));
 }
 
@@ -86,11 +95,26 @@ unsigned ReadFilterer<BidirIt>::num_filters() const noexcept
     return static_cast<unsigned>(basic_filters_.size() + context_filters_.size());
 }
 
+template <typename BidirIt>
+unsigned ReadFilterer<BidirIt>::num_core_filters() const noexcept
+{
+    return static_cast<unsigned>(core_filters_.size());
+}
+
+template <typename BidirIt>
+const CoreReadFilter* ReadFilterer<BidirIt>::find_failing_core_filter(const AlignedReadCore& read) const noexcept
+{
+    const auto itr = std::find_if_not(std::cbegin(core_filters_), std::cend(core_filters_),
+                                      [&read] (const auto filter) { return (*filter)(read); });
+    return itr != std::cend(core_filters_) ? *itr : nullptr;
+}
+
 template <typename BidirIt>
 void ReadFilterer<BidirIt>::shrink_to_fit() noexcept
 {
     basic_filters_.shrink_to_fit();
     context_filters_.shrink_to_fit();
+    core_filters_.shrink_to_fit();
 }
 
 template <typename BidirIt>
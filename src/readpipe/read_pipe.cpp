@@ -6,6 +6,7 @@
 #include <utility>
 #include <iterator>
 #include <algorithm>
+#include <mutex>
 #include <cassert>
 
 #include "utils/read_stats.hpp"
@@ -83,9 +84,10 @@ void sort_each(Map& reads)
     }
 }
 
-auto fetch_batch(const ReadManager& rm, const std::vector<SampleName>& samples, const GenomicRegion& region)
+auto fetch_batch(const ReadManager& rm, const std::vector<SampleName>& samples, const GenomicRegion& region,
+                 const ReadManager::ReadFilter& filter)
 {
-    auto result = rm.fetch_reads(samples, region);
+    auto result = rm.fetch_reads(samples, region, filter);
     sort_each(result);
     return result;
 }
@@ -135,10 +137,38 @@ ReadMap ReadPipe::fetch_reads(const GenomicRegion& region, boost::optional<Repor
     for (const auto& sample : samples_) {
         result.emplace(std::piecewise_construct, std::forward_as_tuple(sample), std::forward_as_tuple());
     }
+    // Core filters are applied before reads are decoded, unless a transform depends on other
+    // reads in the template, in which case the filtered reads may still be needed
+    const bool prefilter_core {filterer_.num_core_filters() > 0 && prefilter_transformer_.num_template_transforms() == 0};
     for (const auto& batch : batch_samples(samples_)) {
-        auto batch_reads = fetch_batch(source_, batch, region);
+        SampleFilterCountMap<SampleName, decltype(filterer_)> core_filter_counts {};
+        std::mutex core_filter_counts_mutex {};
+        ReadManager::ReadFilter core_filter {};
+        if (prefilter_core) {
+            if (debug_log_) {
+                for (const auto& sample : batch) core_filter_counts[sample];
+                // The source may call the filter from several threads if it fetches files concurrently
+                core_filter = [this, &core_filter_counts, &core_filter_counts_mutex] (const SampleName& sample, const AlignedReadCore& read) {
+                    const auto failed_filter = filterer_.find_failing_core_filter(read);
+                    if (failed_filter) {
+                        std::lock_guard<std::mutex> lock {core_filter_counts_mutex};
+                        ++core_filter_counts.at(sample)[failed_filter->name()];
+                    }
+                    return failed_filter == nullptr;
+                };
+            } else {
+                core_filter = [this] (const SampleName&, const AlignedReadCore& read) {
+                    return filterer_.find_failing_core_filter(read) == nullptr;
+                };
+            }
+        }
+        auto batch_reads = fetch_batch(source_, batch, region, core_filter);
         if (debug_log_) {
-            stream(*debug_log_) << "Fetched " << count_reads(batch_reads) << " unfiltered reads from " << region;
+            if (prefilter_core) {
+                stream(*debug_log_) << "Fetched " << count_reads(batch_reads) << " reads passing core filters from " << region;
+            } else {
+                stream(*debug_log_) << "Fetched " << count_reads(batch_reads) << " unfiltered reads from " << region;
+            }
         }
         transform_reads(batch_reads, prefilter_transformer_);
         if (debug_log_) {
@@ -148,6 +178,11 @@ ReadMap ReadPipe::fetch_reads(const GenomicRegion& region, boost::optional<Repor
                 filter_counts[sample].reserve(filterer_.num_filters());
             }
             erase_filtered_reads(batch_reads, filter(batch_reads, filterer_, filter_counts));
+            for (const auto& p : core_filter_counts) {
+                for (const auto& c : p.second) {
+                    filter_counts[p.first][c.first] += c.second;
+                }
+            }
             if (filterer_.num_filters() > 0) {
                 for (const auto& p : filter_counts) {
                     stream(*debug_log_) << "In sample " << p.first;
@@ -24,6 +24,11 @@ unsigned ReadTransformer::num_transforms() const noexcept
     return static_cast<unsigned>(read_transforms_.size() + template_transforms_.size());
 }
 
+unsigned ReadTransformer::num_template_transforms() const noexcept
+{
+    return static_cast<unsigned>(template_transforms_.size());
+}
+
 void ReadTransformer::shrink_to_fit() noexcept
 {
     read_transforms_.shrink_to_fit();
@@ -37,6 +37,7 @@ public:
     void add(TemplateTransform transform);
     
     unsigned num_transforms() const noexcept;
+    unsigned num_template_transforms() const noexcept;
     
     void shrink_to_fit() noexcept;
     
@@ -0,0 +1,56 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef aligned_allocator_hpp
+#define aligned_allocator_hpp
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <limits>
+
+namespace octopus {
+
+// Allocates storage aligned to Alignment bytes (e.g. a cache line or SIMD register width)
+template <typename T, std::size_t Alignment = 64>
+class AlignedAllocator
+{
+    static_assert(Alignment >= alignof(T) && (Alignment & (Alignment - 1)) == 0,
+                  "Alignment must be a power of two no smaller than alignof(T)");
+public:
+    using value_type = T;
+
+    template <typename U> struct rebind { using other = AlignedAllocator<U, Alignment>; };
+
+    AlignedAllocator() noexcept = default;
+    template <typename U> AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+    T* allocate(std::size_t n)
+    {
+        if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) throw std::bad_alloc {};
+        void* result {nullptr};
+        if (posix_memalign(&result, Alignment, n * sizeof(T)) != 0) throw std::bad_alloc {};
+        return static_cast<T*>(result);
+    }
+
+    void deallocate(T* p, std::size_t) noexcept
+    {
+        std::free(p);
+    }
+};
+
+template <typename T, typename U, std::size_t Alignment>
+bool operator==(const AlignedAllocator<T, Alignment>&, const AlignedAllocator<U, Alignment>&) noexcept
+{
+    return true;
+}
+
+template <typename T, typename U, std::size_t Alignment>
+bool operator!=(const AlignedAllocator<T, Alignment>&, const AlignedAllocator<U, Alignment>&) noexcept
+{
+    return false;
+}
+
+} // namespace octopus
+
+#endif
@@ -0,0 +1,124 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "executor.hpp"
+
+#include <algorithm>
+
+namespace octopus {
+
+Executor::Executor(const unsigned max_concurrency)
+: max_concurrency_ {std::max(max_concurrency, 1u)}
+, permit_mutex_ {}
+, permit_released_ {}
+, num_participants_ {0}
+, num_busy_helpers_ {0}
+, num_waiting_participants_ {0}
+, metrics_mutex_ {}
+, metrics_ {}
+, helpers_ {max_concurrency_ - 1}
+{}
+
+unsigned Executor::max_concurrency() const noexcept
+{
+    return max_concurrency_;
+}
+
+std::size_t Executor::num_available_helpers() const noexcept
+{
+    std::lock_guard<std::mutex> lock {permit_mutex_};
+    // The submitting thread is runnable even if it is not a registered participant
+    const auto num_runnable = std::max(num_participants_, 1u) + num_busy_helpers_;
+    if (num_waiting_participants_ > 0 || num_runnable >= max_concurrency_) return 0;
+    return std::min(max_concurrency_ - num_runnable, static_cast<unsigned>(helpers_.size()) - num_busy_helpers_);
+}
+
+std::vector<std::pair<std::string, Executor::CallsiteMetrics>> Executor::metrics() const
+{
+    std::vector<std::pair<std::string, CallsiteMetrics>> result {};
+    std::lock_guard<std::mutex> lock {metrics_mutex_};
+    result.reserve(metrics_.size());
+    for (const auto& p : metrics_) {
+        CallsiteMetrics metrics {};
+        metrics.submissions = p.second->submissions;
+        metrics.tasks = p.second->tasks;
+        metrics.helper_tasks = p.second->helper_tasks;
+        metrics.refused_helpers = p.second->refused_helpers;
+        result.emplace_back(p.first, metrics);
+    }
+    std::sort(std::begin(result), std::end(result), [] (const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+    return result;
+}
+
+// private methods
+
+Executor::AtomicCallsiteMetrics& Executor::callsite_metrics(const char* callsite)
+{
+    std::lock_guard<std::mutex> lock {metrics_mutex_};
+    auto& result = metrics_[callsite];
+    if (!result) result = std::make_unique<AtomicCallsiteMetrics>();
+    return *result;
+}
+
+bool Executor::try_acquire_helper() noexcept
+{
+    std::lock_guard<std::mutex> lock {permit_mutex_};
+    const auto num_runnable = std::max(num_participants_, 1u) + num_busy_helpers_;
+    if (num_waiting_participants_ > 0 || num_runnable >= max_concurrency_ || num_busy_helpers_ >= helpers_.size()) {
+        return false;
+    }
+    ++num_busy_helpers_;
+    return true;
+}
+
+void Executor::release_helper() noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock {permit_mutex_};
+        --num_busy_helpers_;
+    }
+    permit_released_.notify_all();
+}
+
+Executor::Participant::Participant(Executor* executor) noexcept : executor_ {executor}
+{
+    if (!executor_) return;
+    std::unique_lock<std::mutex> lock {executor_->permit_mutex_};
+    ++executor_->num_waiting_participants_;
+    executor_->permit_released_.wait(lock, [this] () {
+        return executor_->num_participants_ + executor_->num_busy_helpers_ < executor_->max_concurrency_;
+    });
+    --executor_->num_waiting_participants_;
+    ++executor_->num_participants_;
+}
+
+Executor::Participant::~Participant() noexcept
+{
+    if (!executor_) return;
+    {
+        std::lock_guard<std::mutex> lock {executor_->permit_mutex_};
+        --executor_->num_participants_;
+    }
+    executor_->permit_released_.notify_all();
+}
+
+namespace {
+
+std::mutex installed_executor_mutex;
+std::weak_ptr<Executor> installed_executor {};
+
+} // namespace
+
+void install_executor(const std::shared_ptr<Executor>& executor) noexcept
+{
+    std::lock_guard<std::mutex> lock {installed_executor_mutex};
+    installed_executor = executor;
+}
+
+std::shared_ptr<Executor> get_executor() noexcept
+{
+    std::lock_guard<std::mutex> lock {installed_executor_mutex};
+    return installed_executor.lock();
+}
+
+} // namespace octopus
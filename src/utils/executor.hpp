@@ -0,0 +1,235 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef executor_hpp
+#define executor_hpp
+
+#include <cstddef>
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <atomic>
+#include <exception>
+#include <type_traits>
+#include <algorithm>
+
+#include "thread_pool.hpp"
+
+namespace octopus {
+
+/*
+    Executor runs the parallel parts of calling tasks on a fixed set of helper threads.
+
+    The number of runnable threads is bounded by max_concurrency: threads running calling tasks
+    register as participants, and participants plus busy helpers never exceed max_concurrency.
+    Helpers are only recruited when there is a spare core, and stop taking work when a thread is
+    waiting to register. Submitting threads always do work themselves (caller-runs), so work never
+    waits on a helper that is not coming, and nested submissions cannot deadlock.
+
+    Each submission names its callsite so the amount of work helpers took can be reported.
+ */
+class Executor
+{
+public:
+    struct CallsiteMetrics
+    {
+        std::size_t submissions = 0, tasks = 0, helper_tasks = 0, refused_helpers = 0;
+    };
+
+    class Participant;
+
+    Executor() = delete;
+
+    explicit Executor(unsigned max_concurrency);
+
+    Executor(const Executor&)            = delete;
+    Executor& operator=(const Executor&) = delete;
+    Executor(Executor&&)                 = delete;
+    Executor& operator=(Executor&&)      = delete;
+
+    ~Executor() = default;
+
+    unsigned max_concurrency() const noexcept;
+    std::size_t num_available_helpers() const noexcept;
+
+    // Calls body(i) for each i < n, returning once all calls have finished. The calling thread
+    // takes part, so the loop runs sequentially if no helpers are available. The first exception
+    // thrown by body is rethrown once the loop has finished.
+    template <typename F>
+    void parallel_for(const char* callsite, std::size_t n, F body);
+
+    // Runs helper() on up to max_helpers available helpers and returns the number recruited. The
+    // caller should also work, and is responsible for waiting for any helpers it depends on.
+    template <typename F>
+    std::size_t recruit(const char* callsite, std::size_t max_helpers, F helper);
+    
+    // Runs f on a helper if one is available, otherwise when the result is first waited on
+    template <typename F>
+    auto async(const char* callsite, F f) -> std::future<std::result_of_t<F()>>;
+
+    std::vector<std::pair<std::string, CallsiteMetrics>> metrics() const;
+
+private:
+    struct AtomicCallsiteMetrics
+    {
+        std::atomic<std::size_t> submissions {0}, tasks {0}, helper_tasks {0}, refused_helpers {0};
+    };
+
+    struct Loop
+    {
+        Loop(std::size_t n) : n {n}, next {0}, num_done {0}, mutex {}, done {}, error {} {}
+        const std::size_t n;
+        std::atomic<std::size_t> next;
+        std::size_t num_done;
+        std::mutex mutex;
+        std::condition_variable done;
+        std::exception_ptr error;
+    };
+
+    class HelperPermit;
+
+    unsigned max_concurrency_;
+    mutable std::mutex permit_mutex_;
+    std::condition_variable permit_released_;
+    unsigned num_participants_, num_busy_helpers_;
+    std::atomic<unsigned> num_waiting_participants_;
+    mutable std::mutex metrics_mutex_;
+    std::unordered_map<std::string, std::unique_ptr<AtomicCallsiteMetrics>> metrics_;
+    ThreadPool helpers_; // last, so helpers are joined before anything they use is destroyed
+
+    AtomicCallsiteMetrics& callsite_metrics(const char* callsite);
+    bool try_acquire_helper() noexcept;
+    void release_helper() noexcept;
+    template <typename F> std::size_t recruit(AtomicCallsiteMetrics& metrics, std::size_t max_helpers, F& helper);
+    template <typename F> void run(Loop& loop, F& body, AtomicCallsiteMetrics* helper_metrics);
+};
+
+// Registers the current thread as running a calling task for its lifetime, waiting for a busy
+// helper to finish if there is no spare core
+class Executor::Participant
+{
+public:
+    Participant() = delete;
+
+    explicit Participant(Executor* executor) noexcept; // executor may be null
+
+    Participant(const Participant&)            = delete;
+    Participant& operator=(const Participant&) = delete;
+    Participant(Participant&&)                 = delete;
+    Participant& operator=(Participant&&)      = delete;
+
+    ~Participant() noexcept;
+
+private:
+    Executor* executor_;
+};
+
+class Executor::HelperPermit
+{
+public:
+    HelperPermit(Executor& executor) noexcept : executor_ {executor} {}
+    HelperPermit(const HelperPermit&)            = delete;
+    HelperPermit& operator=(const HelperPermit&) = delete;
+    ~HelperPermit() noexcept { executor_.release_helper(); }
+private:
+    Executor& executor_;
+};
+
+template <typename F>
+std::size_t Executor::recruit(AtomicCallsiteMetrics& metrics, const std::size_t max_helpers, F& helper)
+{
+    std::size_t result {0};
+    for (; result < max_helpers && try_acquire_helper(); ++result) {
+        helpers_.push([this, helper] () {
+            HelperPermit permit {*this};
+            helper();
+        });
+    }
+    metrics.refused_helpers += max_helpers - result;
+    return result;
+}
+
+template <typename F>
+std::size_t Executor::recruit(const char* callsite, const std::size_t max_helpers, F helper)
+{
+    auto& metrics = callsite_metrics(callsite);
+    ++metrics.submissions;
+    const auto result = recruit(metrics, max_helpers, helper);
+    metrics.tasks += result + 1;
+    metrics.helper_tasks += result;
+    return result;
+}
+
+template <typename F>
+void Executor::run(Loop& loop, F& body, AtomicCallsiteMetrics* helper_metrics)
+{
+    for (auto i = loop.next++; i < loop.n; i = loop.next++) {
+        std::exception_ptr error {};
+        try {
+            body(i);
+        } catch (...) {
+            error = std::current_exception();
+        }
+        if (helper_metrics) ++helper_metrics->helper_tasks;
+        std::lock_guard<std::mutex> lock {loop.mutex};
+        if (error && !loop.error) loop.error = error;
+        if (++loop.num_done == loop.n) loop.done.notify_all();
+        // Remaining work is left to the submitting thread so the waiting thread can run
+        if (helper_metrics && num_waiting_participants_ > 0) break;
+    }
+}
+
+template <typename F>
+void Executor::parallel_for(const char* callsite, const std::size_t n, F body)
+{
+    if (n == 0) return;
+    auto& metrics = callsite_metrics(callsite);
+    ++metrics.submissions;
+    metrics.tasks += n;
+    auto loop = std::make_shared<Loop>(n);
+    // Helpers may start after the loop has finished, in which case they find no work and never touch body
+    const auto helper = [this, loop, &body, &metrics] () { run(*loop, body, &metrics); };
+    recruit(metrics, std::min(n, static_cast<std::size_t>(max_concurrency_)) - 1, helper);
+    run(*loop, body, nullptr);
+    std::unique_lock<std::mutex> lock {loop->mutex};
+    loop->done.wait(lock, [&] () { return loop->num_done == n; });
+    if (loop->error) std::rethrow_exception(loop->error);
+}
+
+template <typename F>
+auto Executor::async(const char* callsite, F f) -> std::future<std::result_of_t<F()>>
+{
+    using ResultType = std::result_of_t<F()>;
+    auto& metrics = callsite_metrics(callsite);
+    ++metrics.submissions;
+    ++metrics.tasks;
+    if (try_acquire_helper()) {
+        ++metrics.helper_tasks;
+        auto task = std::make_shared<std::packaged_task<ResultType()>>(std::move(f));
+        auto result = task->get_future();
+        helpers_.push([this, task] () {
+            HelperPermit permit {*this};
+            (*task)();
+        });
+        return result;
+    } else {
+        ++metrics.refused_helpers;
+        return std::async(std::launch::deferred, std::move(f));
+    }
+}
+
+// Installs the executor that calling tasks should submit parallel work to. Only a weak reference
+// is kept, so there is no executor once the installed one is destroyed.
+void install_executor(const std::shared_ptr<Executor>& executor) noexcept;
+
+// Returns the installed executor, or nullptr if there is none
+std::shared_ptr<Executor> get_executor() noexcept;
+
+} // namespace octopus
+
+#endif
@@ -0,0 +1,97 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+// This is an unbounded lock-free multi-producer single-consumer queue, derived from
+// Dmitry Vyukov's intrusive MPSC node-based queue.
+
+#ifndef mpsc_queue_hpp
+#define mpsc_queue_hpp
+
+#include <atomic>
+#include <utility>
+
+#include <boost/optional.hpp>
+
+namespace octopus {
+
+template <typename T>
+class MPSCQueue
+{
+public:
+    MPSCQueue();
+
+    MPSCQueue(const MPSCQueue&)            = delete;
+    MPSCQueue& operator=(const MPSCQueue&) = delete;
+    MPSCQueue(MPSCQueue&&)                 = delete;
+    MPSCQueue& operator=(MPSCQueue&&)      = delete;
+
+    ~MPSCQueue() noexcept;
+
+    // May be called from any thread
+    void push(T item);
+
+    // Must only be called by the consumer thread. May return boost::none if a push is
+    // in progress; the producer will complete the push without further synchronisation.
+    boost::optional<T> try_pop();
+
+    // Must only be called by the consumer thread
+    bool empty() const noexcept;
+
+private:
+    struct Node
+    {
+        Node() = default;
+        Node(T item) : next {nullptr}, item {std::move(item)} {}
+        std::atomic<Node*> next = {nullptr};
+        boost::optional<T> item;
+    };
+
+    std::atomic<Node*> head_; // producers push here
+    Node* tail_;              // consumer pops from here
+};
+
+template <typename T>
+MPSCQueue<T>::MPSCQueue()
+: head_ {new Node {}}
+, tail_ {head_.load()}
+{}
+
+template <typename T>
+MPSCQueue<T>::~MPSCQueue() noexcept
+{
+    while (tail_) {
+        auto next = tail_->next.load(std::memory_order_relaxed);
+        delete tail_;
+        tail_ = next;
+    }
+}
+
+template <typename T>
+void MPSCQueue<T>::push(T item)
+{
+    auto node = new Node {std::move(item)};
+    const auto prev = head_.exchange(node, std::memory_order_acq_rel);
+    prev->next.store(node, std::memory_order_release);
+}
+
+template <typename T>
+boost::optional<T> MPSCQueue<T>::try_pop()
+{
+    const auto next = tail_->next.load(std::memory_order_acquire);
+    if (!next) return boost::none;
+    boost::optional<T> result {std::move(next->item)};
+    next->item = boost::none;
+    delete tail_;
+    tail_ = next; // next becomes the new stub node
+    return result;
+}
+
+template <typename T>
+bool MPSCQueue<T>::empty() const noexcept
+{
+    return tail_->next.load(std::memory_order_acquire) == nullptr;
+}
+
+} // namespace octopus
+
+#endif
@@ -12,7 +12,10 @@
 #include <utility>
 #include <type_traits>
 
+#include <boost/optional.hpp>
+
 #include "thread_pool.hpp"
+#include "executor.hpp"
 
 namespace octopus {
 
@@ -21,24 +24,23 @@ namespace detail {
 template <typename InputIt,
           typename OutputIt,
           typename UnaryOp>
-OutputIt parallel_transform(InputIt first, InputIt last, OutputIt result, UnaryOp op,
+OutputIt parallel_transform(const char* callsite, InputIt first, InputIt last, OutputIt result, UnaryOp op,
                             std::random_access_iterator_tag)
 {
-    using value_type  = typename std::iterator_traits<InputIt>::value_type;
-    using result_type = std::result_of_t<UnaryOp(value_type)>;
-    std::vector<std::future<result_type>> results(std::distance(first, last));
-    std::transform(first, last, std::begin(results),
-                   [&op](const auto& value) {
-                       return std::async(std::launch::async, op, std::cref(value));
-                   });
-    return std::transform(std::begin(results), std::end(results), result,
-                          [](auto& f) { return f.get(); });
+    using reference   = typename std::iterator_traits<InputIt>::reference;
+    using result_type = std::decay_t<std::result_of_t<UnaryOp(reference)>>;
+    const auto executor = get_executor();
+    if (!executor) return std::transform(first, last, result, std::move(op));
+    std::vector<boost::optional<result_type>> results(std::distance(first, last));
+    executor->parallel_for(callsite, results.size(), [&] (const std::size_t i) { results[i] = op(first[i]); });
+    return std::transform(std::make_move_iterator(std::begin(results)), std::make_move_iterator(std::end(results)), result,
+                          [] (auto&& value) { return std::move(*value); });
 }
 
 template <typename InputIt,
           typename OutputIt,
           typename UnaryOp>
-OutputIt parallel_transform(InputIt first, InputIt last, OutputIt result, UnaryOp op,
+OutputIt parallel_transform(const char* callsite, InputIt first, InputIt last, OutputIt result, UnaryOp op,
                             std::input_iterator_tag)
 {
     return std::transform(first, last, result, std::move(op));
@@ -48,26 +50,25 @@ template <typename InputIt1,
           typename InputIt2,
           typename OutputIt,
           typename BinaryOp>
-OutputIt parallel_transform(InputIt1 first1, InputIt1 last1, InputIt2 first2, OutputIt result, BinaryOp op,
+OutputIt parallel_transform(const char* callsite, InputIt1 first1, InputIt1 last1, InputIt2 first2, OutputIt result, BinaryOp op,
                             std::random_access_iterator_tag, std::random_access_iterator_tag)
 {
-    using value_type1  = typename std::iterator_traits<InputIt1>::value_type;
-    using value_type2  = typename std::iterator_traits<InputIt2>::value_type;
-    using result_type = std::result_of_t<BinaryOp(value_type1, value_type2)>;
-    std::vector<std::future<result_type>> results(std::distance(first1, last1));
-    std::transform(first1, last1, first2, std::begin(results),
-                   [&op](const auto& a, const auto& b) {
-                       return std::async(std::launch::async, op, std::cref(a), std::cref(b));
-                   });
-    return std::transform(std::begin(results), std::end(results), result,
-                          [](auto& f) { return f.get(); });
+    using reference1  = typename std::iterator_traits<InputIt1>::reference;
+    using reference2  = typename std::iterator_traits<InputIt2>::reference;
+    using result_type = std::decay_t<std::result_of_t<BinaryOp(reference1, reference2)>>;
+    const auto executor = get_executor();
+    if (!executor) return std::transform(first1, last1, first2, result, std::move(op));
+    std::vector<boost::optional<result_type>> results(std::distance(first1, last1));
+    executor->parallel_for(callsite, results.size(), [&] (const std::size_t i) { results[i] = op(first1[i], first2[i]); });
+    return std::transform(std::make_move_iterator(std::begin(results)), std::make_move_iterator(std::end(results)), result,
+                          [] (auto&& value) { return std::move(*value); });
 }
 
 template <typename InputIt1,
           typename InputIt2,
           typename OutputIt,
           typename BinaryOp>
-OutputIt parallel_transform(InputIt1 first1, InputIt1 last1, InputIt2 first2, OutputIt result, BinaryOp op,
+OutputIt parallel_transform(const char* callsite, InputIt1 first1, InputIt1 last1, InputIt2 first2, OutputIt result, BinaryOp op,
                             std::input_iterator_tag, std::input_iterator_tag)
 {
     return std::transform(first1, last1, first2, result, std::move(op));
@@ -75,26 +76,45 @@ OutputIt parallel_transform(InputIt1 first1, InputIt1 last1, InputIt2 first2, Ou
 
 } // namespace detail
 
+// Elements are transformed on the installed Executor, with the calling thread taking part; if
+// there is no executor, or the iterators are not random access, the transform is sequential.
 template <typename InputIt,
           typename OutputIt,
           typename UnaryOp>
-OutputIt parallel_transform(InputIt first, InputIt last, OutputIt result, UnaryOp op)
+OutputIt parallel_transform(const char* callsite, InputIt first, InputIt last, OutputIt result, UnaryOp op)
 {
-    return detail::parallel_transform(first, last, result, std::move(op),
+    return detail::parallel_transform(callsite, first, last, result, std::move(op),
                                       typename std::iterator_traits<InputIt>::iterator_category {});
 }
 
+template <typename InputIt,
+          typename OutputIt,
+          typename UnaryOp>
+OutputIt parallel_transform(InputIt first, InputIt last, OutputIt result, UnaryOp op)
+{
+    return parallel_transform("parallel_transform", first, last, result, std::move(op));
+}
+
 template <typename InputIt1,
           typename InputIt2,
           typename OutputIt,
           typename BinaryOp>
-OutputIt parallel_transform(InputIt1 first1, InputIt1 last1, InputIt2 first2, OutputIt result, BinaryOp op)
+OutputIt parallel_transform(const char* callsite, InputIt1 first1, InputIt1 last1, InputIt2 first2, OutputIt result, BinaryOp op)
 {
-    return detail::parallel_transform(first1, last1, first2, result, std::move(op),
+    return detail::parallel_transform(callsite, first1, last1, first2, result, std::move(op),
                                       typename std::iterator_traits<InputIt1>::iterator_category {},
                                       typename std::iterator_traits<InputIt2>::iterator_category {});
 }
 
+template <typename InputIt1,
+          typename InputIt2,
+          typename OutputIt,
+          typename BinaryOp>
+OutputIt parallel_transform(InputIt1 first1, InputIt1 last1, InputIt2 first2, OutputIt result, BinaryOp op)
+{
+    return parallel_transform("parallel_transform", first1, last1, first2, result, std::move(op));
+}
+
 namespace detail {
 
 template <typename InputIt,
@@ -0,0 +1,293 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#if __GNUC__ >= 6
+    #pragma GCC diagnostic ignored "-Wignored-attributes"
+#endif
+
+#include "simd_log_sum_exp.hpp"
+
+#include <vector>
+#include <string>
+#include <atomic>
+#include <cmath>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <immintrin.h>
+
+namespace octopus { namespace maths { namespace simd {
+
+namespace {
+
+template <typename T>
+double log_sum_exp_at(const T* const* columns, const double* log_weights,
+                      const std::size_t k, const std::size_t i) noexcept
+{
+    double max_term {columns[0][i] + log_weights[0]};
+    for (std::size_t j {1}; j < k; ++j) {
+        max_term = std::max(max_term, columns[j][i] + log_weights[j]);
+    }
+    double sum {0};
+    for (std::size_t j {0}; j < k; ++j) {
+        sum += std::exp(columns[j][i] + log_weights[j] - max_term);
+    }
+    return max_term + std::log(sum);
+}
+
+template <typename T>
+double scalar_sum_log_sum_exp(const T* const* columns, const double* log_weights,
+                              const std::size_t k, const std::size_t n) noexcept
+{
+    double result {0};
+    for (std::size_t i {0}; i < n; ++i) {
+        result += log_sum_exp_at(columns, log_weights, k, i);
+    }
+    return result;
+}
+
+template <typename T>
+void scalar_log_sum_exp(const T* const* columns, const double* log_weights,
+                        const std::size_t k, const std::size_t n, T* result) noexcept
+{
+    for (std::size_t i {0}; i < n; ++i) {
+        result[i] = log_sum_exp_at(columns, log_weights, k, i);
+    }
+}
+
+} // namespace
+
+// As for the pair HMM kernels, the vector kernels are compiled once for each instruction set by
+// including them inside a namespace named after it, between target pragmas.
+
+#if defined(__x86_64__) || defined(__i386__)
+#if defined(__GNUC__) && !defined(__clang__)
+    #define OCTOPUS_LOG_SUM_EXP_MULTIVERSION
+    #define OCTOPUS_LOG_SUM_EXP_BEGIN_AVX2 _Pragma("GCC push_options") _Pragma("GCC target(\"avx2\")")
+    #define OCTOPUS_LOG_SUM_EXP_BEGIN_AVX512 _Pragma("GCC push_options") _Pragma("GCC target(\"avx512f\")")
+    #define OCTOPUS_LOG_SUM_EXP_END_TARGET _Pragma("GCC pop_options")
+#elif defined(__clang__) && __clang_major__ >= 6
+    #define OCTOPUS_LOG_SUM_EXP_MULTIVERSION
+    #define OCTOPUS_LOG_SUM_EXP_BEGIN_AVX2 _Pragma("clang attribute push (__attribute__((target(\"avx2\"))), apply_to = function)")
+    #define OCTOPUS_LOG_SUM_EXP_BEGIN_AVX512 _Pragma("clang attribute push (__attribute__((target(\"avx512f\"))), apply_to = function)")
+    #define OCTOPUS_LOG_SUM_EXP_END_TARGET _Pragma("clang attribute pop")
+#endif
+#endif
+
+#ifdef OCTOPUS_LOG_SUM_EXP_MULTIVERSION
+
+OCTOPUS_LOG_SUM_EXP_BEGIN_AVX2
+namespace avx2 {
+namespace batch {
+    using Vector = __m256d;
+    using Mask = __m256d;
+    constexpr std::size_t lanes {4};
+    inline Vector load(const double* values) noexcept { return _mm256_loadu_pd(values); }
+    inline Vector load(const float* values) noexcept { return _mm256_cvtps_pd(_mm_loadu_ps(values)); }
+    inline void store(double* values, Vector a) noexcept { _mm256_storeu_pd(values, a); }
+    inline void store(float* values, Vector a) noexcept { _mm_storeu_ps(values, _mm256_cvtpd_ps(a)); }
+    inline Vector set1(double value) noexcept { return _mm256_set1_pd(value); }
+    inline Vector add(Vector a, Vector b) noexcept { return _mm256_add_pd(a, b); }
+    inline Vector sub(Vector a, Vector b) noexcept { return _mm256_sub_pd(a, b); }
+    inline Vector mul(Vector a, Vector b) noexcept { return _mm256_mul_pd(a, b); }
+    inline Vector div(Vector a, Vector b) noexcept { return _mm256_div_pd(a, b); }
+    inline Vector max(Vector a, Vector b) noexcept { return _mm256_max_pd(a, b); }
+    inline Vector round(Vector a) noexcept { return _mm256_round_pd(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+    inline Mask greater(Vector a, Vector b) noexcept { return _mm256_cmp_pd(a, b, _CMP_GT_OQ); }
+    inline Vector blend(Vector a, Vector b, Mask mask) noexcept { return _mm256_blendv_pd(a, b, mask); }
+    // 2^n for integral n in [-1022, 0]
+    inline Vector pow2(Vector n) noexcept
+    {
+        const auto biased = _mm256_castpd_si256(_mm256_add_pd(n, _mm256_set1_pd(4503599627370496.0 + 1023)));
+        return _mm256_castsi256_pd(_mm256_slli_epi64(biased, 52));
+    }
+    // floor(log2(a)) for positive normal a
+    inline Vector exponent(Vector a) noexcept
+    {
+        const auto magic = _mm256_set1_pd(4503599627370496.0);
+        const auto bits = _mm256_srli_epi64(_mm256_castpd_si256(a), 52);
+        const auto biased = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(bits, _mm256_castpd_si256(magic))), magic);
+        return _mm256_sub_pd(biased, _mm256_set1_pd(1023));
+    }
+    // a / 2^exponent(a), in [1, 2)
+    inline Vector mantissa(Vector a) noexcept
+    {
+        const auto bits = _mm256_and_si256(_mm256_castpd_si256(a), _mm256_set1_epi64x(0x000FFFFFFFFFFFFFll));
+        return _mm256_castsi256_pd(_mm256_or_si256(bits, _mm256_set1_epi64x(0x3FF0000000000000ll)));
+    }
+    inline double reduce_add(Vector a) noexcept
+    {
+        alignas(32) double values[lanes];
+        _mm256_store_pd(values, a);
+        return (values[0] + values[1]) + (values[2] + values[3]);
+    }
+} // namespace batch
+#include "simd_log_sum_exp_kernels.hpp"
+} // namespace avx2
+OCTOPUS_LOG_SUM_EXP_END_TARGET
+
+OCTOPUS_LOG_SUM_EXP_BEGIN_AVX512
+namespace avx512 {
+namespace batch {
+    using Vector = __m512d;
+    using Mask = __mmask8;
+    constexpr std::size_t lanes {8};
+    inline Vector load(const double* values) noexcept { return _mm512_loadu_pd(values); }
+    inline Vector load(const float* values) noexcept { return _mm512_cvtps_pd(_mm256_loadu_ps(values)); }
+    inline void store(double* values, Vector a) noexcept { _mm512_storeu_pd(values, a); }
+    inline void store(float* values, Vector a) noexcept { _mm256_storeu_ps(values, _mm512_cvtpd_ps(a)); }
+    inline Vector set1(double value) noexcept { return _mm512_set1_pd(value); }
+    inline Vector add(Vector a, Vector b) noexcept { return _mm512_add_pd(a, b); }
+    inline Vector sub(Vector a, Vector b) noexcept { return _mm512_sub_pd(a, b); }
+    inline Vector mul(Vector a, Vector b) noexcept { return _mm512_mul_pd(a, b); }
+    inline Vector div(Vector a, Vector b) noexcept { return _mm512_div_pd(a, b); }
+    inline Vector max(Vector a, Vector b) noexcept { return _mm512_max_pd(a, b); }
+    inline Vector round(Vector a) noexcept { return _mm512_roundscale_pd(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+    inline Mask greater(Vector a, Vector b) noexcept { return _mm512_cmp_pd_mask(a, b, _CMP_GT_OQ); }
+    inline Vector blend(Vector a, Vector b, Mask mask) noexcept { return _mm512_mask_blend_pd(mask, a, b); }
+    inline Vector pow2(Vector n) noexcept
+    {
+        const auto biased = _mm512_castpd_si512(_mm512_add_pd(n, _mm512_set1_pd(4503599627370496.0 + 1023)));
+        return _mm512_castsi512_pd(_mm512_slli_epi64(biased, 52));
+    }
+    inline Vector exponent(Vector a) noexcept
+    {
+        const auto magic = _mm512_set1_pd(4503599627370496.0);
+        const auto bits = _mm512_srli_epi64(_mm512_castpd_si512(a), 52);
+        const auto biased = _mm512_sub_pd(_mm512_castsi512_pd(_mm512_or_si512(bits, _mm512_castpd_si512(magic))), magic);
+        return _mm512_sub_pd(biased, _mm512_set1_pd(1023));
+    }
+    inline Vector mantissa(Vector a) noexcept
+    {
+        const auto bits = _mm512_and_si512(_mm512_castpd_si512(a), _mm512_set1_epi64(0x000FFFFFFFFFFFFFll));
+        return _mm512_castsi512_pd(_mm512_or_si512(bits, _mm512_set1_epi64(0x3FF0000000000000ll)));
+    }
+    inline double reduce_add(Vector a) noexcept
+    {
+        alignas(64) double values[lanes];
+        _mm512_store_pd(values, a);
+        return ((values[0] + values[1]) + (values[2] + values[3])) + ((values[4] + values[5]) + (values[6] + values[7]));
+    }
+} // namespace batch
+#include "simd_log_sum_exp_kernels.hpp"
+} // namespace avx512
+OCTOPUS_LOG_SUM_EXP_END_TARGET
+
+#endif // OCTOPUS_LOG_SUM_EXP_MULTIVERSION
+
+namespace {
+
+bool is_supported(const InstructionSet isa) noexcept
+{
+    switch (isa) {
+        case InstructionSet::scalar: return true;
+    #ifdef OCTOPUS_LOG_SUM_EXP_MULTIVERSION
+        case InstructionSet::avx2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2");
+        case InstructionSet::avx512:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx512f");
+    #endif
+        default: return false;
+    }
+}
+
+std::atomic<InstructionSet>& selected_instruction_set() noexcept
+{
+    static std::atomic<InstructionSet> result {supported_instruction_sets().back()};
+    return result;
+}
+
+template <typename T>
+double dispatch_sum_log_sum_exp(const T* const* columns, const double* log_weights,
+                                const std::size_t k, const std::size_t n) noexcept
+{
+    if (k == 0) return n > 0 ? -std::numeric_limits<double>::infinity() : 0;
+    switch (get_instruction_set()) {
+    #ifdef OCTOPUS_LOG_SUM_EXP_MULTIVERSION
+        case InstructionSet::avx512: return avx512::sum_log_sum_exp(columns, log_weights, k, n);
+        case InstructionSet::avx2:   return avx2::sum_log_sum_exp(columns, log_weights, k, n);
+    #endif
+        default: return scalar_sum_log_sum_exp(columns, log_weights, k, n);
+    }
+}
+
+template <typename T>
+void dispatch_log_sum_exp(const T* const* columns, const double* log_weights,
+                          const std::size_t k, const std::size_t n, T* result) noexcept
+{
+    if (k == 0) {
+        std::fill_n(result, n, -std::numeric_limits<T>::infinity());
+        return;
+    }
+    switch (get_instruction_set()) {
+    #ifdef OCTOPUS_LOG_SUM_EXP_MULTIVERSION
+        case InstructionSet::avx512: avx512::log_sum_exp(columns, log_weights, k, n, result); break;
+        case InstructionSet::avx2:   avx2::log_sum_exp(columns, log_weights, k, n, result); break;
+    #endif
+        default: scalar_log_sum_exp(columns, log_weights, k, n, result);
+    }
+}
+
+} // namespace
+
+std::vector<InstructionSet> supported_instruction_sets()
+{
+    std::vector<InstructionSet> result {};
+    for (auto isa : {InstructionSet::scalar, InstructionSet::avx2, InstructionSet::avx512}) {
+        if (is_supported(isa)) result.push_back(isa);
+    }
+    return result;
+}
+
+InstructionSet get_instruction_set() noexcept
+{
+    return selected_instruction_set().load(std::memory_order_relaxed);
+}
+
+void set_instruction_set(const InstructionSet isa)
+{
+    if (!is_supported(isa)) {
+        throw std::invalid_argument {"set_instruction_set: " + to_string(isa) + " is not supported"};
+    }
+    selected_instruction_set().store(isa, std::memory_order_relaxed);
+}
+
+std::string to_string(const InstructionSet isa)
+{
+    switch (isa) {
+        case InstructionSet::scalar: return "scalar";
+        case InstructionSet::avx2:   return "AVX2";
+        case InstructionSet::avx512: return "AVX-512";
+        default: return "unknown";
+    }
+}
+
+double sum_log_sum_exp(const double* const* columns, const double* log_weights,
+                       const std::size_t k, const std::size_t n) noexcept
+{
+    return dispatch_sum_log_sum_exp(columns, log_weights, k, n);
+}
+
+double sum_log_sum_exp(const float* const* columns, const double* log_weights,
+                       const std::size_t k, const std::size_t n) noexcept
+{
+    return dispatch_sum_log_sum_exp(columns, log_weights, k, n);
+}
+
+void log_sum_exp(const double* const* columns, const double* log_weights,
+                 const std::size_t k, const std::size_t n, double* result) noexcept
+{
+    dispatch_log_sum_exp(columns, log_weights, k, n, result);
+}
+
+void log_sum_exp(const float* const* columns, const double* log_weights,
+                 const std::size_t k, const std::size_t n, float* result) noexcept
+{
+    dispatch_log_sum_exp(columns, log_weights, k, n, result);
+}
+
+} // namespace simd
+} // namespace maths
+} // namespace octopus
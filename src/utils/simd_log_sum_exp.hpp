@@ -0,0 +1,41 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef simd_log_sum_exp_hpp
+#define simd_log_sum_exp_hpp
+
+#include <cstddef>
+#include <vector>
+#include <string>
+
+namespace octopus { namespace maths { namespace simd {
+
+// The kernels are compiled for each of these instruction sets and one is chosen at startup from
+// those supported by the CPU. The vector kernels evaluate several reads at once with polynomial
+// exp and log approximations that agree with the scalar kernel to within a few ulps per read.
+enum class InstructionSet { scalar, avx2, avx512 };
+
+std::vector<InstructionSet> supported_instruction_sets(); // in order of preference, best last
+InstructionSet get_instruction_set() noexcept;
+void set_instruction_set(InstructionSet isa); // throws std::invalid_argument if unsupported
+std::string to_string(InstructionSet isa);
+
+// Returns sum {i < n} ln sum {j < k} exp(columns[j][i] + log_weights[j]).
+// This is the log likelihood of n reads given a mixture of k haplotypes with read log likelihoods
+// in columns and log mixture weights log_weights.
+double sum_log_sum_exp(const double* const* columns, const double* log_weights,
+                       std::size_t k, std::size_t n) noexcept;
+double sum_log_sum_exp(const float* const* columns, const double* log_weights,
+                       std::size_t k, std::size_t n) noexcept;
+
+// Writes ln sum {j < k} exp(columns[j][i] + log_weights[j]) to result[i] for each i < n
+void log_sum_exp(const double* const* columns, const double* log_weights,
+                 std::size_t k, std::size_t n, double* result) noexcept;
+void log_sum_exp(const float* const* columns, const double* log_weights,
+                 std::size_t k, std::size_t n, float* result) noexcept;
+
+} // namespace simd
+} // namespace maths
+} // namespace octopus
+
+#endif
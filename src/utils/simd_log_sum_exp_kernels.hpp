@@ -0,0 +1,104 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+// This file is included by simd_log_sum_exp.cpp once for each instruction set, inside a namespace
+// named after it and after a 'batch' namespace defining the vector operations. It must not be
+// included anywhere else.
+
+// exp(x) for x <= 0. Values below -708 are clamped so the result is always a normal double.
+inline batch::Vector exp_nonpositive(batch::Vector x) noexcept
+{
+    using namespace batch;
+    x = max(x, set1(-708.0));
+    // x = n ln(2) + r, with |r| <= ln(2) / 2, so exp(x) = 2^n exp(r)
+    const auto n = round(mul(x, set1(1.44269504088896340736)));
+    auto r = sub(x, mul(n, set1(6.93145751953125e-1)));
+    r = sub(r, mul(n, set1(1.42860682030941723212e-6)));
+    // Taylor series of exp(r) to r^12 (truncation error < 1e-16 for |r| <= ln(2) / 2)
+    auto p = set1(2.08767569878680989792e-9);
+    p = add(mul(p, r), set1(2.50521083854417187751e-8));
+    p = add(mul(p, r), set1(2.75573192239858906526e-7));
+    p = add(mul(p, r), set1(2.75573192239858906526e-6));
+    p = add(mul(p, r), set1(2.48015873015873015873e-5));
+    p = add(mul(p, r), set1(1.98412698412698412698e-4));
+    p = add(mul(p, r), set1(1.38888888888888888889e-3));
+    p = add(mul(p, r), set1(8.33333333333333333333e-3));
+    p = add(mul(p, r), set1(4.16666666666666666667e-2));
+    p = add(mul(p, r), set1(1.66666666666666666667e-1));
+    p = add(mul(p, r), set1(0.5));
+    p = add(mul(p, r), set1(1.0));
+    p = add(mul(p, r), set1(1.0));
+    return mul(p, pow2(n));
+}
+
+// ln(x) for finite x >= 1
+inline batch::Vector log_positive(batch::Vector x) noexcept
+{
+    using namespace batch;
+    // x = 2^e m, with m in [sqrt(2) / 2, sqrt(2)), so ln(x) = e ln(2) + ln(m)
+    auto e = exponent(x);
+    auto m = mantissa(x);
+    const auto is_big = greater(m, set1(1.41421356237309504880));
+    m = blend(m, mul(m, set1(0.5)), is_big);
+    e = blend(e, add(e, set1(1.0)), is_big);
+    // ln(m) = 2 atanh(z), z = (m - 1) / (m + 1), with |z| < 0.172
+    const auto z = div(sub(m, set1(1.0)), add(m, set1(1.0)));
+    const auto z2 = mul(z, z);
+    auto p = set1(1.0 / 17);
+    p = add(mul(p, z2), set1(1.0 / 15));
+    p = add(mul(p, z2), set1(1.0 / 13));
+    p = add(mul(p, z2), set1(1.0 / 11));
+    p = add(mul(p, z2), set1(1.0 / 9));
+    p = add(mul(p, z2), set1(1.0 / 7));
+    p = add(mul(p, z2), set1(1.0 / 5));
+    p = add(mul(p, z2), set1(1.0 / 3));
+    p = add(mul(p, z2), set1(1.0));
+    return add(mul(e, set1(0.693147180559945309417)), mul(add(z, z), p));
+}
+
+template <typename T>
+inline batch::Vector log_sum_exp(const T* const* columns, const double* log_weights,
+                                 const std::size_t k, const std::size_t i) noexcept
+{
+    using namespace batch;
+    auto max_term = add(load(columns[0] + i), set1(log_weights[0]));
+    for (std::size_t j {1}; j < k; ++j) {
+        max_term = max(max_term, add(load(columns[j] + i), set1(log_weights[j])));
+    }
+    auto sum = set1(0.0);
+    for (std::size_t j {0}; j < k; ++j) {
+        sum = add(sum, exp_nonpositive(sub(add(load(columns[j] + i), set1(log_weights[j])), max_term)));
+    }
+    return add(max_term, log_positive(sum));
+}
+
+template <typename T>
+double sum_log_sum_exp(const T* const* columns, const double* log_weights,
+                       const std::size_t k, const std::size_t n) noexcept
+{
+    using namespace batch;
+    auto total = set1(0.0);
+    std::size_t i {0};
+    for (; i + lanes <= n; i += lanes) {
+        total = add(total, log_sum_exp(columns, log_weights, k, i));
+    }
+    auto result = reduce_add(total);
+    for (; i < n; ++i) {
+        result += log_sum_exp_at(columns, log_weights, k, i);
+    }
+    return result;
+}
+
+template <typename T>
+void log_sum_exp(const T* const* columns, const double* log_weights,
+                 const std::size_t k, const std::size_t n, T* result) noexcept
+{
+    using namespace batch;
+    std::size_t i {0};
+    for (; i + lanes <= n; i += lanes) {
+        store(result + i, log_sum_exp(columns, log_weights, k, i));
+    }
+    for (; i < n; ++i) {
+        result[i] = log_sum_exp_at(columns, log_weights, k, i);
+    }
+}
@@ -0,0 +1,92 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef work_stealing_deque_hpp
+#define work_stealing_deque_hpp
+
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+#include <boost/optional.hpp>
+
+namespace octopus {
+
+// A deque owned by a single worker. The owner takes from the front (oldest first) while idle
+// workers steal from the back, so owners and thieves rarely contend for the same items.
+// The lock is per-deque, so there is never a lock shared between all workers.
+template <typename T>
+class WorkStealingDeque
+{
+public:
+    WorkStealingDeque() = default;
+
+    WorkStealingDeque(const WorkStealingDeque&)            = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+    WorkStealingDeque(WorkStealingDeque&&)                 = delete;
+    WorkStealingDeque& operator=(WorkStealingDeque&&)      = delete;
+
+    ~WorkStealingDeque() = default;
+
+    void push(T item);
+    boost::optional<T> pop();
+    boost::optional<T> steal();
+
+    std::size_t size() const noexcept;
+    bool empty() const noexcept;
+
+private:
+    mutable std::mutex mutex_;
+    std::deque<T> items_;
+    std::atomic<std::size_t> size_ = {0};
+};
+
+template <typename T>
+void WorkStealingDeque<T>::push(T item)
+{
+    std::lock_guard<std::mutex> lk {mutex_};
+    items_.push_back(std::move(item));
+    ++size_;
+}
+
+template <typename T>
+boost::optional<T> WorkStealingDeque<T>::pop()
+{
+    if (size_ == 0) return boost::none;
+    std::lock_guard<std::mutex> lk {mutex_};
+    if (items_.empty()) return boost::none;
+    boost::optional<T> result {std::move(items_.front())};
+    items_.pop_front();
+    --size_;
+    return result;
+}
+
+template <typename T>
+boost::optional<T> WorkStealingDeque<T>::steal()
+{
+    if (size_ == 0) return boost::none;
+    std::unique_lock<std::mutex> lk {mutex_, std::try_to_lock};
+    if (!lk.owns_lock() || items_.empty()) return boost::none;
+    boost::optional<T> result {std::move(items_.back())};
+    items_.pop_back();
+    --size_;
+    return result;
+}
+
+template <typename T>
+std::size_t WorkStealingDeque<T>::size() const noexcept
+{
+    return size_;
+}
+
+template <typename T>
+bool WorkStealingDeque<T>::empty() const noexcept
+{
+    return size_ == 0;
+}
+
+} // namespace octopus
+
+#endif
@@ -0,0 +1,116 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+// Times HaplotypeTree on dense synthetic candidate sets, following the extend, extract, prune and clear cycle of
+// HaplotypeGenerator. The unit tests check the same cycles against the tree HaplotypeTree replaced.
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+
+#include "basics/genomic_region.hpp"
+#include "core/types/allele.hpp"
+#include "core/types/haplotype.hpp"
+#include "core/tools/hapgen/haplotype_tree.hpp"
+#include "io/reference/reference_genome.hpp"
+#include "mock/mock_reference.hpp"
+#include "benchmark_utils.hpp"
+
+using namespace octopus;
+
+namespace {
+
+const GenomicRegion::ContigName contig {"5"};
+
+char other_base(const char base) noexcept
+{
+    switch (base) {
+        case 'A': return 'C';
+        case 'C': return 'G';
+        case 'G': return 'T';
+        default: return 'A';
+    }
+}
+
+// Pairs of reference and alternative alleles, one every spacing bases, with a deletion or insertion every few sites
+std::vector<std::vector<Allele>> make_sites(const ReferenceGenome& reference, const GenomicRegion::Size spacing)
+{
+    const auto end = reference.contig_size(contig) - 10;
+    std::vector<std::vector<Allele>> result {};
+    for (GenomicRegion::Position begin {10}, i {0}; begin < end; begin += spacing, ++i) {
+        if (i % 7 == 3) {
+            const GenomicRegion region {contig, begin, begin + 2};
+            result.push_back({Allele {region, reference.fetch_sequence(region)}, Allele {region, ""}});
+        } else if (i % 11 == 5) {
+            const GenomicRegion region {contig, begin, begin};
+            result.push_back({Allele {region, ""}, Allele {region, "TA"}});
+        } else {
+            const GenomicRegion region {contig, begin, begin + 1};
+            const auto ref = reference.fetch_sequence(region);
+            result.push_back({Allele {region, ref}, Allele {region, std::string(1, other_base(ref.front()))}});
+        }
+    }
+    return result;
+}
+
+// FNV-1a, so checksums do not depend on the standard library
+void combine(std::uint64_t& checksum, const std::string& sequence) noexcept
+{
+    for (const char c : sequence) {
+        checksum ^= static_cast<unsigned char>(c);
+        checksum *= 1'099'511'628'211ull;
+    }
+    checksum ^= 0xff;
+    checksum *= 1'099'511'628'211ull;
+}
+
+// Extends the tree window_size sites at a time, extracting all haplotypes, pruning every other one, and then
+// clearing all but the last site of the window. The checksum covers the extracted haplotypes in order and the
+// haplotypes left after pruning.
+std::uint64_t run_cycle(coretools::HaplotypeTree& tree, const std::vector<std::vector<Allele>>& sites,
+                        const std::size_t window_size)
+{
+    std::uint64_t result {14'695'981'039'346'656'037ull};
+    for (std::size_t first {0}; first + window_size <= sites.size(); first += window_size - 1) {
+        for (std::size_t i {first}; i < first + window_size; ++i) {
+            for (const auto& allele : sites[i]) tree.extend(allele);
+        }
+        const auto haplotypes = tree.extract_haplotypes();
+        for (const auto& haplotype : haplotypes) combine(result, haplotype.sequence());
+        for (std::size_t i {0}; i < haplotypes.size(); i += 2) {
+            tree.prune_all(haplotypes[i]);
+        }
+        for (const auto& haplotype : tree.extract_haplotypes()) combine(result, haplotype.sequence());
+        const auto& last = sites[first + window_size - 1].front();
+        tree.clear(GenomicRegion {contig, 0, mapped_begin(last)});
+    }
+    tree.clear();
+    return result;
+}
+
+void run(const ReferenceGenome& reference, const GenomicRegion::Size spacing, const std::size_t window_size)
+{
+    const auto sites = make_sites(reference, spacing);
+    coretools::HaplotypeTree tree {contig, reference};
+    std::uint64_t checksum {0};
+    const auto duration = benchmark<std::chrono::microseconds>([&] () {
+        checksum += run_cycle(tree, sites, window_size);
+    }, 10);
+    std::cout << "HaplotypeTree (" << sites.size() << " sites, windows of " << window_size << "): "
+              << duration.count() << "us" << " [" << checksum << "]" << std::endl;
+}
+
+} // namespace
+
+int main()
+{
+    const auto reference = test::mock::make_reference();
+    for (const auto window_size : {6u, 9u, 12u}) {
+        run(reference, 3, window_size);
+    }
+    return 0;
+}
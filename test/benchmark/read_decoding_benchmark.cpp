@@ -0,0 +1,50 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+// Measures BAM record decoding throughput (reads/sec) and the memory held per decoded read.
+// Usage: read_decoding_benchmark <bam> <contig> <begin> <end> [num_repeats]
+
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <cstddef>
+
+#include <boost/filesystem/path.hpp>
+
+#include "basics/genomic_region.hpp"
+#include "basics/aligned_read.hpp"
+#include "io/read/read_reader.hpp"
+#include "benchmark_utils.hpp"
+
+using namespace octopus;
+
+int main(int argc, char** argv)
+{
+    if (argc < 5) {
+        std::cerr << "Usage: " << argv[0] << " <bam> <contig> <begin> <end> [num_repeats]" << std::endl;
+        return 1;
+    }
+    const boost::filesystem::path bam_path {argv[1]};
+    const GenomicRegion region {argv[2], std::stoul(argv[3]), std::stoul(argv[4])};
+    const unsigned num_repeats = argc > 5 ? std::stoul(argv[5]) : 10;
+    
+    const io::ReadReader reader {bam_path};
+    std::size_t num_reads {0};
+    MemoryFootprint bytes {0};
+    const auto duration = benchmark<std::chrono::microseconds>([&] () {
+        const auto reads = reader.fetch_reads(region);
+        num_reads = 0;
+        bytes = 0;
+        for (const auto& p : reads) {
+            num_reads += p.second.size();
+            bytes += footprint(p.second);
+        }
+    }, num_repeats);
+    
+    std::cout << "Decoded " << num_reads << " reads in " << duration.count() << "us" << std::endl;
+    if (num_reads > 0 && duration.count() > 0) {
+        std::cout << "reads/sec: " << static_cast<double>(num_reads) / duration.count() * 1e6 << std::endl;
+        std::cout << "bytes/read: " << static_cast<double>(bytes.bytes()) / num_reads << std::endl;
+    }
+    return 0;
+}
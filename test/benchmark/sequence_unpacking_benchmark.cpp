@@ -0,0 +1,63 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+// Compares BAM sequence unpacking one base at a time against unpack_bam_sequence for short and long reads.
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+
+#include "io/read/bam_sequence_unpacking.hpp"
+#include "benchmark_utils.hpp"
+
+using namespace octopus;
+
+namespace {
+
+char unpack_base(const std::uint8_t* packed, const std::size_t index) noexcept
+{
+    static constexpr const char* symbolTable {"=ACMGRSVTWYHKDBN"};
+    return symbolTable[(packed[index / 2] >> ((~index & 1) << 2)) & 0xf];
+}
+
+void unpack_bytewise(const std::uint8_t* packed, const std::size_t length, char* result)
+{
+    std::size_t i {0};
+    std::generate_n(result, length, [&] () { return unpack_base(packed, i++); });
+}
+
+template <typename F>
+void run(const std::string& name, F unpacker, const std::size_t read_length, const std::size_t num_reads)
+{
+    std::mt19937 generator {42};
+    std::uniform_int_distribution<unsigned> dist {0, 255};
+    std::vector<std::uint8_t> packed((read_length + 1) / 2 * num_reads);
+    std::generate(std::begin(packed), std::end(packed), [&] () { return static_cast<std::uint8_t>(dist(generator)); });
+    std::string sequence(read_length, 'N');
+    std::size_t checksum {0};
+    const auto duration = benchmark<std::chrono::microseconds>([&] () {
+        for (std::size_t i {0}; i < num_reads; ++i) {
+            unpacker(packed.data() + i * ((read_length + 1) / 2), read_length, &sequence[0]);
+            checksum += sequence.back();
+        }
+    }, 10);
+    std::cout << name << " (" << read_length << "bp): " << duration.count() << "us for " << num_reads << " reads"
+              << " [" << checksum << "]" << std::endl;
+}
+
+} // namespace
+
+int main()
+{
+    for (const auto read_length : {150u, 10'000u}) {
+        const std::size_t num_reads {30'000'000 / read_length};
+        run("bytewise", unpack_bytewise, read_length, num_reads);
+        run("unpack_bam_sequence", io::unpack_bam_sequence, read_length, num_reads);
+    }
+    return 0;
+}
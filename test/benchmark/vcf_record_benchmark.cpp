@@ -0,0 +1,81 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+// Compares VCF record read and write throughput (records/sec) for string valued VcfRecords and
+// columnar TypedVcfRecords. Records are written to a temporary BCF file (and index) which is removed afterwards.
+// Usage: vcf_record_benchmark <vcf> <contig> <begin> <end> [num_repeats]
+
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <cstddef>
+
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/operations.hpp>
+
+#include "basics/genomic_region.hpp"
+#include "io/variant/vcf_header.hpp"
+#include "io/variant/vcf_record.hpp"
+#include "io/variant/typed_vcf_record.hpp"
+#include "io/variant/vcf_reader.hpp"
+#include "io/variant/vcf_writer.hpp"
+#include "benchmark_utils.hpp"
+
+using namespace octopus;
+
+namespace {
+
+void report(const std::string& name, const std::size_t num_records, const std::chrono::microseconds duration)
+{
+    std::cout << name << ": " << num_records << " records in " << duration.count() << "us";
+    if (num_records > 0 && duration.count() > 0) {
+        std::cout << " (" << static_cast<double>(num_records) / duration.count() * 1e6 << " records/sec)";
+    }
+    std::cout << std::endl;
+}
+
+template <typename Container>
+auto benchmark_write(const Container& records, const VcfHeader& header, const boost::filesystem::path& path,
+                     const unsigned num_repeats)
+{
+    return benchmark<std::chrono::microseconds>([&] () {
+        VcfWriter writer {path, header};
+        for (const auto& record : records) writer << record;
+    }, num_repeats);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    if (argc < 5) {
+        std::cerr << "Usage: " << argv[0] << " <vcf> <contig> <begin> <end> [num_repeats]" << std::endl;
+        return 1;
+    }
+    const boost::filesystem::path vcf_path {argv[1]};
+    const GenomicRegion region {argv[2], std::stoul(argv[3]), std::stoul(argv[4])};
+    const unsigned num_repeats = argc > 5 ? std::stoul(argv[5]) : 10;
+
+    const VcfReader reader {vcf_path};
+    const auto header = reader.fetch_header();
+    const auto schema = reader.fetch_schema();
+
+    VcfReader::RecordContainer records {};
+    const auto string_read = benchmark<std::chrono::microseconds>([&] () {
+        records = reader.fetch_records(region);
+    }, num_repeats);
+    report("VcfRecord read", records.size(), string_read);
+
+    VcfReader::TypedRecordContainer typed_records {};
+    const auto typed_read = benchmark<std::chrono::microseconds>([&] () {
+        typed_records = reader.fetch_typed_records(region, schema);
+    }, num_repeats);
+    report("TypedVcfRecord read", typed_records.size(), typed_read);
+
+    const auto out_path = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("%%%%-%%%%-%%%%.bcf");
+    report("VcfRecord write", records.size(), benchmark_write(records, header, out_path, num_repeats));
+    report("TypedVcfRecord write", typed_records.size(), benchmark_write(typed_records, header, out_path, num_repeats));
+    boost::filesystem::remove(out_path);
+    boost::filesystem::remove(out_path.string() + ".csi");
+    return 0;
+}
@@ -0,0 +1,158 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <random>
+#include <algorithm>
+#include <cstddef>
+
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/operations.hpp>
+
+#include "ranger/ForestProbability.h"
+#include "ranger/DataDouble.h"
+
+#include "core/csr/filters/ranger_forest.hpp"
+
+namespace octopus { namespace test {
+
+namespace {
+
+using csr::RangerForest;
+
+// x0 and x2 are ordered, x1 is an unordered factor with levels 1 to 5, and TP is the dependent variable
+const std::vector<std::string> variable_names {"x0", "x1", "x2", "TP"};
+const std::size_t num_variables {3};
+
+using Rows = std::vector<std::vector<double>>;
+
+// TP depends on both an ordered and an unordered variable, with some noise
+Rows make_rows(const std::size_t num_rows, const unsigned seed)
+{
+    std::mt19937 generator {seed};
+    std::uniform_real_distribution<double> x0 {0, 10};
+    std::uniform_int_distribution<int> x1 {1, 5}, x2 {0, 20}, noise {0, 9};
+    Rows result(num_rows);
+    for (auto& row : result) {
+        row = {x0(generator), static_cast<double>(x1(generator)), static_cast<double>(x2(generator))};
+        const bool is_true = (row[0] > 5) != (row[1] == 2 || row[1] == 4);
+        row.push_back(is_true != (noise(generator) == 0) ? 1 : 0);
+    }
+    return result;
+}
+
+std::unique_ptr<ranger::Data> make_data(const Rows& rows)
+{
+    std::vector<double> columns(rows.size() * variable_names.size());
+    for (std::size_t row {0}; row < rows.size(); ++row) {
+        for (std::size_t col {0}; col < variable_names.size(); ++col) {
+            columns[col * rows.size() + row] = col < rows[row].size() ? rows[row][col] : 0;
+        }
+    }
+    return std::make_unique<ranger::DataDouble>(std::move(columns), variable_names, rows.size(), variable_names.size());
+}
+
+// Gives access to ranger's training setup and protected forest file reader
+class RangerForestRunner : public ranger::ForestProbability
+{
+public:
+    void init(const Rows& rows, const std::string& output_prefix, const bool prediction_mode)
+    {
+        std::vector<double> sample_fraction {1};
+        ForestProbability::init("TP", ranger::MemoryMode::MEM_DOUBLE, make_data(rows), 0, output_prefix, 50, 7, 1,
+                                ranger::ImportanceMode::IMP_NONE, 5, "", prediction_mode, true, {"x1"}, false,
+                                ranger::SplitRule::LOGRANK, false, sample_fraction, ranger::DEFAULT_ALPHA,
+                                ranger::DEFAULT_MINPROP, false, ranger::PredictionType::RESPONSE,
+                                ranger::DEFAULT_NUM_RANDOM_SPLITS, false);
+    }
+    void load(const boost::filesystem::path& forest)
+    {
+        loadFromFile(forest.string());
+    }
+};
+
+struct TrainedForest
+{
+    std::vector<double> class_values;
+    std::vector<std::size_t> num_splits; // by variable
+};
+
+// Trains a forest on rows and saves it to output_prefix.forest
+TrainedForest train(const Rows& rows, const boost::filesystem::path& output_prefix)
+{
+    RangerForestRunner forest {};
+    forest.init(rows, output_prefix.string(), false);
+    forest.run(false);
+    forest.saveToFile();
+    TrainedForest result {forest.getClassValues(), std::vector<std::size_t>(num_variables)};
+    const auto child_ids = forest.getChildNodeIDs();
+    const auto split_variables = forest.getSplitVarIDs();
+    for (std::size_t tree {0}; tree < child_ids.size(); ++tree) {
+        for (std::size_t node {0}; node < split_variables[tree].size(); ++node) {
+            if (child_ids[tree][0][node] != 0) ++result.num_splits.at(split_variables[tree][node]);
+        }
+    }
+    return result;
+}
+
+// The false class probabilities ranger itself predicts for rows
+std::vector<double> ranger_predict_false(const boost::filesystem::path& forest_file, const Rows& rows)
+{
+    RangerForestRunner forest {};
+    forest.init(rows, "", true);
+    forest.load(forest_file);
+    forest.run(false);
+    const auto& class_values = forest.getClassValues();
+    const auto false_class_idx = std::distance(std::cbegin(class_values), std::find(std::cbegin(class_values), std::cend(class_values), 0.0));
+    std::vector<double> result {};
+    for (const auto& probabilities : forest.getPredictions().front()) {
+        result.push_back(probabilities[false_class_idx]);
+    }
+    return result;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_AUTO_TEST_SUITE(ranger_forest)
+
+BOOST_AUTO_TEST_CASE(predict_false_is_the_same_as_ranger_for_both_class_orders)
+{
+    const auto directory = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+    boost::filesystem::create_directories(directory);
+    auto training_rows = make_rows(500, 3);
+    auto prediction_rows = make_rows(300, 11);
+    prediction_rows.insert(std::cend(prediction_rows), std::cbegin(training_rows), std::cend(training_rows));
+    for (const double first_class : {0.0, 1.0}) {
+        // ranger orders the classes as they first appear in the training data
+        const auto first_row = std::find_if(std::begin(training_rows), std::end(training_rows),
+                                            [=] (const auto& row) { return row.back() == first_class; });
+        BOOST_REQUIRE(first_row != std::end(training_rows));
+        std::iter_swap(std::begin(training_rows), first_row);
+        const auto prefix = directory / ("forest" + std::to_string(static_cast<int>(first_class)));
+        const auto trained = train(training_rows, prefix);
+        BOOST_REQUIRE_EQUAL(trained.class_values.size(), 2);
+        BOOST_REQUIRE_EQUAL(trained.class_values.front(), first_class);
+        BOOST_REQUIRE_GT(trained.num_splits[0] + trained.num_splits[2], 0);
+        BOOST_REQUIRE_GT(trained.num_splits[1], 0);
+        const boost::filesystem::path forest_file {prefix.string() + ".forest"};
+        const RangerForest forest {forest_file, num_variables};
+        BOOST_CHECK_EQUAL(forest.num_trees(), 50);
+        const auto expected = ranger_predict_false(forest_file, prediction_rows);
+        BOOST_REQUIRE_EQUAL(expected.size(), prediction_rows.size());
+        for (std::size_t row {0}; row < prediction_rows.size(); ++row) {
+            BOOST_CHECK_EQUAL(forest.predict_false(prediction_rows[row].data()), expected[row]);
+        }
+    }
+    boost::filesystem::remove_all(directory);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
@@ -0,0 +1,221 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <iterator>
+#include <algorithm>
+#include <numeric>
+#include <fstream>
+#include <cstddef>
+
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/operations.hpp>
+
+#include "basics/genomic_region.hpp"
+#include "io/variant/vcf.hpp"
+#include "io/variant/vcf_spec.hpp"
+#include "core/csr/facets/samples.hpp"
+#include "core/csr/facets/alleles.hpp"
+#include "core/csr/facets/facet_factory.hpp"
+#include "core/csr/measures/measure.hpp"
+#include "core/csr/filters/threshold_filter.hpp"
+
+namespace octopus { namespace test {
+
+namespace {
+
+namespace fs = boost::filesystem;
+
+using csr::Measure;
+using csr::MeasureWrapper;
+using csr::FacetFactory;
+using csr::ThresholdVariantCallFilter;
+
+// The number of alleles called in the sample's call block, so the result depends on how calls are blocked
+class BlockAlleles : public Measure
+{
+    const static std::string name_;
+    std::unique_ptr<Measure> do_clone() const override { return std::make_unique<BlockAlleles>(*this); }
+    ResultType do_evaluate(const VcfRecord&, const FacetMap& facets) const override
+    {
+        const auto& samples = csr::get_value<csr::Samples>(facets.at("Samples"));
+        const auto& alleles = csr::get_value<csr::Alleles>(facets.at("Alleles"));
+        return alleles.at(samples.front()).size();
+    }
+    ResultCardinality do_cardinality() const noexcept override { return ResultCardinality::one; }
+    const std::string& do_name() const override { return name_; }
+    std::string do_describe() const override { return "Number of alleles called in the block"; }
+    std::vector<std::string> do_requirements() const override { return {"Samples", "Alleles"}; }
+};
+
+const std::string BlockAlleles::name_ = "BLOCK_ALLELES";
+
+const std::string sample {"S"};
+
+// Each block is a phase set of SNVs; blocks of three or more calls are soft filtered
+const std::vector<std::pair<std::string, std::vector<std::size_t>>> block_sizes {
+    {"1", {3, 1, 2, 4, 1, 5}},
+    {"2", {2, 3, 1}},
+    {"3", {1}}
+};
+
+VcfHeader make_header()
+{
+    VcfHeader::Builder builder {};
+    builder.add_sample(sample);
+    for (const auto& contig : block_sizes) {
+        builder.add_contig(contig.first, {{"length", "100000"}});
+    }
+    builder.add_format(vcfspec::format::genotype, "1", "String", "Genotype");
+    builder.add_format(vcfspec::format::phaseSet, "1", "Integer", "Phase set");
+    return builder.build_once();
+}
+
+std::vector<VcfRecord> make_calls()
+{
+    std::vector<VcfRecord> result {};
+    for (const auto& contig : block_sizes) {
+        GenomicRegion::Position block_begin {1000};
+        for (const auto block_size : contig.second) {
+            for (std::size_t i {0}; i < block_size; ++i) {
+                VcfRecord::Builder call {};
+                call.set_chrom(contig.first).set_pos(block_begin + 10 * i).set_ref("A").set_alt("C").set_qual(60);
+                call.set_format({vcfspec::format::genotype, vcfspec::format::phaseSet});
+                call.set_genotype(sample, std::vector<VcfRecord::NucleotideSequence> {"A", "C"}, VcfRecord::Builder::Phasing::phased);
+                call.set_format(sample, vcfspec::format::phaseSet, std::to_string(block_begin));
+                result.push_back(call.build_once());
+            }
+            block_begin += 1000;
+        }
+    }
+    return result;
+}
+
+std::vector<std::string> expected_filters()
+{
+    std::vector<std::string> result {};
+    for (const auto& contig : block_sizes) {
+        for (const auto block_size : contig.second) {
+            result.insert(std::end(result), block_size, block_size >= 3 ? "BLK" : "PASS");
+        }
+    }
+    return result;
+}
+
+std::unique_ptr<VariantCallFilter> make_filter(const VcfHeader& header, const unsigned max_threads)
+{
+    ThresholdVariantCallFilter::ConditionVectorPair conditions {};
+    conditions.soft.push_back({MeasureWrapper {std::make_unique<BlockAlleles>()},
+                               csr::make_wrapped_threshold<csr::GreaterThreshold<std::size_t>>(4), "BLK"});
+    ThresholdVariantCallFilter::OutputOptions output_config {};
+    output_config.annotate_all_active_measures = true;
+    return std::make_unique<ThresholdVariantCallFilter>(FacetFactory {header}, std::move(conditions), output_config,
+                                                        ThresholdVariantCallFilter::ConcurrencyPolicy {max_threads});
+}
+
+// The body lines of the VCF, split into columns
+std::vector<std::vector<std::string>> read_calls(const fs::path& vcf)
+{
+    std::vector<std::vector<std::string>> result {};
+    std::ifstream file {vcf.string()};
+    for (std::string line {}; std::getline(file, line);) {
+        if (line.empty() || line.front() == '#') continue;
+        std::vector<std::string> columns {};
+        for (std::size_t begin {0}, end; begin <= line.size(); begin = end + 1) {
+            end = std::min(line.find('\t', begin), line.size());
+            columns.push_back(line.substr(begin, end - begin));
+        }
+        result.push_back(std::move(columns));
+    }
+    return result;
+}
+
+std::vector<std::string> get_filters(const std::vector<std::vector<std::string>>& calls)
+{
+    std::vector<std::string> result {};
+    for (const auto& call : calls) result.push_back(call.at(6));
+    return result;
+}
+
+// Splits the calls into batches at the given indices
+std::vector<std::vector<VcfRecord>> split(const std::vector<VcfRecord>& calls, std::vector<std::size_t> split_points)
+{
+    split_points.push_back(calls.size());
+    std::vector<std::vector<VcfRecord>> result {};
+    std::size_t begin {0};
+    for (const auto end : split_points) {
+        result.emplace_back(std::next(std::cbegin(calls), begin), std::next(std::cbegin(calls), end));
+        begin = end;
+    }
+    return result;
+}
+
+// Every split point on its own, every call in its own batch, and some uneven splits that cut blocks
+// and contigs
+std::vector<std::vector<std::size_t>> make_split_points(const std::size_t num_calls)
+{
+    std::vector<std::vector<std::size_t>> result {{}};
+    for (std::size_t i {1}; i < num_calls; ++i) result.push_back({i});
+    std::vector<std::size_t> singles(num_calls - 1);
+    std::iota(std::begin(singles), std::end(singles), 1);
+    result.push_back(std::move(singles));
+    result.push_back({1, 2, 5, 8, 15, 17, 20});
+    result.push_back({4, 7, 11, 12, 19});
+    result.push_back({0, 3, 3, 9, 22});
+    return result;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_AUTO_TEST_SUITE(variant_call_filter)
+
+BOOST_AUTO_TEST_CASE(call_stream_filters_calls_the_same_as_reader_for_any_batch_split)
+{
+    const auto directory = fs::temp_directory_path() / fs::unique_path();
+    fs::create_directories(directory);
+    const auto header = make_header();
+    const auto calls_vcf = directory / "calls.vcf";
+    {
+        VcfWriter calls {calls_vcf, header};
+        calls << make_calls();
+    }
+    const VcfReader calls {calls_vcf};
+    const auto input_calls = calls.fetch_records();
+    BOOST_REQUIRE_EQUAL(input_calls.size(), expected_filters().size());
+    for (const unsigned max_threads : {1u, 2u}) {
+        const auto filter = make_filter(header, max_threads);
+        BOOST_REQUIRE(filter->can_stream());
+        const auto read_vcf = directory / "read.vcf";
+        {
+            VcfWriter out {read_vcf};
+            filter->filter(calls, out);
+        }
+        const auto read_calls_result = read_calls(read_vcf);
+        BOOST_REQUIRE(get_filters(read_calls_result) == expected_filters());
+        for (const auto& split_points : make_split_points(input_calls.size())) {
+            const auto streamed_vcf = directory / "streamed.vcf";
+            {
+                VcfWriter out {streamed_vcf};
+                VariantCallFilter::CallStream stream {*filter, header, out};
+                for (auto& batch : split(input_calls, split_points)) {
+                    stream.filter(std::move(batch));
+                }
+                stream.close();
+            }
+            BOOST_CHECK_MESSAGE(read_calls(streamed_vcf) == read_calls_result,
+                                "threads " << max_threads << ", " << split_points.size() + 1 << " batches");
+        }
+    }
+    fs::remove_all(directory);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
@@ -0,0 +1,197 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <iterator>
+#include <cstddef>
+
+#include "config/common.hpp"
+#include "basics/genomic_region.hpp"
+#include "basics/aligned_read.hpp"
+#include "basics/cigar_string.hpp"
+#include "core/types/allele.hpp"
+#include "core/types/haplotype.hpp"
+#include "core/models/haplotype_likelihood_model.hpp"
+#include "core/models/haplotype_likelihood_array.hpp"
+#include "core/models/read_likelihood_cache.hpp"
+#include "utils/memory_footprint.hpp"
+#include "io/reference/reference_genome.hpp"
+#include "mock/mock_reference.hpp"
+
+namespace octopus { namespace test {
+
+namespace {
+
+const GenomicRegion::ContigName contig {"5"};
+
+char other_base(const char base) noexcept
+{
+    return base == 'A' ? 'C' : 'A';
+}
+
+AlignedRead make_read(std::string name, const GenomicRegion& region, std::string sequence, const bool is_reverse)
+{
+    const auto length = sequence.size();
+    AlignedRead::BaseQualityVector qualities(length);
+    for (std::size_t i {0}; i < length; ++i) {
+        qualities[i] = static_cast<AlignedRead::BaseQuality>(15 + (7 * i) % 25);
+    }
+    AlignedRead::Flags flags {};
+    flags.reverse_mapped = is_reverse;
+    return AlignedRead {std::move(name), region, std::move(sequence), std::move(qualities),
+                        parse_cigar(std::to_string(length) + "M"), 60, flags, ""};
+}
+
+// Reads of the reference, one starting every spacing bases in [begin, end), alternating strands
+std::vector<AlignedRead> make_reads(const ReferenceGenome& reference, const std::string& prefix,
+                                    const GenomicRegion::Position begin, const GenomicRegion::Position end,
+                                    const GenomicRegion::Size spacing)
+{
+    const GenomicRegion::Size length {30};
+    std::vector<AlignedRead> result {};
+    for (auto position = begin; position + length <= end; position += spacing) {
+        const GenomicRegion region {contig, position, position + length};
+        result.push_back(make_read(prefix + std::to_string(position), region, reference.fetch_sequence(region), result.size() % 2 == 1));
+    }
+    return result;
+}
+
+ReadMap make_read_map(std::vector<AlignedRead> normal_reads, std::vector<AlignedRead> tumour_reads)
+{
+    ReadMap result {};
+    result.emplace("NORMAL", MappableFlatMultiSet<AlignedRead> {std::make_move_iterator(std::begin(normal_reads)),
+                                                                std::make_move_iterator(std::end(normal_reads))});
+    result.emplace("TUMOUR", MappableFlatMultiSet<AlignedRead> {std::make_move_iterator(std::begin(tumour_reads)),
+                                                                std::make_move_iterator(std::end(tumour_reads))});
+    return result;
+}
+
+// alleles must be sorted; Haplotype needs the gaps between them filled with reference alleles
+Haplotype make_haplotype(const ReferenceGenome& reference, const GenomicRegion& region, const std::vector<ContigAllele>& alleles = {})
+{
+    std::vector<ContigAllele> explicit_alleles {};
+    for (const auto& allele : alleles) {
+        if (!explicit_alleles.empty() && mapped_end(explicit_alleles.back()) < mapped_begin(allele)) {
+            const ContigRegion gap {mapped_end(explicit_alleles.back()), mapped_begin(allele)};
+            explicit_alleles.emplace_back(gap, reference.fetch_sequence(GenomicRegion {contig, gap}));
+        }
+        explicit_alleles.push_back(allele);
+    }
+    return Haplotype {region, std::cbegin(explicit_alleles), std::cend(explicit_alleles), reference};
+}
+
+ContigAllele make_snv(const ReferenceGenome& reference, const GenomicRegion::Position position)
+{
+    const GenomicRegion region {contig, position, position + 1};
+    return ContigAllele {region.contig_region(), std::string(1, other_base(reference.fetch_sequence(region).front()))};
+}
+
+// The reference haplotype over region and one with a SNV at position
+std::vector<Haplotype> make_haplotypes(const ReferenceGenome& reference, const GenomicRegion& region,
+                                       const GenomicRegion::Position position)
+{
+    return {make_haplotype(reference, region), make_haplotype(reference, region, {make_snv(reference, position)})};
+}
+
+auto copy(HaplotypeLikelihoodArray::LikelihoodVector likelihoods)
+{
+    return std::vector<HaplotypeLikelihoodArray::StoredLogProbability> {std::cbegin(likelihoods), std::cend(likelihoods)};
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_AUTO_TEST_SUITE(haplotype_likelihood_array)
+
+BOOST_AUTO_TEST_CASE(shared_arrays_are_primed_independently_and_keep_their_likelihoods_when_the_original_is_repopulated)
+{
+    const auto reference = mock::make_reference();
+    const std::vector<SampleName> samples {"NORMAL", "TUMOUR"};
+    const GenomicRegion region {contig, 80, 320};
+    const auto haplotypes = make_haplotypes(reference, region, 200);
+    const auto reads = make_read_map(make_reads(reference, "n", 100, 300, 5), make_reads(reference, "t", 110, 290, 7));
+    HaplotypeLikelihoodArray likelihoods {HaplotypeLikelihoodModel {}, 2, samples};
+    likelihoods.populate(reads, haplotypes);
+    const auto shared = likelihoods.share();
+    BOOST_REQUIRE_EQUAL(shared.num_likelihoods("NORMAL"), likelihoods.num_likelihoods("NORMAL"));
+    BOOST_REQUIRE_EQUAL(shared.num_likelihoods("TUMOUR"), likelihoods.num_likelihoods("TUMOUR"));
+    std::vector<std::vector<HaplotypeLikelihoodArray::StoredLogProbability>> expected {};
+    for (const auto& sample : samples) {
+        for (const auto& haplotype : haplotypes) {
+            const auto sample_likelihoods = likelihoods(sample, haplotype);
+            BOOST_CHECK_EQUAL(shared(sample, haplotype).data(), sample_likelihoods.data());
+            expected.push_back(copy(sample_likelihoods));
+        }
+    }
+    likelihoods.prime("NORMAL");
+    shared.prime("TUMOUR");
+    BOOST_CHECK(copy(likelihoods[haplotypes[1]]) == expected[1]);
+    BOOST_CHECK(copy(shared[haplotypes[1]]) == expected[3]);
+    BOOST_CHECK(copy(shared[shared.index_of(haplotypes[0])]) == expected[2]);
+    likelihoods.unprime();
+    BOOST_CHECK(shared.is_primed());
+    const auto other_haplotypes = make_haplotypes(reference, GenomicRegion {contig, 500, 740}, 620);
+    likelihoods.populate(make_read_map(make_reads(reference, "n", 520, 720, 3), {}), other_haplotypes);
+    BOOST_CHECK(!likelihoods.contains(haplotypes[0]));
+    BOOST_CHECK(copy(shared[haplotypes[0]]) == expected[2]);
+    BOOST_CHECK(copy(shared[haplotypes[1]]) == expected[3]);
+    shared.prime("NORMAL");
+    BOOST_CHECK(copy(shared[haplotypes[0]]) == expected[0]);
+    BOOST_CHECK(copy(shared[haplotypes[1]]) == expected[1]);
+}
+
+BOOST_AUTO_TEST_CASE(likelihoods_reused_from_earlier_populations_are_the_same_as_fresh_likelihoods)
+{
+    const auto reference = mock::make_reference();
+    const std::vector<SampleName> samples {"NORMAL", "TUMOUR"};
+    const GenomicRegion region {contig, 100, 700};
+    // A read with a mismatch, which maps to a perfect copy of itself far away when there is one
+    const GenomicRegion mismatched_region {contig, 300, 330};
+    auto mismatched_sequence = reference.fetch_sequence(mismatched_region);
+    mismatched_sequence[15] = other_base(mismatched_sequence[15]);
+    auto normal_reads = make_reads(reference, "n", 150, 650, 4);
+    normal_reads.push_back(make_read("m", mismatched_region, mismatched_sequence, false));
+    // A short read with an A inserted into a run of Ts ending at 422. Its context starts at 402, so runs of
+    // different lengths that start before 402 give it the same context sequence but different gap penalties.
+    const GenomicRegion run_region {contig, 420, 430};
+    normal_reads.push_back(make_read("r", run_region, "TTAT" + reference.fetch_sequence(GenomicRegion {contig, 422, 428}), true));
+    const auto reads = make_read_map(std::move(normal_reads), make_reads(reference, "t", 161, 650, 9));
+    const auto ref = make_haplotype(reference, region);
+    const auto distant_copy = make_haplotype(reference, region, {ContigAllele {ContigRegion {550, 580}, mismatched_sequence}});
+    const auto short_run = make_haplotype(reference, region, {ContigAllele {ContigRegion {400, 422}, std::string(22, 'T')}});
+    const auto long_run = make_haplotype(reference, region, {ContigAllele {ContigRegion {392, 422}, std::string(30, 'T')}});
+    const std::vector<std::vector<Haplotype>> populations {
+        {ref, make_haplotype(reference, region, {make_snv(reference, 320)}), short_run},
+        {ref, distant_copy, make_haplotype(reference, region, {make_snv(reference, 320), make_snv(reference, 480)})},
+        {long_run, ref},
+        {ref, short_run, distant_copy, make_haplotype(reference, region, {ContigAllele {ContigRegion {500, 502}, ""}})},
+        {make_haplotype(reference, region, {make_snv(reference, 320)}), ref, make_haplotype(reference, region, {ContigAllele {ContigRegion {600, 600}, "GAT"}})}
+    };
+    const std::vector<boost::optional<HaplotypeLikelihoodArray::FlankState>> flank_states {
+        boost::none, HaplotypeLikelihoodArray::FlankState {40, 40}
+    };
+    ReadLikelihoodCache reuse_cache {MemoryFootprint {64 * 1024 * 1024}};
+    HaplotypeLikelihoodArray cached {HaplotypeLikelihoodModel {}, 4, samples}, fresh {HaplotypeLikelihoodModel {}, 4, samples};
+    for (const auto& haplotypes : populations) {
+        for (const auto& flank_state : flank_states) {
+            cached.populate(reads, haplotypes, flank_state, reuse_cache);
+            fresh.populate(reads, haplotypes, flank_state);
+            for (const auto& sample : samples) {
+                for (const auto& haplotype : haplotypes) {
+                    BOOST_CHECK(copy(cached(sample, haplotype)) == copy(fresh(sample, haplotype)));
+                }
+            }
+        }
+    }
+    BOOST_CHECK(reuse_cache.num_hits() > reuse_cache.num_misses());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
@@ -1,4 +1,92 @@
 // Copyright (c) 2017 Daniel Cooke
 // Use of this source code is governed by the MIT license that can be found in the LICENSE file.
 
-#include <stdio.h>
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <iterator>
+#include <random>
+
+#include "core/models/pairhmm/pair_hmm.hpp"
+#include "core/models/pairhmm/simd_pair_hmm.hpp"
+
+namespace octopus { namespace test {
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_AUTO_TEST_SUITE(pair_hmm)
+
+BOOST_AUTO_TEST_CASE(sse2_kernels_are_always_supported)
+{
+    const auto isas = hmm::simd::supported_instruction_sets();
+    BOOST_REQUIRE(!isas.empty());
+    BOOST_CHECK(isas.front() == hmm::simd::InstructionSet::sse2);
+    BOOST_CHECK(isas.back() == hmm::simd::get_instruction_set());
+}
+
+BOOST_AUTO_TEST_CASE(all_supported_kernels_give_the_same_results_as_sse2)
+{
+    const auto mismatches = hmm::simd::verify_instruction_sets(2000);
+    for (const auto isa : mismatches) {
+        BOOST_ERROR("Kernel mismatch for " << hmm::simd::to_string(isa));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(perfect_match_scores_zero_with_every_kernel)
+{
+    using namespace hmm::simd;
+    const std::string truth {"ACGTACGTTGCAGGATCCATGACCTAGAAT"};
+    const std::string target {truth.substr(min_flank_pad(), truth.size() - 2 * min_flank_pad() + 1)};
+    const std::vector<std::int8_t> qualities(target.size(), 30), gap_open(truth.size(), 40), gap_extend(truth.size(), 3);
+    const auto original_isa = get_instruction_set();
+    for (const auto isa : supported_instruction_sets()) {
+        set_instruction_set(isa);
+        BOOST_CHECK_EQUAL(align(truth.data(), target.data(), qualities.data(),
+                                static_cast<int>(truth.size()), static_cast<int>(target.size()),
+                                gap_open.data(), gap_extend.data(), 2), 0);
+    }
+    set_instruction_set(original_isa);
+}
+
+BOOST_AUTO_TEST_CASE(batched_evaluate_gives_the_same_likelihoods_as_evaluate)
+{
+    std::mt19937 generator {42};
+    const std::string bases {"ACGT"};
+    std::string truth {};
+    std::generate_n(std::back_inserter(truth), 500, [&] () { return bases[generator() % 4]; });
+    const std::vector<char> snv_mask(std::cbegin(truth), std::cend(truth));
+    const std::vector<std::int8_t> snv_priors(truth.size(), 25), gap_open(truth.size(), 35), gap_extend(truth.size(), 3);
+    hmm::MutationModel model {snv_mask, snv_priors, gap_open, gap_extend};
+    model.lhs_flank_size = 20;
+    model.rhs_flank_size = 20;
+    std::vector<std::string> targets {};
+    std::vector<std::size_t> offsets {};
+    for (int i {0}; i < 200; ++i) {
+        const std::size_t length {i % 5 == 0 ? 100u : 120u}, offset {generator() % (truth.size() - length)};
+        auto target = truth.substr(offset, length);
+        for (int j {0}; j < i % 6; ++j) {
+            target[generator() % length] = bases[generator() % 4];
+        }
+        targets.push_back(std::move(target));
+        offsets.push_back(offset);
+    }
+    const std::vector<std::uint8_t> qualities(120, 30), short_qualities(100, 30);
+    std::vector<hmm::BatchTarget> batch {};
+    for (std::size_t i {0}; i < targets.size(); ++i) {
+        batch.push_back({targets[i], targets[i].size() == 100 ? short_qualities : qualities, offsets[i], model});
+    }
+    std::vector<double> likelihoods {};
+    hmm::evaluate(batch, truth, likelihoods);
+    BOOST_REQUIRE_EQUAL(likelihoods.size(), targets.size());
+    for (std::size_t i {0}; i < targets.size(); ++i) {
+        BOOST_CHECK_EQUAL(likelihoods[i], hmm::evaluate(targets[i], truth, batch[i].qualities, offsets[i], model));
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
@@ -0,0 +1,150 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <cstddef>
+
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/operations.hpp>
+
+#include "config/common.hpp"
+#include "basics/genomic_region.hpp"
+#include "io/variant/vcf.hpp"
+#include "core/calling_task.hpp"
+#include "core/task_writer.hpp"
+
+namespace octopus { namespace test {
+
+namespace {
+
+namespace fs = boost::filesystem;
+
+const std::vector<ContigName> contigs {"1", "2", "3", "4"};
+
+VcfHeader make_header()
+{
+    VcfHeader::Builder builder {};
+    for (const auto& contig : contigs) {
+        builder.add_contig(contig, {{"length", "10000"}});
+    }
+    return builder.build_once();
+}
+
+// Each task has three calls, with IDs naming the task and call
+CompletedTask make_task(const ContigName& contig, const std::size_t index)
+{
+    const auto begin = static_cast<GenomicRegion::Position>(100 * index);
+    CompletedTask result {Task {GenomicRegion {contig, begin, begin + 100}, ExecutionPolicy::seq, index}};
+    for (GenomicRegion::Position i {0}; i < 3; ++i) {
+        const auto id = contig + ":" + std::to_string(index) + ":" + std::to_string(i);
+        result.calls.push_back(VcfRecord::Builder {}.set_chrom(contig).set_id(id).set_pos(begin + 10 * i)
+                               .set_ref("A").set_alt("C").set_qual(60).set_passed().build_once());
+    }
+    return result;
+}
+
+void write_tasks(OrderedTaskWriter& writer, const ContigName& contig, const std::vector<std::size_t>& indices)
+{
+    std::deque<CompletedTask> tasks {};
+    for (const auto index : indices) tasks.push_back(make_task(contig, index));
+    writer.write(std::move(tasks));
+}
+
+// Writes tasks out of contig order, as they might complete with several threads. Contig 3 has no tasks
+// and is closed before the contigs before it. With a limit of 5 buffered calls, contig 4 is spilled
+// twice to the same file, contig 2 is spilled once and then has a task left in memory.
+void run_writer(VcfWriter& out, OrderedTaskWriter::SpillFileFactory make_spill_file, const std::size_t max_buffered_calls)
+{
+    TaskWriterSyncPacket sync {};
+    auto task_writer_thread = make_task_writer_thread(out, sync, boost::none);
+    {
+        OrderedTaskWriter writer {contigs, sync, std::move(make_spill_file), max_buffered_calls};
+        write_tasks(writer, "4", {0, 1});
+        write_tasks(writer, "2", {0});
+        write_tasks(writer, "1", {0});
+        writer.close("3");
+        write_tasks(writer, "2", {1});
+        write_tasks(writer, "4", {2});
+        write_tasks(writer, "2", {2});
+        write_tasks(writer, "1", {1});
+        writer.close("1");
+        write_tasks(writer, "2", {3});
+        writer.close("2");
+        write_tasks(writer, "4", {3});
+        writer.close("4");
+    }
+    wait_until_finished(sync);
+    task_writer_thread.join();
+    out.close();
+}
+
+std::vector<std::string> read_ids(const fs::path& vcf)
+{
+    const VcfReader reader {vcf};
+    std::vector<std::string> result {};
+    for (const auto& record : reader.fetch_records()) {
+        result.push_back(record.id());
+    }
+    return result;
+}
+
+std::vector<std::string> expected_ids()
+{
+    std::vector<std::string> result {};
+    for (const auto& task : {std::make_pair("1", 2), std::make_pair("2", 4), std::make_pair("4", 4)}) {
+        for (int index {0}; index < task.second; ++index) {
+            for (int i {0}; i < 3; ++i) {
+                result.push_back(std::string {task.first} + ":" + std::to_string(index) + ":" + std::to_string(i));
+            }
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_AUTO_TEST_SUITE(task_writer)
+
+BOOST_AUTO_TEST_CASE(ordered_task_writer_output_is_the_same_when_buffered_calls_are_spilled)
+{
+    const auto directory = fs::temp_directory_path() / fs::unique_path();
+    fs::create_directories(directory);
+    const auto header = make_header();
+    const auto unspilled_vcf = directory / "unspilled.vcf", spilled_vcf = directory / "spilled.vcf";
+    {
+        VcfWriter out {unspilled_vcf, header};
+        run_writer(out, nullptr, 5);
+    }
+    const auto spill_directory = directory / "spilled";
+    fs::create_directories(spill_directory);
+    std::vector<ContigName> spilled_contigs {};
+    const auto make_spill_file = [&] (const ContigName& contig) {
+        spilled_contigs.push_back(contig);
+        return VcfWriter {spill_directory / (contig + ".vcf"), header};
+    };
+    {
+        VcfWriter out {spilled_vcf, header};
+        run_writer(out, make_spill_file, 5);
+    }
+    BOOST_CHECK(spilled_contigs == (std::vector<ContigName> {"4", "2"}));
+    BOOST_CHECK(fs::is_empty(spill_directory));
+    const auto unspilled_ids = read_ids(unspilled_vcf);
+    BOOST_CHECK(unspilled_ids == expected_ids());
+    BOOST_CHECK(read_ids(spilled_vcf) == unspilled_ids);
+    BOOST_CHECK(VcfReader {spilled_vcf}.fetch_records() == VcfReader {unspilled_vcf}.fetch_records());
+    fs::remove_all(directory);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
@@ -72,6 +72,35 @@ BOOST_AUTO_TEST_CASE(assembler_throws_if_reference_sequence_is_inserted_twice)
     BOOST_CHECK_THROW(assembler.insert_reference(reference), std::exception);
 }
 
+BOOST_AUTO_TEST_CASE(packed_reads_can_be_shared_between_assemblers_with_different_kmer_sizes)
+{
+    const Assembler::NucleotideSequence reference {"GATTACAGCTTGACCATGGTACCGTAGCATCGGATCCAAGTTCGATGCTAGCAGTCAACGTGATCGCTTAGGCATTC"};
+    const Assembler::NucleotideSequence alt_read   {"GATTACAGCTTGACCATGGTACCGTAGCATCGGATCGAAGTTCGATGCTAGCAGTCAACGTGATCGCTTAGGCATTC"};
+    const Assembler::NucleotideSequence noisy_read {"GATTACAGCTTGACCATGGTACCGTAGCATCGGATCGAAGTTCGATGNTAGCAGTCAACGTGATCGCTTAGGCATTC"};
+    
+    const Assembler::PackedSequence packed_alt_read {alt_read}, packed_noisy_read {noisy_read};
+    
+    for (const unsigned kmer_size : {10u, 34u}) {
+        Assembler packed_assembler {{kmer_size}, reference}, unpacked_assembler {{kmer_size}, reference};
+        
+        packed_assembler.insert_read(packed_alt_read, Assembler::Direction::forward);
+        packed_assembler.insert_read(packed_noisy_read, Assembler::Direction::reverse);
+        unpacked_assembler.insert_read(alt_read, Assembler::Direction::forward);
+        unpacked_assembler.insert_read(noisy_read, Assembler::Direction::reverse);
+        
+        BOOST_CHECK(!packed_assembler.is_all_reference());
+        BOOST_CHECK_EQUAL(packed_assembler.num_kmers(), unpacked_assembler.num_kmers());
+        
+        packed_assembler.cleanup();
+        unpacked_assembler.cleanup();
+        
+        const auto packed_variants = packed_assembler.extract_variants(10, 0);
+        
+        BOOST_CHECK_EQUAL(packed_variants.size(), 1);
+        BOOST_CHECK(packed_variants == unpacked_assembler.extract_variants(10, 0));
+    }
+}
+
 
 
 BOOST_AUTO_TEST_SUITE_END()
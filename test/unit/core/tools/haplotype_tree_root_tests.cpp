@@ -0,0 +1,236 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+#include <string>
+#include <iterator>
+#include <algorithm>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+
+#include "basics/genomic_region.hpp"
+#include "core/types/allele.hpp"
+#include "core/types/haplotype.hpp"
+#include "core/tools/hapgen/haplotype_tree.hpp"
+#include "io/reference/reference_genome.hpp"
+#include "mock/mock_reference.hpp"
+
+namespace octopus { namespace test {
+
+namespace {
+
+using coretools::HaplotypeTree;
+
+// Contig 5 of the mock reference starts TCCCTTTGGGGTTTCCTCCCAAAAACCCATGACTCC
+const GenomicRegion::ContigName contig {"5"};
+
+Allele make_allele(const GenomicRegion::Position begin, const GenomicRegion::Position end, std::string sequence)
+{
+    return Allele {GenomicRegion {contig, begin, end}, std::move(sequence)};
+}
+
+auto extract_sequences(const HaplotypeTree& tree)
+{
+    const auto haplotypes = tree.extract_haplotypes();
+    std::vector<Haplotype::NucleotideSequence> result {};
+    result.reserve(haplotypes.size());
+    std::transform(std::cbegin(haplotypes), std::cend(haplotypes), std::back_inserter(result),
+                   [] (const Haplotype& haplotype) { return haplotype.sequence(); });
+    return result;
+}
+
+using Sequences = std::vector<Haplotype::NucleotideSequence>;
+
+char other_base(const char base) noexcept
+{
+    switch (base) {
+        case 'A': return 'C';
+        case 'C': return 'G';
+        case 'G': return 'T';
+        default: return 'A';
+    }
+}
+
+// Pairs of reference and alternative alleles, one every spacing bases, with a deletion or insertion every few sites
+std::vector<std::vector<Allele>> make_sites(const ReferenceGenome& reference, const GenomicRegion::Size spacing)
+{
+    const auto end = reference.contig_size(contig) - 10;
+    std::vector<std::vector<Allele>> result {};
+    for (GenomicRegion::Position begin {10}, i {0}; begin < end; begin += spacing, ++i) {
+        if (i % 7 == 3) {
+            const GenomicRegion region {contig, begin, begin + 2};
+            result.push_back({Allele {region, reference.fetch_sequence(region)}, Allele {region, ""}});
+        } else if (i % 11 == 5) {
+            const GenomicRegion region {contig, begin, begin};
+            result.push_back({Allele {region, ""}, Allele {region, "TA"}});
+        } else {
+            const GenomicRegion region {contig, begin, begin + 1};
+            const auto ref = reference.fetch_sequence(region);
+            result.push_back({Allele {region, ref}, Allele {region, std::string(1, other_base(ref.front()))}});
+        }
+    }
+    return result;
+}
+
+// FNV-1a, so checksums do not depend on the standard library
+void combine(std::uint64_t& checksum, const std::string& sequence) noexcept
+{
+    for (const char c : sequence) {
+        checksum ^= static_cast<unsigned char>(c);
+        checksum *= 1'099'511'628'211ull;
+    }
+    checksum ^= 0xff;
+    checksum *= 1'099'511'628'211ull;
+}
+
+// Follows HaplotypeGenerator's cycle: extends the tree window_size sites at a time, extracts all haplotypes,
+// prunes every other one, and then clears all but the last site of the window. The checksum covers the
+// extracted haplotypes in order and the haplotypes left after pruning.
+std::uint64_t run_cycles(HaplotypeTree& tree, const std::vector<std::vector<Allele>>& sites, const std::size_t window_size)
+{
+    std::uint64_t result {14'695'981'039'346'656'037ull};
+    for (std::size_t first {0}; first + window_size <= sites.size(); first += window_size - 1) {
+        for (std::size_t i {first}; i < first + window_size; ++i) {
+            for (const auto& allele : sites[i]) tree.extend(allele);
+        }
+        const auto haplotypes = tree.extract_haplotypes();
+        for (const auto& haplotype : haplotypes) combine(result, haplotype.sequence());
+        for (std::size_t i {0}; i < haplotypes.size(); i += 2) {
+            tree.prune_all(haplotypes[i]);
+        }
+        for (const auto& haplotype : tree.extract_haplotypes()) combine(result, haplotype.sequence());
+        const auto& last = sites[first + window_size - 1].front();
+        tree.clear(GenomicRegion {contig, 0, mapped_begin(last)});
+    }
+    tree.clear();
+    return result;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_AUTO_TEST_SUITE(haplotype_tree_root)
+
+BOOST_AUTO_TEST_CASE(splice_can_add_an_insertion_before_the_first_allele)
+{
+    const auto reference = mock::make_reference();
+    HaplotypeTree tree {contig, reference};
+    tree.extend(make_allele(27, 28, "C"));
+    tree.splice(make_allele(27, 27, "AA"));
+    BOOST_CHECK_EQUAL(tree.num_haplotypes(), 2);
+    BOOST_CHECK(extract_sequences(tree) == (Sequences {"C", "AAC"}));
+}
+
+BOOST_AUTO_TEST_CASE(splice_can_add_an_allele_before_the_first_allele)
+{
+    const auto reference = mock::make_reference();
+    HaplotypeTree tree {contig, reference};
+    tree.extend(make_allele(27, 28, "T"));
+    tree.splice(make_allele(26, 27, "G"));
+    BOOST_CHECK_EQUAL(tree.num_haplotypes(), 2);
+    BOOST_CHECK(extract_sequences(tree) == (Sequences {"CT", "GC"}));
+}
+
+BOOST_AUTO_TEST_CASE(splice_treats_the_start_of_the_contig_like_any_other_position)
+{
+    const auto reference = mock::make_reference();
+    HaplotypeTree tree {contig, reference};
+    tree.extend(make_allele(0, 1, "T"));
+    tree.extend(make_allele(0, 1, "G"));
+    tree.splice(make_allele(0, 0, "A"));
+    BOOST_CHECK_EQUAL(tree.num_haplotypes(), 3);
+    auto sequences = extract_sequences(tree);
+    std::sort(std::begin(sequences), std::end(sequences));
+    BOOST_CHECK(sequences == (Sequences {"AT", "G", "T"}));
+}
+
+BOOST_AUTO_TEST_CASE(splice_adds_a_leaf_to_each_branch_from_the_root)
+{
+    const auto reference = mock::make_reference();
+    HaplotypeTree tree {contig, reference};
+    tree.extend(make_allele(27, 28, "C"));
+    tree.extend(make_allele(27, 28, "G"));
+    tree.extend(make_allele(30, 31, "A"));
+    tree.splice(make_allele(28, 29, "T"));
+    BOOST_CHECK_EQUAL(tree.num_haplotypes(), 4);
+    auto sequences = extract_sequences(tree);
+    std::sort(std::begin(sequences), std::end(sequences));
+    BOOST_CHECK(sequences == (Sequences {"CATA", "CTTG", "GATA", "GTTG"}));
+}
+
+BOOST_AUTO_TEST_CASE(splice_into_an_empty_tree_extends_the_root)
+{
+    const auto reference = mock::make_reference();
+    HaplotypeTree tree {contig, reference};
+    tree.splice(make_allele(27, 27, "AA"));
+    BOOST_CHECK_EQUAL(tree.num_haplotypes(), 1);
+    BOOST_CHECK(extract_sequences(tree) == (Sequences {"AA"}));
+}
+
+BOOST_AUTO_TEST_CASE(pruning_every_branch_from_the_root_leaves_the_tree_empty_and_extendable)
+{
+    const auto reference = mock::make_reference();
+    HaplotypeTree tree {contig, reference};
+    tree.extend(make_allele(27, 28, "C"));
+    tree.extend(make_allele(27, 28, "G"));
+    const auto haplotypes = tree.extract_haplotypes();
+    BOOST_REQUIRE_EQUAL(haplotypes.size(), 2);
+    tree.prune_all(haplotypes[1]);
+    BOOST_CHECK_EQUAL(tree.num_haplotypes(), 1);
+    BOOST_CHECK(tree.contains(haplotypes[0]));
+    BOOST_CHECK(!tree.contains(haplotypes[1]));
+    tree.prune_all(haplotypes[0]);
+    BOOST_CHECK(tree.is_empty());
+    BOOST_CHECK_EQUAL(tree.num_haplotypes(), 0);
+    tree.extend(make_allele(27, 28, "T"));
+    BOOST_CHECK_EQUAL(tree.num_haplotypes(), 1);
+    BOOST_CHECK(extract_sequences(tree) == (Sequences {"T"}));
+    tree.splice(make_allele(26, 27, "G"));
+    BOOST_CHECK(extract_sequences(tree) == (Sequences {"CT", "GC"}));
+}
+
+BOOST_AUTO_TEST_CASE(pruning_next_to_the_root_keeps_the_other_branches)
+{
+    const auto reference = mock::make_reference();
+    HaplotypeTree tree {contig, reference};
+    tree.extend(make_allele(0, 1, "T"));
+    tree.extend(make_allele(0, 1, "G"));
+    tree.extend(make_allele(2, 3, "A"));
+    const auto haplotypes = tree.extract_haplotypes();
+    BOOST_REQUIRE(extract_sequences(tree) == (Sequences {"GCA", "TCA"}));
+    tree.prune_unique(haplotypes[0]);
+    BOOST_CHECK_EQUAL(tree.num_haplotypes(), 2);
+    tree.prune_all(haplotypes[1]);
+    BOOST_CHECK_EQUAL(tree.num_haplotypes(), 1);
+    BOOST_CHECK(extract_sequences(tree) == (Sequences {"GCA"}));
+    tree.prune_all(haplotypes[0]);
+    BOOST_CHECK(tree.is_empty());
+}
+
+BOOST_AUTO_TEST_CASE(extend_extract_prune_and_clear_cycles_match_the_adjacency_list_tree)
+{
+    const auto reference = mock::make_reference();
+    const auto sites = make_sites(reference, 3);
+    BOOST_REQUIRE_EQUAL(sites.size(), 660);
+    // Checksums given by the boost::adjacency_list tree that HaplotypeTree replaced. Windows of 12 sites
+    // (5'780'496'819'244'373'701) also match but take too long for a unit test.
+    const std::vector<std::pair<std::size_t, std::uint64_t>> windows {
+        {6, 15'973'949'407'822'575'013ull}, {9, 7'306'004'838'659'050'789ull}
+    };
+    HaplotypeTree tree {contig, reference};
+    for (const auto& window : windows) {
+        // Twice, so the second run reuses the vertices freed by the first
+        BOOST_CHECK_EQUAL(run_cycles(tree, sites, window.first), window.second);
+        BOOST_CHECK_EQUAL(run_cycles(tree, sites, window.first), window.second);
+        BOOST_CHECK(tree.is_empty());
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
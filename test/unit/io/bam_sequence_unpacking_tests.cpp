@@ -0,0 +1,60 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include "io/read/bam_sequence_unpacking.hpp"
+
+namespace octopus { namespace test {
+
+namespace {
+
+const std::string symbols {"=ACMGRSVTWYHKDBN"};
+
+std::vector<std::uint8_t> pack(const std::string& sequence)
+{
+    std::vector<std::uint8_t> result((sequence.size() + 1) / 2, 0);
+    for (std::size_t i {0}; i < sequence.size(); ++i) {
+        const auto code = static_cast<std::uint8_t>(symbols.find(sequence[i]));
+        result[i / 2] |= (i % 2 == 0) ? code << 4 : code;
+    }
+    return result;
+}
+
+std::string unpack(const std::vector<std::uint8_t>& packed, const std::size_t length)
+{
+    std::string result(length, '?');
+    io::unpack_bam_sequence(packed.data(), length, &result[0]);
+    return result;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(io)
+BOOST_AUTO_TEST_SUITE(bam_sequence_unpacking)
+
+BOOST_AUTO_TEST_CASE(unpack_bam_sequence_decodes_all_symbols)
+{
+    const auto sequence = symbols + symbols;
+    BOOST_CHECK_EQUAL(unpack(pack(sequence), sequence.size()), sequence);
+}
+
+BOOST_AUTO_TEST_CASE(unpack_bam_sequence_handles_all_lengths)
+{
+    std::string sequence {};
+    for (std::size_t length {0}; length <= 300; ++length) {
+        BOOST_REQUIRE_EQUAL(unpack(pack(sequence), length), sequence);
+        sequence += symbols[(7 * length + 3) % symbols.size()];
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
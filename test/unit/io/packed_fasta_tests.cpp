@@ -0,0 +1,177 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <memory>
+#include <fstream>
+#include <algorithm>
+#include <iterator>
+#include <cctype>
+#include <cstddef>
+
+#include <boost/filesystem/operations.hpp>
+
+#include "basics/genomic_region.hpp"
+#include "io/reference/reference_genome.hpp"
+#include "io/reference/fasta.hpp"
+#include "io/reference/packed_fasta.hpp"
+
+namespace octopus { namespace test {
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+using io::Fasta;
+using io::PackedFasta;
+
+// Word boundaries are every 32 bases, and byte boundaries every 4
+const std::string contig1Sequence {"ACGTNNNNacgtnnRYKMacgtACGTSWBDHVNacgtacgtACGTACGTACGTACGTACGTAAAAcccCGGGTTTTnnNNaa"};
+const std::string contig2Sequence {"NNNNNNNNNNttttTTTTggggGGGG"};
+
+// Writes an indexed FASTA with 10 bases per line
+struct TestFasta
+{
+    fs::path directory, path;
+
+    TestFasta()
+    : directory {fs::temp_directory_path() / fs::unique_path("octopus-packed-fasta-tests-%%%%-%%%%")}
+    , path {directory / "packed.fa"}
+    {
+        fs::create_directories(directory);
+        std::ofstream fasta {path.string()}, index {path.string() + ".fai"};
+        fasta << ">1 first\n";
+        for (std::size_t i {0}; i < contig1Sequence.size(); i += 10) fasta << contig1Sequence.substr(i, 10) << '\n';
+        fasta << ">2\n";
+        for (std::size_t i {0}; i < contig2Sequence.size(); i += 10) fasta << contig2Sequence.substr(i, 10) << '\n';
+        index << "1\t" << contig1Sequence.size() << "\t9\t10\t11\n";
+        index << "2\t" << contig2Sequence.size() << "\t" << (9 + contig1Sequence.size() + (contig1Sequence.size() + 9) / 10 + 3)
+              << "\t10\t11\n";
+    }
+
+    ~TestFasta()
+    {
+        boost::system::error_code ec {};
+        fs::permissions(directory, fs::owner_all, ec);
+        fs::remove_all(directory, ec);
+    }
+};
+
+auto make_options(const bool capitalise, const bool disambiguate)
+{
+    Fasta::Options result {};
+    if (capitalise) result.base_transform_policy = Fasta::Options::CapitalisationPolicy::capitalise;
+    if (disambiguate) result.iupac_ambiguity_symbol_policy = Fasta::Options::IUPACAmbiguitySymbolPolicy::disambiguate;
+    result.base_fill_policy = Fasta::Options::BaseFillPolicy::fill_with_ns;
+    return result;
+}
+
+auto expected_sequence(const GenomicRegion& region, const bool capitalise)
+{
+    auto result = contig1Sequence.substr(region.begin(), size(region));
+    if (capitalise) {
+        std::transform(std::cbegin(result), std::cend(result), std::begin(result),
+                       [] (char c) { return static_cast<char>(std::toupper(static_cast<unsigned char>(c))); });
+    }
+    return result;
+}
+
+bool is_writable(const fs::path& directory)
+{
+    const auto probe = directory / fs::unique_path();
+    {
+        std::ofstream file {probe.string()};
+        if (!file) return false;
+    }
+    fs::remove(probe);
+    return true;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(io)
+BOOST_AUTO_TEST_SUITE(packed_fasta)
+
+BOOST_AUTO_TEST_CASE(packed_fasta_fetches_the_same_sequence_as_fasta)
+{
+    const TestFasta test_fasta {};
+    for (const bool capitalise : {false, true}) {
+        for (const bool disambiguate : {false, true}) {
+            const auto options = make_options(capitalise, disambiguate);
+            const ReferenceGenome fasta {std::make_unique<Fasta>(test_fasta.path, options)};
+            const ReferenceGenome packed {std::make_unique<PackedFasta>(test_fasta.path, options)};
+            BOOST_REQUIRE(fs::exists(PackedFasta::default_packed_path(test_fasta.path)));
+            BOOST_REQUIRE(packed.contig_names() == fasta.contig_names());
+            for (const auto& contig : fasta.contig_names()) {
+                BOOST_REQUIRE_EQUAL(packed.contig_size(contig), fasta.contig_size(contig));
+                const auto contig_size = fasta.contig_size(contig);
+                for (GenomicRegion::Position begin {0}; begin <= contig_size; ++begin) {
+                    for (auto end = begin; end <= contig_size + 2; ++end) {
+                        const GenomicRegion region {contig, begin, end};
+                        BOOST_CHECK_EQUAL(packed.fetch_sequence(region), fasta.fetch_sequence(region));
+                    }
+                }
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(packed_fasta_fetches_regions_that_cross_packed_boundaries)
+{
+    const TestFasta test_fasta {};
+    const GenomicRegion byte_crossing_region {"1", 2, 6}, word_crossing_region {"1", 60, 68};
+    BOOST_REQUIRE_EQUAL(expected_sequence(byte_crossing_region, false), "GTNN");
+    BOOST_REQUIRE_EQUAL(expected_sequence(word_crossing_region, false), "TAAAAccc");
+    for (const bool capitalise : {false, true}) {
+        const ReferenceGenome packed {std::make_unique<PackedFasta>(test_fasta.path, make_options(capitalise, false))};
+        BOOST_CHECK_EQUAL(packed.fetch_sequence(byte_crossing_region), expected_sequence(byte_crossing_region, capitalise));
+        BOOST_CHECK_EQUAL(packed.fetch_sequence(word_crossing_region), expected_sequence(word_crossing_region, capitalise));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(packed_fasta_keeps_lowercase_and_n_bases)
+{
+    const TestFasta test_fasta {};
+    const GenomicRegion region {"1", 4, 14};
+    BOOST_REQUIRE_EQUAL(expected_sequence(region, false), "NNNNacgtnn");
+    const ReferenceGenome packed {std::make_unique<PackedFasta>(test_fasta.path, make_options(false, false))};
+    BOOST_CHECK_EQUAL(packed.fetch_sequence(region), "NNNNacgtnn");
+    const ReferenceGenome capitalised {std::make_unique<PackedFasta>(test_fasta.path, make_options(true, false))};
+    BOOST_CHECK_EQUAL(capitalised.fetch_sequence(region), "NNNNACGTNN");
+    BOOST_CHECK_EQUAL(capitalised.fetch_sequence(GenomicRegion {"2", 8, 12}), "NNTT");
+}
+
+BOOST_AUTO_TEST_CASE(packed_fasta_can_be_made_at_a_given_path)
+{
+    const TestFasta test_fasta {};
+    const auto packed_path = test_fasta.directory / "elsewhere.packed";
+    const ReferenceGenome packed {std::make_unique<PackedFasta>(test_fasta.path, packed_path, make_options(true, false))};
+    BOOST_CHECK(fs::exists(packed_path));
+    BOOST_CHECK(!fs::exists(PackedFasta::default_packed_path(test_fasta.path)));
+    BOOST_CHECK_EQUAL(packed.fetch_sequence(GenomicRegion {"1", 4, 14}), "NNNNACGTNN");
+}
+
+BOOST_AUTO_TEST_CASE(packed_fasta_falls_back_to_the_temp_directory_if_the_fasta_directory_is_read_only)
+{
+    const TestFasta test_fasta {};
+    fs::permissions(test_fasta.directory, fs::owner_read | fs::owner_exe);
+    if (is_writable(test_fasta.directory)) {
+        BOOST_TEST_MESSAGE("Skipping read-only directory test as permissions are not enforced for this user");
+        return;
+    }
+    const auto fallback_path = PackedFasta::fallback_packed_path(test_fasta.path);
+    BOOST_REQUIRE_NE(fallback_path.parent_path(), test_fasta.directory);
+    const ReferenceGenome packed {std::make_unique<PackedFasta>(test_fasta.path, make_options(true, false))};
+    BOOST_CHECK(!fs::exists(PackedFasta::default_packed_path(test_fasta.path)));
+    BOOST_CHECK(fs::exists(fallback_path));
+    BOOST_CHECK_EQUAL(packed.fetch_sequence(GenomicRegion {"1", 2, 6}), "GTNN");
+    fs::remove(fallback_path);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
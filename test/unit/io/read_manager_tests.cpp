@@ -3,151 +3,232 @@
 
 #include <boost/test/unit_test.hpp>
 
-#include <iostream>
 #include <string>
 #include <iterator>
 #include <vector>
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <fstream>
+#include <stdexcept>
+#include <cstddef>
 
 #include <boost/filesystem.hpp>
 
+#include <htslib/sam.h>
+
 #include "basics/genomic_region.hpp"
 #include "basics/aligned_read.hpp"
 #include "io/read/read_manager.hpp"
-#include "test_common.hpp"
-#include "mock_objects.hpp"
+#include "utils/executor.hpp"
 
 namespace octopus { namespace test {
 
 namespace fs = boost::filesystem;
 
+namespace {
+
+constexpr unsigned readLength {100}, contigLength {100'000};
+
+struct TestRead
+{
+    std::string sample, contig;
+    unsigned begin; // 0-based
+};
+
+void convert_to_indexed_bam(const fs::path& sam, const fs::path& bam)
+{
+    samFile* in {sam_open(sam.c_str(), "r")};
+    if (!in) throw std::runtime_error {"could not open " + sam.string()};
+    bam_hdr_t* header {sam_hdr_read(in)};
+    samFile* out {sam_open(bam.c_str(), "wb")};
+    bool good {header && out && sam_hdr_write(out, header) >= 0};
+    bam1_t* record {bam_init1()};
+    int status {0};
+    while (good && (status = sam_read1(in, header, record)) >= 0) {
+        good = sam_write1(out, header, record) >= 0;
+    }
+    good = good && status == -1;
+    bam_destroy1(record);
+    if (out) good = sam_close(out) >= 0 && good;
+    if (header) bam_hdr_destroy(header);
+    sam_close(in);
+    if (!good || sam_index_build(bam.c_str(), 0) < 0) {
+        throw std::runtime_error {"could not write " + bam.string()};
+    }
+}
+
+// Writes a coordinate sorted and indexed BAM with one read group for each sample and reads
+// placed at random on two contigs
+std::vector<TestRead>
+write_bam(const fs::path& bam, const std::vector<std::string>& samples, const unsigned num_reads_per_sample,
+          const unsigned seed)
+{
+    std::mt19937 generator {seed};
+    std::uniform_int_distribution<unsigned> position_dist {0, contigLength - readLength};
+    std::uniform_int_distribution<std::size_t> base_dist {0, 3};
+    std::vector<TestRead> result {};
+    for (const auto& sample : samples) {
+        for (const std::string contig : {"1", "2"}) {
+            for (unsigned i {0}; i < num_reads_per_sample / 2; ++i) {
+                result.push_back({sample, contig, position_dist(generator)});
+            }
+        }
+    }
+    std::sort(std::begin(result), std::end(result), [] (const auto& lhs, const auto& rhs) {
+        return lhs.contig == rhs.contig ? lhs.begin < rhs.begin : lhs.contig < rhs.contig;
+    });
+    const auto sam = fs::path {bam}.replace_extension(".sam");
+    {
+        std::ofstream out {sam.string()};
+        out << "@HD\tVN:1.6\tSO:coordinate\n";
+        out << "@SQ\tSN:1\tLN:" << contigLength << "\n@SQ\tSN:2\tLN:" << contigLength << '\n';
+        for (const auto& sample : samples) {
+            out << "@RG\tID:" << bam.stem().string() << '.' << sample << "\tSM:" << sample << '\n';
+        }
+        const std::string bases {"ACGT"};
+        for (std::size_t i {0}; i < result.size(); ++i) {
+            const auto& read = result[i];
+            std::string sequence(readLength, 'N');
+            for (auto& base : sequence) base = bases[base_dist(generator)];
+            out << bam.stem().string() << '.' << i << "\t0\t" << read.contig << '\t' << read.begin + 1 << "\t60\t"
+                << readLength << "M\t*\t0\t0\t" << sequence << '\t' << std::string(readLength, 'I')
+                << "\tRG:Z:" << bam.stem().string() << '.' << read.sample << '\n';
+        }
+    }
+    convert_to_indexed_bam(sam, bam);
+    fs::remove(sam);
+    return result;
+}
+
+// Three BAMs: a.bam has sample A, b.bam has samples A and B, and c.bam has sample C
+struct TestBams
+{
+    fs::path directory;
+    std::vector<fs::path> paths;
+    std::vector<TestRead> reads;
+
+    TestBams()
+    : directory {fs::temp_directory_path() / fs::unique_path("octopus-read-manager-tests-%%%%-%%%%")}
+    , paths {}
+    , reads {}
+    {
+        fs::create_directories(directory);
+        const std::vector<std::pair<std::string, std::vector<std::string>>> files {
+            {"a.bam", {"A"}}, {"b.bam", {"A", "B"}}, {"c.bam", {"C"}}
+        };
+        unsigned seed {0};
+        for (const auto& file : files) {
+            paths.push_back(directory / file.first);
+            auto file_reads = write_bam(paths.back(), file.second, 2'000, ++seed);
+            reads.insert(std::end(reads), std::begin(file_reads), std::end(file_reads));
+        }
+    }
+
+    ~TestBams() { fs::remove_all(directory); }
+
+    std::size_t count_reads(const std::string& sample, const GenomicRegion& region) const
+    {
+        return std::count_if(std::cbegin(reads), std::cend(reads), [&] (const TestRead& read) {
+            return read.sample == sample && read.contig == region.contig_name()
+                && read.begin < region.end() && region.begin() < read.begin + readLength;
+        });
+    }
+};
+
+} // namespace
+
 BOOST_AUTO_TEST_SUITE(io)
 BOOST_AUTO_TEST_SUITE(read_manager)
 
 BOOST_AUTO_TEST_CASE(can_extract_reads_from_BAM_files)
 {
-    BOOST_REQUIRE(test_file_exists(NA12878_low_coverage));
-    
-    ReadManager read_manager {NA12878_low_coverage};
-    
-    BOOST_REQUIRE(read_manager.num_samples() == 1);
-    
-    const auto sample = read_manager.samples().front();
-    
-    const GenomicRegion region1 {"1", 9'990, 10'000};
-    const GenomicRegion region2 {"10", 1'000'000, 1'000'100};
-    const GenomicRegion region3 {"3", 100'000, 100'100};
-    
-    const auto reads1 = read_manager.fetch_reads(sample, region1);
-    
-    BOOST_CHECK(reads1.size() == 1);
-    
-    const auto reads2 = read_manager.fetch_reads(sample, region2);
-    
-    BOOST_CHECK(reads2.size() == 7);
-    
-    const auto reads3 = read_manager.fetch_reads(sample, region3);
-    
-    BOOST_CHECK(reads3.size() == 21);
-}
+    const TestBams bams {};
+
+    ReadManager read_manager {bams.paths.front()};
 
-BOOST_AUTO_TEST_CASE(can_extract_reads_from_CRAM_files)
-{
-    BOOST_REQUIRE(test_file_exists(NA12878_low_coverage_cram));
-    
-    ReadManager read_manager {NA12878_low_coverage_cram};
-    
     BOOST_REQUIRE(read_manager.num_samples() == 1);
-    
+
     const auto sample = read_manager.samples().front();
-    
+
+    BOOST_REQUIRE(sample == "A");
+
     const GenomicRegion region1 {"1", 9'990, 10'000};
-    const GenomicRegion region2 {"10", 1'000'000, 1'000'100};
-    const GenomicRegion region3 {"3", 100'000, 100'100};
-    
-    const auto reads1 = read_manager.fetch_reads(sample, region1);
-    
-    BOOST_CHECK(reads1.size() == 1);
-    
-    const auto reads2 = read_manager.fetch_reads(sample, region2);
-    
-    BOOST_CHECK(reads2.size() == 7);
-    
-    const auto reads3 = read_manager.fetch_reads(sample, region3);
-    
-    BOOST_CHECK(reads3.size() == 21);
+    const GenomicRegion region2 {"2", 50'000, 52'000};
+    const GenomicRegion region3 {"1", 0, contigLength};
+
+    for (const auto& region : {region1, region2, region3}) {
+        const auto reads = read_manager.fetch_reads(sample, region);
+        BOOST_CHECK(reads.size() == bams.count_reads(sample, region));
+        BOOST_CHECK(std::is_sorted(std::cbegin(reads), std::cend(reads)));
+    }
 }
 
 BOOST_AUTO_TEST_CASE(read_manager_multiple_files_below_max_file_limit_test)
 {
-    BOOST_REQUIRE(test_file_exists(NA12878_low_coverage));
-    BOOST_REQUIRE(test_file_exists(HG00101));
-    
-    std::vector<fs::path> read_paths {NA12878_low_coverage, HG00101};
-    
-    constexpr unsigned maxOpenFiles {2};
-    
-    ReadManager read_manager(read_paths, maxOpenFiles);
-    
-    BOOST_REQUIRE(read_manager.num_samples() == 2);
-    
-    const auto samples = read_manager.samples();
-    
-    BOOST_REQUIRE(samples.size() == 2);
-    
-    const GenomicRegion a_big_region {"1", 2000000, 3000000};
-    const GenomicRegion a_small_region {"10", 1000000, 1000100};
-    
-    const auto first_sample = samples.front();
-    
-    const auto big_region_reads1   = read_manager.fetch_reads(first_sample, a_big_region);
-    const auto small_region_reads1 = read_manager.fetch_reads(first_sample, a_small_region);
-    
-    BOOST_CHECK(big_region_reads1.size() == 61225);
-    BOOST_CHECK(small_region_reads1.size() == 10);
-    
-    const auto second_sample = samples.back();
-    
-    const auto big_region_reads2   = read_manager.fetch_reads(second_sample, a_big_region);
-    const auto small_region_reads2 = read_manager.fetch_reads(second_sample, a_small_region);
-    
-    BOOST_CHECK(big_region_reads2.size() == 39200);
-    BOOST_CHECK(small_region_reads2.size() == 7);
+    const TestBams bams {};
+
+    constexpr unsigned maxOpenFiles {3};
+
+    ReadManager read_manager(bams.paths, maxOpenFiles);
+
+    BOOST_REQUIRE(read_manager.num_samples() == 3);
+
+    const GenomicRegion a_big_region {"1", 20'000, 80'000};
+    const GenomicRegion a_small_region {"2", 1'000, 1'100};
+
+    for (const auto& sample : read_manager.samples()) {
+        BOOST_CHECK(read_manager.fetch_reads(sample, a_big_region).size() == bams.count_reads(sample, a_big_region));
+        BOOST_CHECK(read_manager.fetch_reads(sample, a_small_region).size() == bams.count_reads(sample, a_small_region));
+    }
 }
 
 BOOST_AUTO_TEST_CASE(read_manager_multiple_files_above_max_file_limit_test)
 {
-    BOOST_REQUIRE(test_file_exists(NA12878_low_coverage));
-    BOOST_REQUIRE(test_file_exists(HG00101));
-    BOOST_REQUIRE(test_file_exists(HG00102));
-    
-    std::vector<fs::path> read_paths {NA12878_low_coverage, HG00101, HG00102};
-    
+    const TestBams bams {};
+
     constexpr unsigned maxOpenFiles {2};
-    
-    ReadManager read_manager(read_paths, maxOpenFiles);
-    
+
+    ReadManager read_manager(bams.paths, maxOpenFiles);
+
     BOOST_REQUIRE(read_manager.num_samples() == 3);
-    
-    const auto samples = read_manager.samples();
-    
-    const GenomicRegion a_big_region {"1", 2000000, 3000000};
-    const GenomicRegion a_small_region {"10", 1000000, 1000100};
-    
-    const auto big_reads1 = read_manager.fetch_reads(samples[0], a_big_region);
-    const auto big_reads2 = read_manager.fetch_reads(samples[1], a_big_region);
-    const auto big_reads3 = read_manager.fetch_reads(samples[2], a_big_region);
-    
-    BOOST_CHECK(big_reads1.size() == 61225);
-    BOOST_CHECK(big_reads2.size() == 49810);
-    BOOST_CHECK(big_reads3.size() == 39200);
-    
-    const auto small_reads1 = read_manager.fetch_reads(samples[0], a_small_region);
-    const auto small_reads2 = read_manager.fetch_reads(samples[1], a_small_region);
-    const auto small_reads3 = read_manager.fetch_reads(samples[2], a_small_region);
-    
-    BOOST_CHECK(small_reads1.size() == 10);
-    BOOST_CHECK(small_reads2.size() == 9);
-    BOOST_CHECK(small_reads3.size() == 7);
+
+    const GenomicRegion a_big_region {"1", 20'000, 80'000};
+    const GenomicRegion a_small_region {"2", 1'000, 1'100};
+
+    for (const auto& sample : read_manager.samples()) {
+        BOOST_CHECK(read_manager.fetch_reads(sample, a_big_region).size() == bams.count_reads(sample, a_big_region));
+        BOOST_CHECK(read_manager.fetch_reads(sample, a_small_region).size() == bams.count_reads(sample, a_small_region));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(concurrent_fetching_gives_the_same_reads_as_serial_fetching)
+{
+    const TestBams bams {};
+
+    const auto executor = std::make_shared<Executor>(4);
+    install_executor(executor);
+
+    const GenomicRegion region {"1", 10'000, 90'000};
+
+    for (const unsigned max_open_files : {2u, 3u}) {
+        ReadManager serial_manager(bams.paths, max_open_files), concurrent_manager(bams.paths, max_open_files);
+        concurrent_manager.set_max_fetch_threads(3);
+
+        const auto serial_reads     = serial_manager.fetch_reads(region);
+        const auto concurrent_reads = concurrent_manager.fetch_reads(region);
+
+        BOOST_REQUIRE(serial_reads.size() == 3);
+        BOOST_REQUIRE(concurrent_reads.size() == 3);
+
+        for (const auto& p : serial_reads) {
+            const auto& reads = concurrent_reads.at(p.first);
+            BOOST_CHECK(reads.size() == bams.count_reads(p.first, region));
+            BOOST_CHECK(std::is_sorted(std::cbegin(reads), std::cend(reads)));
+            BOOST_CHECK(reads == p.second);
+            BOOST_CHECK(concurrent_manager.fetch_reads(p.first, region) == p.second);
+        }
+    }
 }
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,136 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+#include "io/variant/vcf_header.hpp"
+#include "io/variant/vcf_record.hpp"
+#include "io/variant/typed_vcf_record.hpp"
+
+namespace octopus { namespace test {
+
+namespace {
+
+auto make_test_schema()
+{
+    const auto header = get_default_header_builder()
+    .set_samples({"S1", "S2"})
+    .add_contig("1")
+    .add_format("GT", "1", "String", "Genotype")
+    .add_format("GQ", "1", "Integer", "Genotype quality")
+    .add_format("AD", "R", "Integer", "Allele depths")
+    .add_format("GL", "G", "Float", "Genotype likelihoods")
+    .add_format("FT", "1", "String", "Sample filter")
+    .build_once();
+    return std::make_shared<const VcfRecordSchema>(header);
+}
+
+auto make_test_record()
+{
+    using Phasing = VcfRecord::Builder::Phasing;
+    return VcfRecord::Builder {}
+    .set_chrom("1").set_pos(100).set_id("rs1").set_ref("A").set_alt(std::vector<VcfRecord::NucleotideSequence> {"C", "T"})
+    .set_qual(50)
+    .set_passed()
+    .set_info("DP", std::string {"20"})
+    .set_info("AF", std::vector<std::string> {"0.250000", "."})
+    .set_info_flag("DB")
+    .set_info("AA", std::string {"A"})
+    .set_format({"GT", "GQ", "AD", "GL", "FT"})
+    .set_genotype("S1", std::vector<VcfRecord::NucleotideSequence> {"A", "C"}, Phasing::phased)
+    .set_genotype("S2", std::vector<VcfRecord::NucleotideSequence> {"T"}, Phasing::unphased)
+    .set_format("S1", "GQ", std::string {"30"}).set_format("S2", "GQ", std::string {"."})
+    .set_format("S1", "AD", std::vector<std::string> {"10", "8", "2"})
+    .set_format("S2", "AD", std::vector<std::string> {"5", "0"})
+    .set_format("S1", "GL", std::vector<std::string> {"-0.500000", "0.000000", "-2.000000"})
+    .set_format("S2", "GL", std::vector<std::string> {"."})
+    .set_format("S1", "FT", std::string {"PASS"}).set_format("S2", "FT", std::string {"q10"})
+    .build_once();
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(io)
+BOOST_AUTO_TEST_SUITE(typed_vcf_record)
+
+BOOST_AUTO_TEST_CASE(schema_indexes_header_fields)
+{
+    const auto schema = make_test_schema();
+    BOOST_REQUIRE(schema->info_index("DP"));
+    BOOST_CHECK(schema->info_field(*schema->info_index("DP")).type == VcfRecordSchema::ValueType::integer);
+    BOOST_CHECK_EQUAL(*schema->info_field(*schema->info_index("DP")).number, 1);
+    BOOST_CHECK(schema->info_field(*schema->info_index("AF")).type == VcfRecordSchema::ValueType::floating);
+    BOOST_CHECK(!schema->info_field(*schema->info_index("AF")).number);
+    BOOST_CHECK(schema->info_field(*schema->info_index("DB")).type == VcfRecordSchema::ValueType::flag);
+    BOOST_CHECK(schema->format_field(*schema->format_index("GL")).type == VcfRecordSchema::ValueType::floating);
+    BOOST_CHECK(!schema->info_index("NOT_A_KEY"));
+    BOOST_CHECK_EQUAL(*schema->sample_index("S2"), 1);
+}
+
+BOOST_AUTO_TEST_CASE(make_typed_stores_values_in_declared_types)
+{
+    const auto schema = make_test_schema();
+    const auto record = make_typed(make_test_record(), schema);
+
+    BOOST_CHECK_EQUAL(record.pos(), 100);
+    BOOST_CHECK_EQUAL(record.alt().size(), 2);
+
+    const auto dp = record.info_ints(*schema->info_index("DP"));
+    BOOST_REQUIRE_EQUAL(dp.size(), 1);
+    BOOST_CHECK_EQUAL(dp[0], 20);
+    const auto af = record.info_floats(*schema->info_index("AF"));
+    BOOST_REQUIRE_EQUAL(af.size(), 2);
+    BOOST_CHECK_CLOSE(af[0], 0.25f, 1e-6);
+    BOOST_CHECK(TypedVcfRecord::is_missing(af[1]));
+    BOOST_CHECK(record.info_flag(*schema->info_index("DB")));
+    BOOST_CHECK(!record.has_info("END"));
+
+    BOOST_REQUIRE(record.has_genotypes());
+    BOOST_CHECK_EQUAL(record.max_ploidy(), 2);
+    BOOST_CHECK_EQUAL(record.ploidy(0), 2);
+    BOOST_CHECK_EQUAL(record.ploidy(1), 1);
+    BOOST_CHECK_EQUAL(record.genotype(0)[1], 1);
+    BOOST_CHECK_EQUAL(record.genotype(1)[0], 2);
+    BOOST_CHECK(record.is_sample_phased(0));
+    BOOST_CHECK(!record.is_sample_phased(1));
+
+    const auto ad = *schema->format_index("AD");
+    BOOST_CHECK_EQUAL(record.format_stride(ad), 3);
+    BOOST_CHECK_EQUAL(record.format_ints(ad, 0).size(), 3);
+    BOOST_CHECK_EQUAL(record.format_ints(ad, 1).size(), 2); // padding is not visible
+    BOOST_CHECK(TypedVcfRecord::is_missing(record.format_ints(*schema->format_index("GQ"), 1)[0]));
+    BOOST_CHECK_EQUAL(record.format_string(*schema->format_index("FT"), 1), "q10");
+}
+
+BOOST_AUTO_TEST_CASE(typed_records_convert_back_to_equivalent_string_records)
+{
+    const auto schema = make_test_schema();
+    const auto original = make_test_record();
+    const auto converted = make_vcf_record(make_typed(original, schema));
+
+    BOOST_CHECK(converted == original);
+    BOOST_CHECK_EQUAL(converted.id(), original.id());
+    BOOST_CHECK(converted.filter() == original.filter());
+    for (const auto& key : original.info_keys()) {
+        BOOST_REQUIRE(converted.has_info(key));
+        BOOST_CHECK(converted.info_value(key) == original.info_value(key));
+    }
+    BOOST_CHECK(converted.format() == original.format());
+    for (const std::string sample : {"S1", "S2"}) {
+        BOOST_CHECK_EQUAL(converted.is_sample_phased(sample), original.is_sample_phased(sample));
+        for (const auto& key : original.format()) {
+            BOOST_CHECK(converted.get_sample_value(sample, key) == original.get_sample_value(sample, key));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
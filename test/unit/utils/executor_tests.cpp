@@ -0,0 +1,89 @@
+// Copyright (c) 2017 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <thread>
+#include <chrono>
+#include <stdexcept>
+#include <cstddef>
+
+#include "utils/executor.hpp"
+
+namespace octopus { namespace test {
+
+BOOST_AUTO_TEST_SUITE(utils)
+BOOST_AUTO_TEST_SUITE(executor)
+
+namespace {
+
+void update_max(std::atomic<unsigned>& max, const unsigned value)
+{
+    auto current = max.load();
+    while (current < value && !max.compare_exchange_weak(current, value));
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(parallel_for_calls_body_once_for_each_index)
+{
+    Executor executor {4};
+    std::vector<std::atomic<int>> counts(1000);
+    for (auto& count : counts) count = 0;
+    executor.parallel_for("test", counts.size(), [&] (const std::size_t i) { ++counts[i]; });
+    BOOST_CHECK(std::all_of(std::cbegin(counts), std::cend(counts), [] (const auto& count) { return count == 1; }));
+}
+
+BOOST_AUTO_TEST_CASE(parallel_for_never_exceeds_max_concurrency)
+{
+    const unsigned max_concurrency {4};
+    Executor executor {max_concurrency};
+    std::atomic<unsigned> num_running {0}, max_running {0};
+    const auto task = [&] () {
+        const Executor::Participant participant {&executor};
+        executor.parallel_for("outer", 8, [&] (std::size_t) {
+            executor.parallel_for("inner", 8, [&] (std::size_t) {
+                update_max(max_running, ++num_running);
+                std::this_thread::sleep_for(std::chrono::microseconds {100});
+                --num_running;
+            });
+        });
+    };
+    std::thread other_task {task};
+    task();
+    other_task.join();
+    BOOST_CHECK_LE(max_running.load(), max_concurrency);
+}
+
+BOOST_AUTO_TEST_CASE(parallel_for_rethrows_exceptions_after_finishing)
+{
+    Executor executor {4};
+    std::atomic<std::size_t> num_calls {0};
+    BOOST_CHECK_THROW(executor.parallel_for("test", 100, [&] (const std::size_t i) {
+        ++num_calls;
+        if (i == 10) throw std::runtime_error {"test"};
+    }), std::runtime_error);
+    BOOST_CHECK_EQUAL(num_calls.load(), 100);
+}
+
+BOOST_AUTO_TEST_CASE(async_is_deferred_without_available_helpers)
+{
+    Executor executor {1};
+    const auto caller = std::this_thread::get_id();
+    auto result = executor.async("test", [] () { return std::this_thread::get_id(); });
+    BOOST_CHECK(result.get() == caller);
+    const auto metrics = executor.metrics();
+    BOOST_REQUIRE_EQUAL(metrics.size(), 1);
+    BOOST_CHECK_EQUAL(metrics.front().first, "test");
+    BOOST_CHECK_EQUAL(metrics.front().second.helper_tasks, 0);
+    BOOST_CHECK_EQUAL(metrics.front().second.refused_helpers, 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
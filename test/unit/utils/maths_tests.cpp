@@ -5,7 +5,13 @@
 #include <boost/test/unit_test.hpp>
 #include <boost/test/floating_point_comparison.hpp>
  
+#include <vector>
+#include <random>
+#include <cmath>
+#include <cstddef>
+
 #include "utils/maths.hpp"
+#include "utils/simd_log_sum_exp.hpp"
  
 namespace octopus { namespace test {
  
@@ -22,6 +28,106 @@ BOOST_AUTO_TEST_CASE(log_sum_exp_handles_edge_cases)
     BOOST_CHECK_CLOSE(log_sum_exp(lnHalf, lnHalf), zero, tolerance);
     BOOST_CHECK_CLOSE(log_sum_exp(zero, zero), -lnHalf, tolerance);
 }
+
+BOOST_AUTO_TEST_CASE(scalar_log_sum_exp_kernel_is_always_supported)
+{
+    const auto isas = octopus::maths::simd::supported_instruction_sets();
+    BOOST_REQUIRE(!isas.empty());
+    BOOST_CHECK(isas.front() == octopus::maths::simd::InstructionSet::scalar);
+    BOOST_CHECK(isas.back() == octopus::maths::simd::get_instruction_set());
+}
+
+BOOST_AUTO_TEST_CASE(simd_sum_log_sum_exp_agrees_with_log_sum_exp)
+{
+    using namespace octopus::maths::simd;
+    std::mt19937 generator {42};
+    std::uniform_real_distribution<double> log_likelihood {-300.0, 0.0};
+    std::uniform_int_distribution<int> scale {0, 6};
+    const auto original_isa = get_instruction_set();
+    for (std::size_t k {1}; k <= 5; ++k) {
+        // Sizes either side of every vector width so the scalar remainder is covered
+        for (const std::size_t n : {0, 1, 3, 4, 5, 7, 8, 9, 17, 250}) {
+            std::vector<std::vector<double>> columns(k, std::vector<double>(n));
+            std::vector<std::vector<float>> float_columns(k, std::vector<float>(n));
+            std::vector<const double*> column_ptrs {};
+            std::vector<const float*> float_column_ptrs {};
+            std::vector<double> log_weights {};
+            for (std::size_t j {0}; j < k; ++j) {
+                for (std::size_t i {0}; i < n; ++i) {
+                    columns[j][i] = log_likelihood(generator) * std::pow(10.0, -scale(generator));
+                    float_columns[j][i] = columns[j][i];
+                }
+                column_ptrs.push_back(columns[j].data());
+                float_column_ptrs.push_back(float_columns[j].data());
+                log_weights.push_back(std::log(j + 1));
+            }
+            double expected {0}, float_expected {0};
+            std::vector<double> buffer(k);
+            for (std::size_t i {0}; i < n; ++i) {
+                for (std::size_t j {0}; j < k; ++j) buffer[j] = columns[j][i] + log_weights[j];
+                expected += octopus::maths::log_sum_exp(buffer);
+                for (std::size_t j {0}; j < k; ++j) buffer[j] = float_columns[j][i] + log_weights[j];
+                float_expected += octopus::maths::log_sum_exp(buffer);
+            }
+            for (const auto isa : supported_instruction_sets()) {
+                set_instruction_set(isa);
+                BOOST_TEST_CONTEXT(to_string(isa) << " k=" << k << " n=" << n) {
+                    // The vector kernels are accurate to a few ulps per read
+                    const auto abs_tolerance = 1e-12 * std::max(1.0, std::abs(expected));
+                    BOOST_CHECK_SMALL(sum_log_sum_exp(column_ptrs.data(), log_weights.data(), k, n) - expected, abs_tolerance);
+                    BOOST_CHECK_SMALL(sum_log_sum_exp(float_column_ptrs.data(), log_weights.data(), k, n) - float_expected, abs_tolerance);
+                }
+            }
+        }
+    }
+    set_instruction_set(original_isa);
+}
+
+BOOST_AUTO_TEST_CASE(simd_log_sum_exp_agrees_with_log_sum_exp_for_each_read)
+{
+    using namespace octopus::maths::simd;
+    std::mt19937 generator {7};
+    std::uniform_real_distribution<double> log_likelihood {-100.0, 0.0};
+    const std::size_t k {3}, n {37};
+    std::vector<std::vector<double>> columns(k, std::vector<double>(n));
+    std::vector<const double*> column_ptrs {};
+    for (auto& column : columns) {
+        for (auto& value : column) value = log_likelihood(generator);
+        column_ptrs.push_back(column.data());
+    }
+    const std::vector<double> log_weights {0.0, std::log(2.0), 0.0};
+    const auto original_isa = get_instruction_set();
+    for (const auto isa : supported_instruction_sets()) {
+        set_instruction_set(isa);
+        std::vector<double> result(n);
+        log_sum_exp(column_ptrs.data(), log_weights.data(), k, n, result.data());
+        for (std::size_t i {0}; i < n; ++i) {
+            BOOST_TEST_CONTEXT(to_string(isa) << " i=" << i) {
+                const auto expected = octopus::maths::log_sum_exp({columns[0][i] + log_weights[0],
+                                                                   columns[1][i] + log_weights[1],
+                                                                   columns[2][i] + log_weights[2]});
+                BOOST_CHECK_SMALL(result[i] - expected, 1e-12 * std::max(1.0, std::abs(expected)));
+            }
+        }
+    }
+    set_instruction_set(original_isa);
+}
+
+BOOST_AUTO_TEST_CASE(simd_sum_log_sum_exp_handles_extreme_differences)
+{
+    using namespace octopus::maths::simd;
+    const std::vector<double> likely(16, -1.0), unlikely(16, -5000.0);
+    const std::vector<const double*> columns {likely.data(), unlikely.data()};
+    const std::vector<double> log_weights {0.0, 0.0};
+    const auto original_isa = get_instruction_set();
+    for (const auto isa : supported_instruction_sets()) {
+        set_instruction_set(isa);
+        BOOST_TEST_CONTEXT(to_string(isa)) {
+            BOOST_CHECK_CLOSE(sum_log_sum_exp(columns.data(), log_weights.data(), 2, 16), -16.0, tolerance);
+        }
+    }
+    set_instruction_set(original_isa);
+}
  
 BOOST_AUTO_TEST_SUITE_END()
 BOOST_AUTO_TEST_SUITE_END()